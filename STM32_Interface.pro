@@ -3,7 +3,7 @@
 # IMT Atlantique
 #-------------------------------------------------
 
-QT       += core gui widgets serialport
+QT       += core gui widgets serialport network
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -14,30 +14,29 @@ CONFIG += c++17
 
 DEFINES += QT_DEPRECATED_WARNINGS
 
+# Modèle, contrôleur, communication, stockage, IPC (partagés avec le démon)
+include(STM32_Interface_core.pri)
+
 #-------------------------------------------------
 # SOURCES
 #-------------------------------------------------
 SOURCES += \
     src/main.cpp \
-    src/model/DeviceState.cpp \
-    src/model/DataModel.cpp \
     src/view/MainWindow.cpp \
-    src/controller/DeviceController.cpp \
-    src/communication/SerialManager.cpp \
-    src/communication/SerialWorker.cpp \
-    src/communication/JsonProtocol.cpp
+    src/view/MonitorLogModel.cpp \
+    src/view/MonitorLogDelegate.cpp \
+    src/view/PlotRenderer.cpp \
+    src/view/PlotWidget.cpp
 
 #-------------------------------------------------
 # HEADERS
 #-------------------------------------------------
 HEADERS += \
-    src/model/DeviceState.h \
-    src/model/DataModel.h \
     src/view/MainWindow.h \
-    src/controller/DeviceController.h \
-    src/communication/SerialManager.h \
-    src/communication/SerialWorker.h \
-    src/communication/JsonProtocol.h
+    src/view/MonitorLogModel.h \
+    src/view/MonitorLogDelegate.h \
+    src/view/PlotRenderer.h \
+    src/view/PlotWidget.h
 
 #-------------------------------------------------
 # FORMS
@@ -49,11 +48,7 @@ FORMS += \
 # INCLUDE PATHS
 #-------------------------------------------------
 INCLUDEPATH += \
-    src \
-    src/model \
-    src/view \
-    src/controller \
-    src/communication
+    src/view
 
 #-------------------------------------------------
 # DEPLOYMENT
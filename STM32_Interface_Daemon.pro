@@ -0,0 +1,37 @@
+#-------------------------------------------------
+# STM32 Interface - Démon sans interface graphique
+# IMT Atlantique
+#-------------------------------------------------
+
+QT       += core serialport network
+QT       -= gui
+
+TARGET = STM32_Interface_Daemon
+TEMPLATE = app
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(STM32_Interface_core.pri)
+
+#-------------------------------------------------
+# SOURCES
+#-------------------------------------------------
+SOURCES += \
+    src/daemon/main.cpp \
+    src/daemon/HeadlessRunner.cpp
+
+#-------------------------------------------------
+# HEADERS
+#-------------------------------------------------
+HEADERS += \
+    src/daemon/HeadlessRunner.h
+
+#-------------------------------------------------
+# DEPLOYMENT
+#-------------------------------------------------
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
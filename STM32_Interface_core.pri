@@ -0,0 +1,82 @@
+#-------------------------------------------------
+# STM32 Interface - Cœur sans interface graphique
+# (modèle, contrôleur, communication, stockage, IPC)
+# Inclus par STM32_Interface.pro et STM32_Interface_Daemon.pro
+#-------------------------------------------------
+
+QT += core serialport network
+
+SOURCES += \
+    src/model/DeviceState.cpp \
+    src/model/DataModel.cpp \
+    src/model/ChannelInfo.cpp \
+    src/model/ChannelStorage.cpp \
+    src/model/DownsamplePyramid.cpp \
+    src/model/MonotonicClock.cpp \
+    src/model/QuantileSketch.cpp \
+    src/model/RollingAggregator.cpp \
+    src/model/GorillaCodec.cpp \
+    src/model/CompressedChannelStorage.cpp \
+    src/controller/DeviceController.cpp \
+    src/controller/ClockSync.cpp \
+    src/controller/AlarmEngine.cpp \
+    src/controller/PollScheduler.cpp \
+    src/controller/ActuationTracker.cpp \
+    src/controller/ScriptEngine.cpp \
+    src/controller/ScriptRunner.cpp \
+    src/communication/SerialManager.cpp \
+    src/communication/SerialWorker.cpp \
+    src/communication/JsonProtocol.cpp \
+    src/communication/TextProtocol.cpp \
+    src/communication/RawCapture.cpp \
+    src/storage/ColumnStore.cpp \
+    src/storage/ExportWorker.cpp \
+    src/storage/TelemetryExporter.cpp \
+    src/ipc/TelemetryShmPublisher.cpp \
+    src/ipc/TelemetryIpcServer.cpp
+
+HEADERS += \
+    src/model/DeviceState.h \
+    src/model/DataModel.h \
+    src/model/ChannelInfo.h \
+    src/model/ChannelStorage.h \
+    src/model/DownsamplePyramid.h \
+    src/model/MonotonicClock.h \
+    src/model/QuantileSketch.h \
+    src/model/RollingAggregator.h \
+    src/model/GorillaCodec.h \
+    src/model/CompressedChannelStorage.h \
+    src/controller/DeviceController.h \
+    src/controller/ClockSync.h \
+    src/controller/AlarmEngine.h \
+    src/controller/PollScheduler.h \
+    src/controller/ActuationTracker.h \
+    src/controller/ScriptEngine.h \
+    src/controller/ScriptRunner.h \
+    src/communication/SerialManager.h \
+    src/communication/SerialWorker.h \
+    src/communication/JsonProtocol.h \
+    src/communication/ProtocolTables.h \
+    src/communication/TextProtocol.h \
+    src/communication/RawCapture.h \
+    src/storage/ColumnStore.h \
+    src/storage/ExportWorker.h \
+    src/storage/TelemetryExporter.h \
+    src/ipc/TelemetryShmLayout.h \
+    src/ipc/TelemetryShmPublisher.h \
+    src/ipc/TelemetryIpcServer.h
+
+# Table des commandes (firmware: tools/gen_protocol_tables.py)
+DISTFILES += \
+    src/communication/ProtocolCommands.def
+
+INCLUDEPATH += \
+    $$PWD/src \
+    $$PWD/src/model \
+    $$PWD/src/controller \
+    $$PWD/src/communication \
+    $$PWD/src/storage \
+    $$PWD/src/ipc
+
+# shm_open
+unix:!macx: LIBS += -lrt
@@ -2,6 +2,20 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QDebug>
+#include "ProtocolTables.h"
+
+namespace {
+
+// Types de messages: table à hachage parfait construite à la compilation
+constexpr Protocol::PerfectHashEntry<JsonProtocol::MessageType> MessageTypeEntries[] = {
+#define PROTOCOL_MESSAGE_TYPE(type, name) { name, sizeof(name) - 1, JsonProtocol::type },
+#include "ProtocolCommands.def"
+};
+
+constexpr auto MessageTypeTable = Protocol::makePerfectHashTable(MessageTypeEntries);
+static_assert(MessageTypeTable.isValid(), "ProtocolCommands.def: aucune graine sans collision");
+
+} // namespace
 
 JsonProtocol::JsonProtocol(QObject *parent)
     : QObject(parent)
@@ -32,34 +46,100 @@ QByteArray JsonProtocol::encodeSetLed(bool state)
 {
     QJsonObject params;
     params["state"] = state ? 1 : 0;
-    return encodeCommand("SET_LED", params);
+    return encodeCommand(Protocol::commandName(Protocol::Command::SetLed), params);
 }
 
 QByteArray JsonProtocol::encodeSetPwm(uint8_t dutyCycle)
 {
     QJsonObject params;
     params["duty"] = dutyCycle;
-    return encodeCommand("SET_PWM", params);
+    return encodeCommand(Protocol::commandName(Protocol::Command::SetPwm), params);
 }
 
 QByteArray JsonProtocol::encodeGetStatus()
 {
-    return encodeCommand("STATUS");
+    return encodeCommand(Protocol::commandName(Protocol::Command::Status));
 }
 
 QByteArray JsonProtocol::encodeGetTemperature()
 {
-    return encodeCommand("GET_TEMP");
+    return encodeCommand(Protocol::commandName(Protocol::Command::GetTemp));
 }
 
 QByteArray JsonProtocol::encodeGetVoltage()
 {
-    return encodeCommand("GET_VOLTAGE");
+    return encodeCommand(Protocol::commandName(Protocol::Command::GetVoltage));
 }
 
 QByteArray JsonProtocol::encodeReset()
 {
-    return encodeCommand("RESET");
+    return encodeCommand(Protocol::commandName(Protocol::Command::Reset));
+}
+
+QByteArray JsonProtocol::encodeGetCapabilities()
+{
+    return encodeCommand(Protocol::commandName(Protocol::Command::Caps));
+}
+
+QByteArray JsonProtocol::encodeSync(quint32 sequence)
+{
+    QJsonObject params;
+    params["seq"] = static_cast<qint64>(sequence);
+    return encodeCommand(Protocol::commandName(Protocol::Command::Sync), params);
+}
+
+QByteArray JsonProtocol::encodeBatch(const QJsonArray &commands)
+{
+    QJsonObject params;
+    params["cmds"] = commands;
+    return encodeCommand(Protocol::commandName(Protocol::Command::Batch), params);
+}
+
+QByteArray JsonProtocol::encodeStream(const QList<quint16> &channelIds, int rateHz)
+{
+    // Aucun canal ou fréquence nulle: arrêt du flux
+    QJsonArray channels;
+    for (quint16 id : channelIds) {
+        channels.append(id);
+    }
+
+    QJsonObject params;
+    params["channels"] = channels;
+    params["rate"] = qMax(0, rateHz);
+    return encodeCommand(Protocol::commandName(Protocol::Command::Stream), params);
+}
+
+QJsonObject JsonProtocol::batchEntry(const QByteArray &command, bool *ok)
+{
+    // Sans "type" ni "timestamp": le lot doit tenir dans le buffer du firmware
+    bool valid = false;
+    const QJsonObject message = parseMessage(command, &valid);
+    QJsonObject entry;
+
+    if (valid && message["command"].isString()) {
+        entry["command"] = message["command"];
+        if (message["params"].isObject()) {
+            entry["params"] = message["params"];
+        }
+    }
+
+    if (ok) *ok = !entry.isEmpty();
+    return entry;
+}
+
+int JsonProtocol::batchResultSize(const QJsonObject &entry)
+{
+    // Pires cas des réponses du firmware (main_with_dma.c), erreur comprise
+    const QByteArray name = entry["command"].toString().toLatin1();
+    switch (Protocol::commandFromName(name.constData(), std::size_t(name.size()))) {
+        case Protocol::Command::SetLed:     return 12;   // {"led":1}
+        case Protocol::Command::SetPwm:     return 14;   // {"pwm":100}
+        case Protocol::Command::GetTemp:    return 24;   // {"temp":-40.0}
+        case Protocol::Command::GetVoltage: return 40;   // {"voltage":3.30,"adc_raw":4095}
+        case Protocol::Command::Sync:       return 80;
+        case Protocol::Command::Status:     return 170;
+        default:                            return 64;   // {"error":"..."} ou résultat court
+    }
 }
 
 JsonProtocol::MessageType JsonProtocol::getMessageType(const QByteArray &data)
@@ -71,14 +151,18 @@ JsonProtocol::MessageType JsonProtocol::getMessageType(const QByteArray &data)
         return Unknown;
     }
 
-    QString type = json["type"].toString();
+    return messageType(json);
+}
 
-    if (type == "response") return Response;
-    if (type == "cmd" || type == "command") return Command;
-    if (type == "error") return Error;
-    if (type == "heartbeat") return Heartbeat;
+JsonProtocol::MessageType JsonProtocol::messageType(const QJsonObject &json)
+{
+    const QJsonValue type = json.value("type");
+    if (!type.isString()) {
+        return Unknown;
+    }
 
-    return Unknown;
+    const QString name = type.toString();
+    return MessageTypeTable.find(name.utf16(), std::size_t(name.size()), Unknown);
 }
 
 QJsonObject JsonProtocol::parseMessage(const QByteArray &data, bool *ok)
@@ -176,7 +260,7 @@ bool JsonProtocol::extractStatus(const QJsonObject &json, QJsonObject *status)
 
 bool JsonProtocol::extractError(const QJsonObject &json, QString *errorMessage)
 {
-    if (json["type"].toString() != "error") {
+    if (messageType(json) != Error) {
         return false;
     }
 
@@ -187,6 +271,156 @@ bool JsonProtocol::extractError(const QJsonObject &json, QString *errorMessage)
     return true;
 }
 
+bool JsonProtocol::extractCapabilities(const QJsonObject &json, QJsonArray *channels)
+{
+    if (!json.contains("data") || !json["data"].isObject()) {
+        return false;
+    }
+
+    QJsonObject data = json["data"].toObject();
+
+    if (!data.contains("channels") || !data["channels"].isArray()) {
+        return false;
+    }
+
+    if (channels) {
+        *channels = data["channels"].toArray();
+    }
+
+    return true;
+}
+
+bool JsonProtocol::extractSync(const QJsonObject &json, quint32 *sequence, qint64 *deviceRxUs, qint64 *deviceTxUs)
+{
+    // {"type":"response","data":{"sync":{"seq":N,"t1":µs,"t2":µs}}}
+    if (!json.contains("data") || !json["data"].isObject()) {
+        return false;
+    }
+
+    QJsonObject data = json["data"].toObject();
+
+    if (!data.contains("sync") || !data["sync"].isObject()) {
+        return false;
+    }
+
+    QJsonObject sync = data["sync"].toObject();
+
+    if (!sync["seq"].isDouble() || !sync["t1"].isDouble() || !sync["t2"].isDouble()) {
+        return false;
+    }
+
+    if (sequence) *sequence = static_cast<quint32>(sync["seq"].toDouble());
+    if (deviceRxUs) *deviceRxUs = static_cast<qint64>(sync["t1"].toDouble());
+    if (deviceTxUs) *deviceTxUs = static_cast<qint64>(sync["t2"].toDouble());
+
+    return true;
+}
+
+bool JsonProtocol::extractDeviceTimestamp(const QJsonObject &json, qint64 *deviceUs)
+{
+    // Instant d'acquisition côté dispositif: "t_us" dans "data"
+    if (!json.contains("data") || !json["data"].isObject()) {
+        return false;
+    }
+
+    QJsonObject data = json["data"].toObject();
+
+    if (!data["t_us"].isDouble()) {
+        return false;
+    }
+
+    if (deviceUs) {
+        *deviceUs = static_cast<qint64>(data["t_us"].toDouble());
+    }
+
+    return true;
+}
+
+bool JsonProtocol::extractBatch(const QJsonObject &json, QList<QJsonObject> *messages,
+                                bool *truncated, int *answered, int *executed)
+{
+    // {"type":"response","data":{"batch":[r0,r1,...]}}: chaque résultat est
+    // rendu sous la forme du message qu'aurait produit la commande seule.
+    // Lot tronqué: ...,"truncated":1,"executed":N (exécution arrêtée après N)
+    if (!json.contains("data") || !json["data"].isObject()) {
+        return false;
+    }
+
+    QJsonObject data = json["data"].toObject();
+
+    if (!data.contains("batch") || !data["batch"].isArray()) {
+        return false;
+    }
+
+    const int results = data["batch"].toArray().size();
+    if (truncated) *truncated = data["truncated"].toInt() != 0;
+    if (answered) *answered = results;
+    if (executed) *executed = data["executed"].isDouble() ? qMax(results, data["executed"].toInt()) : results;
+
+    if (messages) {
+        messages->clear();
+        for (const QJsonValue &result : data["batch"].toArray()) {
+            if (!result.isObject()) {
+                continue;  // null: commande sans réponse
+            }
+
+            const QJsonObject object = result.toObject();
+            QJsonObject message;
+            if (object.contains("error")) {
+                message["type"] = "error";
+                message["message"] = object["error"];
+            } else {
+                message["type"] = "response";
+                message["data"] = object;
+            }
+            messages->append(message);
+        }
+    }
+
+    return true;
+}
+
+bool JsonProtocol::extractStreamSequence(const QJsonObject &json, quint32 *sequence)
+{
+    if (messageType(json) != Stream || !json["data"].isObject()) {
+        return false;
+    }
+
+    QJsonObject data = json["data"].toObject();
+
+    if (!data["seq"].isDouble()) {
+        return false;
+    }
+
+    if (sequence) {
+        *sequence = static_cast<quint32>(data["seq"].toDouble());
+    }
+
+    return true;
+}
+
+bool JsonProtocol::extractBatchLimits(const QJsonObject &json, int *maxCommands, int *maxBytes,
+                                      int *maxResultBytes)
+{
+    // Annoncées dans la réponse CAPS: "batch":{"max":8,"bytes":511,"results":438}
+    // ("results" absent: réponse bornée comme la requête)
+    if (!json.contains("data") || !json["data"].isObject()) {
+        return false;
+    }
+
+    QJsonObject batch = json["data"].toObject()["batch"].toObject();
+
+    if (!batch["max"].isDouble() || !batch["bytes"].isDouble()) {
+        return false;
+    }
+
+    if (maxCommands) *maxCommands = batch["max"].toInt();
+    if (maxBytes) *maxBytes = batch["bytes"].toInt();
+    if (maxResultBytes) *maxResultBytes = batch["results"].isDouble() ? batch["results"].toInt() : batch["bytes"].toInt();
+
+    return true;
+}
+
 QString JsonProtocol::messageTypeToString(MessageType type)
 {
     switch (type) {
@@ -194,6 +428,7 @@ QString JsonProtocol::messageTypeToString(MessageType type)
         case Response: return "Response";
         case Error: return "Error";
         case Heartbeat: return "Heartbeat";
+        case Stream: return "Stream";
         case Unknown: return "Unknown";
         default: return "Invalid";
     }
@@ -6,6 +6,8 @@
 #include <QJsonDocument>
 #include <QByteArray>
 #include <QString>
+#include <QJsonArray>
+#include <QList>
 
 /**
  * @brief Protocole de communication JSON pour échanges structurés
@@ -17,6 +19,10 @@
  * - Commande: {"type":"cmd", "command":"GET_TEMP", "params":{}}
  * - Réponse: {"type":"response", "data":{"temp":25.5}, "status":"ok"}
  * - Erreur: {"type":"error", "message":"Invalid command"}
+ * - Lot: {"type":"cmd", "command":"BATCH", "params":{"cmds":[{"command":"SET_LED",
+ *   "params":{"state":1}}, {"command":"GET_TEMP"}]}}, réponse unique
+ *   {"type":"response", "data":{"batch":[{"led":1}, {"temp":25.5}]}}
+ * - Flux: {"type":"stream", "data":{"seq":12, "t_us":83412057, "temp":25.5}}
  */
 class JsonProtocol : public QObject
 {
@@ -28,6 +34,7 @@ public:
         Response,
         Error,
         Heartbeat,
+        Stream,
         Unknown
     };
     
@@ -41,9 +48,21 @@ public:
     static QByteArray encodeGetTemperature();
     static QByteArray encodeGetVoltage();
     static QByteArray encodeReset();
+    static QByteArray encodeGetCapabilities();
+    static QByteArray encodeSync(quint32 sequence);
+    static QByteArray encodeBatch(const QJsonArray &commands);
+    static QByteArray encodeStream(const QList<quint16> &channelIds, int rateHz);
+    
+    // Entrée de lot {"command","params"} tirée d'une commande encodée
+    static QJsonObject batchEntry(const QByteArray &command, bool *ok = nullptr);
+    
+    // Taille maximale du résultat d'une entrée dans la réponse du lot
+    // (séparateur compris), pour borner les lots côté réponse
+    static int batchResultSize(const QJsonObject &entry);
     
     // Décodage des messages
     static MessageType getMessageType(const QByteArray &data);
+    static MessageType messageType(const QJsonObject &json);  // Message déjà décodé
     static QJsonObject parseMessage(const QByteArray &data, bool *ok = nullptr);
     static bool isValidJson(const QByteArray &data);
     
@@ -52,6 +71,16 @@ public:
     static bool extractVoltage(const QJsonObject &json, float *voltage, uint16_t *adcRaw);
     static bool extractStatus(const QJsonObject &json, QJsonObject *status);
     static bool extractError(const QJsonObject &json, QString *errorMessage);
+    static bool extractCapabilities(const QJsonObject &json, QJsonArray *channels);
+    static bool extractSync(const QJsonObject &json, quint32 *sequence, qint64 *deviceRxUs, qint64 *deviceTxUs);
+    static bool extractDeviceTimestamp(const QJsonObject &json, qint64 *deviceUs);
+    // answered: résultats présents (null compris); executed: commandes
+    // exécutées (= answered si le lot n'est pas tronqué)
+    static bool extractBatch(const QJsonObject &json, QList<QJsonObject> *messages,
+                             bool *truncated = nullptr, int *answered = nullptr, int *executed = nullptr);
+    static bool extractBatchLimits(const QJsonObject &json, int *maxCommands, int *maxBytes,
+                                   int *maxResultBytes = nullptr);
+    static bool extractStreamSequence(const QJsonObject &json, quint32 *sequence);
     
     // Utilitaires
     static QString messageTypeToString(MessageType type);
@@ -0,0 +1,171 @@
+#ifndef PROTOCOLTABLES_H
+#define PROTOCOLTABLES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Tables du protocole calculées à la compilation
+ *
+ * Les commandes et types de messages sont définis une seule fois dans
+ * ProtocolCommands.def. Les tables de recherche utilisent un hachage parfait
+ * (FNV-1a 32 bits avec graine, taille puissance de 2 ≥ 2 × entrées): la
+ * graine sans collision est cherchée par le compilateur, une recherche coûte
+ * un hachage et une comparaison. Le firmware utilise la même fonction de
+ * hachage (stm32_firmware/protocol_commands.h, généré).
+ *
+ * C++ standard uniquement, sans Qt.
+ */
+namespace Protocol {
+
+enum Mode : std::uint8_t {
+    ModeJson = 0x01,
+    ModeText = 0x02
+};
+
+enum class Command : std::uint8_t {
+#define PROTOCOL_COMMAND(id, name, modes) id,
+#include "ProtocolCommands.def"
+    Unknown
+};
+
+const std::size_t CommandCount = std::size_t(Command::Unknown);
+
+// Octets comparés tels quels: un caractère hors Latin-1 ne correspond à rien
+template<typename Char>
+constexpr std::uint32_t hashName(const Char *name, std::size_t length, std::uint32_t seed)
+{
+    std::uint32_t hash = 2166136261u ^ seed;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= std::uint8_t(name[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template<typename Value>
+struct PerfectHashEntry
+{
+    const char *name;
+    std::size_t length;
+    Value value;
+};
+
+template<typename Value, std::size_t Count>
+class PerfectHashTable
+{
+public:
+    static constexpr std::size_t Size = []() {
+        std::size_t size = 8;
+        while (size < 2 * Count) {
+            size *= 2;
+        }
+        return size;
+    }();
+
+    static const std::uint32_t MaxSeed = 1u << 16;
+
+    constexpr explicit PerfectHashTable(const PerfectHashEntry<Value> (&entries)[Count])
+        : m_seed(MaxSeed)
+        , m_slots{}
+    {
+        for (std::uint32_t seed = 0; seed < MaxSeed; ++seed) {
+            if (build(entries, seed)) {
+                m_seed = seed;
+                return;
+            }
+        }
+    }
+
+    constexpr bool isValid() const { return m_seed < MaxSeed; }
+    constexpr std::uint32_t seed() const { return m_seed; }
+
+    template<typename Char>
+    Value find(const Char *name, std::size_t length, Value notFound) const
+    {
+        const Slot &slot = m_slots[hashName(name, length, m_seed) & (Size - 1)];
+        if (!slot.used || slot.entry.length != length) {
+            return notFound;
+        }
+        for (std::size_t i = 0; i < length; ++i) {
+            if (name[i] != Char(std::uint8_t(slot.entry.name[i]))) {
+                return notFound;
+            }
+        }
+        return slot.entry.value;
+    }
+
+private:
+    struct Slot {
+        bool used;
+        PerfectHashEntry<Value> entry;
+    };
+
+    constexpr bool build(const PerfectHashEntry<Value> (&entries)[Count], std::uint32_t seed)
+    {
+        for (Slot &slot : m_slots) {
+            slot = Slot{};
+        }
+        for (const PerfectHashEntry<Value> &entry : entries) {
+            Slot &slot = m_slots[hashName(entry.name, entry.length, seed) & (Size - 1)];
+            if (slot.used) {
+                return false;
+            }
+            slot.used = true;
+            slot.entry = entry;
+        }
+        return true;
+    }
+
+    std::uint32_t m_seed;
+    std::array<Slot, Size> m_slots;
+};
+
+template<typename Value, std::size_t Count>
+constexpr PerfectHashTable<Value, Count> makePerfectHashTable(const PerfectHashEntry<Value> (&entries)[Count])
+{
+    return PerfectHashTable<Value, Count>(entries);
+}
+
+// ============================================================================
+// COMMANDES
+// ============================================================================
+
+constexpr PerfectHashEntry<Command> CommandEntries[] = {
+#define PROTOCOL_COMMAND(id, name, modes) { name, sizeof(name) - 1, Command::id },
+#include "ProtocolCommands.def"
+};
+
+constexpr const char *CommandNames[] = {
+#define PROTOCOL_COMMAND(id, name, modes) name,
+#include "ProtocolCommands.def"
+};
+
+constexpr std::uint8_t CommandModes[] = {
+#define PROTOCOL_COMMAND(id, name, modes) std::uint8_t(modes),
+#include "ProtocolCommands.def"
+};
+
+constexpr auto CommandTable = makePerfectHashTable(CommandEntries);
+static_assert(CommandTable.isValid(), "ProtocolCommands.def: aucune graine sans collision");
+
+inline const char *commandName(Command command)
+{
+    return command < Command::Unknown ? CommandNames[std::size_t(command)] : "";
+}
+
+inline bool commandSupports(Command command, Mode mode)
+{
+    return command < Command::Unknown && (CommandModes[std::size_t(command)] & mode) != 0;
+}
+
+template<typename Char>
+Command commandFromName(const Char *name, std::size_t length)
+{
+    return CommandTable.find(name, length, Command::Unknown);
+}
+
+} // namespace Protocol
+
+#endif // PROTOCOLTABLES_H
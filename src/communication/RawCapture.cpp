@@ -0,0 +1,151 @@
+#include "RawCapture.h"
+#include "MonotonicClock.h"
+#include <QDateTime>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+
+const char CaptureMagic[4] = { 'S', 'T', 'R', 'C' };
+const quint16 CaptureVersion = 1;
+const int FileHeaderSize = 16;
+const int RecordHeaderSize = 13;             // u8 + i64 + u32
+const quint32 MaxRecordSize = 16 * 1024 * 1024;  // Protection contre un fichier corrompu
+
+} // namespace
+
+// ============================================================================
+// ÉCRITURE
+// ============================================================================
+
+RawCaptureWriter::RawCaptureWriter()
+    : m_originNs(0)
+    , m_records(0)
+    , m_bytes(0)
+{
+}
+
+RawCaptureWriter::~RawCaptureWriter()
+{
+    close();
+}
+
+bool RawCaptureWriter::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "[RawCapture] Cannot open" << fileName << ":" << m_file.errorString();
+        return false;
+    }
+
+    uchar header[FileHeaderSize];
+    memcpy(header, CaptureMagic, sizeof(CaptureMagic));
+    qToLittleEndian<quint16>(CaptureVersion, header + 4);
+    qToLittleEndian<quint16>(0, header + 6);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), header + 8);
+
+    if (m_file.write(reinterpret_cast<const char *>(header), sizeof(header)) != sizeof(header)) {
+        m_file.close();
+        return false;
+    }
+
+    m_records = 0;
+    m_bytes = 0;
+    m_originNs = MonotonicClock::nowNs();
+
+    qDebug() << "[RawCapture] Recording to" << fileName;
+    return true;
+}
+
+void RawCaptureWriter::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close();
+        qDebug() << "[RawCapture] Recording closed:" << m_records << "records," << m_bytes << "bytes";
+    }
+}
+
+bool RawCaptureWriter::write(RawCaptureRecord::Direction direction, const QByteArray &data,
+                             qint64 timestampNs)
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    uchar header[RecordHeaderSize];
+    header[0] = direction;
+    // Bloc lu juste avant l'ouverture: ramené au début de la capture
+    qToLittleEndian<qint64>(qMax<qint64>(0, timestampNs - m_originNs), header + 1);
+    qToLittleEndian<quint32>(static_cast<quint32>(data.size()), header + 9);
+
+    // QFile met en tampon: pas d'appel système par bloc
+    if (m_file.write(reinterpret_cast<const char *>(header), sizeof(header)) != sizeof(header)
+            || m_file.write(data) != data.size()) {
+        return false;
+    }
+
+    m_records++;
+    m_bytes += data.size();
+    return true;
+}
+
+// ============================================================================
+// LECTURE
+// ============================================================================
+
+RawCaptureReader::RawCaptureReader()
+    : m_startEpochMs(0)
+{
+}
+
+bool RawCaptureReader::open(const QString &fileName)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    uchar header[FileHeaderSize];
+    if (m_file.read(reinterpret_cast<char *>(header), sizeof(header)) != sizeof(header)
+            || memcmp(header, CaptureMagic, sizeof(CaptureMagic)) != 0
+            || qFromLittleEndian<quint16>(header + 4) != CaptureVersion) {
+        m_error = "Format de capture invalide";
+        m_file.close();
+        return false;
+    }
+
+    m_startEpochMs = qFromLittleEndian<qint64>(header + 8);
+    return true;
+}
+
+void RawCaptureReader::close()
+{
+    m_file.close();
+}
+
+bool RawCaptureReader::next(RawCaptureRecord *record)
+{
+    uchar header[RecordHeaderSize];
+    if (m_file.read(reinterpret_cast<char *>(header), sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+
+    const quint32 length = qFromLittleEndian<quint32>(header + 9);
+    if (header[0] > RawCaptureRecord::Tx || length > MaxRecordSize) {
+        m_error = "Bloc de capture corrompu";
+        return false;
+    }
+
+    record->direction = static_cast<RawCaptureRecord::Direction>(header[0]);
+    record->timestampNs = qFromLittleEndian<qint64>(header + 1);
+    record->data = m_file.read(length);
+
+    // Bloc tronqué (capture interrompue): fin de lecture
+    return record->data.size() == static_cast<int>(length);
+}
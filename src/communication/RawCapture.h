@@ -0,0 +1,88 @@
+#ifndef RAWCAPTURE_H
+#define RAWCAPTURE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+/**
+ * @brief Enregistrement d'un bloc brut du flux série
+ */
+struct RawCaptureRecord
+{
+    enum Direction : quint8 {
+        Rx = 0,   // STM32 → PC
+        Tx = 1    // PC → STM32
+    };
+
+    Direction direction;
+    qint64 timestampNs;   // Horloge monotone, relative au début de la capture
+    QByteArray data;
+
+    RawCaptureRecord() : direction(Rx), timestampNs(0) {}
+};
+
+/**
+ * @brief Écriture d'un fichier de capture brute (.strc)
+ *
+ * Chaque bloc RX/TX reçu ou envoyé par SerialWorker est enregistré tel quel,
+ * avant découpage en lignes, avec l'horodatage pris par SerialWorker
+ * (MonotonicClock, celui que reçoit le pipeline), stocké relativement à
+ * l'ouverture de la capture.
+ *
+ * Format (little-endian):
+ * @code
+ * "STRC" | u16 version | u16 réservé | i64 début (epoch ms)
+ * puis par bloc: u8 direction | i64 horodatage ns | u32 longueur | octets
+ * @endcode
+ */
+class RawCaptureWriter
+{
+public:
+    RawCaptureWriter();
+    ~RawCaptureWriter();
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // timestampNs: base MonotonicClock
+    bool write(RawCaptureRecord::Direction direction, const QByteArray &data, qint64 timestampNs);
+
+    QString fileName() const { return m_file.fileName(); }
+    QString errorString() const { return m_file.errorString(); }
+    qint64 recordCount() const { return m_records; }
+    qint64 byteCount() const { return m_bytes; }
+
+private:
+    QFile m_file;
+    qint64 m_originNs;    // MonotonicClock à l'ouverture
+    qint64 m_records;
+    qint64 m_bytes;
+};
+
+/**
+ * @brief Lecture séquentielle d'un fichier de capture brute
+ */
+class RawCaptureReader
+{
+public:
+    RawCaptureReader();
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    // Bloc suivant; false en fin de fichier ou sur bloc tronqué
+    bool next(RawCaptureRecord *record);
+
+    qint64 startEpochMs() const { return m_startEpochMs; }
+    QString errorString() const { return m_error; }
+
+private:
+    QFile m_file;
+    qint64 m_startEpochMs;
+    QString m_error;
+};
+
+#endif // RAWCAPTURE_H
@@ -48,6 +48,21 @@ void SerialManager::setupWorkerThread()
     connect(this, &SerialManager::requestSendDataPriority,
             m_worker, &SerialWorker::sendDataPriority, Qt::QueuedConnection);
     
+    connect(this, &SerialManager::requestStartRecording,
+            m_worker, &SerialWorker::startRecording, Qt::QueuedConnection);
+    
+    connect(this, &SerialManager::requestStopRecording,
+            m_worker, &SerialWorker::stopRecording, Qt::QueuedConnection);
+    
+    connect(this, &SerialManager::requestStartReplay,
+            m_worker, &SerialWorker::startReplay, Qt::QueuedConnection);
+    
+    connect(this, &SerialManager::requestStopReplay,
+            m_worker, &SerialWorker::stopReplay, Qt::QueuedConnection);
+    
+    connect(this, &SerialManager::requestAcknowledgeReplayBatch,
+            m_worker, &SerialWorker::acknowledgeReplayBatch, Qt::QueuedConnection);
+    
     // === CONNEXIONS POUR LES ÉVÉNEMENTS DU WORKER ===
     connect(m_worker, &SerialWorker::portOpened,
             this, &SerialManager::handlePortOpened);
@@ -73,11 +88,28 @@ void SerialManager::setupWorkerThread()
     connect(m_worker, &SerialWorker::bytesReceived,
             this, &SerialManager::bytesReceived);
     
+    connect(m_worker, &SerialWorker::recordingStateChanged,
+            this, &SerialManager::recordingStateChanged);
+    
+    connect(m_worker, &SerialWorker::replayFinished,
+            this, &SerialManager::replayFinished);
+    
+    connect(m_worker, &SerialWorker::replayBatchQueued,
+            this, &SerialManager::handleReplayBatchQueued);
+    
     // Démarre le thread
     m_workerThread->start();
     qDebug() << "[SerialManager] Worker thread started";
 }
 
+void SerialManager::attachToWorkerThread(QObject *object)
+{
+    // L'objet doit être sans parent; il est détruit avec le thread
+    object->moveToThread(m_workerThread);
+    connect(m_workerThread, &QThread::finished,
+            object, &QObject::deleteLater);
+}
+
 void SerialManager::cleanupWorkerThread()
 {
     if (m_workerThread) {
@@ -149,6 +181,36 @@ bool SerialManager::sendCommandPriority(const QByteArray &command)
     return true;
 }
 
+void SerialManager::startRecording(const QString &fileName)
+{
+    qDebug() << "[SerialManager] Requesting raw recording to" << fileName;
+    emit requestStartRecording(fileName);
+}
+
+void SerialManager::stopRecording()
+{
+    emit requestStopRecording();
+}
+
+bool SerialManager::startReplay(const QString &fileName, double speed)
+{
+    if (m_connected) {
+        emit errorOccurred("Close the serial port before replaying a capture");
+        return false;
+    }
+    
+    qDebug() << "[SerialManager] Requesting replay of" << fileName << "speed" << speed;
+    emit requestStartReplay(fileName, speed);
+    
+    // La confirmation viendra via connectionStatusChanged
+    return true;
+}
+
+void SerialManager::stopReplay()
+{
+    emit requestStopReplay();
+}
+
 QString SerialManager::getPortInfo() const
 {
     if (!m_connected) {
@@ -226,3 +288,10 @@ void SerialManager::handleWorkerError(const QString &error)
     emit errorOccurred(error);
     qDebug() << "[SerialManager] Worker error:" << error;
 }
+
+void SerialManager::handleReplayBatchQueued()
+{
+    // Exécuté après les dataReceived du lot (même file d'événements):
+    // le worker n'envoie le lot suivant qu'une fois celui-ci consommé
+    emit requestAcknowledgeReplayBatch();
+}
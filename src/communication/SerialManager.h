@@ -33,6 +33,12 @@ public:
     bool sendCommand(const QByteArray &command);
     bool sendCommandPriority(const QByteArray &command);
     
+    // Enregistrement et rejeu du flux brut
+    void startRecording(const QString &fileName);
+    void stopRecording();
+    bool startReplay(const QString &fileName, double speed = 1.0);
+    void stopReplay();
+    
     // Informations
     QString getPortName() const { return m_portName; }
     qint32 getBaudRate() const { return m_baudRate; }
@@ -41,10 +47,14 @@ public:
     // Utilitaires statiques
     static QStringList availablePorts();
     static QString getPortDescription(const QString &portName);
+    
+    // Objets devant vivre dans le thread du worker (accès direct au port)
+    SerialWorker* worker() const { return m_worker; }
+    void attachToWorkerThread(QObject *object);
 
 signals:
     // Signaux de communication
-    void dataReceived(const QByteArray &data);
+    void dataReceived(const QByteArray &data, qint64 rxTimestampNs);
     void dataSent(const QByteArray &data);
     void connectionStatusChanged(bool connected);
     void errorOccurred(const QString &error);
@@ -53,17 +63,27 @@ signals:
     void bytesWritten(qint64 bytes);
     void bytesReceived(qint64 bytes);
     
+    // Enregistrement / rejeu
+    void recordingStateChanged(bool active, const QString &fileName);
+    void replayFinished(qint64 records, qint64 bytes, qint64 elapsedNs);
+    
     // Signaux internes pour le worker (via queued connections)
     void requestOpenPort(const QString &portName, qint32 baudRate);
     void requestClosePort();
     void requestSendData(const QByteArray &data);
     void requestSendDataPriority(const QByteArray &data);
+    void requestStartRecording(const QString &fileName);
+    void requestStopRecording();
+    void requestStartReplay(const QString &fileName, double speed);
+    void requestStopReplay();
+    void requestAcknowledgeReplayBatch();
 
 private slots:
     void handlePortOpened(const QString &portName, qint32 baudRate);
     void handlePortClosed();
     void handleOpenError(const QString &error);
     void handleWorkerError(const QString &error);
+    void handleReplayBatchQueued();
 
 private:
     void setupWorkerThread();
@@ -1,6 +1,9 @@
 #include "SerialWorker.h"
+#include "MonotonicClock.h"
 #include <QDebug>
 #include <QThread>
+#include <QTimer>
+#include <climits>
 
 SerialWorker::SerialWorker(QObject *parent)
     : QObject(parent)
@@ -10,14 +13,31 @@ SerialWorker::SerialWorker(QObject *parent)
     , m_stopRequested(false)
     , m_totalBytesSent(0)
     , m_totalBytesReceived(0)
+    , m_replayReader(nullptr)
+    , m_replayHasRecord(false)
+    , m_replaySpeed(1.0)
+    , m_replayOriginNs(0)
+    , m_replayBaseNs(0)
+    , m_replayRecords(0)
+    , m_replayBytes(0)
+    , m_replayAwaitingAck(false)
 {
     m_receiveBuffer.reserve(BUFFER_SIZE);
+
+    // Enfant du worker: suit moveToThread()
+    m_replayTimer = new QTimer(this);
+    m_replayTimer->setSingleShot(true);
+    m_replayTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_replayTimer, &QTimer::timeout, this, &SerialWorker::replayStep);
+
     qDebug() << "[SerialWorker] Initialized in thread" << QThread::currentThreadId();
 }
 
 SerialWorker::~SerialWorker()
 {
     stop();
+    delete m_replayReader;
+    m_recorder.close();
     cleanupSerialPort();
     qDebug() << "[SerialWorker] Destroyed";
 }
@@ -107,6 +127,11 @@ void SerialWorker::openPort(const QString &portName, qint32 baudRate)
 
 void SerialWorker::closePort()
 {
+    if (m_replayReader) {
+        stopReplay();
+        return;
+    }
+
     QMutexLocker locker(&m_portMutex);
 
     qDebug() << "[SerialWorker] Closing port";
@@ -169,6 +194,12 @@ void SerialWorker::processSendQueue()
 
 bool SerialWorker::sendDataInternal(const QByteArray &data)
 {
+    // En rejeu, les commandes de l'application ne partent nulle part
+    if (m_replayReader) {
+        emit dataSent(data);
+        return true;
+    }
+
     QMutexLocker locker(&m_portMutex);
 
     if (!m_serialPort || !m_serialPort->isOpen()) {
@@ -176,6 +207,7 @@ bool SerialWorker::sendDataInternal(const QByteArray &data)
         return false;
     }
 
+    const qint64 txTimestampNs = MonotonicClock::nowNs();
     qint64 written = m_serialPort->write(data);
 
     if (written == -1) {
@@ -191,6 +223,7 @@ bool SerialWorker::sendDataInternal(const QByteArray &data)
     }
 
     m_totalBytesSent += written;
+    m_recorder.write(RawCaptureRecord::Tx, data.left(static_cast<int>(written)), txTimestampNs);
 
     emit dataSent(data);
     emit bytesWritten(written);
@@ -208,17 +241,24 @@ void SerialWorker::handleReadyRead()
         return;
     }
 
-    // Lit toutes les données disponibles
+    // Lit toutes les données disponibles, horodatées à la réception
+    const qint64 rxTimestampNs = MonotonicClock::nowNs();
     QByteArray data = m_serialPort->readAll();
 
     if (data.isEmpty()) {
         return;
     }
 
-    m_totalBytesReceived += data.size();
-
     qDebug() << "[SerialWorker] RX:" << data.size() << "bytes -" << data.toHex(' ').left(60);
 
+    m_recorder.write(RawCaptureRecord::Rx, data, rxTimestampNs);
+    processIncoming(data, rxTimestampNs);
+}
+
+void SerialWorker::processIncoming(const QByteArray &data, qint64 rxTimestampNs)
+{
+    m_totalBytesReceived += data.size();
+
     emit bytesReceived(data.size());
 
     // Ajoute au buffer de réception
@@ -237,7 +277,7 @@ void SerialWorker::handleReadyRead()
 
         // Émet uniquement les lignes non vides
         if (!line.isEmpty()) {
-            emit dataReceived(line);
+            emit dataReceived(line, rxTimestampNs);
         }
     }
 
@@ -249,6 +289,150 @@ void SerialWorker::handleReadyRead()
     }
 }
 
+// ============================================================================
+// ENREGISTREMENT DU FLUX BRUT
+// ============================================================================
+
+void SerialWorker::startRecording(const QString &fileName)
+{
+    if (!m_recorder.open(fileName)) {
+        emit errorOccurred("Capture error: " + m_recorder.errorString());
+        return;
+    }
+
+    emit recordingStateChanged(true, fileName);
+}
+
+void SerialWorker::stopRecording()
+{
+    if (!m_recorder.isOpen()) {
+        return;
+    }
+
+    const QString fileName = m_recorder.fileName();
+    m_recorder.close();
+    emit recordingStateChanged(false, fileName);
+}
+
+// ============================================================================
+// REJEU D'UNE CAPTURE
+// ============================================================================
+
+void SerialWorker::startReplay(const QString &fileName, double speed)
+{
+    if ((m_serialPort && m_serialPort->isOpen()) || m_replayReader) {
+        emit openError("Close the serial port before replaying a capture");
+        return;
+    }
+
+    m_replayReader = new RawCaptureReader;
+    if (!m_replayReader->open(fileName)) {
+        emit openError("Failed to open capture " + fileName + ": " + m_replayReader->errorString());
+        delete m_replayReader;
+        m_replayReader = nullptr;
+        return;
+    }
+
+    m_receiveBuffer.clear();
+    m_totalBytesReceived = 0;
+    m_replaySpeed = qMax(0.0, speed);
+    m_replayHasRecord = false;
+    m_replayRecords = 0;
+    m_replayBytes = 0;
+    m_replayAwaitingAck = false;
+    m_replayClock.start();
+
+    qDebug() << "[SerialWorker] Replaying" << fileName << "at"
+             << (m_replaySpeed > 0 ? QString("%1x").arg(m_replaySpeed) : QString("max speed"));
+
+    // Le rejeu se présente comme un port ouvert au reste de l'application
+    emit portOpened("replay:" + fileName, 0);
+    m_replayTimer->start(0);
+}
+
+void SerialWorker::stopReplay()
+{
+    if (m_replayReader) {
+        finishReplay();
+    }
+}
+
+void SerialWorker::replayStep()
+{
+    if (!m_replayReader) {
+        return;
+    }
+
+    // En mode rapide, rend la main à la boucle d'événements par lots
+    int budget = m_replaySpeed > 0 ? INT_MAX : REPLAY_BATCH;
+
+    while (budget-- > 0) {
+        if (!m_replayHasRecord) {
+            if (!m_replayReader->next(&m_replayRecord)) {
+                finishReplay();
+                return;
+            }
+            if (m_replayRecords == 0) {
+                m_replayOriginNs = m_replayRecord.timestampNs;
+                m_replayBaseNs = MonotonicClock::nowNs();
+            }
+            m_replayHasRecord = true;
+        }
+
+        // Échéance du bloc selon l'horodatage enregistré et la vitesse
+        if (m_replaySpeed > 0) {
+            const qint64 dueNs = static_cast<qint64>((m_replayRecord.timestampNs - m_replayOriginNs) / m_replaySpeed);
+            const qint64 waitNs = dueNs - m_replayClock.nsecsElapsed();
+            if (waitNs > 0) {
+                m_replayTimer->start(static_cast<int>(waitNs / 1000000));
+                return;
+            }
+        }
+
+        // Seuls les blocs reçus sont réinjectés; les TX enregistrés sont ignorés
+        if (m_replayRecord.direction == RawCaptureRecord::Rx) {
+            // Espacement d'origine conservé quelle que soit la vitesse de rejeu
+            processIncoming(m_replayRecord.data,
+                            m_replayBaseNs + m_replayRecord.timestampNs - m_replayOriginNs);
+            m_replayBytes += m_replayRecord.data.size();
+        }
+
+        m_replayRecords++;
+        m_replayHasRecord = false;
+    }
+
+    // Au plus vite, le lot suivant attend que le thread principal ait traité
+    // celui-ci: sa file d'événements reste bornée à un lot
+    m_replayAwaitingAck = true;
+    emit replayBatchQueued();
+}
+
+void SerialWorker::acknowledgeReplayBatch()
+{
+    // Accusé d'un rejeu terminé ou remplacé: ignoré
+    if (!m_replayReader || !m_replayAwaitingAck) {
+        return;
+    }
+    m_replayAwaitingAck = false;
+    replayStep();
+}
+
+void SerialWorker::finishReplay()
+{
+    m_replayTimer->stop();
+
+    const qint64 elapsedNs = m_replayClock.nsecsElapsed();
+    delete m_replayReader;
+    m_replayReader = nullptr;
+    m_receiveBuffer.clear();
+
+    qDebug() << "[SerialWorker] Replay finished:" << m_replayRecords << "records,"
+             << m_replayBytes << "bytes in" << elapsedNs / 1000000 << "ms";
+
+    emit replayFinished(m_replayRecords, m_replayBytes, elapsedNs);
+    emit portClosed();
+}
+
 void SerialWorker::handleError(QSerialPort::SerialPortError error)
 {
     // Ignore les erreurs normales
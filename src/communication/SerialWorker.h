@@ -7,6 +7,10 @@
 #include <QQueue>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QElapsedTimer>
+#include "RawCapture.h"
+
+class QTimer;
 
 /**
  * @brief Worker thread pour communication série asynchrone
@@ -16,6 +20,13 @@
  * 
  * Utilise une queue de commandes pour gérer les envois multiples et
  * assure la synchronisation thread-safe.
+ *
+ * Peut enregistrer les blocs RX/TX bruts (RawCaptureWriter) et rejouer une
+ * capture à la place du port série: les blocs RX repassent par le même
+ * découpage en lignes, donc par tout le pipeline (contrôleur, modèle, vue).
+ *
+ * Chaque bloc est horodaté une seule fois, à la réception, par
+ * MonotonicClock (ns); chaque ligne porte l'horodatage du bloc qui la termine.
  */
 class SerialWorker : public QObject
 {
@@ -26,6 +37,7 @@ public:
     ~SerialWorker();
     
     bool isRunning() const { return m_running; }
+    bool isReplaying() const { return m_replayReader != nullptr; }
     QString portName() const { return m_portName; }
     qint32 baudRate() const { return m_baudRate; }
 
@@ -41,27 +53,47 @@ public slots:
     // Contrôle du worker
     void start();
     void stop();
+    
+    // Enregistrement du flux brut
+    void startRecording(const QString &fileName);
+    void stopRecording();
+    
+    // Rejeu d'une capture (speed = facteur temps réel, 0 = au plus vite)
+    void startReplay(const QString &fileName, double speed);
+    void stopReplay();
+    
+    // Au plus vite: lot précédent consommé par le thread principal, lot suivant
+    void acknowledgeReplayBatch();
 
 signals:
     // Signaux émis vers le thread principal
     void portOpened(const QString &portName, qint32 baudRate);
     void portClosed();
     void openError(const QString &error);
-    void dataReceived(const QByteArray &data);
+    void dataReceived(const QByteArray &data, qint64 rxTimestampNs);
     void dataSent(const QByteArray &data);
     void errorOccurred(const QString &error);
     void bytesWritten(qint64 bytes);
     void bytesReceived(qint64 bytes);
+    void recordingStateChanged(bool active, const QString &fileName);
+    void replayFinished(qint64 records, qint64 bytes, qint64 elapsedNs);
+    
+    // Au plus vite: un lot a été émis; l'accusé (acknowledgeReplayBatch) doit
+    // repasser par la boucle du thread principal, derrière ses dataReceived
+    void replayBatchQueued();
 
 private slots:
     void handleReadyRead();
     void handleError(QSerialPort::SerialPortError error);
     void processSendQueue();
+    void replayStep();
 
 private:
     void setupSerialPort();
     void cleanupSerialPort();
     bool sendDataInternal(const QByteArray &data);
+    void processIncoming(const QByteArray &data, qint64 rxTimestampNs);
+    void finishReplay();
     
     QSerialPort *m_serialPort;
     QString m_portName;
@@ -82,6 +114,22 @@ private:
     
     quint64 m_totalBytesSent;
     quint64 m_totalBytesReceived;
+    
+    // Enregistrement / rejeu
+    RawCaptureWriter m_recorder;
+    RawCaptureReader *m_replayReader;
+    QTimer *m_replayTimer;
+    QElapsedTimer m_replayClock;
+    RawCaptureRecord m_replayRecord;
+    bool m_replayHasRecord;
+    double m_replaySpeed;
+    qint64 m_replayOriginNs;
+    qint64 m_replayBaseNs;    // Horodatage (MonotonicClock) du premier bloc rejoué
+    qint64 m_replayRecords;
+    qint64 m_replayBytes;
+    bool m_replayAwaitingAck;  // Au plus vite: lot émis, accusé attendu
+    
+    static constexpr int REPLAY_BATCH = 256;  // Blocs par itération en mode rapide
 };
 
 #endif // SERIALWORKER_H
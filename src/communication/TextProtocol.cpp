@@ -0,0 +1,220 @@
+#include "TextProtocol.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// Vue sur la ligne en cours de lecture; aucune méthode ne dépasse end
+struct Cursor
+{
+    const char *pos;
+    const char *end;
+
+    void skipSpaces()
+    {
+        while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) {
+            ++pos;
+        }
+    }
+
+    bool onlySpacesLeft()
+    {
+        skipSpaces();
+        return pos == end;
+    }
+
+    template<std::size_t N>
+    bool consume(const char (&literal)[N])
+    {
+        const std::size_t length = N - 1;
+        if (std::size_t(end - pos) < length || std::memcmp(pos, literal, length) != 0) {
+            return false;
+        }
+        pos += length;
+        return true;
+    }
+
+    bool parseFloat(float *value)
+    {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        const std::from_chars_result result = std::from_chars(pos, end, *value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        pos = result.ptr;
+        return true;
+#else
+        // Bibliothèque sans from_chars flottant: décimal simple, indépendant
+        // de la locale (strtof suivrait LC_NUMERIC, réglée par Qt)
+        const char *p = pos;
+        const bool negative = (p < end && *p == '-');
+        if (negative) ++p;
+
+        double number = 0.0;
+        int digits = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            number = number * 10.0 + (*p++ - '0');
+            ++digits;
+        }
+        if (p < end && *p == '.') {
+            ++p;
+            double scale = 0.1;
+            while (p < end && *p >= '0' && *p <= '9') {
+                number += (*p++ - '0') * scale;
+                scale *= 0.1;
+                ++digits;
+            }
+        }
+        if (digits == 0) {
+            return false;
+        }
+        *value = float(negative ? -number : number);
+        pos = p;
+        return true;
+#endif
+    }
+
+    template<typename T>
+    bool parseUnsigned(T *value, quint32 max)
+    {
+        quint32 number = 0;
+        const std::from_chars_result result = std::from_chars(pos, end, number);
+        if (result.ec != std::errc() || number > max) {
+            return false;
+        }
+        *value = T(number);
+        pos = result.ptr;
+        return true;
+    }
+
+    bool parseOnOff(bool *state)
+    {
+        if (consume("ON")) {
+            *state = true;
+            return true;
+        }
+        if (consume("OFF")) {
+            *state = false;
+            return true;
+        }
+        return false;
+    }
+};
+
+TextProtocol::Message textMessage(TextProtocol::Message::Kind kind, Cursor cursor)
+{
+    cursor.skipSpaces();
+    const char *textEnd = cursor.end;
+    while (textEnd > cursor.pos && (textEnd[-1] == ' ' || textEnd[-1] == '\r')) {
+        --textEnd;
+    }
+
+    TextProtocol::Message message;
+    message.kind = kind;
+    message.text = cursor.pos;
+    message.textSize = int(textEnd - cursor.pos);
+    return message;
+}
+
+} // namespace
+
+TextProtocol::Message TextProtocol::parse(const char *data, int size)
+{
+    Message message;
+    if (!data || size <= 0) {
+        return message;
+    }
+
+    Cursor cursor = { data, data + size };
+    cursor.skipSpaces();
+
+    if (cursor.consume("TEMP:")) {
+        // "TEMP: 25.3°C" ('°' en UTF-8 ou en Latin-1)
+        cursor.skipSpaces();
+        if (!cursor.parseFloat(&message.value)) {
+            return Message();
+        }
+        cursor.skipSpaces();
+        if (!cursor.consume("\xC2\xB0")) {
+            cursor.consume("\xB0");
+        }
+        cursor.consume("C");
+        message.kind = Message::Temperature;
+    }
+    else if (cursor.consume("VOLTAGE:")) {
+        // "VOLTAGE: 1.65V (ADC: 2048)"
+        cursor.skipSpaces();
+        if (!cursor.parseFloat(&message.value)) {
+            return Message();
+        }
+        cursor.consume("V");
+        cursor.skipSpaces();
+        if (cursor.consume("(ADC:")) {
+            cursor.skipSpaces();
+            if (!cursor.parseUnsigned(&message.adcRaw, 0xFFFF)) {
+                return Message();
+            }
+            cursor.skipSpaces();
+            if (!cursor.consume(")")) {
+                return Message();
+            }
+            message.hasAdcRaw = true;
+        }
+        message.kind = Message::Voltage;
+    }
+    else if (cursor.consume("OK:")) {
+        // "OK: LED ON", "OK: PWM=50%", sinon acquittement générique
+        Cursor ack = cursor;
+        ack.skipSpaces();
+        message.acknowledgement = true;
+        if (ack.consume("LED")) {
+            ack.skipSpaces();
+            if (ack.parseOnOff(&message.ledState) && ack.onlySpacesLeft()) {
+                message.kind = Message::Led;
+                return message;
+            }
+        } else if (ack.consume("PWM=")) {
+            if (ack.parseUnsigned(&message.pwmDuty, 100)) {
+                ack.consume("%");
+                if (ack.onlySpacesLeft()) {
+                    message.kind = Message::Pwm;
+                    return message;
+                }
+            }
+        }
+        return textMessage(Message::Ok, cursor);
+    }
+    else if (cursor.consume("ERROR")) {
+        cursor.consume(":");
+        return textMessage(Message::Error, cursor);
+    }
+    else if (cursor.consume("LED:")) {
+        cursor.skipSpaces();
+        if (!cursor.parseOnOff(&message.ledState)) {
+            return Message();
+        }
+        message.kind = Message::Led;
+    }
+    else if (cursor.consume("PWM:")) {
+        cursor.skipSpaces();
+        if (!cursor.parseUnsigned(&message.pwmDuty, 100)) {
+            return Message();
+        }
+        cursor.consume("%");
+        message.kind = Message::Pwm;
+    }
+    else if (cursor.consume("UPTIME:")) {
+        cursor.skipSpaces();
+        if (!cursor.parseUnsigned(&message.uptime, 0xFFFFFFFFu)) {
+            return Message();
+        }
+        cursor.consume("s");
+        message.kind = Message::Uptime;
+    }
+    else {
+        return message;
+    }
+
+    // Rien d'autre que des espaces après la valeur
+    return cursor.onlySpacesLeft() ? message : Message();
+}
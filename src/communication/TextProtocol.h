@@ -0,0 +1,59 @@
+#ifndef TEXTPROTOCOL_H
+#define TEXTPROTOCOL_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/**
+ * @brief Décodage des réponses texte du mode de compatibilité
+ *
+ * Lignes reconnues (firmware en mode texte):
+ * - "TEMP: 25.3°C"
+ * - "VOLTAGE: 1.65V (ADC: 2048)"
+ * - "OK: LED ON", "OK: LED OFF", "OK: PWM=50%", "OK: ..."
+ * - lignes d'un bloc STATUS: "LED: ON", "PWM: 50%", "UPTIME: 1234"
+ * - "ERROR: ..."
+ *
+ * Le décodage travaille directement sur les octets de la ligne reçue
+ * (std::from_chars, aucune copie ni allocation) et ne lit jamais au-delà de
+ * la fin: une ligne tronquée ou malformée donne Unknown, jamais d'accès hors
+ * limites. Le texte des messages OK/ERROR est une vue sur la ligne d'origine.
+ */
+class TextProtocol
+{
+public:
+    struct Message {
+        enum Kind {
+            Unknown,
+            Temperature,   // value
+            Voltage,       // value, adcRaw si hasAdcRaw
+            Led,           // ledState (acquittement ou ligne STATUS)
+            Pwm,           // pwmDuty (acquittement ou ligne STATUS)
+            Uptime,        // uptime
+            Ok,            // Autre acquittement, texte dans text/textSize
+            Error          // Texte après "ERROR:" dans text/textSize
+        };
+
+        Kind kind;
+        float value;
+        quint16 adcRaw;
+        bool hasAdcRaw;
+        bool ledState;
+        quint8 pwmDuty;
+        bool acknowledgement;  // Led/Pwm: ligne "OK: ..." en réponse à SET_*
+        quint32 uptime;
+        const char *text;
+        int textSize;
+
+        Message()
+            : kind(Unknown), value(0.0f), adcRaw(0), hasAdcRaw(false), ledState(false)
+            , pwmDuty(0), acknowledgement(false), uptime(0), text(nullptr), textSize(0)
+        {
+        }
+    };
+
+    static Message parse(const char *data, int size);
+    static Message parse(const QByteArray &line) { return parse(line.constData(), line.size()); }
+};
+
+#endif // TEXTPROTOCOL_H
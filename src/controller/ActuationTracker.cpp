@@ -0,0 +1,237 @@
+#include "ActuationTracker.h"
+#include "MonotonicClock.h"
+#include <QTimer>
+#include <QDebug>
+
+namespace {
+
+const double NsPerMsF = 1e6;
+
+} // namespace
+
+ActuationTracker::Stats::Stats()
+    : sent(0)
+    , confirmed(0)
+    , mismatches(0)
+    , timeouts(0)
+    , lost(0)
+    , lastLatencyMs(0.0)
+    , meanLatencyMs(0.0)
+    , minLatencyMs(0.0)
+    , maxLatencyMs(0.0)
+{
+}
+
+ActuationTracker::ActuationTracker(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_timeoutMs(DefaultTimeoutMs)
+{
+    qRegisterMetaType<ActuationTracker::Actuator>("ActuationTracker::Actuator");
+
+    for (Entry &entry : m_entries) {
+        entry.deviceValue = 0;
+        entry.deviceValueValid = false;
+        entry.latencySumMs = 0.0;
+    }
+
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &ActuationTracker::onTimer);
+}
+
+QString ActuationTracker::actuatorToString(Actuator actuator)
+{
+    switch (actuator) {
+        case Led: return "led";
+        case Pwm: return "pwm";
+        default:  return QString();
+    }
+}
+
+void ActuationTracker::setTimeoutMs(int timeoutMs)
+{
+    m_timeoutMs = qMax(1, timeoutMs);
+    arm();
+}
+
+// ============================================================================
+// COMMANDES ET CONFIRMATIONS
+// ============================================================================
+
+void ActuationTracker::commandSent(Actuator actuator, int requested, int previous, qint64 sentNs)
+{
+    if (actuator < 0 || actuator >= ActuatorCount) {
+        return;
+    }
+
+    Entry &entry = m_entries[actuator];
+
+    // Rien en vol: le modèle reflète le dispositif
+    if (entry.inFlight.empty()) {
+        entry.deviceValue = previous;
+        entry.deviceValueValid = true;
+    }
+
+    entry.inFlight.push_back(Command{ requested, sentNs });
+    entry.stats.sent++;
+    arm();
+}
+
+bool ActuationTracker::report(Actuator actuator, int value, Source source, qint64 rxTimestampNs)
+{
+    if (actuator < 0 || actuator >= ActuatorCount) {
+        return true;
+    }
+
+    Entry &entry = m_entries[actuator];
+    entry.deviceValue = value;
+    entry.deviceValueValid = true;
+
+    if (entry.inFlight.empty()) {
+        return true;  // Commande manuelle ou confirmation déjà reçue
+    }
+
+    if (source == Acknowledgement) {
+        const Command command = entry.inFlight.front();
+        entry.inFlight.pop_front();
+
+        if (value != command.requested) {
+            entry.stats.mismatches++;
+            rollBack(actuator, entry, command.requested, "mismatch");
+            return false;  // Modèle déjà remis à la valeur réelle
+        }
+
+        confirm(actuator, entry, command, rxTimestampNs);
+        arm();
+        return entry.inFlight.empty();
+    }
+
+    // État rapporté: ne confirme que la dernière valeur demandée, sinon il
+    // peut dater d'avant la commande (décision laissée à l'expiration)
+    if (value != entry.inFlight.back().requested) {
+        return false;
+    }
+
+    const Command command = entry.inFlight.back();
+    entry.inFlight.clear();
+    confirm(actuator, entry, command, rxTimestampNs);
+    arm();
+    return true;
+}
+
+void ActuationTracker::commandLost(Actuator actuator)
+{
+    if (actuator < 0 || actuator >= ActuatorCount || m_entries[actuator].inFlight.empty()) {
+        return;
+    }
+
+    // Valeur appliquée inconnue: même traitement qu'une expiration
+    Entry &entry = m_entries[actuator];
+    entry.stats.lost++;
+    rollBack(actuator, entry, entry.inFlight.back().requested, "lost");
+}
+
+void ActuationTracker::clear()
+{
+    for (Entry &entry : m_entries) {
+        entry.inFlight.clear();
+        entry.deviceValueValid = false;
+    }
+    m_timer->stop();
+}
+
+bool ActuationTracker::isPending(Actuator actuator) const
+{
+    return actuator >= 0 && actuator < ActuatorCount && !m_entries[actuator].inFlight.empty();
+}
+
+int ActuationTracker::pendingCount() const
+{
+    int count = 0;
+    for (const Entry &entry : m_entries) {
+        count += int(entry.inFlight.size());
+    }
+    return count;
+}
+
+ActuationTracker::Stats ActuationTracker::stats(Actuator actuator) const
+{
+    return (actuator >= 0 && actuator < ActuatorCount) ? m_entries[actuator].stats : Stats();
+}
+
+// ============================================================================
+// EXPIRATION
+// ============================================================================
+
+void ActuationTracker::onTimer()
+{
+    const qint64 now = MonotonicClock::nowNs();
+    const qint64 timeoutNs = qint64(m_timeoutMs) * MonotonicClock::NsPerMs;
+
+    for (int i = 0; i < ActuatorCount; ++i) {
+        Entry &entry = m_entries[i];
+        if (entry.inFlight.empty() || now - entry.inFlight.front().sentNs < timeoutNs) {
+            continue;
+        }
+
+        entry.stats.timeouts++;
+        rollBack(Actuator(i), entry, entry.inFlight.back().requested, "timeout");
+    }
+
+    arm();
+}
+
+// ============================================================================
+// OUTILS
+// ============================================================================
+
+void ActuationTracker::confirm(Actuator actuator, Entry &entry, const Command &command, qint64 rxTimestampNs)
+{
+    const qint64 latencyNs = qMax<qint64>(0, rxTimestampNs - command.sentNs);
+    const double latencyMs = latencyNs / NsPerMsF;
+
+    Stats &stats = entry.stats;
+    stats.confirmed++;
+    stats.lastLatencyMs = latencyMs;
+    stats.minLatencyMs = stats.confirmed == 1 ? latencyMs : qMin(stats.minLatencyMs, latencyMs);
+    stats.maxLatencyMs = qMax(stats.maxLatencyMs, latencyMs);
+    entry.latencySumMs += latencyMs;
+    stats.meanLatencyMs = entry.latencySumMs / double(stats.confirmed);
+
+    emit confirmed(actuator, command.requested, latencyNs);
+}
+
+void ActuationTracker::rollBack(Actuator actuator, Entry &entry, int requested, const QString &reason)
+{
+    entry.inFlight.clear();
+    arm();
+
+    // Sans valeur connue du dispositif, rien à restaurer
+    if (!entry.deviceValueValid) {
+        return;
+    }
+
+    qDebug() << "[ActuationTracker]" << actuatorToString(actuator) << "rolled back:"
+             << "requested" << requested << "actual" << entry.deviceValue << "(" << reason << ")";
+    emit rolledBack(actuator, requested, entry.deviceValue, reason);
+}
+
+void ActuationTracker::arm()
+{
+    qint64 oldestNs = 0;
+    for (const Entry &entry : m_entries) {
+        if (!entry.inFlight.empty() && (oldestNs == 0 || entry.inFlight.front().sentNs < oldestNs)) {
+            oldestNs = entry.inFlight.front().sentNs;
+        }
+    }
+
+    if (oldestNs == 0) {
+        m_timer->stop();
+        return;
+    }
+
+    const qint64 dueNs = oldestNs + qint64(m_timeoutMs) * MonotonicClock::NsPerMs;
+    const qint64 remainingNs = qMax<qint64>(0, dueNs - MonotonicClock::nowNs());
+    m_timer->start(int((remainingNs + MonotonicClock::NsPerMs - 1) / MonotonicClock::NsPerMs));
+}
@@ -0,0 +1,126 @@
+#ifndef ACTUATIONTRACKER_H
+#define ACTUATIONTRACKER_H
+
+#include <QObject>
+#include <QString>
+#include <QtGlobal>
+#include <deque>
+
+class QTimer;
+
+/**
+ * @brief Suivi des commandes d'actionneurs appliquées de façon optimiste
+ *
+ * SET_LED et SET_PWM mettent le modèle à jour dès l'envoi; la commande reste
+ * en attente jusqu'à sa confirmation par le dispositif. Plusieurs commandes
+ * d'un même actionneur peuvent être en vol (file FIFO, le firmware répond
+ * dans l'ordre).
+ *
+ * - Acquittement ({"led":1}, {"pwm":50}, "OK: LED ON"...): correspond à la
+ *   plus ancienne commande en vol. Valeur identique: confirmée. Valeur
+ *   différente: le dispositif a appliqué autre chose, toutes les commandes
+ *   en vol de l'actionneur sont annulées (rolledBack, raison "mismatch").
+ * - État rapporté (STATUS, heartbeat, flux): égal à la dernière valeur
+ *   demandée, il confirme toutes les commandes en vol (acquittement perdu).
+ *   Différent, il peut être antérieur à la commande et n'est donc pas
+ *   appliqué au modèle; il devient la valeur de repli.
+ * - Sans confirmation après timeoutMs(), la commande est annulée (raison
+ *   "timeout") et le modèle revient à la dernière valeur connue du
+ *   dispositif.
+ * - Acquittement perdu côté firmware (résultat absent d'un lot tronqué):
+ *   annulation immédiate (raison "lost") par commandLost(), sans attendre
+ *   l'expiration.
+ *
+ * Le récepteur de rolledBack remet le modèle à la valeur réelle. La latence
+ * commande → confirmation (horodatage d'envoi → horodatage de réception)
+ * est mesurée pour chaque commande confirmée.
+ */
+class ActuationTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Actuator {
+        Led,
+        Pwm,
+        ActuatorCount
+    };
+
+    enum Source {
+        Acknowledgement,   // Réponse directe à SET_LED / SET_PWM
+        StatusReport       // STATUS, heartbeat ou flux
+    };
+
+    struct Stats {
+        quint64 sent;
+        quint64 confirmed;
+        quint64 mismatches;
+        quint64 timeouts;
+        quint64 lost;
+        double lastLatencyMs;
+        double meanLatencyMs;
+        double minLatencyMs;
+        double maxLatencyMs;
+
+        Stats();
+    };
+
+    static const int DefaultTimeoutMs = 1000;
+
+    explicit ActuationTracker(QObject *parent = nullptr);
+
+    void setTimeoutMs(int timeoutMs);
+    int timeoutMs() const { return m_timeoutMs; }
+
+    // Commande envoyée: requested appliquée au modèle, previous = valeur avant
+    void commandSent(Actuator actuator, int requested, int previous, qint64 sentNs);
+
+    // Valeur rapportée par le dispositif. Retourne true si le modèle doit
+    // prendre cette valeur (false: commande plus récente encore en attente)
+    bool report(Actuator actuator, int value, Source source, qint64 rxTimestampNs);
+
+    // Acquittement de la plus ancienne commande en vol perdu par le firmware
+    void commandLost(Actuator actuator);
+
+    // Abandon sans événement (déconnexion)
+    void clear();
+
+    bool isPending(Actuator actuator) const;
+    int pendingCount() const;
+    Stats stats(Actuator actuator) const;
+
+    static QString actuatorToString(Actuator actuator);
+
+signals:
+    void confirmed(ActuationTracker::Actuator actuator, int value, qint64 latencyNs);
+    void rolledBack(ActuationTracker::Actuator actuator, int requested, int actual, const QString &reason);
+
+private slots:
+    void onTimer();
+
+private:
+    struct Command {
+        int requested;
+        qint64 sentNs;
+    };
+
+    struct Entry {
+        std::deque<Command> inFlight;
+        int deviceValue;        // Dernière valeur connue du dispositif
+        bool deviceValueValid;
+        Stats stats;
+        double latencySumMs;
+    };
+
+    void confirm(Actuator actuator, Entry &entry, const Command &command, qint64 rxTimestampNs);
+    void rollBack(Actuator actuator, Entry &entry, int requested, const QString &reason);
+    void arm();
+
+    Entry m_entries[ActuatorCount];
+    QTimer *m_timer;
+    int m_timeoutMs;
+};
+
+Q_DECLARE_METATYPE(ActuationTracker::Actuator)
+
+#endif // ACTUATIONTRACKER_H
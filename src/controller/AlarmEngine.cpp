@@ -0,0 +1,487 @@
+#include "AlarmEngine.h"
+#include "DataModel.h"
+#include "MonotonicClock.h"
+#include <QTimer>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+
+const qint64 NsPerSecond = 1000000000LL;
+const int MinTimeoutCheckMs = 10;
+const int MaxTimeoutCheckMs = 250;
+
+struct KindName {
+    AlarmRule::Kind kind;
+    const char *name;
+};
+
+const KindName KindNames[] = {
+    { AlarmRule::ThresholdAbove, "above" },
+    { AlarmRule::ThresholdBelow, "below" },
+    { AlarmRule::RateOfChange, "rate" },
+    { AlarmRule::StaleChannel, "stale" },
+    { AlarmRule::HeartbeatLoss, "heartbeat" }
+};
+
+} // namespace
+
+// ============================================================================
+// RÈGLES
+// ============================================================================
+
+AlarmRule::AlarmRule()
+    : kind(ThresholdAbove)
+    , severity(Warning)
+    , threshold(0.0)
+    , hysteresis(0.0)
+    , timeoutMs(0)
+{
+}
+
+QString AlarmRule::kindToString(Kind kind)
+{
+    for (const KindName &entry : KindNames) {
+        if (entry.kind == kind) {
+            return entry.name;
+        }
+    }
+    return QString();
+}
+
+QJsonObject AlarmRule::toJson() const
+{
+    QJsonObject json;
+    json["name"] = name;
+    json["kind"] = kindToString(kind);
+    json["severity"] = severity == Critical ? "critical" : "warning";
+
+    switch (kind) {
+        case StaleChannel:
+            json["channel"] = channel;
+            json["timeout_ms"] = timeoutMs;
+            break;
+        case HeartbeatLoss:
+            json["timeout_ms"] = timeoutMs;
+            break;
+        default:
+            json["channel"] = channel;
+            json["threshold"] = threshold;
+            json["hysteresis"] = hysteresis;
+            break;
+    }
+
+    return json;
+}
+
+AlarmRule AlarmRule::fromJson(const QJsonObject &json, bool *ok)
+{
+    AlarmRule rule;
+    bool valid = false;
+
+    const QString kind = json["kind"].toString();
+    for (const KindName &entry : KindNames) {
+        if (kind == QLatin1String(entry.name)) {
+            rule.kind = entry.kind;
+            valid = true;
+            break;
+        }
+    }
+
+    rule.name = json["name"].toString();
+    rule.channel = json["channel"].toString();
+    rule.severity = json["severity"].toString() == "critical" ? Critical : Warning;
+    rule.threshold = json["threshold"].toDouble();
+    rule.hysteresis = qMax(0.0, json["hysteresis"].toDouble());
+    rule.timeoutMs = static_cast<qint64>(json["timeout_ms"].toDouble());
+
+    if (rule.name.isEmpty()) {
+        rule.name = kind;
+    }
+    if (rule.kind != HeartbeatLoss && rule.channel.isEmpty()) {
+        valid = false;
+    }
+    if (rule.kind == StaleChannel && rule.timeoutMs <= 0) {
+        valid = false;
+    }
+
+    if (ok) *ok = valid;
+    return rule;
+}
+
+AlarmEvent::AlarmEvent()
+    : kind(AlarmRule::ThresholdAbove)
+    , severity(AlarmRule::Warning)
+    , channelId(-1)
+    , active(false)
+    , value(0.0)
+    , sampleTimestampNs(0)
+    , detectedNs(0)
+{
+}
+
+// ============================================================================
+// MOTEUR
+// ============================================================================
+
+AlarmEngine::AlarmEngine(DataModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_heartbeatIntervalMs(DefaultHeartbeatIntervalMs)
+    , m_lastHeartbeatNs(0)
+    , m_heartbeatSeen(false)
+    , m_running(false)
+{
+    qRegisterMetaType<AlarmEvent>("AlarmEvent");
+
+    m_timeoutTimer = new QTimer(this);
+    connect(m_timeoutTimer, &QTimer::timeout, this, &AlarmEngine::checkTimeouts);
+
+    // Évaluation synchrone, dans le thread qui alimente le modèle
+    connect(m_model, &DataModel::sampleAdded, this,
+            [this](quint16 channelId, const DataModel::DataPoint &point) {
+                processSample(channelId, point.value, point.timestampNs);
+            }, Qt::DirectConnection);
+
+    connect(m_model, &DataModel::channelRegistered, this, &AlarmEngine::recompile);
+
+    qDebug() << "[AlarmEngine] Initialized";
+}
+
+void AlarmEngine::setRules(const QList<AlarmRule> &rules)
+{
+    // Les abonnés voient retomber les alarmes des règles remplacées
+    const qint64 now = MonotonicClock::nowNs();
+    for (int i = 0; i < m_state.size(); ++i) {
+        if (m_state[i].active) {
+            setState(i, false, m_state[i].event.channelId, m_state[i].event.value, now);
+        }
+    }
+
+    m_rules = rules;
+    m_state = QVector<RuleState>(m_rules.size());
+    for (RuleState &state : m_state) {
+        state.active = false;
+    }
+
+    recompile();
+    qDebug() << "[AlarmEngine]" << m_rules.size() << "rule(s) installed";
+}
+
+int AlarmEngine::loadRules(const QJsonArray &rules)
+{
+    QList<AlarmRule> parsed;
+
+    for (const QJsonValue &value : rules) {
+        bool ok;
+        AlarmRule rule = AlarmRule::fromJson(value.toObject(), &ok);
+        if (ok) {
+            parsed.append(rule);
+        } else {
+            qDebug() << "[AlarmEngine] Invalid rule ignored:" << value.toObject();
+        }
+    }
+
+    setRules(parsed);
+    return parsed.size();
+}
+
+QJsonArray AlarmEngine::rulesToJson() const
+{
+    QJsonArray array;
+    for (const AlarmRule &rule : m_rules) {
+        array.append(rule.toJson());
+    }
+    return array;
+}
+
+void AlarmEngine::setHeartbeatInterval(qint64 intervalMs)
+{
+    if (intervalMs > 0 && intervalMs != m_heartbeatIntervalMs) {
+        m_heartbeatIntervalMs = intervalMs;
+        recompile();
+    }
+}
+
+void AlarmEngine::recompile()
+{
+    // Conserve l'historique des canaux déjà suivis
+    QHash<quint16, ChannelSlot> previous;
+    for (auto it = m_slotIndex.constBegin(); it != m_slotIndex.constEnd(); ++it) {
+        previous.insert(it.key(), m_slots[it.value()]);
+    }
+
+    m_checks.clear();
+    m_slots.clear();
+    m_slotIndex.clear();
+    m_timeouts.clear();
+
+    // Regroupe les tests par canal (ordre de première apparition)
+    QHash<quint16, QVector<Check>> perChannel;
+    QList<quint16> order;
+
+    for (int i = 0; i < m_rules.size(); ++i) {
+        const AlarmRule &rule = m_rules[i];
+
+        if (rule.kind == AlarmRule::HeartbeatLoss) {
+            Timeout timeout;
+            timeout.rule = i;
+            timeout.slot = -1;
+            timeout.timeoutNs = (rule.timeoutMs > 0 ? rule.timeoutMs
+                                                    : m_heartbeatIntervalMs * HeartbeatTimeoutFactor) * 1000000;
+            m_timeouts.append(timeout);
+            continue;
+        }
+
+        const int channelId = m_model->channelIdForName(rule.channel);
+        if (channelId < 0) {
+            continue;  // Canal pas encore annoncé
+        }
+
+        Check check;
+        check.kind = static_cast<quint8>(rule.kind);
+        check.rule = i;
+        switch (rule.kind) {
+            case AlarmRule::ThresholdAbove:
+                check.raiseLevel = rule.threshold;
+                check.clearLevel = rule.threshold - rule.hysteresis;
+                break;
+            case AlarmRule::ThresholdBelow:
+                check.raiseLevel = rule.threshold;
+                check.clearLevel = rule.threshold + rule.hysteresis;
+                break;
+            case AlarmRule::RateOfChange:
+                check.raiseLevel = rule.threshold / NsPerSecond;
+                check.clearLevel = (rule.threshold - rule.hysteresis) / NsPerSecond;
+                break;
+            default:
+                check.raiseLevel = 0.0;
+                check.clearLevel = 0.0;
+                break;
+        }
+
+        const quint16 id = static_cast<quint16>(channelId);
+        if (!perChannel.contains(id)) {
+            order.append(id);
+        }
+        perChannel[id].append(check);
+    }
+
+    for (quint16 id : qAsConst(order)) {
+        const QVector<Check> &checks = perChannel[id];
+
+        ChannelSlot slot;
+        if (previous.contains(id)) {
+            slot = previous.value(id);
+        } else {
+            slot.hasPrevious = false;
+            slot.previousValue = 0.0;
+            slot.previousNs = 0;
+            slot.lastSampleNs = m_running ? MonotonicClock::nowNs() : 0;
+        }
+        slot.firstCheck = m_checks.size();
+        slot.checkCount = checks.size();
+
+        const int slotIndex = m_slots.size();
+        m_slotIndex.insert(id, slotIndex);
+        m_slots.append(slot);
+
+        for (const Check &check : checks) {
+            m_checks.append(check);
+
+            if (check.kind == AlarmRule::StaleChannel) {
+                Timeout timeout;
+                timeout.rule = check.rule;
+                timeout.slot = slotIndex;
+                timeout.timeoutNs = m_rules[check.rule].timeoutMs * 1000000;
+                m_timeouts.append(timeout);
+            }
+        }
+    }
+
+    // Période de vérification des délais: un dixième du plus court
+    qint64 shortestNs = 0;
+    for (const Timeout &timeout : qAsConst(m_timeouts)) {
+        if (shortestNs == 0 || timeout.timeoutNs < shortestNs) {
+            shortestNs = timeout.timeoutNs;
+        }
+    }
+    m_timeoutTimer->setInterval(qBound(MinTimeoutCheckMs,
+                                       static_cast<int>(shortestNs / 10 / 1000000),
+                                       MaxTimeoutCheckMs));
+
+    if (m_running && !m_timeouts.isEmpty() && !m_timeoutTimer->isActive()) {
+        m_timeoutTimer->start();
+    } else if (m_timeouts.isEmpty()) {
+        m_timeoutTimer->stop();
+    }
+}
+
+// ============================================================================
+// SURVEILLANCE
+// ============================================================================
+
+void AlarmEngine::start(qint64 nowNs)
+{
+    m_running = true;
+    m_lastHeartbeatNs = nowNs;
+    m_heartbeatSeen = false;
+    for (ChannelSlot &slot : m_slots) {
+        slot.lastSampleNs = nowNs;
+        slot.hasPrevious = false;
+    }
+
+    if (!m_timeouts.isEmpty()) {
+        m_timeoutTimer->start();
+    }
+}
+
+void AlarmEngine::stop()
+{
+    m_running = false;
+    m_timeoutTimer->stop();
+
+    // Retombée de toutes les alarmes levées
+    const qint64 now = MonotonicClock::nowNs();
+    for (int i = 0; i < m_state.size(); ++i) {
+        if (m_state[i].active) {
+            setState(i, false, m_state[i].event.channelId, m_state[i].event.value, now);
+        }
+    }
+}
+
+QList<AlarmEvent> AlarmEngine::activeAlarms() const
+{
+    QList<AlarmEvent> active;
+    for (const RuleState &state : m_state) {
+        if (state.active) {
+            active.append(state.event);
+        }
+    }
+    return active;
+}
+
+void AlarmEngine::processSample(quint16 channelId, double value, qint64 timestampNs)
+{
+    const auto found = m_slotIndex.constFind(channelId);
+    if (found == m_slotIndex.constEnd()) {
+        return;
+    }
+
+    ChannelSlot &slot = m_slots[found.value()];
+    const Check *check = m_checks.constData() + slot.firstCheck;
+    const Check *end = check + slot.checkCount;
+
+    for (; check != end; ++check) {
+        const bool active = m_state[check->rule].active;
+
+        switch (check->kind) {
+            case AlarmRule::ThresholdAbove:
+                if (!active && value > check->raiseLevel) {
+                    setState(check->rule, true, channelId, value, timestampNs);
+                } else if (active && value < check->clearLevel) {
+                    setState(check->rule, false, channelId, value, timestampNs);
+                }
+                break;
+
+            case AlarmRule::ThresholdBelow:
+                if (!active && value < check->raiseLevel) {
+                    setState(check->rule, true, channelId, value, timestampNs);
+                } else if (active && value > check->clearLevel) {
+                    setState(check->rule, false, channelId, value, timestampNs);
+                }
+                break;
+
+            case AlarmRule::RateOfChange:
+                if (slot.hasPrevious && timestampNs > slot.previousNs) {
+                    const double rate = std::fabs(value - slot.previousValue)
+                            / static_cast<double>(timestampNs - slot.previousNs);
+                    if (!active && rate > check->raiseLevel) {
+                        setState(check->rule, true, channelId, value, timestampNs);
+                    } else if (active && rate < check->clearLevel) {
+                        setState(check->rule, false, channelId, value, timestampNs);
+                    }
+                }
+                break;
+
+            case AlarmRule::StaleChannel:
+                if (active) {
+                    setState(check->rule, false, channelId, value, timestampNs);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    slot.hasPrevious = true;
+    slot.previousValue = value;
+    slot.previousNs = timestampNs;
+    slot.lastSampleNs = qMax(slot.lastSampleNs, timestampNs);
+}
+
+void AlarmEngine::processHeartbeat(qint64 timestampNs)
+{
+    m_lastHeartbeatNs = qMax(m_lastHeartbeatNs, timestampNs);
+    m_heartbeatSeen = true;
+
+    for (const Timeout &timeout : qAsConst(m_timeouts)) {
+        if (timeout.slot < 0 && m_state[timeout.rule].active) {
+            setState(timeout.rule, false, -1, 0.0, timestampNs);
+        }
+    }
+}
+
+void AlarmEngine::checkTimeouts()
+{
+    const qint64 now = MonotonicClock::nowNs();
+
+    for (const Timeout &timeout : qAsConst(m_timeouts)) {
+        if (m_state[timeout.rule].active) {
+            continue;
+        }
+        // Dispositif sans heartbeat (mode texte): rien à perdre
+        if (timeout.slot < 0 && !m_heartbeatSeen) {
+            continue;
+        }
+
+        const qint64 last = timeout.slot < 0 ? m_lastHeartbeatNs : m_slots[timeout.slot].lastSampleNs;
+        if (now - last > timeout.timeoutNs) {
+            // Horodatage = échéance: la latence mesure le retard de détection
+            int channelId = -1;
+            for (auto it = m_slotIndex.constBegin(); it != m_slotIndex.constEnd(); ++it) {
+                if (it.value() == timeout.slot) {
+                    channelId = it.key();
+                    break;
+                }
+            }
+            setState(timeout.rule, true, channelId, 0.0, last + timeout.timeoutNs);
+        }
+    }
+}
+
+void AlarmEngine::setState(int rule, bool active, int channelId, double value, qint64 timestampNs)
+{
+    RuleState &state = m_state[rule];
+    const AlarmRule &definition = m_rules[rule];
+
+    state.active = active;
+    state.event.ruleName = definition.name;
+    state.event.kind = definition.kind;
+    state.event.severity = definition.severity;
+    state.event.channelId = channelId;
+    state.event.active = active;
+    state.event.value = value;
+    state.event.sampleTimestampNs = timestampNs;
+    state.event.detectedNs = MonotonicClock::nowNs();
+
+    qDebug() << "[AlarmEngine]" << (active ? "Raised" : "Cleared") << definition.name
+             << "value" << value << "latency" << state.event.latencyNs() / 1000 << "us";
+
+    if (active) {
+        emit alarmRaised(state.event);
+    } else {
+        emit alarmCleared(state.event);
+    }
+}
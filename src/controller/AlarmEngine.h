@@ -0,0 +1,184 @@
+#ifndef ALARMENGINE_H
+#define ALARMENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMetaType>
+
+class QTimer;
+class DataModel;
+
+/**
+ * @brief Règle d'alarme configurable (sérialisable en JSON)
+ *
+ * @code
+ * {"name":"surchauffe","kind":"above","channel":"temp","threshold":28.0,"hysteresis":0.5}
+ * {"name":"dérive tension","kind":"rate","channel":"voltage","threshold":0.5}   (unités/s)
+ * {"name":"tension figée","kind":"stale","channel":"voltage","timeout_ms":2000}
+ * {"name":"heartbeat perdu","kind":"heartbeat","timeout_ms":0}   (0 = 3 x période)
+ * @endcode
+ */
+struct AlarmRule
+{
+    enum Kind {
+        ThresholdAbove,   // valeur > seuil, retombe sous seuil - hystérésis
+        ThresholdBelow,   // valeur < seuil, remonte au-dessus de seuil + hystérésis
+        RateOfChange,     // |dv/dt| > seuil (unités/s), hystérésis idem
+        StaleChannel,     // aucun échantillon depuis timeoutMs
+        HeartbeatLoss     // aucun heartbeat depuis timeoutMs (armé au premier heartbeat)
+    };
+
+    enum Severity {
+        Warning,
+        Critical
+    };
+
+    QString name;
+    Kind kind;
+    Severity severity;
+    QString channel;      // Nom du canal (sans objet pour HeartbeatLoss)
+    double threshold;
+    double hysteresis;
+    qint64 timeoutMs;
+
+    AlarmRule();
+
+    QJsonObject toJson() const;
+    static AlarmRule fromJson(const QJsonObject &json, bool *ok = nullptr);
+    static QString kindToString(Kind kind);
+};
+
+/**
+ * @brief Événement d'alarme (levée ou retombée)
+ *
+ * latencyNs = détection - horodatage de l'échantillon (réception de la
+ * trame): temps de décodage et d'évaluation inclus.
+ */
+struct AlarmEvent
+{
+    QString ruleName;
+    AlarmRule::Kind kind;
+    AlarmRule::Severity severity;
+    int channelId;            // -1 pour HeartbeatLoss
+    bool active;              // true = levée, false = retombée
+    double value;
+    qint64 sampleTimestampNs;
+    qint64 detectedNs;
+
+    AlarmEvent();
+    qint64 latencyNs() const { return detectedNs - sampleTimestampNs; }
+};
+
+Q_DECLARE_METATYPE(AlarmEvent)
+
+/**
+ * @brief Moteur de règles d'alarme évalué à l'ingestion
+ *
+ * Connecté en direct à DataModel::sampleAdded: les règles sont évaluées
+ * dans le thread qui décode les trames, au moment où l'échantillon entre
+ * dans le modèle, et jamais dans la vue.
+ *
+ * Les règles sont compilées en tableaux plats: un tableau de tests par
+ * canal (seuils de levée/retombée précalculés, taux converti en unités/ns)
+ * et un tableau de délais d'expiration. Un échantillon coûte une recherche
+ * de canal puis un parcours linéaire de ses tests, sans allocation hors
+ * levée/retombée. Les délais (canal figé, heartbeat perdu) sont vérifiés
+ * par un timer dont la période est un dixième du plus court délai.
+ *
+ * La compilation résout les noms de canaux: elle est refaite à chaque
+ * nouveau canal enregistré. La perte de heartbeat n'est surveillée qu'après
+ * un premier heartbeat depuis start(): le firmware n'en émet qu'en mode JSON.
+ * setRules() fait retomber les alarmes levées avant de remplacer les règles.
+ */
+class AlarmEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const qint64 DefaultHeartbeatIntervalMs = 5000;  // Firmware
+    static const int HeartbeatTimeoutFactor = 3;
+
+    explicit AlarmEngine(DataModel *model, QObject *parent = nullptr);
+
+    // Configuration
+    void setRules(const QList<AlarmRule> &rules);
+    QList<AlarmRule> rules() const { return m_rules; }
+    int loadRules(const QJsonArray &rules);   // Retourne le nombre de règles valides
+    QJsonArray rulesToJson() const;
+    void setHeartbeatInterval(qint64 intervalMs);
+
+    // Surveillance (arme / désarme les délais)
+    void start(qint64 nowNs);
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    // Alarmes actuellement levées
+    QList<AlarmEvent> activeAlarms() const;
+
+public slots:
+    void processSample(quint16 channelId, double value, qint64 timestampNs);
+    void processHeartbeat(qint64 timestampNs);
+
+signals:
+    void alarmRaised(const AlarmEvent &event);
+    void alarmCleared(const AlarmEvent &event);
+
+private slots:
+    void checkTimeouts();
+    void recompile();
+
+private:
+    // Test compilé (un par règle de valeur)
+    struct Check {
+        quint8 kind;
+        int rule;           // Index dans m_rules / m_state
+        double raiseLevel;  // Seuil de levée (|dv/dt| en unités/ns pour RateOfChange)
+        double clearLevel;  // Seuil de retombée
+    };
+
+    // Délai compilé (canal figé ou heartbeat)
+    struct Timeout {
+        int rule;
+        int slot;           // Index dans m_slots, -1 = heartbeat
+        qint64 timeoutNs;
+    };
+
+    struct ChannelSlot {
+        int firstCheck;
+        int checkCount;
+        bool hasPrevious;
+        double previousValue;
+        qint64 previousNs;
+        qint64 lastSampleNs;
+    };
+
+    struct RuleState {
+        bool active;
+        AlarmEvent event;   // Dernier événement (levée en cours)
+    };
+
+    void setState(int rule, bool active, int channelId, double value, qint64 timestampNs);
+
+    DataModel *m_model;
+    QList<AlarmRule> m_rules;
+    QVector<RuleState> m_state;
+
+    // Forme compilée
+    QVector<Check> m_checks;
+    QHash<quint16, int> m_slotIndex;     // Canal → index dans m_slots
+    QVector<ChannelSlot> m_slots;
+    QVector<Timeout> m_timeouts;
+
+    qint64 m_heartbeatIntervalMs;
+    qint64 m_lastHeartbeatNs;
+    bool m_heartbeatSeen;     // Premier heartbeat reçu depuis start()
+    bool m_running;
+    QTimer *m_timeoutTimer;
+};
+
+#endif // ALARMENGINE_H
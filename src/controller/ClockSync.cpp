@@ -0,0 +1,120 @@
+#include "ClockSync.h"
+#include <QDebug>
+#include <cmath>
+
+ClockSync::ClockSync()
+{
+    reset();
+}
+
+void ClockSync::reset()
+{
+    m_window.clear();
+    m_windowNext = 0;
+    m_points.clear();
+    m_lastDeviceUs = 0;
+    m_exchangeCount = 0;
+    m_referenceNs = 0;
+    m_offsetNs = 0;
+    m_slope = 0.0;
+    m_delayNs = 0;
+}
+
+// ============================================================================
+// ÉCHANGES
+// ============================================================================
+
+bool ClockSync::addExchange(qint64 hostSendNs, qint64 deviceRxUs, qint64 deviceTxUs, qint64 hostRecvNs)
+{
+    if (deviceRxUs < m_lastDeviceUs) {
+        qDebug() << "[ClockSync] Device clock went backwards, restarting estimation";
+        reset();
+    }
+
+    const qint64 t1 = deviceRxUs * 1000;
+    const qint64 t2 = deviceTxUs * 1000;
+    if (hostRecvNs < hostSendNs || t2 < t1) {
+        return false;
+    }
+
+    Sample sample;
+    sample.deviceNs = t1 + (t2 - t1) / 2;
+    sample.offsetNs = ((hostSendNs - t1) + (hostRecvNs - t2)) / 2;
+    sample.delayNs = qMax<qint64>(0, (hostRecvNs - hostSendNs) - (t2 - t1));
+
+    m_lastDeviceUs = deviceTxUs;
+    m_exchangeCount++;
+
+    if (m_window.size() < FilterWindow) {
+        m_window.append(sample);
+    } else {
+        m_window[m_windowNext] = sample;
+        m_windowNext = (m_windowNext + 1) % FilterWindow;
+    }
+
+    // Filtre d'horloge: l'échange de plus faible délai de la fenêtre
+    const Sample *best = &m_window.first();
+    for (const Sample &candidate : qAsConst(m_window)) {
+        if (candidate.delayNs < best->delayNs) {
+            best = &candidate;
+        }
+    }
+
+    if (m_points.isEmpty() || best->deviceNs > m_points.last().deviceNs) {
+        m_points.append(*best);
+        if (m_points.size() > RegressionWindow) {
+            m_points.removeFirst();
+        }
+        fit();
+    }
+
+    return true;
+}
+
+void ClockSync::fit()
+{
+    const Sample &last = m_points.last();
+    m_referenceNs = last.deviceNs;
+    m_offsetNs = last.offsetNs;
+    m_delayNs = last.delayNs;
+    m_slope = 0.0;
+
+    const int n = m_points.size();
+    if (n < 2) {
+        return;
+    }
+
+    // Moindres carrés sur des écarts au dernier point (précision double)
+    double meanX = 0.0;
+    double meanY = 0.0;
+    for (const Sample &point : qAsConst(m_points)) {
+        meanX += static_cast<double>(point.deviceNs - m_referenceNs);
+        meanY += static_cast<double>(point.offsetNs - last.offsetNs);
+    }
+    meanX /= n;
+    meanY /= n;
+
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (const Sample &point : qAsConst(m_points)) {
+        const double dx = static_cast<double>(point.deviceNs - m_referenceNs) - meanX;
+        const double dy = static_cast<double>(point.offsetNs - last.offsetNs) - meanY;
+        covariance += dx * dy;
+        variance += dx * dx;
+    }
+
+    if (variance > 0.0) {
+        const double limit = MaxDriftPpm * 1e-6;
+        m_slope = qBound(-limit, covariance / variance, limit);
+    }
+
+    // Ordonnée à l'instant de référence
+    m_offsetNs = last.offsetNs + std::llround(meanY - m_slope * meanX);
+}
+
+qint64 ClockSync::toHostNs(qint64 deviceUs) const
+{
+    const qint64 deviceNs = deviceUs * 1000;
+    return deviceNs + m_offsetNs
+            + std::llround(m_slope * static_cast<double>(deviceNs - m_referenceNs));
+}
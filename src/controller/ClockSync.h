@@ -0,0 +1,78 @@
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * @brief Estimation de l'horloge du dispositif dans la base de temps hôte
+ *
+ * Échange de type NTP avec la commande SYNC du firmware:
+ * @code
+ * t0  hôte: émission de la requête       (ns MonotonicClock)
+ * t1  dispositif: réception de la requête (µs depuis le démarrage)
+ * t2  dispositif: émission de la réponse  (µs)
+ * t3  hôte: réception de la réponse       (ns)
+ *
+ * délai   = (t3 - t0) - (t2 - t1)
+ * décalage = ((t0 - t1) + (t3 - t2)) / 2     (hôte - dispositif)
+ * @endcode
+ *
+ * Filtre d'horloge: parmi les FilterWindow derniers échanges, seul celui de
+ * plus faible délai (le moins perturbé par la file série) est retenu. Les
+ * points retenus alimentent une régression linéaire du décalage en fonction
+ * du temps dispositif: l'ordonnée donne le décalage, la pente la dérive du
+ * quartz. toHostNs() projette un horodatage dispositif dans la base hôte.
+ *
+ * Un temps dispositif qui recule (reset du firmware) réinitialise
+ * l'estimation.
+ */
+class ClockSync
+{
+public:
+    static const int FilterWindow = 8;        // Échanges par filtre de délai minimal
+    static const int RegressionWindow = 32;   // Points retenus pour la dérive
+    static const int BurstIntervalMs = 250;   // Période tant que le filtre n'est pas plein
+    static const int IntervalMs = 2000;       // Période en régime établi
+    static constexpr double MaxDriftPpm = 500.0;
+
+    ClockSync();
+
+    void reset();
+
+    // Ajoute un échange complet; false si incohérent (ignoré)
+    bool addExchange(qint64 hostSendNs, qint64 deviceRxUs, qint64 deviceTxUs, qint64 hostRecvNs);
+
+    bool isSynchronized() const { return !m_points.isEmpty(); }
+    int exchangeCount() const { return m_exchangeCount; }
+
+    // Horodatage dispositif (µs) → ns MonotonicClock
+    qint64 toHostNs(qint64 deviceUs) const;
+
+    qint64 offsetNs() const { return m_offsetNs; }   // Hôte - dispositif à l'instant de référence
+    double driftPpm() const { return m_slope * 1e6; }
+    qint64 delayNs() const { return m_delayNs; }     // Aller-retour du dernier point retenu
+
+private:
+    struct Sample {
+        qint64 deviceNs;   // Milieu de [t1, t2]
+        qint64 offsetNs;
+        qint64 delayNs;
+    };
+
+    void fit();
+
+    QVector<Sample> m_window;   // Derniers échanges (buffer circulaire)
+    int m_windowNext;
+    QVector<Sample> m_points;   // Échanges retenus par le filtre
+    qint64 m_lastDeviceUs;
+    int m_exchangeCount;
+
+    // Modèle: hôte = dispositif + m_offsetNs + m_slope * (dispositif - m_referenceNs)
+    qint64 m_referenceNs;
+    qint64 m_offsetNs;
+    double m_slope;
+    qint64 m_delayNs;
+};
+
+#endif // CLOCKSYNC_H
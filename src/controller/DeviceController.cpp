@@ -1,10 +1,24 @@
 #include "DeviceController.h"
 #include <QDebug>
 #include <QJsonDocument>
+#include <QJsonArray>
+#include <QMetaMethod>
+#include "MonotonicClock.h"
+#include "ProtocolTables.h"
+#include "TextProtocol.h"
 
 DeviceController::DeviceController(QObject *parent)
     : QObject(parent)
-    , m_autoRefreshEnabled(false)
+    , m_batchingEnabled(true)
+    , m_batchMaxCommands(0)
+    , m_batchMaxBytes(0)
+    , m_batchMaxResultBytes(0)
+    , m_streamRateHz(0)
+    , m_streamSequenceValid(false)
+    , m_streamNextSequence(0)
+    , m_streamFrames(0)
+    , m_streamLost(0)
+    , m_syncSequence(0)
 {
     // Initialisation des modèles
     m_deviceState = new DeviceState(this);
@@ -14,10 +28,66 @@ DeviceController::DeviceController(QObject *parent)
     m_serialManager = new SerialManager(this);
     m_jsonProtocol = new JsonProtocol(this);
     
-    // Timer pour rafraîchissement automatique
-    m_autoRefreshTimer = new QTimer(this);
-    connect(m_autoRefreshTimer, &QTimer::timeout,
-            this, &DeviceController::handleAutoRefreshTimeout);
+    // Export des historiques (thread dédié)
+    m_exporter = new TelemetryExporter(m_dataModel, this);
+    
+    // Alarmes: perte de heartbeat par défaut (surveillée dès le premier
+    // heartbeat, mode JSON), règles de canaux via loadRules()
+    m_alarmEngine = new AlarmEngine(m_dataModel, this);
+    AlarmRule heartbeatRule;
+    heartbeatRule.name = "Heartbeat perdu";
+    heartbeatRule.kind = AlarmRule::HeartbeatLoss;
+    heartbeatRule.severity = AlarmRule::Critical;
+    m_alarmEngine->setRules(QList<AlarmRule>() << heartbeatRule);
+    connect(m_alarmEngine, &AlarmEngine::alarmRaised,
+            this, &DeviceController::alarmRaised);
+    connect(m_alarmEngine, &AlarmEngine::alarmCleared,
+            this, &DeviceController::alarmCleared);
+    
+    // Publication en mémoire partagée pour les autres processus locaux
+    // (ouverte par l'application ou le démon: shmPublisher()->open())
+    m_shmPublisher = new TelemetryShmPublisher(m_deviceState, m_dataModel, this);
+    
+    // Abonnements locaux (QLocalServer): canaux, état et alarmes
+    // (démarrés par l'application ou le démon: ipcServer()->listen())
+    m_ipcServer = new TelemetryIpcServer(m_deviceState, m_dataModel, this);
+    connect(m_alarmEngine, &AlarmEngine::alarmRaised, m_ipcServer, &TelemetryIpcServer::publishAlarm);
+    connect(m_alarmEngine, &AlarmEngine::alarmCleared, m_ipcServer, &TelemetryIpcServer::publishAlarm);
+    
+    // Interrogation périodique (désactivée tant que setAutoRefresh() ou
+    // pollScheduler()->setInterval() n'a pas fixé de période)
+    m_pollScheduler = new PollScheduler(this);
+    connect(m_pollScheduler, &PollScheduler::pollRequested,
+            this, &DeviceController::handlePollRequested);
+    
+    // Séquences de test: les réponses n'étant pas corrélées aux requêtes,
+    // le script a la liaison pour lui seul pendant l'exécution
+    m_scriptRunner = new ScriptRunner(m_serialManager, this);
+    connect(m_scriptRunner, &ScriptRunner::started,
+            this, &DeviceController::handleScriptStarted);
+    connect(m_scriptRunner, &ScriptRunner::finished,
+            this, &DeviceController::handleScriptFinished);
+    
+    // LED/PWM: confirmation ou annulation des mises à jour optimistes
+    m_actuationTracker = new ActuationTracker(this);
+    connect(m_actuationTracker, &ActuationTracker::confirmed, this,
+            [this](ActuationTracker::Actuator actuator, int value, qint64 latencyNs) {
+        emit actuationConfirmed(ActuationTracker::actuatorToString(actuator), value, latencyNs);
+    });
+    connect(m_actuationTracker, &ActuationTracker::rolledBack,
+            this, &DeviceController::handleActuationRolledBack);
+    
+    // Regroupement: envoi à la fin de l'itération courante de la boucle
+    m_batchTimer = new QTimer(this);
+    m_batchTimer->setSingleShot(true);
+    m_batchTimer->setInterval(0);
+    connect(m_batchTimer, &QTimer::timeout,
+            this, &DeviceController::flushCommands);
+    
+    // Timer des échanges de synchronisation d'horloge
+    m_syncTimer = new QTimer(this);
+    connect(m_syncTimer, &QTimer::timeout,
+            this, &DeviceController::requestClockSync);
     
     // === CONNEXIONS SERIALMANAGER ===
     connect(m_serialManager, &SerialManager::dataReceived,
@@ -29,6 +99,12 @@ DeviceController::DeviceController(QObject *parent)
     connect(m_serialManager, &SerialManager::errorOccurred,
             this, &DeviceController::handleSerialError);
     
+    connect(m_serialManager, &SerialManager::recordingStateChanged,
+            this, &DeviceController::rawRecordingChanged);
+    
+    connect(m_serialManager, &SerialManager::replayFinished,
+            this, &DeviceController::replayFinished);
+    
     qDebug() << "[DeviceController] Initialized with MVC architecture";
 }
 
@@ -53,22 +129,32 @@ void DeviceController::disconnectFromDevice()
 {
     qDebug() << "[DeviceController] Disconnecting";
     
-    // Arrête le rafraîchissement automatique
-    if (m_autoRefreshTimer->isActive()) {
-        m_autoRefreshTimer->stop();
+    // Arrête l'interrogation périodique, le script et le flux du dispositif
+    m_pollScheduler->stop();
+    m_scriptRunner->abort();
+    if (isStreaming() && isConnected()) {
+        sendStreamStop();
+        flushCommands();
     }
+    m_syncTimer->stop();
     
     m_serialManager->closePort();
 }
 
 void DeviceController::setLed(bool state)
 {
+    if (!acceptHostCommand("SET_LED")) {
+        return;
+    }
+    
     qDebug() << "[DeviceController] Setting LED to" << (state ? "ON" : "OFF");
     
     QByteArray command = JsonProtocol::encodeSetLed(state);
-    m_serialManager->sendCommand(command);
+    submitCommand(command);
     
-    // Mise à jour immédiate du modèle (sera confirmé par la réponse)
+    // Mise à jour immédiate du modèle, en attente de confirmation
+    m_actuationTracker->commandSent(ActuationTracker::Led, state ? 1 : 0,
+                                    m_deviceState->ledState() ? 1 : 0, MonotonicClock::nowNs());
     m_deviceState->setLedState(state);
     
     emit commandSent(state ? "SET_LED=1" : "SET_LED=0");
@@ -86,20 +172,29 @@ void DeviceController::setPwm(uint8_t dutyCycle)
         dutyCycle = 100;
     }
     
+    if (!acceptHostCommand("SET_PWM")) {
+        return;
+    }
+    
     qDebug() << "[DeviceController] Setting PWM to" << dutyCycle << "%";
     
     QByteArray command = JsonProtocol::encodeSetPwm(dutyCycle);
-    m_serialManager->sendCommand(command);
+    submitCommand(command);
     
-    // Mise à jour immédiate du modèle
+    // Mise à jour immédiate du modèle, en attente de confirmation
+    m_actuationTracker->commandSent(ActuationTracker::Pwm, dutyCycle,
+                                    m_deviceState->pwmDutyCycle(), MonotonicClock::nowNs());
     m_deviceState->setPwmDutyCycle(dutyCycle);
-    m_dataModel->addPwmPoint(dutyCycle);
     
     emit commandSent(QString("SET_PWM=%1").arg(dutyCycle));
 }
 
 void DeviceController::resetDevice()
 {
+    if (!acceptHostCommand("RESET")) {
+        return;
+    }
+    
     qDebug() << "[DeviceController] Resetting device";
     
     QByteArray command = JsonProtocol::encodeReset();
@@ -110,15 +205,23 @@ void DeviceController::resetDevice()
 
 void DeviceController::requestTemperature()
 {
+    if (!acceptHostCommand("GET_TEMP")) {
+        return;
+    }
+    
     QByteArray command = JsonProtocol::encodeGetTemperature();
-    m_serialManager->sendCommand(command);
+    submitCommand(command);
     emit commandSent("GET_TEMP");
 }
 
 void DeviceController::requestVoltage()
 {
+    if (!acceptHostCommand("GET_VOLTAGE")) {
+        return;
+    }
+    
     QByteArray command = JsonProtocol::encodeGetVoltage();
-    m_serialManager->sendCommand(command);
+    submitCommand(command);
     emit commandSent("GET_VOLTAGE");
 }
 
@@ -130,37 +233,150 @@ void DeviceController::requestAdcRaw()
 
 void DeviceController::requestStatus()
 {
+    if (!acceptHostCommand("STATUS")) {
+        return;
+    }
+    
     QByteArray command = JsonProtocol::encodeGetStatus();
-    m_serialManager->sendCommand(command);
+    submitCommand(command);
     emit commandSent("STATUS");
 }
 
+void DeviceController::requestCapabilities()
+{
+    if (!acceptHostCommand("CAPS")) {
+        return;
+    }
+    
+    QByteArray command = JsonProtocol::encodeGetCapabilities();
+    m_serialManager->sendCommand(command);
+    emit commandSent("CAPS");
+}
+
+void DeviceController::requestClockSync()
+{
+    // Suspendue pendant un script: sa réponse compléterait une étape
+    if (m_scriptRunner->isRunning()) {
+        return;
+    }
+    
+    // Borne les requêtes restées sans réponse
+    if (m_syncPending.size() > ClockSync::FilterWindow * 4) {
+        m_syncPending.clear();
+    }
+    
+    const quint32 sequence = ++m_syncSequence;
+    QByteArray command = JsonProtocol::encodeSync(sequence);
+    m_syncPending.insert(sequence, MonotonicClock::nowNs());
+    m_serialManager->sendCommand(command);
+    
+    // Cadence rapide jusqu'à remplir le filtre, puis régime établi
+    const int interval = m_clockSync.exchangeCount() < ClockSync::FilterWindow
+            ? ClockSync::BurstIntervalMs : ClockSync::IntervalMs;
+    if (m_syncTimer->interval() != interval) {
+        m_syncTimer->setInterval(interval);
+    }
+}
+
 void DeviceController::setHeartbeatInterval(uint32_t intervalMs)
 {
+    if (!acceptHostCommand("SET_HEARTBEAT")) {
+        return;
+    }
+    
     qDebug() << "[DeviceController] Setting heartbeat interval to" << intervalMs << "ms";
     
     QJsonObject params;
     params["interval"] = static_cast<qint64>(intervalMs);
     
     QByteArray command = JsonProtocol::encodeCommand("SET_HEARTBEAT", params);
-    m_serialManager->sendCommand(command);
+    submitCommand(command);
+    
+    m_alarmEngine->setHeartbeatInterval(intervalMs);
 }
 
 void DeviceController::setAutoRefresh(bool enabled, uint32_t intervalMs)
 {
-    m_autoRefreshEnabled = enabled;
-    
+    // Rafraîchissement de l'état complet (STATUS); les autres métriques se
+    // règlent directement sur pollScheduler()
     if (enabled) {
         qDebug() << "[DeviceController] Auto-refresh enabled, interval:" << intervalMs << "ms";
-        m_autoRefreshTimer->start(intervalMs);
+        m_pollScheduler->setInterval(PollScheduler::Status, intervalMs);
     } else {
         qDebug() << "[DeviceController] Auto-refresh disabled";
-        m_autoRefreshTimer->stop();
+        m_pollScheduler->setInterval(PollScheduler::Status, 0);
+    }
+    
+    if (isConnected() && !m_pollScheduler->isRunning()) {
+        m_pollScheduler->start();
+    }
+}
+
+// ============================================================================
+// ENREGISTREMENT / REJEU DU FLUX BRUT
+// ============================================================================
+
+void DeviceController::startRawRecording(const QString &fileName)
+{
+    m_serialManager->startRecording(fileName);
+}
+
+void DeviceController::stopRawRecording()
+{
+    m_serialManager->stopRecording();
+}
+
+bool DeviceController::startReplay(const QString &fileName, double speed)
+{
+    return m_serialManager->startReplay(fileName, speed);
+}
+
+void DeviceController::stopReplay()
+{
+    m_serialManager->stopReplay();
+}
+
+// ============================================================================
+// CAPTURE LONGUE DURÉE
+// ============================================================================
+
+bool DeviceController::isCapturing() const
+{
+    return m_dataModel->hasStore();
+}
+
+bool DeviceController::startCapture(const QString &directory)
+{
+    QString error;
+    if (!m_dataModel->attachStore(directory, &error)) {
+        emit deviceError(QString("Capture impossible: %1").arg(error));
+        return false;
     }
+
+    qDebug() << "[DeviceController] Capture started in" << directory;
+    emit captureStateChanged(true, directory);
+    return true;
+}
+
+void DeviceController::stopCapture()
+{
+    if (!m_dataModel->hasStore()) {
+        return;
+    }
+
+    const QString directory = m_dataModel->storeDirectory();
+    m_dataModel->detachStore();
+
+    qDebug() << "[DeviceController] Capture stopped";
+    emit captureStateChanged(false, directory);
 }
 
 void DeviceController::sendCustomCommand(const QString &command)
 {
+    if (!acceptHostCommand(command.section(QLatin1Char(':'), 0, 0))) {  // Sans les paramètres (AUTH)
+        return;
+    }
+    
     qDebug() << "[DeviceController] Sending custom command:" << command;
     
     QByteArray data = command.toUtf8();
@@ -168,23 +384,310 @@ void DeviceController::sendCustomCommand(const QString &command)
         data.append('\n');
     }
     
+    flushCommands();  // Conserve l'ordre d'émission
     m_serialManager->sendCommand(data);
     emit commandSent(command);
 }
 
 void DeviceController::sendJsonCommand(const QJsonObject &json)
 {
+    if (!acceptHostCommand(json["command"].toString())) {
+        return;
+    }
+    
     QByteArray data = JsonProtocol::formatJsonForSerial(json);
+    flushCommands();
     m_serialManager->sendCommand(data);
     
     QString command = json["command"].toString();
     emit commandSent(command);
 }
 
-void DeviceController::handleDataReceived(const QByteArray &data)
+// ============================================================================
+// FLUX DE TÉLÉMÉTRIE
+// ============================================================================
+
+bool DeviceController::startStream(const QStringList &channels, int rateHz)
+{
+    if (!acceptHostCommand("STREAM")) {
+        return false;
+    }
+    
+    // Noms des canaux annoncés par CAPS → identifiants firmware
+    QList<quint16> ids;
+    for (const QString &name : channels) {
+        const int id = m_dataModel->channelIdForName(name);
+        if (id < 0) {
+            qDebug() << "[DeviceController] Unknown stream channel:" << name;
+            return false;
+        }
+        ids.append(static_cast<quint16>(id));
+    }
+    
+    if (ids.isEmpty() || rateHz <= 0) {
+        stopStream();
+        return true;
+    }
+    
+    qDebug() << "[DeviceController] Starting stream" << channels << "@" << rateHz << "Hz";
+    
+    // Le firmware renumérote à partir de 0 à chaque commande STREAM
+    m_streamRateHz = rateHz;
+    m_streamSequenceValid = false;
+    submitCommand(JsonProtocol::encodeStream(ids, rateHz));
+    emit commandSent(QString("STREAM %1 @%2Hz").arg(channels.join(',')).arg(rateHz));
+    return true;
+}
+
+void DeviceController::stopStream()
+{
+    if (!acceptHostCommand("STREAM")) {
+        return;
+    }
+    
+    sendStreamStop();
+}
+
+void DeviceController::sendStreamStop()
+{
+    qDebug() << "[DeviceController] Stopping stream";
+    
+    m_streamRateHz = 0;
+    m_streamSequenceValid = false;
+    submitCommand(JsonProtocol::encodeStream(QList<quint16>(), 0));
+    emit commandSent("STREAM stop");
+}
+
+void DeviceController::updateStreamFromJson(const QJsonObject &json, qint64 rxTimestampNs)
+{
+    quint32 sequence;
+    if (!JsonProtocol::extractStreamSequence(json, &sequence)) {
+        return;
+    }
+    
+    // Écart modulo 2^32; un saut en arrière est un redémarrage du flux
+    if (m_streamSequenceValid && sequence != m_streamNextSequence) {
+        const quint32 gap = sequence - m_streamNextSequence;
+        if (gap < 0x80000000u) {
+            m_streamLost += gap;
+            qDebug() << "[DeviceController] Stream gap:" << gap << "frame(s) lost";
+        }
+    }
+    m_streamSequenceValid = true;
+    m_streamNextSequence = sequence + 1;
+    m_streamFrames++;
+    
+    // État courant du dispositif (l'historique est alimenté par les canaux)
+    const QJsonObject data = json["data"].toObject();
+    if (data["temp"].isDouble()) {
+        const float temperature = static_cast<float>(data["temp"].toDouble());
+        m_deviceState->setTemperature(temperature);
+        emit temperatureUpdated(temperature);
+    }
+    if (data["voltage"].isDouble()) {
+        const float voltage = static_cast<float>(data["voltage"].toDouble());
+        m_deviceState->setVoltage(voltage);
+        emit voltageUpdated(voltage);
+    }
+    if (data["adc_raw"].isDouble()) {
+        m_deviceState->setAdcRaw(static_cast<uint16_t>(data["adc_raw"].toInt()));
+    }
+    if (data["pwm"].isDouble()) {
+        reportPwmDutyCycle(data["pwm"].toInt(), ActuationTracker::StatusReport, rxTimestampNs);
+    }
+}
+
+// ============================================================================
+// REGROUPEMENT DES COMMANDES
+// ============================================================================
+
+void DeviceController::setCommandBatching(bool enabled)
+{
+    if (!enabled) {
+        flushCommands();
+    }
+    m_batchingEnabled = enabled;
+}
+
+bool DeviceController::acceptHostCommand(const QString &command)
+{
+    if (!m_scriptRunner->isRunning()) {
+        return true;
+    }
+    
+    qDebug() << "[DeviceController] Command refused while a script is running:" << command;
+    emit deviceError(QString("%1 refusée: séquence de test en cours").arg(command));
+    return false;
+}
+
+void DeviceController::handleScriptStarted()
+{
+    // Lots en attente envoyés avant la première étape, puis plus rien
+    flushCommands();
+    m_pollScheduler->stop();
+    m_syncTimer->stop();
+}
+
+void DeviceController::handleScriptFinished()
+{
+    if (!isConnected()) {
+        return;
+    }
+    
+    m_pollScheduler->start();
+    m_syncTimer->start();
+}
+
+void DeviceController::submitCommand(const QByteArray &command)
+{
+    if (!m_batchingEnabled || !isBatchSupported()) {
+        m_serialManager->sendCommand(command);
+        return;
+    }
+    
+    m_pendingCommands.append(command);
+    if (m_pendingCommands.size() >= m_batchMaxCommands) {
+        flushCommands();
+    } else if (!m_batchTimer->isActive()) {
+        m_batchTimer->start();
+    }
+}
+
+void DeviceController::flushCommands()
+{
+    m_batchTimer->stop();
+    if (m_pendingCommands.isEmpty()) {
+        return;
+    }
+    
+    const QList<QByteArray> commands = m_pendingCommands;
+    m_pendingCommands.clear();
+    
+    if (commands.size() == 1) {
+        m_serialManager->sendCommand(commands.first());
+        return;
+    }
+    
+    // Lots bornés par les limites du firmware (nombre d'entrées, taille de
+    // la ligne reçue, taille de la réponse); une entrée = son JSON compact
+    // plus une virgule, un résultat = son pire cas (batchResultSize)
+    const int overhead = JsonProtocol::encodeBatch(QJsonArray()).size();
+    QJsonArray entries;
+    QList<QByteArray> entryCommands;
+    int bytes = overhead;
+    int resultBytes = 0;
+    int batches = 0;
+    
+    auto sendEntries = [&]() {
+        if (entries.size() == 1) {
+            m_serialManager->sendCommand(entryCommands.first());
+        } else if (!entries.isEmpty()) {
+            m_serialManager->sendCommand(JsonProtocol::encodeBatch(entries));
+            // Réponses appariées dans l'ordre d'envoi (troncature). Borne
+            // de l'hôte: au-delà de MaxBatchesInFlight lots sans réponse, le
+            // plus ancien est retiré et ses résultats comptés perdus
+            const qint64 now = MonotonicClock::nowNs();
+            expireBatches(now);
+            m_batchesInFlight.append(BatchInFlight{ entryCommands, now });
+            while (m_batchesInFlight.size() > MaxBatchesInFlight) {
+                const QList<QByteArray> lost = m_batchesInFlight.takeFirst().commands;
+                batchResultsLost(lost, 0, lost.size());
+            }
+            ++batches;
+        }
+        entries = QJsonArray();
+        entryCommands.clear();
+        bytes = overhead;
+        resultBytes = 0;
+    };
+    
+    for (const QByteArray &command : commands) {
+        bool ok;
+        const QJsonObject entry = JsonProtocol::batchEntry(command, &ok);
+        const int size = QJsonDocument(entry).toJson(QJsonDocument::Compact).size() + 1;
+        const int resultSize = JsonProtocol::batchResultSize(entry);
+        
+        if (!ok || overhead + size > m_batchMaxBytes) {
+            sendEntries();
+            m_serialManager->sendCommand(command);
+            continue;
+        }
+        
+        if (entries.size() >= m_batchMaxCommands || bytes + size > m_batchMaxBytes
+                || resultBytes + resultSize > m_batchMaxResultBytes) {
+            sendEntries();
+        }
+        entries.append(entry);
+        entryCommands.append(command);
+        bytes += size;
+        resultBytes += resultSize;
+    }
+    sendEntries();
+    
+    qDebug() << "[DeviceController]" << commands.size() << "command(s) sent in" << batches << "batch(es)";
+}
+
+void DeviceController::handleBatchTruncated(const QList<QByteArray> &commands, int answered, int executed)
+{
+    // [answered, executed): exécutées, résultat perdu; les attentes
+    // correspondantes échouent tout de suite plutôt qu'au délai d'expiration
+    executed = qBound(answered, executed, commands.size());
+    batchResultsLost(commands, answered, executed);
+    
+    // [executed, n): jamais exécutées, renvoyées dans l'ordre
+    qDebug() << "[DeviceController] Batch truncated:" << answered << "answered,"
+             << executed << "executed," << commands.size() - executed << "resent";
+    for (int i = executed; i < commands.size(); ++i) {
+        submitCommand(commands[i]);
+    }
+}
+
+void DeviceController::batchResultsLost(const QList<QByteArray> &commands, int first, int last)
+{
+    for (int i = first; i < last; ++i) {
+        const QByteArray name = JsonProtocol::batchEntry(commands[i])["command"].toString().toLatin1();
+        switch (Protocol::commandFromName(name.constData(), std::size_t(name.size()))) {
+            case Protocol::Command::SetLed:
+                m_actuationTracker->commandLost(ActuationTracker::Led);
+                break;
+            case Protocol::Command::SetPwm:
+                m_actuationTracker->commandLost(ActuationTracker::Pwm);
+                break;
+            case Protocol::Command::GetTemp:
+                m_pollScheduler->responseLost(PollScheduler::Temperature);
+                break;
+            case Protocol::Command::GetVoltage:
+                m_pollScheduler->responseLost(PollScheduler::Voltage);
+                break;
+            case Protocol::Command::Status:
+                m_pollScheduler->responseLost(PollScheduler::Status);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void DeviceController::expireBatches(qint64 nowNs)
 {
-    qDebug() << "[DeviceController] Data received:" << data.left(100);
-    parseResponse(data);
+    // Lot sans réponse (trame perdue): retiré pour que les réponses
+    // suivantes ne lui soient pas attribuées
+    const qint64 timeoutNs = BatchTimeoutMs * MonotonicClock::NsPerMs;
+    while (!m_batchesInFlight.isEmpty() && nowNs - m_batchesInFlight.first().sentNs > timeoutNs) {
+        const QList<QByteArray> commands = m_batchesInFlight.takeFirst().commands;
+        qDebug() << "[DeviceController] Batch response timed out," << commands.size() << "command(s)";
+        batchResultsLost(commands, 0, commands.size());
+    }
+}
+
+void DeviceController::handleDataReceived(const QByteArray &data, qint64 rxTimestampNs)
+{
+    // Tous les échantillons de la trame portent son horodatage de réception.
+    // Les champs modifiés par le message sont notifiés en un seul lot.
+    DeviceState::UpdateBatch batch(m_deviceState);
+    m_deviceState->beginFrame(rxTimestampNs);
+    parseResponse(data, rxTimestampNs);
+    m_deviceState->endFrame();
 }
 
 void DeviceController::handleConnectionChanged(bool connected)
@@ -194,10 +697,47 @@ void DeviceController::handleConnectionChanged(bool connected)
     m_deviceState->setConnected(connected);
     emit connectedChanged(connected);
     
-    if (connected && m_autoRefreshEnabled) {
-        m_autoRefreshTimer->start();
+    // Délais d'alarme (canal figé, heartbeat) armés pendant la connexion
+    if (connected) {
+        m_alarmEngine->start(MonotonicClock::nowNs());
     } else {
-        m_autoRefreshTimer->stop();
+        m_alarmEngine->stop();
+    }
+    
+    // Découverte des canaux annoncés par le firmware
+    const bool automatic = connected && !m_scriptRunner->isRunning();
+    if (automatic) {
+        requestCapabilities();
+    }
+    
+    // Synchronisation d'horloge: nouvelle estimation à chaque connexion
+    m_clockSync.reset();
+    m_syncPending.clear();
+    m_syncTimer->setInterval(ClockSync::BurstIntervalMs);
+    if (automatic) {
+        m_syncTimer->start();
+        requestClockSync();
+    } else {
+        m_syncTimer->stop();
+    }
+    
+    if (automatic) {
+        m_pollScheduler->start();
+    } else {
+        m_pollScheduler->stop();
+    }
+    
+    // Support de BATCH redécouvert à chaque connexion (réponse CAPS)
+    if (!connected) {
+        m_batchTimer->stop();
+        m_pendingCommands.clear();
+        m_batchMaxCommands = 0;
+        m_batchMaxBytes = 0;
+        m_batchMaxResultBytes = 0;
+        m_batchesInFlight.clear();
+        m_streamRateHz = 0;
+        m_streamSequenceValid = false;
+        m_actuationTracker->clear();
     }
 }
 
@@ -207,47 +747,98 @@ void DeviceController::handleSerialError(const QString &error)
     emit deviceError(error);
 }
 
-void DeviceController::handleAutoRefreshTimeout()
+void DeviceController::handlePollRequested(PollScheduler::Metric metric)
 {
-    // Demande périodique de l'état complet
-    requestStatus();
+    switch (metric) {
+        case PollScheduler::Temperature:
+            requestTemperature();
+            break;
+        case PollScheduler::Voltage:
+            requestVoltage();
+            break;
+        case PollScheduler::Status:
+            requestStatus();
+            break;
+        default:
+            break;
+    }
 }
 
-void DeviceController::parseResponse(const QByteArray &data)
+void DeviceController::parseResponse(const QByteArray &data, qint64 rxTimestampNs)
 {
-    // Tente de parser en JSON d'abord
-    if (JsonProtocol::isValidJson(data)) {
+    // Tente de parser en JSON d'abord (les réponses texte ne commencent
+    // jamais par '{': pas de tentative de parse JSON pour elles)
+    int first = 0;
+    while (first < data.size() && data.at(first) == ' ') {
+        ++first;
+    }
+    if (first < data.size() && data.at(first) == '{') {
         bool ok;
         QJsonObject json = JsonProtocol::parseMessage(data, &ok);
         
         if (ok) {
-            parseJsonResponse(json);
+            parseJsonResponse(json, rxTimestampNs);
             return;
         }
     }
     
     // Sinon, parse comme texte brut
-    QString text = QString::fromUtf8(data);
-    parseTextResponse(text);
+    parseTextResponse(data, rxTimestampNs);
 }
 
-void DeviceController::parseJsonResponse(const QJsonObject &json)
+void DeviceController::parseJsonResponse(const QJsonObject &json, qint64 rxTimestampNs)
 {
-    JsonProtocol::MessageType type = JsonProtocol::getMessageType(
-        QJsonDocument(json).toJson()
-    );
+    JsonProtocol::MessageType type = JsonProtocol::messageType(json);
     
-    qDebug() << "[DeviceController] JSON message type:" << JsonProtocol::messageTypeToString(type);
+    // Réponse d'un lot: chaque résultat est traité comme une réponse isolée
+    QList<QJsonObject> batchResults;
+    bool truncated = false;
+    int answered = 0;
+    int executed = 0;
+    if (type == JsonProtocol::Response
+            && JsonProtocol::extractBatch(json, &batchResults, &truncated, &answered, &executed)) {
+        expireBatches(rxTimestampNs);
+        const QList<QByteArray> commands = m_batchesInFlight.isEmpty()
+            ? QList<QByteArray>() : m_batchesInFlight.takeFirst().commands;
+        if (answered > commands.size()) {
+            // Réponse sans lot correspondant: l'appariement n'est plus fiable
+            qDebug() << "[DeviceController] Unmatched batch response," << answered << "result(s)";
+            m_batchesInFlight.clear();
+        }
+        
+        for (const QJsonObject &result : batchResults) {
+            parseJsonResponse(result, rxTimestampNs);
+        }
+        if (truncated && answered <= commands.size()) {
+            handleBatchTruncated(commands, answered, executed);
+        }
+        return;
+    }
+    
+    // Les mises à jour du message sont datées à l'instant d'acquisition
+    const qint64 timestampNs = sampleTimestamp(json, rxTimestampNs);
+    m_deviceState->beginFrame(timestampNs);
     
     switch (type) {
         case JsonProtocol::Response:
+            notifyPollResponse(json, rxTimestampNs);
+            updateClockSyncFromJson(json, rxTimestampNs);
+            updateCapabilitiesFromJson(json);
             updateTemperatureFromJson(json);
             updateVoltageFromJson(json);
-            updateStatusFromJson(json);
+            updateStatusFromJson(json, rxTimestampNs);
+            ingestChannelValues(json, timestampNs);
+            break;
+            
+        case JsonProtocol::Stream:
+            updateStreamFromJson(json, rxTimestampNs);
+            ingestChannelValues(json, timestampNs);
             break;
             
         case JsonProtocol::Heartbeat:
-            updateHeartbeatFromJson(json);
+            m_alarmEngine->processHeartbeat(rxTimestampNs);
+            updateHeartbeatFromJson(json, rxTimestampNs);
+            ingestChannelValues(json, timestampNs);
             emit heartbeatReceived();
             break;
             
@@ -267,35 +858,75 @@ void DeviceController::parseJsonResponse(const QJsonObject &json)
     emit responseReceived(QJsonDocument(json).toJson(QJsonDocument::Compact));
 }
 
-void DeviceController::parseTextResponse(const QString &text)
+void DeviceController::parseTextResponse(const QByteArray &line, qint64 rxTimestampNs)
 {
-    qDebug() << "[DeviceController] Parsing text response:" << text;
+    // Décodage sur les octets de la ligne: aucune allocation par réponse
+    const TextProtocol::Message message = TextProtocol::parse(line);
     
-    // Parse des réponses texte simples
-    if (text.startsWith("TEMP:")) {
-        QString tempStr = text.mid(5).trimmed();
-        tempStr.remove("°C");
-        bool ok;
-        float temp = tempStr.toFloat(&ok);
-        if (ok) {
-            m_deviceState->setTemperature(temp);
-            m_dataModel->addTemperaturePoint(temp);
-            emit temperatureUpdated(temp);
-        }
+    switch (message.kind) {
+        case TextProtocol::Message::Temperature:
+            m_pollScheduler->responseReceived(PollScheduler::Temperature, rxTimestampNs);
+            m_deviceState->setTemperature(message.value);
+            m_dataModel->addSample(ChannelInfo::TemperatureChannel, message.value, rxTimestampNs);
+            emit temperatureUpdated(message.value);
+            break;
+            
+        case TextProtocol::Message::Voltage:
+            m_pollScheduler->responseReceived(PollScheduler::Voltage, rxTimestampNs);
+            m_deviceState->setVoltage(message.value);
+            if (message.hasAdcRaw) {
+                m_deviceState->setAdcRaw(message.adcRaw);
+            }
+            m_dataModel->addSample(ChannelInfo::VoltageChannel, message.value, rxTimestampNs);
+            emit voltageUpdated(message.value);
+            break;
+            
+        case TextProtocol::Message::Led:
+            reportLedState(message.ledState, message.acknowledgement ? ActuationTracker::Acknowledgement
+                                                                     : ActuationTracker::StatusReport,
+                           rxTimestampNs);
+            break;
+            
+        case TextProtocol::Message::Pwm:
+            // Historique alimenté par les valeurs rapportées, comme en JSON
+            m_dataModel->addSample(ChannelInfo::PwmChannel, message.pwmDuty, rxTimestampNs);
+            reportPwmDutyCycle(message.pwmDuty, message.acknowledgement ? ActuationTracker::Acknowledgement
+                                                                        : ActuationTracker::StatusReport,
+                               rxTimestampNs);
+            break;
+            
+        case TextProtocol::Message::Uptime:
+            m_deviceState->setUptime(message.uptime);
+            break;
+            
+        case TextProtocol::Message::Error:
+            emit deviceError(QString::fromUtf8(line));
+            break;
+            
+        default:
+            break;
     }
-    else if (text.startsWith("VOLTAGE:")) {
-        QString voltStr = text.split(' ')[1].trimmed();
-        voltStr.remove("V");
-        bool ok;
-        float volt = voltStr.toFloat(&ok);
-        if (ok) {
-            m_deviceState->setVoltage(volt);
-            m_dataModel->addVoltagePoint(volt);
-            emit voltageUpdated(volt);
-        }
+    
+    // Conversion en QString seulement si une vue affiche les réponses
+    static const QMetaMethod responseSignal = QMetaMethod::fromSignal(&DeviceController::responseReceived);
+    if (isSignalConnected(responseSignal)) {
+        emit responseReceived(QString::fromUtf8(line));
     }
+}
+
+void DeviceController::notifyPollResponse(const QJsonObject &json, qint64 rxTimestampNs)
+{
+    // Les réponses ne rappellent pas la commande: GET_TEMP → {temp},
+    // GET_VOLTAGE → {voltage, adc_raw}, STATUS → {temp, voltage, ..., uptime}
+    const QJsonObject data = json.value("data").toObject();
     
-    emit responseReceived(text);
+    if (data.contains("uptime")) {
+        m_pollScheduler->responseReceived(PollScheduler::Status, rxTimestampNs);
+    } else if (data.contains("voltage") && data.contains("adc_raw")) {
+        m_pollScheduler->responseReceived(PollScheduler::Voltage, rxTimestampNs);
+    } else if (data.contains("temp") && !data.contains("voltage")) {
+        m_pollScheduler->responseReceived(PollScheduler::Temperature, rxTimestampNs);
+    }
 }
 
 void DeviceController::updateTemperatureFromJson(const QJsonObject &json)
@@ -303,7 +934,6 @@ void DeviceController::updateTemperatureFromJson(const QJsonObject &json)
     float temperature;
     if (JsonProtocol::extractTemperature(json, &temperature)) {
         m_deviceState->setTemperature(temperature);
-        m_dataModel->addTemperaturePoint(temperature);
         emit temperatureUpdated(temperature);
     }
 }
@@ -311,19 +941,23 @@ void DeviceController::updateTemperatureFromJson(const QJsonObject &json)
 void DeviceController::updateVoltageFromJson(const QJsonObject &json)
 {
     float voltage;
-    uint16_t adcRaw;
+    uint16_t adcRaw = m_deviceState->adcRaw();
     if (JsonProtocol::extractVoltage(json, &voltage, &adcRaw)) {
         m_deviceState->setVoltage(voltage);
         m_deviceState->setAdcRaw(adcRaw);
-        m_dataModel->addVoltagePoint(voltage);
         emit voltageUpdated(voltage);
     }
 }
 
-void DeviceController::updateStatusFromJson(const QJsonObject &json)
+void DeviceController::updateStatusFromJson(const QJsonObject &json, qint64 rxTimestampNs)
 {
     QJsonObject status;
     if (JsonProtocol::extractStatus(json, &status)) {
+        // Réponse à SET_LED ({"led":1}) ou SET_PWM ({"pwm":50}) seule, sinon
+        // STATUS complet (toujours avec "uptime")
+        const ActuationTracker::Source source = status.contains("uptime")
+                ? ActuationTracker::StatusReport : ActuationTracker::Acknowledgement;
+        
         // Mise à jour de tous les paramètres d'état
         if (status.contains("temp")) {
             m_deviceState->setTemperature(status["temp"].toDouble());
@@ -332,10 +966,11 @@ void DeviceController::updateStatusFromJson(const QJsonObject &json)
             m_deviceState->setVoltage(status["voltage"].toDouble());
         }
         if (status.contains("led")) {
-            m_deviceState->setLedState(status["led"].toBool());
+            const QJsonValue led = status["led"];
+            reportLedState(led.isBool() ? led.toBool() : led.toInt() != 0, source, rxTimestampNs);
         }
         if (status.contains("pwm")) {
-            m_deviceState->setPwmDutyCycle(status["pwm"].toInt());
+            reportPwmDutyCycle(status["pwm"].toInt(), source, rxTimestampNs);
         }
         if (status.contains("uptime")) {
             m_deviceState->setUptime(status["uptime"].toInt());
@@ -345,7 +980,7 @@ void DeviceController::updateStatusFromJson(const QJsonObject &json)
     }
 }
 
-void DeviceController::updateHeartbeatFromJson(const QJsonObject &json)
+void DeviceController::updateHeartbeatFromJson(const QJsonObject &json, qint64 rxTimestampNs)
 {
     // Traite les données de heartbeat
     if (json.contains("data") && json["data"].isObject()) {
@@ -358,7 +993,114 @@ void DeviceController::updateHeartbeatFromJson(const QJsonObject &json)
             m_deviceState->setTemperature(data["temp"].toDouble());
         }
         if (data.contains("pwm")) {
-            m_deviceState->setPwmDutyCycle(data["pwm"].toInt());
+            reportPwmDutyCycle(data["pwm"].toInt(), ActuationTracker::StatusReport, rxTimestampNs);
+        }
+    }
+}
+
+void DeviceController::reportLedState(bool state, ActuationTracker::Source source, qint64 rxTimestampNs)
+{
+    if (m_actuationTracker->report(ActuationTracker::Led, state ? 1 : 0, source, rxTimestampNs)) {
+        m_deviceState->setLedState(state);
+    }
+}
+
+void DeviceController::reportPwmDutyCycle(int duty, ActuationTracker::Source source, qint64 rxTimestampNs)
+{
+    if (m_actuationTracker->report(ActuationTracker::Pwm, duty, source, rxTimestampNs)) {
+        m_deviceState->setPwmDutyCycle(static_cast<uint8_t>(duty));
+    }
+}
+
+void DeviceController::handleActuationRolledBack(ActuationTracker::Actuator actuator, int requested,
+                                                 int actual, const QString &reason)
+{
+    // Le modèle reprend la dernière valeur rapportée par le dispositif
+    if (actuator == ActuationTracker::Led) {
+        m_deviceState->setLedState(actual != 0);
+    } else if (actuator == ActuationTracker::Pwm) {
+        m_deviceState->setPwmDutyCycle(static_cast<uint8_t>(actual));
+    }
+    
+    emit actuationRolledBack(ActuationTracker::actuatorToString(actuator), requested, actual, reason);
+}
+
+void DeviceController::updateCapabilitiesFromJson(const QJsonObject &json)
+{
+    QJsonArray channels;
+    if (JsonProtocol::extractCapabilities(json, &channels)) {
+        int count = m_dataModel->registerChannels(channels);
+        qDebug() << "[DeviceController]" << count << "channel(s) advertised by firmware";
+        
+        if (JsonProtocol::extractBatchLimits(json, &m_batchMaxCommands, &m_batchMaxBytes,
+                                             &m_batchMaxResultBytes)) {
+            qDebug() << "[DeviceController] BATCH supported:" << m_batchMaxCommands
+                     << "command(s)," << m_batchMaxBytes << "bytes,"
+                     << m_batchMaxResultBytes << "result bytes";
+        }
+        emit capabilitiesReceived(count);
+    }
+}
+
+void DeviceController::updateClockSyncFromJson(const QJsonObject &json, qint64 rxTimestampNs)
+{
+    quint32 sequence;
+    qint64 deviceRxUs;
+    qint64 deviceTxUs;
+    if (!JsonProtocol::extractSync(json, &sequence, &deviceRxUs, &deviceTxUs)) {
+        return;
+    }
+    
+    // Réponse tardive ou d'une autre session: ignorée
+    const auto pending = m_syncPending.find(sequence);
+    if (pending == m_syncPending.end()) {
+        return;
+    }
+    const qint64 hostSendNs = pending.value();
+    m_syncPending.erase(pending);
+    
+    if (m_clockSync.addExchange(hostSendNs, deviceRxUs, deviceTxUs, rxTimestampNs)) {
+        emit clockSyncUpdated(m_clockSync.offsetNs(), m_clockSync.driftPpm(), m_clockSync.delayNs());
+    }
+}
+
+qint64 DeviceController::sampleTimestamp(const QJsonObject &json, qint64 rxTimestampNs) const
+{
+    qint64 deviceUs;
+    if (!m_clockSync.isSynchronized() || !JsonProtocol::extractDeviceTimestamp(json, &deviceUs)) {
+        return rxTimestampNs;
+    }
+    
+    // Une mesure ne peut pas être postérieure à sa réception
+    return qMin(m_clockSync.toHostNs(deviceUs), rxTimestampNs);
+}
+
+void DeviceController::ingestChannelValues(const QJsonObject &json, qint64 rxTimestampNs)
+{
+    // Chaque clé de "data" correspondant à un canal enregistré alimente l'historique
+    if (!json.contains("data") || !json["data"].isObject()) {
+        return;
+    }
+    
+    const QJsonObject data = json["data"].toObject();
+    
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        if (!it.value().isDouble()) {
+            continue;
+        }
+        
+        int channelId = m_dataModel->channelIdForName(it.key());
+        if (channelId < 0) {
+            // Anciennes clés du firmware: même canal que "temp" / "voltage",
+            // sauf si la trame porte aussi la clé actuelle
+            if (it.key() == QLatin1String("temperature") && !data.contains("temp")) {
+                channelId = ChannelInfo::TemperatureChannel;
+            } else if (it.key() == QLatin1String("volt") && !data.contains("voltage")) {
+                channelId = ChannelInfo::VoltageChannel;
+            }
+        }
+        if (channelId >= 0) {
+            m_dataModel->addSample(static_cast<quint16>(channelId), it.value().toDouble(), rxTimestampNs);
         }
     }
 }
@@ -3,10 +3,19 @@
 
 #include <QObject>
 #include <QTimer>
+#include <QHash>
 #include "DeviceState.h"
 #include "DataModel.h"
 #include "SerialManager.h"
 #include "JsonProtocol.h"
+#include "TelemetryExporter.h"
+#include "ClockSync.h"
+#include "AlarmEngine.h"
+#include "TelemetryShmPublisher.h"
+#include "TelemetryIpcServer.h"
+#include "PollScheduler.h"
+#include "ScriptRunner.h"
+#include "ActuationTracker.h"
 
 /**
  * @brief Contrôleur principal du dispositif STM32 (MVC Controller)
@@ -17,6 +26,36 @@
  * - Interface avec la couche communication (SerialManager)
  * - Parse les données JSON reçues
  * - Met à jour le modèle de données
+ *
+ * Tant que la connexion est ouverte, des échanges SYNC périodiques
+ * (ClockSync) estiment le décalage et la dérive de l'horloge du dispositif:
+ * les messages portant un horodatage d'acquisition ("t_us") sont datés à
+ * l'instant de la mesure plutôt qu'à celui de leur réception.
+ *
+ * L'interrogation périodique (température, tension, STATUS) est confiée au
+ * PollScheduler: une période par métrique, pas de nouvelle requête tant que
+ * la précédente est sans réponse, cadence réduite quand le dispositif tarde.
+ *
+ * Les commandes émises pendant une même itération de la boucle d'événements
+ * (LED, PWM, lectures, heartbeat) sont regroupées en un message BATCH si le
+ * firmware l'annonce dans sa réponse CAPS: une trame, une exécution sans
+ * pause entre commandes et une réponse combinée.
+ *
+ * startStream() fait pousser par le firmware les canaux choisis à une
+ * fréquence fixe (messages "stream" numérotés), ingérés directement dans le
+ * DataModel; les trames perdues sont détectées par saut de numéro.
+ *
+ * scriptRunner() exécute des séquences de test chronométrées (commandes,
+ * attentes de réponse, boucles, vérifications) dans le thread du port série.
+ * Les réponses n'étant pas corrélées aux requêtes, le script a la liaison
+ * pour lui seul: interrogation périodique et synchronisation d'horloge sont
+ * suspendues, et les commandes de l'hôte refusées (deviceError) jusqu'à la
+ * fin du script.
+ *
+ * setLed() et setPwm() appliquent la valeur au modèle dès l'envoi; la
+ * commande reste en attente (ActuationTracker) jusqu'à l'acquittement du
+ * firmware ou un STATUS concordant. Valeur différente ou absence de
+ * confirmation: le modèle revient à la valeur réelle (actuationRolledBack).
  */
 class DeviceController : public QObject
 {
@@ -26,6 +65,11 @@ class DeviceController : public QObject
     Q_PROPERTY(bool connected READ isConnected NOTIFY connectedChanged)
 
 public:
+    // Lots envoyés dont la réponse est attendue (appariement des troncatures):
+    // bornés côté hôte, un lot sans réponse après BatchTimeoutMs est retiré
+    static const int MaxBatchesInFlight = 8;
+    static const int BatchTimeoutMs = 1000;
+    
     explicit DeviceController(QObject *parent = nullptr);
     ~DeviceController();
     
@@ -33,9 +77,33 @@ public:
     DeviceState* deviceState() const { return m_deviceState; }
     DataModel* dataModel() const { return m_dataModel; }
     SerialManager* serialManager() const { return m_serialManager; }
+    TelemetryExporter* exporter() const { return m_exporter; }
+    AlarmEngine* alarmEngine() const { return m_alarmEngine; }
+    TelemetryShmPublisher* shmPublisher() const { return m_shmPublisher; }
+    TelemetryIpcServer* ipcServer() const { return m_ipcServer; }
+    PollScheduler* pollScheduler() const { return m_pollScheduler; }
+    ScriptRunner* scriptRunner() const { return m_scriptRunner; }
+    ActuationTracker* actuationTracker() const { return m_actuationTracker; }
     
     // État de connexion
     bool isConnected() const;
+    
+    // Capture longue durée
+    bool isCapturing() const;
+    
+    // Synchronisation d'horloge hôte/dispositif
+    const ClockSync &clockSync() const { return m_clockSync; }
+    
+    // Regroupement des commandes (actif si le firmware supporte BATCH)
+    void setCommandBatching(bool enabled);
+    bool commandBatching() const { return m_batchingEnabled; }
+    bool isBatchSupported() const { return m_batchMaxCommands > 1; }
+    
+    // Flux de télémétrie poussé par le dispositif
+    bool isStreaming() const { return m_streamRateHz > 0; }
+    int streamRate() const { return m_streamRateHz; }
+    quint64 streamFramesReceived() const { return m_streamFrames; }
+    quint64 streamFramesLost() const { return m_streamLost; }
 
 public slots:
     // === COMMANDES DE CONNEXION ===
@@ -53,14 +121,33 @@ public slots:
     void requestVoltage();
     void requestAdcRaw();
     void requestStatus();
+    void requestCapabilities();
+    void requestClockSync();
     
     // === CONFIGURATION ===
     void setHeartbeatInterval(uint32_t intervalMs);
     void setAutoRefresh(bool enabled, uint32_t intervalMs = 1000);
     
+    // === FLUX DE TÉLÉMÉTRIE ===
+    bool startStream(const QStringList &channels, int rateHz);
+    void stopStream();
+    
+    // === CAPTURE LONGUE DURÉE ===
+    bool startCapture(const QString &directory);
+    void stopCapture();
+    
+    // === ENREGISTREMENT / REJEU DU FLUX BRUT ===
+    void startRawRecording(const QString &fileName);
+    void stopRawRecording();
+    bool startReplay(const QString &fileName, double speed = 1.0);
+    void stopReplay();
+    
     // === COMMANDES AVANCÉES ===
     void sendCustomCommand(const QString &command);
     void sendJsonCommand(const QJsonObject &json);
+    
+    // Envoi immédiat des commandes en attente de regroupement
+    void flushCommands();
 
 signals:
     // Notifications de changement d'état
@@ -74,27 +161,69 @@ signals:
     void voltageUpdated(float voltage);
     void statusUpdated(const QJsonObject &status);
     void heartbeatReceived();
+    void capabilitiesReceived(int channelCount);
+    void clockSyncUpdated(qint64 offsetNs, double driftPpm, qint64 delayNs);
+    void alarmRaised(const AlarmEvent &event);
+    void alarmCleared(const AlarmEvent &event);
+    void captureStateChanged(bool active, const QString &directory);
+    void rawRecordingChanged(bool active, const QString &fileName);
+    void replayFinished(qint64 records, qint64 bytes, qint64 elapsedNs);
+    void actuationConfirmed(const QString &actuator, int value, qint64 latencyNs);
+    void actuationRolledBack(const QString &actuator, int requested, int actual, const QString &reason);
 
 private slots:
     // Gestion des données reçues
-    void handleDataReceived(const QByteArray &data);
+    void handleDataReceived(const QByteArray &data, qint64 rxTimestampNs);
     void handleConnectionChanged(bool connected);
     void handleSerialError(const QString &error);
     
-    // Rafraîchissement automatique
-    void handleAutoRefreshTimeout();
+    // Interrogation périodique
+    void handlePollRequested(PollScheduler::Metric metric);
 
 private:
     // Parsing des réponses
-    void parseResponse(const QByteArray &data);
-    void parseJsonResponse(const QJsonObject &json);
-    void parseTextResponse(const QString &text);
+    void parseResponse(const QByteArray &data, qint64 rxTimestampNs);
+    void parseJsonResponse(const QJsonObject &json, qint64 rxTimestampNs);
+    void parseTextResponse(const QByteArray &line, qint64 rxTimestampNs);
+    
+    // Commande regroupable avec celles de la même itération
+    void submitCommand(const QByteArray &command);
+    void handleBatchTruncated(const QList<QByteArray> &commands, int answered, int executed);
+    void batchResultsLost(const QList<QByteArray> &commands, int first, int last);
+    void expireBatches(qint64 nowNs);
+    
+    // false (et deviceError) si un script occupe la liaison
+    bool acceptHostCommand(const QString &command);
+    void sendStreamStop();
+    
+    // Script: suspension/reprise des échanges automatiques
+    void handleScriptStarted();
+    void handleScriptFinished();
+    
+    // Réponse à une interrogation: métrique déduite de la forme de "data"
+    void notifyPollResponse(const QJsonObject &json, qint64 rxTimestampNs);
     
     // Extraction de données spécifiques
     void updateTemperatureFromJson(const QJsonObject &json);
     void updateVoltageFromJson(const QJsonObject &json);
-    void updateStatusFromJson(const QJsonObject &json);
-    void updateHeartbeatFromJson(const QJsonObject &json);
+    void updateStatusFromJson(const QJsonObject &json, qint64 rxTimestampNs);
+    void updateHeartbeatFromJson(const QJsonObject &json, qint64 rxTimestampNs);
+    void updateCapabilitiesFromJson(const QJsonObject &json);
+    void updateClockSyncFromJson(const QJsonObject &json, qint64 rxTimestampNs);
+    void updateStreamFromJson(const QJsonObject &json, qint64 rxTimestampNs);
+    
+    // Valeur d'actionneur rapportée par le dispositif (commande en attente
+    // confirmée ou annulée); le modèle n'est mis à jour que si elle est sûre
+    void reportLedState(bool state, ActuationTracker::Source source, qint64 rxTimestampNs);
+    void reportPwmDutyCycle(int duty, ActuationTracker::Source source, qint64 rxTimestampNs);
+    void handleActuationRolledBack(ActuationTracker::Actuator actuator, int requested, int actual,
+                                   const QString &reason);
+    
+    // Instant d'acquisition d'un message (horloge dispositif si synchronisée)
+    qint64 sampleTimestamp(const QJsonObject &json, qint64 rxTimestampNs) const;
+    
+    // Alimentation générique des canaux du DataModel
+    void ingestChannelValues(const QJsonObject &json, qint64 rxTimestampNs);
     
     // Modèles (Model dans MVC)
     DeviceState *m_deviceState;
@@ -104,9 +233,48 @@ private:
     SerialManager *m_serialManager;
     JsonProtocol *m_jsonProtocol;
     
-    // Rafraîchissement automatique
-    QTimer *m_autoRefreshTimer;
-    bool m_autoRefreshEnabled;
+    // Export en arrière-plan
+    TelemetryExporter *m_exporter;
+    
+    // Règles d'alarme évaluées à l'ingestion
+    AlarmEngine *m_alarmEngine;
+    TelemetryShmPublisher *m_shmPublisher;
+    TelemetryIpcServer *m_ipcServer;
+    
+    // Interrogation périodique
+    PollScheduler *m_pollScheduler;
+    
+    // Séquences de test (exécutées dans le thread du port série)
+    ScriptRunner *m_scriptRunner;
+    
+    // Commandes d'actionneurs appliquées de façon optimiste
+    ActuationTracker *m_actuationTracker;
+    
+    // Regroupement des commandes (limites annoncées par CAPS)
+    QList<QByteArray> m_pendingCommands;
+    QTimer *m_batchTimer;
+    bool m_batchingEnabled;
+    int m_batchMaxCommands;
+    int m_batchMaxBytes;
+    int m_batchMaxResultBytes;
+    struct BatchInFlight {
+        QList<QByteArray> commands;
+        qint64 sentNs;
+    };
+    QList<BatchInFlight> m_batchesInFlight;  // Lots envoyés, dans l'ordre
+    
+    // Flux de télémétrie (numéro de séquence attendu, pertes)
+    int m_streamRateHz;
+    bool m_streamSequenceValid;
+    quint32 m_streamNextSequence;
+    quint64 m_streamFrames;
+    quint64 m_streamLost;
+    
+    // Synchronisation d'horloge (requêtes SYNC en attente: séquence → t0)
+    ClockSync m_clockSync;
+    QTimer *m_syncTimer;
+    quint32 m_syncSequence;
+    QHash<quint32, qint64> m_syncPending;
 };
 
 #endif // DEVICECONTROLLER_H
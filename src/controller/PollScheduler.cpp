@@ -0,0 +1,322 @@
+#include "PollScheduler.h"
+#include "MonotonicClock.h"
+#include <QTimer>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+
+const double NsPerMsF = 1e6;
+const double RttGain = 1.0 / 8.0;
+const double RttVarGain = 1.0 / 4.0;
+const double LatenessGain = 1.0 / 16.0;
+
+} // namespace
+
+PollScheduler::Stats::Stats()
+    : intervalMs(0)
+    , effectiveIntervalMs(0)
+    , backoff(1.0)
+    , outstanding(false)
+    , sent(0)
+    , answered(0)
+    , skipped(0)
+    , deferred(0)
+    , timeouts(0)
+    , lost(0)
+    , rttMs(0.0)
+    , rttVarMs(0.0)
+    , driftMs(0.0)
+    , jitterMs(0.0)
+    , maxLatenessMs(0.0)
+{
+}
+
+PollScheduler::PollScheduler(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_running(false)
+{
+    qRegisterMetaType<PollScheduler::Metric>("PollScheduler::Metric");
+
+    for (Entry &entry : m_entries) {
+        entry.dueNs = 0;
+        entry.sentNs = 0;
+        entry.lastLatenessMs = 0.0;
+        entry.rttValid = false;
+        entry.deferred = false;
+    }
+
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &PollScheduler::onTimer);
+}
+
+QString PollScheduler::metricToString(Metric metric)
+{
+    switch (metric) {
+        case Temperature: return "temperature";
+        case Voltage:     return "voltage";
+        case Status:      return "status";
+        default:          return QString();
+    }
+}
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+void PollScheduler::setInterval(Metric metric, qint64 intervalMs)
+{
+    if (metric < 0 || metric >= MetricCount) {
+        return;
+    }
+
+    Entry &entry = m_entries[metric];
+    const bool wasEnabled = entry.stats.intervalMs > 0;
+    entry.stats.intervalMs = intervalMs > 0 ? qMax<qint64>(intervalMs, MinIntervalMs) : 0;
+    updateEffectiveInterval(entry);
+
+    if (entry.stats.intervalMs == 0) {
+        entry.stats.outstanding = false;
+        entry.deferred = false;
+    } else if (m_running && !wasEnabled) {
+        entry.dueNs = MonotonicClock::nowNs();
+    }
+
+    qDebug() << "[PollScheduler] Interval" << metricToString(metric) << entry.stats.intervalMs << "ms";
+    arm();
+}
+
+qint64 PollScheduler::interval(Metric metric) const
+{
+    return (metric >= 0 && metric < MetricCount) ? m_entries[metric].stats.intervalMs : 0;
+}
+
+void PollScheduler::start()
+{
+    const qint64 now = MonotonicClock::nowNs();
+    for (Entry &entry : m_entries) {
+        entry.stats.outstanding = false;
+        entry.stats.backoff = 1.0;
+        entry.deferred = false;
+        entry.dueNs = now;
+        updateEffectiveInterval(entry);
+    }
+
+    m_running = true;
+    arm();
+}
+
+void PollScheduler::stop()
+{
+    m_running = false;
+    m_timer->stop();
+    for (Entry &entry : m_entries) {
+        entry.stats.outstanding = false;
+        entry.deferred = false;
+    }
+}
+
+PollScheduler::Stats PollScheduler::stats(Metric metric) const
+{
+    return (metric >= 0 && metric < MetricCount) ? m_entries[metric].stats : Stats();
+}
+
+int PollScheduler::outstandingCount() const
+{
+    int count = 0;
+    for (const Entry &entry : m_entries) {
+        if (entry.stats.outstanding) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// ORDONNANCEMENT
+// ============================================================================
+
+void PollScheduler::onTimer()
+{
+    if (!m_running) {
+        return;
+    }
+
+    const qint64 now = MonotonicClock::nowNs();
+
+    for (int i = 0; i < MetricCount; ++i) {
+        Entry &entry = m_entries[i];
+        if (entry.stats.intervalMs == 0 || entry.dueNs > now) {
+            continue;
+        }
+
+        // Retard mesuré sur l'échéance de la grille, pas sur un nouvel essai
+        if (!entry.deferred) {
+            recordLateness(entry, now - entry.dueNs);
+        }
+
+        if (entry.stats.outstanding && now - entry.sentNs >= timeoutNs(entry)) {
+            // Réponse perdue ou dispositif saturé: on relâche la cadence
+            entry.stats.outstanding = false;
+            entry.stats.timeouts++;
+            increaseBackoff(entry);
+            qDebug() << "[PollScheduler] Timeout" << metricToString(Metric(i))
+                     << "backoff" << entry.stats.backoff;
+        }
+
+        if (entry.stats.outstanding) {
+            entry.stats.skipped++;
+        } else if (outstandingCount() >= MaxOutstanding) {
+            // Plafond partagé: la métrique n'y est pour rien, pas de
+            // ralentissement; nouvel essai à la prochaine place libre
+            if (!entry.deferred) {
+                entry.deferred = true;
+                entry.stats.deferred++;
+            }
+            entry.dueNs = now + DeferRetryMs * MonotonicClock::NsPerMs;
+            continue;
+        } else {
+            entry.deferred = false;
+            entry.stats.outstanding = true;
+            entry.sentNs = now;
+            entry.stats.sent++;
+            emit pollRequested(Metric(i));
+        }
+
+        // Échéance suivante calée sur la grille théorique, sauf retard d'une
+        // période entière (veille, blocage): on repart de maintenant
+        const qint64 periodNs = entry.stats.effectiveIntervalMs * MonotonicClock::NsPerMs;
+        entry.dueNs += periodNs;
+        if (entry.dueNs <= now) {
+            entry.dueNs = now + periodNs;
+        }
+    }
+
+    arm();
+}
+
+void PollScheduler::responseReceived(PollScheduler::Metric metric, qint64 rxTimestampNs)
+{
+    if (metric < 0 || metric >= MetricCount) {
+        return;
+    }
+
+    Entry &entry = m_entries[metric];
+    if (!entry.stats.outstanding) {
+        return;  // Réponse à une requête manuelle ou arrivée après expiration
+    }
+
+    entry.stats.outstanding = false;
+    entry.stats.answered++;
+
+    const double rttMs = qMax<qint64>(0, rxTimestampNs - entry.sentNs) / NsPerMsF;
+    if (!entry.rttValid) {
+        entry.stats.rttMs = rttMs;
+        entry.stats.rttVarMs = rttMs / 2.0;
+        entry.rttValid = true;
+    } else {
+        entry.stats.rttVarMs += RttVarGain * (std::fabs(entry.stats.rttMs - rttMs) - entry.stats.rttVarMs);
+        entry.stats.rttMs += RttGain * (rttMs - entry.stats.rttMs);
+    }
+    resumeDeferred();
+
+    // Hystérésis: on ne réaccélère que si le RTT resterait sous la moitié de
+    // la période réduite, sinon la cadence oscillerait
+    const double periodMs = double(entry.stats.effectiveIntervalMs);
+    if (entry.stats.rttMs > periodMs / 2.0) {
+        increaseBackoff(entry);
+    } else if (entry.stats.rttMs <= periodMs * RecoveryFactor / 2.0 && entry.stats.backoff > 1.0) {
+        entry.stats.backoff = qMax(1.0, entry.stats.backoff * RecoveryFactor);
+        updateEffectiveInterval(entry);
+    }
+}
+
+void PollScheduler::responseLost(PollScheduler::Metric metric)
+{
+    if (metric < 0 || metric >= MetricCount) {
+        return;
+    }
+
+    Entry &entry = m_entries[metric];
+    if (!entry.stats.outstanding) {
+        return;
+    }
+
+    // Le dispositif a répondu à temps, le résultat n'a pas tenu dans la
+    // réponse du lot: ni RTT ni ralentissement
+    entry.stats.outstanding = false;
+    entry.stats.lost++;
+    qDebug() << "[PollScheduler] Response lost" << metricToString(metric);
+    resumeDeferred();
+}
+
+// ============================================================================
+// OUTILS
+// ============================================================================
+
+qint64 PollScheduler::timeoutNs(const Entry &entry) const
+{
+    const double rtoMs = entry.rttValid ? entry.stats.rttMs + 4.0 * entry.stats.rttVarMs : 0.0;
+    return qint64(qMax(double(MinTimeoutMs), rtoMs) * NsPerMsF);
+}
+
+void PollScheduler::increaseBackoff(Entry &entry)
+{
+    entry.stats.backoff = qMin(MaxBackoff, entry.stats.backoff * 2.0);
+    updateEffectiveInterval(entry);
+}
+
+void PollScheduler::updateEffectiveInterval(Entry &entry)
+{
+    entry.stats.effectiveIntervalMs = qint64(std::llround(entry.stats.intervalMs * entry.stats.backoff));
+}
+
+void PollScheduler::recordLateness(Entry &entry, qint64 latenessNs)
+{
+    const double latenessMs = latenessNs / NsPerMsF;
+    entry.stats.driftMs += LatenessGain * (latenessMs - entry.stats.driftMs);
+    entry.stats.jitterMs += LatenessGain * (std::fabs(latenessMs - entry.lastLatenessMs) - entry.stats.jitterMs);
+    entry.stats.maxLatenessMs = qMax(entry.stats.maxLatenessMs, latenessMs);
+    entry.lastLatenessMs = latenessMs;
+}
+
+void PollScheduler::resumeDeferred()
+{
+    // Une place vient de se libérer: les requêtes reportées partent maintenant
+    const qint64 now = MonotonicClock::nowNs();
+    bool resumed = false;
+    for (Entry &entry : m_entries) {
+        if (entry.deferred && entry.stats.intervalMs > 0) {
+            entry.dueNs = qMin(entry.dueNs, now);
+            resumed = true;
+        }
+    }
+    if (resumed) {
+        arm();
+    }
+}
+
+void PollScheduler::arm()
+{
+    if (!m_running) {
+        return;
+    }
+
+    qint64 nextNs = 0;
+    for (const Entry &entry : m_entries) {
+        if (entry.stats.intervalMs > 0 && (nextNs == 0 || entry.dueNs < nextNs)) {
+            nextNs = entry.dueNs;
+        }
+    }
+
+    if (nextNs == 0) {
+        m_timer->stop();
+        return;
+    }
+
+    const qint64 delayNs = nextNs - MonotonicClock::nowNs();
+    const qint64 delayMs = delayNs > 0 ? (delayNs + MonotonicClock::NsPerMs - 1) / MonotonicClock::NsPerMs : 0;
+    m_timer->start(int(delayMs));
+}
@@ -0,0 +1,124 @@
+#ifndef POLLSCHEDULER_H
+#define POLLSCHEDULER_H
+
+#include <QObject>
+#include <QtGlobal>
+
+class QTimer;
+
+/**
+ * @brief Ordonnanceur d'interrogation par métrique, à cadence adaptative
+ *
+ * Chaque métrique (température, tension, STATUS) a sa propre période. Un
+ * seul timer précis est armé sur la prochaine échéance; les échéances
+ * suivantes sont calculées à partir de l'échéance théorique (pas de
+ * l'instant de réveil), la dérive ne s'accumule donc pas.
+ *
+ * - Une requête n'est pas réémise tant que la précédente de la même métrique
+ *   est sans réponse (comptée comme sautée), jusqu'au délai d'expiration.
+ * - Au plafond global (MaxOutstanding), la requête est reportée, sans
+ *   ralentissement: elle part à la prochaine réponse, ou au plus tard
+ *   DeferRetryMs après.
+ * - Cadence adaptative (par métrique): le facteur de ralentissement double
+ *   quand le RTT lissé dépasse la moitié de la période, quand trop de
+ *   requêtes sont en vol (profondeur de file côté firmware) ou sur
+ *   expiration; il décroît de 20 % à chaque réponse rapide.
+ * - Retard de réveil (échéance → exécution) enregistré: moyenne lissée
+ *   (dérive), gigue au sens de la RFC 3550 (écart lissé entre retards
+ *   successifs, gain 1/16) et maximum.
+ *
+ * Le RTT est lissé comme dans TCP (gain 1/8, variance 1/4) et le délai
+ * d'expiration d'une requête vaut RTT + 4 × variance, au moins MinTimeoutMs.
+ */
+class PollScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Metric {
+        Temperature,
+        Voltage,
+        Status,
+        MetricCount
+    };
+
+    struct Stats {
+        qint64 intervalMs;           // Période demandée (0 = désactivée)
+        qint64 effectiveIntervalMs;  // Période après ralentissement
+        double backoff;
+        bool outstanding;
+        quint64 sent;
+        quint64 answered;
+        quint64 skipped;
+        quint64 deferred;            // Reportées (plafond MaxOutstanding atteint)
+        quint64 timeouts;
+        quint64 lost;                // Réponses perdues signalées (lot tronqué)
+        double rttMs;                // RTT lissé
+        double rttVarMs;
+        double driftMs;              // Retard moyen du réveil
+        double jitterMs;             // Gigue du retard (RFC 3550)
+        double maxLatenessMs;
+
+        Stats();
+    };
+
+    static const int MaxOutstanding = 2;        // Requêtes en vol, toutes métriques
+    static const int MinIntervalMs = 20;
+    static const int DeferRetryMs = 20;         // Nouvel essai d'une requête reportée
+    static const int MinTimeoutMs = 1000;
+    static constexpr double MaxBackoff = 16.0;
+    static constexpr double RecoveryFactor = 0.8;
+
+    explicit PollScheduler(QObject *parent = nullptr);
+
+    void setInterval(Metric metric, qint64 intervalMs);  // 0 désactive la métrique
+    qint64 interval(Metric metric) const;
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    Stats stats(Metric metric) const;
+    int outstandingCount() const;
+
+    static QString metricToString(Metric metric);
+
+public slots:
+    // Réponse reçue pour la métrique (horodatage de réception, ns)
+    void responseReceived(PollScheduler::Metric metric, qint64 rxTimestampNs);
+    
+    // Réponse perdue côté firmware (lot tronqué): la requête est close sans
+    // attendre l'expiration ni ralentir la cadence
+    void responseLost(PollScheduler::Metric metric);
+
+signals:
+    void pollRequested(PollScheduler::Metric metric);
+
+private slots:
+    void onTimer();
+
+private:
+    struct Entry {
+        Stats stats;
+        qint64 dueNs;
+        qint64 sentNs;
+        double lastLatenessMs;
+        bool rttValid;
+        bool deferred;        // En attente d'une place (dueNs = prochain essai)
+    };
+
+    qint64 timeoutNs(const Entry &entry) const;
+    void increaseBackoff(Entry &entry);
+    void updateEffectiveInterval(Entry &entry);
+    void recordLateness(Entry &entry, qint64 latenessNs);
+    void resumeDeferred();
+    void arm();
+
+    Entry m_entries[MetricCount];
+    QTimer *m_timer;
+    bool m_running;
+};
+
+Q_DECLARE_METATYPE(PollScheduler::Metric)
+
+#endif // POLLSCHEDULER_H
@@ -0,0 +1,492 @@
+#include "ScriptEngine.h"
+#include "SerialWorker.h"
+#include "JsonProtocol.h"
+#include "MonotonicClock.h"
+#include <QTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDebug>
+
+namespace {
+
+const double NsPerMsF = 1e6;
+
+// "status.led" → data["status"]["led"]
+QJsonValue resolvePath(const QJsonObject &data, const QString &path)
+{
+    QJsonValue value = data;
+    for (const QString &part : path.split('.', Qt::SkipEmptyParts)) {
+        if (!value.isObject()) {
+            return QJsonValue(QJsonValue::Undefined);
+        }
+        value = value.toObject().value(part);
+    }
+    return value;
+}
+
+bool appendSteps(const QJsonArray &array, QVector<ScriptStep> *steps, QString *errorMessage)
+{
+    for (const QJsonValue &value : array) {
+        const int index = steps->size();
+        if (!value.isObject()) {
+            *errorMessage = QString("Étape %1: objet JSON attendu").arg(index);
+            return false;
+        }
+
+        const QJsonObject json = value.toObject();
+        ScriptStep step;
+        step.label = json.value("name").toString();
+        step.timeoutMs = qint64(json.value("timeout_ms").toDouble(Script::DefaultTimeoutMs));
+
+        if (json.contains("send")) {
+            const QJsonValue send = json.value("send");
+            if (send.isString()) {
+                step.payload = send.toString().toUtf8();
+                if (!step.payload.endsWith('\n')) {
+                    step.payload.append('\n');
+                }
+            } else if (send.isObject() && send.toObject().contains("command")) {
+                const QJsonObject command = send.toObject();
+                step.payload = JsonProtocol::encodeCommand(command.value("command").toString(),
+                                                           command.value("params").toObject());
+            } else {
+                *errorMessage = QString("Étape %1: \"send\" doit être une chaîne ou {\"command\":...}").arg(index);
+                return false;
+            }
+
+            step.kind = ScriptStep::Send;
+            const QJsonValue expect = json.value("expect");
+            step.expectResponse = expect.isObject() || expect.toBool(false);
+            if (expect.isObject()) {
+                step.predicate = ScriptPredicate::fromJson(expect.toObject());
+            }
+            if (step.label.isEmpty()) {
+                step.label = QString::fromUtf8(step.payload).trimmed();
+            }
+        } else if (json.contains("wait")) {
+            step.kind = ScriptStep::Wait;
+            step.predicate = ScriptPredicate::fromJson(json.value("wait").toObject());
+        } else if (json.contains("delay_ms")) {
+            step.kind = ScriptStep::Delay;
+            step.delayMs = qMax<qint64>(0, qint64(json.value("delay_ms").toDouble()));
+        } else if (json.contains("assert")) {
+            step.kind = ScriptStep::Assert;
+            step.predicate = ScriptPredicate::fromJson(json.value("assert").toObject());
+        } else if (json.contains("loop")) {
+            step.kind = ScriptStep::LoopBegin;
+            step.count = json.value("loop").toInt();
+            steps->append(step);
+
+            if (!appendSteps(json.value("steps").toArray(), steps, errorMessage)) {
+                return false;
+            }
+
+            ScriptStep end;
+            end.kind = ScriptStep::LoopEnd;
+            end.label = step.label;
+            end.jump = index;
+            (*steps)[index].jump = steps->size();
+            steps->append(end);
+            continue;
+        } else {
+            *errorMessage = QString("Étape %1: action inconnue").arg(index);
+            return false;
+        }
+
+        steps->append(step);
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// SCRIPT
+// ============================================================================
+
+ScriptPredicate::ScriptPredicate()
+    : hasMin(false)
+    , hasMax(false)
+    , min(0.0)
+    , max(0.0)
+    , equals(QJsonValue::Undefined)
+{
+}
+
+ScriptPredicate ScriptPredicate::fromJson(const QJsonObject &json)
+{
+    ScriptPredicate predicate;
+    predicate.type = json.value("type").toString();
+    predicate.key = json.value("key").toString();
+    predicate.text = json.value("text").toString();
+    predicate.hasMin = json.contains("min");
+    predicate.hasMax = json.contains("max");
+    predicate.min = json.value("min").toDouble();
+    predicate.max = json.value("max").toDouble();
+    if (json.contains("equals")) {
+        predicate.equals = json.value("equals");
+    }
+    return predicate;
+}
+
+bool ScriptPredicate::matchesValues(const QJsonObject &data, QString *reason) const
+{
+    if (key.isEmpty()) {
+        return true;
+    }
+
+    const QJsonValue value = resolvePath(data, key);
+    if (value.isUndefined()) {
+        if (reason) *reason = QString("%1 absent").arg(key);
+        return false;
+    }
+
+    if (!equals.isUndefined() && value != equals) {
+        if (reason) {
+            *reason = QString("%1 = %2, attendu %3")
+                .arg(key, QString::fromUtf8(QJsonDocument(QJsonArray{value}).toJson(QJsonDocument::Compact)),
+                     QString::fromUtf8(QJsonDocument(QJsonArray{equals}).toJson(QJsonDocument::Compact)));
+        }
+        return false;
+    }
+
+    if (hasMin || hasMax) {
+        if (!value.isDouble()) {
+            if (reason) *reason = QString("%1 n'est pas numérique").arg(key);
+            return false;
+        }
+        const double number = value.toDouble();
+        if ((hasMin && number < min) || (hasMax && number > max)) {
+            if (reason) {
+                *reason = QString("%1 = %2 hors de [%3, %4]")
+                    .arg(key).arg(number)
+                    .arg(hasMin ? QString::number(min) : QString("-inf"))
+                    .arg(hasMax ? QString::number(max) : QString("+inf"));
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ScriptPredicate::matchesLine(const QByteArray &line, const QJsonObject &message) const
+{
+    if (!text.isEmpty()) {
+        return line.startsWith(text.toUtf8());
+    }
+    if (message.isEmpty()) {
+        return false;
+    }
+    if (!type.isEmpty() && message.value("type").toString() != type) {
+        return false;
+    }
+    return matchesValues(message.value("data").toObject());
+}
+
+ScriptStep::ScriptStep()
+    : kind(Delay)
+    , expectResponse(false)
+    , timeoutMs(Script::DefaultTimeoutMs)
+    , delayMs(0)
+    , count(0)
+    , jump(-1)
+{
+}
+
+Script Script::fromJson(const QJsonObject &json, QString *errorMessage, bool *ok)
+{
+    Script script;
+    script.name = json.value("name").toString();
+    script.stopOnFailure = json.value("stop_on_failure").toBool(true);
+
+    QString error;
+    if (!json.value("steps").isArray()) {
+        error = "Tableau \"steps\" manquant";
+    } else if (appendSteps(json.value("steps").toArray(), &script.steps, &error) && script.steps.isEmpty()) {
+        error = "Script vide";
+    }
+
+    if (errorMessage) *errorMessage = error;
+    if (ok) *ok = error.isEmpty();
+    return error.isEmpty() ? script : Script();
+}
+
+QJsonObject ScriptStepResult::toJson() const
+{
+    QJsonObject json;
+    json["step"] = step;
+    json["name"] = label;
+    json["iteration"] = iteration;
+    json["passed"] = passed;
+    json["latency_ms"] = latencyNs / NsPerMsF;
+    if (!message.isEmpty()) {
+        json["message"] = message;
+    }
+    return json;
+}
+
+// ============================================================================
+// EXÉCUTION
+// ============================================================================
+
+ScriptEngine::ScriptEngine(SerialWorker *worker, QObject *parent)
+    : QObject(parent)
+    , m_worker(worker)
+    , m_timer(new QTimer(this))
+    , m_running(false)
+    , m_pc(0)
+    , m_waitState(Idle)
+    , m_stepStartNs(0)
+    , m_deadlineNs(0)
+    , m_scheduleNs(0)
+    , m_failures(0)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::PreciseTimer);
+    connect(m_timer, &QTimer::timeout, this, &ScriptEngine::handleTimer);
+
+    // Moteur et worker partagent le même thread
+    connect(m_worker, &SerialWorker::dataReceived,
+            this, &ScriptEngine::handleLine, Qt::DirectConnection);
+}
+
+void ScriptEngine::run(const Script &script)
+{
+    if (m_running) {
+        qDebug() << "[ScriptEngine] Script already running, request ignored";
+        return;
+    }
+
+    m_script = script;
+    m_running = true;
+    m_pc = 0;
+    m_waitState = Idle;
+    m_failures = 0;
+    m_loops.clear();
+    m_lastValues = QJsonObject();
+    m_scheduleNs = MonotonicClock::nowNs();
+
+    qDebug() << "[ScriptEngine] Running" << m_script.name << "-" << m_script.steps.size() << "steps";
+    advance();
+}
+
+void ScriptEngine::abort()
+{
+    if (m_running) {
+        qDebug() << "[ScriptEngine] Aborted at step" << m_pc;
+        stop(true);
+    }
+}
+
+void ScriptEngine::advance()
+{
+    while (m_running) {
+        if (m_pc >= m_script.steps.size()) {
+            stop(false);
+            return;
+        }
+
+        const ScriptStep &step = m_script.steps.at(m_pc);
+        const qint64 now = MonotonicClock::nowNs();
+
+        switch (step.kind) {
+            case ScriptStep::LoopBegin:
+                if (step.count <= 0) {
+                    m_pc = step.jump + 1;
+                } else {
+                    m_loops.append({ m_pc, step.count, 0 });
+                    m_pc++;
+                }
+                break;
+
+            case ScriptStep::LoopEnd: {
+                LoopFrame &frame = m_loops.last();
+                if (--frame.remaining > 0) {
+                    frame.iteration++;
+                    m_pc = frame.begin + 1;
+                } else {
+                    m_loops.removeLast();
+                    m_pc++;
+                }
+                break;
+            }
+
+            case ScriptStep::Send:
+                m_stepStartNs = now;
+                m_worker->sendData(step.payload);
+                if (!step.expectResponse) {
+                    // Une pause qui suit part de l'envoi
+                    m_scheduleNs = now;
+                    if (!completeStep(true, now)) return;
+                    break;
+                }
+                m_waitState = WaitingResponse;
+                armTimer(now + step.timeoutMs * MonotonicClock::NsPerMs);
+                return;
+
+            case ScriptStep::Wait:
+                m_stepStartNs = now;
+                m_waitState = WaitingMatch;
+                armTimer(now + step.timeoutMs * MonotonicClock::NsPerMs);
+                return;
+
+            case ScriptStep::Delay:
+                // Échéance calée sur la fin théorique de la pause précédente
+                m_stepStartNs = now;
+                m_waitState = Sleeping;
+                armTimer(m_scheduleNs + step.delayMs * MonotonicClock::NsPerMs);
+                return;
+
+            case ScriptStep::Assert: {
+                m_stepStartNs = now;
+                QString reason;
+                const bool passed = step.predicate.matchesValues(m_lastValues, &reason);
+                if (!completeStep(passed, now, reason)) return;
+                break;
+            }
+        }
+    }
+}
+
+void ScriptEngine::handleLine(const QByteArray &line, qint64 rxTimestampNs)
+{
+    if (!m_running) {
+        return;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+    const QJsonObject message = (parseError.error == QJsonParseError::NoError) ? document.object() : QJsonObject();
+    rememberValues(message);
+
+    const ScriptStep &step = m_script.steps.at(qMin(m_pc, m_script.steps.size() - 1));
+
+    if (m_waitState == WaitingResponse) {
+        // Les messages non sollicités (heartbeat, stream) ne répondent à rien,
+        // pas plus qu'une réponse SYNC (échange d'horloge de DeviceController)
+        const JsonProtocol::MessageType type = JsonProtocol::messageType(message);
+        if (!message.isEmpty() && type != JsonProtocol::Response && type != JsonProtocol::Error) {
+            return;
+        }
+        if (JsonProtocol::extractSync(message, nullptr, nullptr, nullptr) && !step.payload.contains("SYNC")) {
+            return;
+        }
+
+        bool passed = true;
+        QString reason;
+        QString deviceError;
+        if (JsonProtocol::extractError(message, &deviceError)) {
+            passed = false;
+            reason = deviceError;
+        } else if (!step.predicate.text.isEmpty()) {
+            passed = step.predicate.matchesLine(line, message);
+            if (!passed) reason = QString("Réponse inattendue: %1").arg(QString::fromUtf8(line));
+        } else {
+            passed = step.predicate.matchesValues(message.value("data").toObject(), &reason);
+        }
+
+        m_scheduleNs = rxTimestampNs;
+        if (completeStep(passed, rxTimestampNs, reason)) {
+            advance();
+        }
+    } else if (m_waitState == WaitingMatch && step.predicate.matchesLine(line, message)) {
+        m_scheduleNs = rxTimestampNs;
+        if (completeStep(true, rxTimestampNs)) {
+            advance();
+        }
+    }
+}
+
+void ScriptEngine::handleTimer()
+{
+    if (!m_running || m_waitState == Idle) {
+        return;
+    }
+
+    const qint64 now = MonotonicClock::nowNs();
+    if (now < m_deadlineNs) {
+        armTimer(m_deadlineNs);  // Réveil anticipé
+        return;
+    }
+
+    bool next;
+    if (m_waitState == Sleeping) {
+        m_scheduleNs = m_deadlineNs;
+        next = completeStep(true, now);
+    } else {
+        // Une pause qui suit part de l'expiration, pas de l'échéance précédente
+        m_scheduleNs = now;
+        const qint64 timeoutMs = m_script.steps.at(m_pc).timeoutMs;
+        next = completeStep(false, now, QString("Délai dépassé (%1 ms)").arg(timeoutMs));
+    }
+
+    if (next) {
+        advance();
+    }
+}
+
+// ============================================================================
+// OUTILS
+// ============================================================================
+
+bool ScriptEngine::completeStep(bool passed, qint64 endNs, const QString &message)
+{
+    ScriptStepResult result;
+    result.step = m_pc;
+    result.label = m_script.steps.at(m_pc).label;
+    result.iteration = currentIteration();
+    result.passed = passed;
+    result.startedNs = m_stepStartNs;
+    result.latencyNs = qMax<qint64>(0, endNs - m_stepStartNs);
+    result.message = message;
+
+    m_waitState = Idle;
+    m_timer->stop();
+    if (!passed) {
+        m_failures++;
+    }
+
+    emit stepFinished(result);
+    m_pc++;
+
+    if (!passed && m_script.stopOnFailure) {
+        stop(false);
+        return false;
+    }
+    return true;
+}
+
+void ScriptEngine::rememberValues(const QJsonObject &message)
+{
+    const QJsonObject data = message.value("data").toObject();
+    if (JsonProtocol::messageType(message) == JsonProtocol::Error) {
+        return;
+    }
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        m_lastValues.insert(it.key(), it.value());
+    }
+}
+
+void ScriptEngine::armTimer(qint64 deadlineNs)
+{
+    m_deadlineNs = deadlineNs;
+    const qint64 delayNs = deadlineNs - MonotonicClock::nowNs();
+    const qint64 delayMs = delayNs > 0 ? (delayNs + MonotonicClock::NsPerMs - 1) / MonotonicClock::NsPerMs : 0;
+    m_timer->start(int(delayMs));
+}
+
+void ScriptEngine::stop(bool aborted)
+{
+    m_running = false;
+    m_waitState = Idle;
+    m_timer->stop();
+    m_loops.clear();
+
+    qDebug() << "[ScriptEngine] Finished," << m_failures << "failure(s)";
+    emit finished(!aborted && m_failures == 0, m_failures, aborted);
+}
+
+int ScriptEngine::currentIteration() const
+{
+    return m_loops.isEmpty() ? 0 : m_loops.last().iteration;
+}
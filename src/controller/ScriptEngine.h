@@ -0,0 +1,197 @@
+#ifndef SCRIPTENGINE_H
+#define SCRIPTENGINE_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QMetaType>
+
+class QTimer;
+class SerialWorker;
+
+/**
+ * @brief Condition portant sur un message reçu
+ *
+ * Format JSON:
+ * @code
+ * {"key":"temp","min":20,"max":30}            // bornes sur data.temp
+ * {"key":"status.led","equals":true}          // égalité, chemin pointé dans data
+ * {"type":"heartbeat"}                        // type de message
+ * {"text":"OK"}                               // ligne brute (préfixe)
+ * @endcode
+ * Une condition vide accepte tout message.
+ */
+struct ScriptPredicate
+{
+    QString type;
+    QString key;
+    bool hasMin;
+    bool hasMax;
+    double min;
+    double max;
+    QJsonValue equals;   // Undefined = pas de test d'égalité
+    QString text;
+
+    ScriptPredicate();
+
+    static ScriptPredicate fromJson(const QJsonObject &json);
+
+    // data: objet "data" du message (ou valeurs mémorisées pour assert)
+    bool matchesValues(const QJsonObject &data, QString *reason = nullptr) const;
+    bool matchesLine(const QByteArray &line, const QJsonObject &message) const;
+};
+
+/**
+ * @brief Étape élémentaire d'un script (programme aplati)
+ */
+struct ScriptStep
+{
+    enum Kind {
+        Send,        // Envoi d'une commande, attente éventuelle de la réponse
+        Wait,        // Attente d'un message satisfaisant la condition
+        Delay,       // Pause
+        Assert,      // Vérification immédiate des dernières valeurs reçues
+        LoopBegin,
+        LoopEnd
+    };
+
+    Kind kind;
+    QString label;
+    QByteArray payload;          // Send: trame terminée par '\n'
+    bool expectResponse;         // Send: attend la réponse (ou l'erreur)
+    ScriptPredicate predicate;
+    qint64 timeoutMs;
+    qint64 delayMs;
+    int count;                   // LoopBegin: nombre d'itérations
+    int jump;                    // LoopBegin → LoopEnd et inversement
+
+    ScriptStep();
+};
+
+/**
+ * @brief Séquence de test chargée depuis un fichier JSON
+ *
+ * @code
+ * {"name":"recette carte",
+ *  "stop_on_failure":true,
+ *  "steps":[
+ *    {"send":{"command":"SET_LED","params":{"state":true}},"expect":true},
+ *    {"delay_ms":50},
+ *    {"loop":10,"steps":[
+ *      {"name":"lecture","send":"GET_TEMP","expect":{"key":"temp","min":15,"max":60},"timeout_ms":200},
+ *      {"delay_ms":100}]},
+ *    {"wait":{"type":"heartbeat"},"timeout_ms":5000},
+ *    {"assert":{"key":"voltage","min":3.0,"max":3.6}}]}
+ * @endcode
+ * Les boucles sont aplaties en LoopBegin/LoopEnd à la lecture.
+ */
+struct Script
+{
+    QString name;
+    QVector<ScriptStep> steps;
+    bool stopOnFailure;
+
+    static const qint64 DefaultTimeoutMs = 1000;
+
+    Script() : stopOnFailure(true) {}
+
+    static Script fromJson(const QJsonObject &json, QString *errorMessage = nullptr, bool *ok = nullptr);
+};
+
+/**
+ * @brief Résultat d'une étape exécutée
+ */
+struct ScriptStepResult
+{
+    int step;            // Index dans le programme aplati
+    QString label;
+    int iteration;       // Itération de la boucle la plus interne (0 hors boucle)
+    bool passed;
+    qint64 startedNs;    // Base MonotonicClock
+    qint64 latencyNs;    // Envoi → réponse, ou durée de l'attente
+    QString message;
+
+    ScriptStepResult() : step(-1), iteration(0), passed(false), startedNs(0), latencyNs(0) {}
+
+    QJsonObject toJson() const;
+};
+
+Q_DECLARE_METATYPE(Script)
+Q_DECLARE_METATYPE(ScriptStepResult)
+
+/**
+ * @brief Exécuteur de scripts, dans le thread du SerialWorker
+ *
+ * Placé dans le même thread que le port série: les commandes sont écrites
+ * directement par SerialWorker::sendData() et les lignes reçues arrivent par
+ * connexion directe, avec leur horodatage de réception. La latence d'une
+ * étape ne dépend donc ni de la boucle d'événements du thread principal ni
+ * du rendu de l'interface.
+ *
+ * Les pauses et délais d'expiration sont des échéances absolues servies par
+ * un timer précis: une pause de 100 ms dans une boucle de 10 itérations dure
+ * 10 × 100 ms depuis le début de la boucle, sans cumul des retards de
+ * réveil. Une réponse de type "error" fait échouer l'étape qui l'attend.
+ */
+class ScriptEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ScriptEngine(SerialWorker *worker, QObject *parent = nullptr);
+
+    bool isRunning() const { return m_running; }
+
+public slots:
+    void run(const Script &script);
+    void abort();
+
+signals:
+    void stepFinished(const ScriptStepResult &result);
+    void finished(bool passed, int failures, bool aborted);
+
+private slots:
+    void handleLine(const QByteArray &line, qint64 rxTimestampNs);
+    void handleTimer();
+
+private:
+    enum WaitState {
+        Idle,
+        WaitingResponse,
+        WaitingMatch,
+        Sleeping
+    };
+
+    void advance();
+    bool completeStep(bool passed, qint64 endNs, const QString &message = QString());  // false: script arrêté
+    void rememberValues(const QJsonObject &message);
+    void armTimer(qint64 deadlineNs);
+    void stop(bool aborted);
+    int currentIteration() const;
+
+    SerialWorker *m_worker;
+    QTimer *m_timer;
+
+    Script m_script;
+    bool m_running;
+    int m_pc;
+    WaitState m_waitState;
+    qint64 m_stepStartNs;
+    qint64 m_deadlineNs;
+    qint64 m_scheduleNs;         // Échéance théorique de la prochaine pause
+    int m_failures;
+
+    struct LoopFrame {
+        int begin;
+        int remaining;
+        int iteration;
+    };
+    QVector<LoopFrame> m_loops;
+
+    QJsonObject m_lastValues;    // Dernières valeurs de "data", toutes réponses
+};
+
+#endif // SCRIPTENGINE_H
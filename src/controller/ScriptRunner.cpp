@@ -0,0 +1,183 @@
+#include "ScriptRunner.h"
+#include "SerialManager.h"
+#include "MonotonicClock.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QDebug>
+
+ScriptRunner::ScriptRunner(SerialManager *serialManager, QObject *parent)
+    : QObject(parent)
+    , m_running(false)
+    , m_passed(false)
+    , m_aborted(false)
+    , m_startedNs(0)
+    , m_finishedNs(0)
+{
+    qRegisterMetaType<Script>("Script");
+    qRegisterMetaType<ScriptStepResult>("ScriptStepResult");
+
+    m_engine = new ScriptEngine(serialManager->worker());
+    serialManager->attachToWorkerThread(m_engine);
+
+    connect(this, &ScriptRunner::requestRun,
+            m_engine, &ScriptEngine::run, Qt::QueuedConnection);
+
+    connect(this, &ScriptRunner::requestAbort,
+            m_engine, &ScriptEngine::abort, Qt::QueuedConnection);
+
+    connect(m_engine, &ScriptEngine::stepFinished,
+            this, &ScriptRunner::handleStepFinished);
+
+    connect(m_engine, &ScriptEngine::finished,
+            this, &ScriptRunner::handleFinished);
+}
+
+ScriptRunner::~ScriptRunner()
+{
+    // Le moteur est détruit avec le thread du worker
+    if (m_running) {
+        emit requestAbort();
+    }
+}
+
+// ============================================================================
+// CHARGEMENT
+// ============================================================================
+
+bool ScriptRunner::loadFile(const QString &fileName, QString *errorMessage)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage) *errorMessage = QString("Script illisible: %1").arg(file.errorString());
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        if (errorMessage) *errorMessage = QString("Script JSON invalide: %1").arg(parseError.errorString());
+        return false;
+    }
+
+    QJsonObject json = document.object();
+    if (!json.contains("name")) {
+        json["name"] = file.fileName();
+    }
+    return load(json, errorMessage);
+}
+
+bool ScriptRunner::load(const QJsonObject &json, QString *errorMessage)
+{
+    if (m_running) {
+        if (errorMessage) *errorMessage = "Un script est déjà en cours";
+        return false;
+    }
+
+    bool ok;
+    const Script script = Script::fromJson(json, errorMessage, &ok);
+    if (!ok) {
+        return false;
+    }
+
+    m_script = script;
+    m_results.clear();
+    qDebug() << "[ScriptRunner] Loaded" << m_script.name << "-" << m_script.steps.size() << "steps";
+    return true;
+}
+
+// ============================================================================
+// EXÉCUTION
+// ============================================================================
+
+bool ScriptRunner::start()
+{
+    if (m_running || m_script.steps.isEmpty()) {
+        qDebug() << "[ScriptRunner] Nothing to run or already running";
+        return false;
+    }
+
+    m_running = true;
+    m_passed = false;
+    m_aborted = false;
+    m_results.clear();
+    m_startedNs = MonotonicClock::nowNs();
+    m_finishedNs = 0;
+
+    emit started(m_script.name);
+    emit requestRun(m_script);
+    return true;
+}
+
+void ScriptRunner::abort()
+{
+    if (m_running) {
+        emit requestAbort();
+    }
+}
+
+void ScriptRunner::handleStepFinished(const ScriptStepResult &result)
+{
+    m_results.append(result);
+    emit stepFinished(result);
+}
+
+void ScriptRunner::handleFinished(bool passed, int failures, bool aborted)
+{
+    m_running = false;
+    m_passed = passed;
+    m_aborted = aborted;
+    m_finishedNs = MonotonicClock::nowNs();
+
+    qDebug() << "[ScriptRunner]" << m_script.name << (passed ? "passed" : "failed")
+             << "-" << m_results.size() << "steps," << failures << "failure(s)";
+    emit finished(passed, failures);
+}
+
+// ============================================================================
+// RAPPORT
+// ============================================================================
+
+QJsonObject ScriptRunner::report() const
+{
+    QJsonArray steps;
+    int failures = 0;
+    int timed = 0;
+    qint64 minNs = 0;
+    qint64 maxNs = 0;
+    qint64 totalNs = 0;
+
+    for (const ScriptStepResult &result : m_results) {
+        steps.append(result.toJson());
+        if (!result.passed) {
+            failures++;
+        }
+
+        // Latences: seulement les étapes qui attendent le dispositif
+        const ScriptStep::Kind kind = m_script.steps.at(result.step).kind;
+        const bool waited = kind == ScriptStep::Wait
+            || (kind == ScriptStep::Send && m_script.steps.at(result.step).expectResponse);
+        if (waited && result.passed) {
+            minNs = timed == 0 ? result.latencyNs : qMin(minNs, result.latencyNs);
+            maxNs = qMax(maxNs, result.latencyNs);
+            totalNs += result.latencyNs;
+            timed++;
+        }
+    }
+
+    QJsonObject latency;
+    latency["count"] = timed;
+    latency["min_ms"] = minNs / 1e6;
+    latency["mean_ms"] = timed > 0 ? totalNs / 1e6 / timed : 0.0;
+    latency["max_ms"] = maxNs / 1e6;
+
+    QJsonObject json;
+    json["name"] = m_script.name;
+    json["passed"] = m_passed;
+    json["aborted"] = m_aborted;
+    json["failures"] = failures;
+    json["duration_ms"] = (m_finishedNs > m_startedNs ? m_finishedNs - m_startedNs : 0) / 1e6;
+    json["latency"] = latency;
+    json["steps"] = steps;
+    return json;
+}
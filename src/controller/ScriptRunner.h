@@ -0,0 +1,66 @@
+#ifndef SCRIPTRUNNER_H
+#define SCRIPTRUNNER_H
+
+#include <QObject>
+#include <QList>
+#include <QJsonObject>
+#include "ScriptEngine.h"
+
+class SerialManager;
+
+/**
+ * @brief Séquences de test de production (thread principal)
+ *
+ * Même architecture que TelemetryExporter:
+ * - ScriptRunner (thread principal) : chargement, suivi et rapport
+ * - ScriptEngine (thread du SerialWorker) : exécution et chronométrage
+ *
+ * Chaque étape terminée est relayée par stepFinished(); report() produit un
+ * rapport JSON (résultat par étape, latences min/moyenne/max des étapes
+ * avec réponse) exploitable par un banc de test.
+ */
+class ScriptRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ScriptRunner(SerialManager *serialManager, QObject *parent = nullptr);
+    ~ScriptRunner();
+
+    bool loadFile(const QString &fileName, QString *errorMessage = nullptr);
+    bool load(const QJsonObject &json, QString *errorMessage = nullptr);
+
+    const Script &script() const { return m_script; }
+    bool isRunning() const { return m_running; }
+    const QList<ScriptStepResult> &results() const { return m_results; }
+    QJsonObject report() const;
+
+public slots:
+    bool start();
+    void abort();
+
+signals:
+    void started(const QString &name);
+    void stepFinished(const ScriptStepResult &result);
+    void finished(bool passed, int failures);
+
+    // Signaux internes pour le moteur (queued connections)
+    void requestRun(const Script &script);
+    void requestAbort();
+
+private slots:
+    void handleStepFinished(const ScriptStepResult &result);
+    void handleFinished(bool passed, int failures, bool aborted);
+
+private:
+    ScriptEngine *m_engine;
+    Script m_script;
+    QList<ScriptStepResult> m_results;
+    bool m_running;
+    bool m_passed;
+    bool m_aborted;
+    qint64 m_startedNs;
+    qint64 m_finishedNs;
+};
+
+#endif // SCRIPTRUNNER_H
@@ -0,0 +1,348 @@
+#include "HeadlessRunner.h"
+#include "TelemetryShmLayout.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QDebug>
+
+#ifdef Q_OS_UNIX
+#include <QSocketNotifier>
+#include <csignal>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef Q_OS_UNIX
+// Self-pipe: [0] écrit par le handler de signal, [1] surveillé par Qt
+int s_signalFds[2] = { -1, -1 };
+
+void signalHandler(int)
+{
+    const char byte = 1;
+    const ssize_t written = ::write(s_signalFds[0], &byte, sizeof(byte));
+    Q_UNUSED(written);
+}
+#endif
+
+} // namespace
+
+HeadlessRunner::Options::Options()
+    : baudRate(115200)
+    , streamRateHz(0)
+    , heartbeatMs(0)
+    , reconnectMs(2000)
+    , sharedMemory(true)
+    , shmName(TelemetryShm::DefaultName)
+    , ipcServer(true)
+    , ipcName(TelemetryIpcServer::DefaultName)
+{
+    for (qint64 &interval : pollIntervalMs) {
+        interval = 0;
+    }
+}
+
+HeadlessRunner::HeadlessRunner(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_controller(new DeviceController(this))
+    , m_reconnectTimer(new QTimer(this))
+    , m_shuttingDown(false)
+    , m_scriptStarted(false)
+    , m_exitCode(0)
+{
+    connect(m_controller, &DeviceController::connectedChanged,
+            this, &HeadlessRunner::handleConnectionChanged);
+    connect(m_controller, &DeviceController::capabilitiesReceived,
+            this, &HeadlessRunner::handleCapabilities);
+    connect(m_controller, &DeviceController::deviceError,
+            this, &HeadlessRunner::handleDeviceError);
+
+    connect(m_controller, &DeviceController::alarmRaised, this, [](const AlarmEvent &event) {
+        qWarning().noquote() << "Alarm raised:" << event.ruleName << "value" << event.value;
+    });
+    connect(m_controller, &DeviceController::alarmCleared, this, [](const AlarmEvent &event) {
+        qInfo().noquote() << "Alarm cleared:" << event.ruleName;
+    });
+    connect(m_controller, &DeviceController::actuationConfirmed, this,
+            [](const QString &actuator, int value, qint64 latencyNs) {
+        qInfo().noquote() << "Actuation confirmed:" << actuator << "=" << value
+                          << "in" << QString::number(latencyNs / 1e6, 'f', 1) << "ms";
+    });
+    connect(m_controller, &DeviceController::actuationRolledBack, this,
+            [](const QString &actuator, int requested, int actual, const QString &reason) {
+        qWarning().noquote() << "Actuation rolled back:" << actuator << "requested" << requested
+                             << "actual" << actual << "(" + reason + ")";
+    });
+
+    connect(m_controller->scriptRunner(), &ScriptRunner::stepFinished, this, [](const ScriptStepResult &result) {
+        const QString line = QString("Step %1 [%2] %3 %4 ms %5")
+            .arg(result.step).arg(result.label).arg(result.passed ? "PASS" : "FAIL")
+            .arg(result.latencyNs / 1e6, 0, 'f', 3).arg(result.message);
+        if (result.passed) {
+            qInfo().noquote() << line;
+        } else {
+            qWarning().noquote() << line;
+        }
+    });
+    connect(m_controller->scriptRunner(), &ScriptRunner::finished,
+            this, &HeadlessRunner::handleScriptFinished);
+
+    connect(m_reconnectTimer, &QTimer::timeout,
+            this, &HeadlessRunner::handleReconnectTimeout);
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+#ifdef Q_OS_UNIX
+    if (s_signalFds[0] >= 0) {
+        ::close(s_signalFds[0]);
+        ::close(s_signalFds[1]);
+        s_signalFds[0] = s_signalFds[1] = -1;
+    }
+#endif
+}
+
+// ============================================================================
+// DÉMARRAGE
+// ============================================================================
+
+bool HeadlessRunner::start(QString *errorMessage)
+{
+    auto fail = [errorMessage](const QString &message) {
+        if (errorMessage) *errorMessage = message;
+        return false;
+    };
+
+    if (m_options.portName.isEmpty()) {
+        return fail("Aucun port série (--port)");
+    }
+
+    // Segment déjà tenu par une autre instance: le démon tourne sans
+    if (m_options.sharedMemory) {
+        QString error;
+        if (!m_controller->shmPublisher()->open(m_options.shmName, &error)) {
+            qWarning().noquote() << "Shared memory disabled:" << error;
+        }
+    }
+    if (m_options.ipcServer) {
+        QString error;
+        if (!m_controller->ipcServer()->listen(m_options.ipcName, &error)) {
+            qWarning().noquote() << "Local subscriptions disabled:" << error;
+        }
+    }
+
+    if (!m_options.rulesFile.isEmpty()) {
+        QFile file(m_options.rulesFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return fail(QString("Règles d'alarme illisibles: %1").arg(file.errorString()));
+        }
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+        if (!document.isArray()) {
+            return fail(QString("Règles d'alarme: tableau JSON attendu dans %1").arg(m_options.rulesFile));
+        }
+        const int count = m_controller->alarmEngine()->loadRules(document.array());
+        qInfo() << "Loaded" << count << "alarm rule(s)";
+    }
+
+    if (!m_options.scriptFile.isEmpty()) {
+        QString error;
+        if (!m_controller->scriptRunner()->loadFile(m_options.scriptFile, &error)) {
+            return fail(error);
+        }
+    }
+
+    for (int metric = 0; metric < PollScheduler::MetricCount; ++metric) {
+        m_controller->pollScheduler()->setInterval(PollScheduler::Metric(metric), m_options.pollIntervalMs[metric]);
+    }
+
+    if (!m_options.captureDirectory.isEmpty() && !m_controller->startCapture(m_options.captureDirectory)) {
+        return fail(QString("Capture impossible dans %1").arg(m_options.captureDirectory));
+    }
+
+    if (!m_options.recordFile.isEmpty()) {
+        m_controller->startRawRecording(m_options.recordFile);
+    }
+
+    qInfo().noquote() << "Connecting to" << m_options.portName << "@" << m_options.baudRate;
+    if (!m_controller->connectToDevice(m_options.portName, m_options.baudRate) && m_options.reconnectMs <= 0) {
+        return fail(QString("Ouverture de %1 impossible").arg(m_options.portName));
+    }
+
+    if (m_options.reconnectMs > 0) {
+        m_reconnectTimer->start(m_options.reconnectMs);
+    }
+
+    return true;
+}
+
+bool HeadlessRunner::installSignalHandlers()
+{
+#ifdef Q_OS_UNIX
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, s_signalFds) != 0) {
+        qWarning() << "socketpair failed, signals will not be handled";
+        return false;
+    }
+
+    QSocketNotifier *notifier = new QSocketNotifier(s_signalFds[1], QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, &HeadlessRunner::handleSignal);
+
+    struct sigaction action;
+    action.sa_handler = signalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+
+    for (int signal : { SIGTERM, SIGINT, SIGHUP }) {
+        if (::sigaction(signal, &action, nullptr) != 0) {
+            qWarning() << "sigaction failed for signal" << signal;
+            return false;
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ============================================================================
+// ARRÊT
+// ============================================================================
+
+void HeadlessRunner::handleSignal()
+{
+#ifdef Q_OS_UNIX
+    char byte;
+    const ssize_t received = ::read(s_signalFds[1], &byte, sizeof(byte));
+    Q_UNUSED(received);
+#endif
+
+    if (m_shuttingDown) {
+        // Second signal pendant l'export: sortie immédiate
+        qWarning() << "Second signal received, exiting without waiting";
+        m_controller->exporter()->cancel();
+        finish(1);
+        return;
+    }
+
+    qInfo() << "Termination signal received";
+    shutdown();
+}
+
+void HeadlessRunner::shutdown()
+{
+    if (m_shuttingDown) {
+        return;
+    }
+    m_shuttingDown = true;
+    m_reconnectTimer->stop();
+
+    // La capture reste attachée jusqu'à la fin de l'export (finish()):
+    // l'export lit l'historique complet depuis le stockage
+    m_controller->stopRawRecording();
+    m_controller->disconnectFromDevice();
+
+    if (m_options.exportFile.isEmpty()) {
+        finish(m_exitCode);
+        return;
+    }
+
+    // L'historique reste disponible après la fermeture du port
+    ExportRequest request;
+    request.fileName = m_options.exportFile;
+    const QString suffix = QFileInfo(m_options.exportFile).suffix().toLower();
+    request.format = (suffix == "bin" || suffix == "col") ? ExportRequest::BinaryColumnar : ExportRequest::Csv;
+
+    TelemetryExporter *exporter = m_controller->exporter();
+    connect(exporter, &TelemetryExporter::exportFinished, this, [this](const QString &fileName, qint64 samples) {
+        qInfo().noquote() << "Exported" << samples << "sample(s) to" << fileName;
+        finish(m_exitCode);
+    });
+    connect(exporter, &TelemetryExporter::exportFailed, this, [this](const QString &error) {
+        qWarning().noquote() << "Export failed:" << error;
+        finish(1);
+    });
+    connect(exporter, &TelemetryExporter::exportCanceled, this, [this]() {
+        finish(1);
+    });
+
+    if (!exporter->startExport(request)) {
+        qWarning() << "Export could not be started";
+        finish(1);
+    }
+}
+
+void HeadlessRunner::finish(int exitCode)
+{
+    m_controller->stopCapture();
+    qInfo() << "Shutdown complete";
+    QCoreApplication::exit(exitCode);
+}
+
+// ============================================================================
+// CONNEXION
+// ============================================================================
+
+void HeadlessRunner::handleConnectionChanged(bool connected)
+{
+    qInfo().noquote() << (connected ? "Connected to" : "Disconnected from") << m_options.portName;
+
+    if (connected && m_options.heartbeatMs > 0) {
+        m_controller->setHeartbeatInterval(m_options.heartbeatMs);
+    }
+}
+
+void HeadlessRunner::handleCapabilities(int channelCount)
+{
+    Q_UNUSED(channelCount);
+
+    // Les noms de canaux du flux ne sont connus qu'après CAPS
+    if (!m_options.streamChannels.isEmpty() && m_options.streamRateHz > 0 && !m_controller->isStreaming()) {
+        if (!m_controller->startStream(m_options.streamChannels, m_options.streamRateHz)) {
+            qWarning().noquote() << "Stream channels not advertised by firmware:"
+                                 << m_options.streamChannels.join(',');
+        }
+    }
+
+    if (!m_options.scriptFile.isEmpty() && !m_scriptStarted) {
+        m_scriptStarted = true;
+        qInfo().noquote() << "Running script" << m_controller->scriptRunner()->script().name;
+        m_controller->scriptRunner()->start();
+    }
+}
+
+void HeadlessRunner::handleScriptFinished(bool passed, int failures)
+{
+    qInfo().noquote() << "Script" << (passed ? "passed" : "failed") << "-" << failures << "failure(s)";
+
+    const QByteArray report = QJsonDocument(m_controller->scriptRunner()->report()).toJson();
+    if (m_options.reportFile.isEmpty()) {
+        QFile output;
+        if (output.open(stdout, QIODevice::WriteOnly)) {
+            output.write(report);
+        }
+    } else {
+        QFile file(m_options.reportFile);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(report) != report.size()) {
+            qWarning().noquote() << "Cannot write report" << m_options.reportFile << ":" << file.errorString();
+            passed = false;
+        }
+    }
+
+    m_exitCode = passed ? 0 : 3;
+    shutdown();
+}
+
+void HeadlessRunner::handleDeviceError(const QString &error)
+{
+    qWarning().noquote() << "Device error:" << error;
+}
+
+void HeadlessRunner::handleReconnectTimeout()
+{
+    if (!m_shuttingDown && !m_controller->isConnected()) {
+        m_controller->connectToDevice(m_options.portName, m_options.baudRate);
+    }
+}
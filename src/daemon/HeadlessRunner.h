@@ -0,0 +1,89 @@
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include "DeviceController.h"
+
+/**
+ * @brief Exécution sans interface graphique (mode démon)
+ *
+ * Pilote un DeviceController à partir des options de la ligne de commande,
+ * sous QCoreApplication: aucune dépendance à Qt Widgets ni à un affichage.
+ * - connexion au port série, reconnexion périodique si le port disparaît;
+ * - interrogation périodique par métrique (PollScheduler) et/ou flux STREAM;
+ * - capture longue durée, enregistrement brut, règles d'alarme;
+ * - mémoire partagée et serveur IPC actifs sauf option contraire;
+ * - export de l'historique à l'arrêt;
+ * - séquence de test exécutée après CAPS, rapport JSON puis arrêt avec un
+ *   code de sortie non nul si une étape échoue.
+ *
+ * SIGTERM, SIGINT et SIGHUP déclenchent shutdown(): arrêt du flux, de la
+ * capture et de l'enregistrement, fermeture du port, export éventuel, puis
+ * sortie de la boucle d'événements. Les signaux sont relayés par un
+ * « self-pipe » vers un QSocketNotifier: rien n'est fait dans le handler.
+ */
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        QString portName;
+        qint32 baudRate;
+        qint64 pollIntervalMs[PollScheduler::MetricCount];  // 0 = pas d'interrogation
+        QStringList streamChannels;
+        int streamRateHz;
+        quint32 heartbeatMs;          // 0 = valeur du firmware
+        QString captureDirectory;
+        QString recordFile;
+        QString rulesFile;
+        QString exportFile;           // Export à l'arrêt (.csv ou .bin)
+        QString scriptFile;           // Séquence de test, puis arrêt
+        QString reportFile;           // Rapport JSON du script (vide = sortie standard)
+        int reconnectMs;              // 0 = pas de reconnexion
+        bool sharedMemory;
+        QString shmName;              // Nom POSIX du segment ("/...")
+        bool ipcServer;
+        QString ipcName;              // Nom du QLocalServer
+
+        Options();
+    };
+
+    explicit HeadlessRunner(const Options &options, QObject *parent = nullptr);
+    ~HeadlessRunner();
+
+    // Prépare le contrôleur (mémoire partagée et serveur IPC seulement s'ils
+    // sont activés) et lance la connexion (false: option invalide)
+    bool start(QString *errorMessage = nullptr);
+
+    DeviceController *controller() const { return m_controller; }
+
+    // Relais SIGTERM/SIGINT/SIGHUP vers shutdown() (Unix)
+    bool installSignalHandlers();
+
+public slots:
+    void shutdown();
+
+private slots:
+    void handleConnectionChanged(bool connected);
+    void handleCapabilities(int channelCount);
+    void handleDeviceError(const QString &error);
+    void handleReconnectTimeout();
+    void handleSignal();
+    void handleScriptFinished(bool passed, int failures);
+
+private:
+    void finish(int exitCode);
+
+    Options m_options;
+    DeviceController *m_controller;
+    QTimer *m_reconnectTimer;
+    bool m_shuttingDown;
+    bool m_scriptStarted;
+    int m_exitCode;
+};
+
+#endif // HEADLESSRUNNER_H
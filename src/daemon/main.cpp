@@ -0,0 +1,156 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QDebug>
+#include "HeadlessRunner.h"
+#include "TelemetryShmLayout.h"
+
+namespace {
+
+// "status=1000" → métrique + période (ms)
+bool parsePollSpec(const QString &spec, HeadlessRunner::Options *options)
+{
+    const int separator = spec.indexOf('=');
+    if (separator <= 0) {
+        return false;
+    }
+
+    bool ok;
+    const qint64 intervalMs = spec.mid(separator + 1).toLongLong(&ok);
+    if (!ok || intervalMs < 0) {
+        return false;
+    }
+
+    const QString name = spec.left(separator).trimmed().toLower();
+    for (int metric = 0; metric < PollScheduler::MetricCount; ++metric) {
+        if (name == PollScheduler::metricToString(PollScheduler::Metric(metric))) {
+            options->pollIntervalMs[metric] = intervalMs;
+            return true;
+        }
+    }
+    return false;
+}
+
+// "temp,voltage@50" → canaux + fréquence (Hz)
+bool parseStreamSpec(const QString &spec, HeadlessRunner::Options *options)
+{
+    const int separator = spec.lastIndexOf('@');
+    if (separator <= 0) {
+        return false;
+    }
+
+    bool ok;
+    options->streamRateHz = spec.mid(separator + 1).toInt(&ok);
+    options->streamChannels = spec.left(separator).split(',', Qt::SkipEmptyParts);
+    return ok && options->streamRateHz > 0 && !options->streamChannels.isEmpty();
+}
+
+} // namespace
+
+/**
+ * @brief Point d'entrée du mode sans interface (démon)
+ *
+ * Même contrôleur que l'application graphique, sous QCoreApplication:
+ * @code
+ * STM32InterfaceDaemon --port /dev/ttyACM0 --poll status=1000 \
+ *     --stream temp,voltage@50 --capture /var/lib/stm32 --export /tmp/run.csv
+ * @endcode
+ * Les messages de debug sont masqués sauf avec --verbose.
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    app.setOrganizationName("IMT Atlantique");
+    app.setOrganizationDomain("imt-atlantique.fr");
+    app.setApplicationName("STM32 Interface Daemon");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Supervision STM32 sans interface graphique");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    const QCommandLineOption portOption({"p", "port"}, "Port série (ex: /dev/ttyACM0).", "name");
+    const QCommandLineOption baudOption({"b", "baud"}, "Débit en bauds.", "rate", "115200");
+    const QCommandLineOption pollOption("poll",
+        "Interrogation périodique: temperature|voltage|status=<ms> (répétable).", "metric=ms");
+    const QCommandLineOption streamOption("stream",
+        "Flux poussé par le dispositif: <canaux>@<Hz> (ex: temp,voltage@50).", "channels@rate");
+    const QCommandLineOption heartbeatOption("heartbeat", "Période du heartbeat firmware.", "ms");
+    const QCommandLineOption captureOption("capture", "Capture longue durée dans ce répertoire.", "dir");
+    const QCommandLineOption recordOption("record", "Enregistrement du flux série brut.", "file");
+    const QCommandLineOption rulesOption("rules", "Règles d'alarme (tableau JSON).", "file");
+    const QCommandLineOption exportOption("export", "Export de l'historique à l'arrêt (.csv ou .bin).", "file");
+    const QCommandLineOption scriptOption("script",
+        "Séquence de test (JSON) exécutée après connexion, puis arrêt (code 3 si échec).", "file");
+    const QCommandLineOption reportOption("report", "Rapport JSON du script (défaut: sortie standard).", "file");
+    const QCommandLineOption reconnectOption("reconnect",
+        "Période de reconnexion, 0 pour quitter si le port est absent.", "ms", "2000");
+    const QCommandLineOption noShmOption("no-shm", "Désactive la publication en mémoire partagée.");
+    const QCommandLineOption shmNameOption("shm-name", "Nom du segment de mémoire partagée.", "name",
+                                           TelemetryShm::DefaultName);
+    const QCommandLineOption noIpcOption("no-ipc", "Désactive le serveur d'abonnements local.");
+    const QCommandLineOption ipcNameOption("ipc-name", "Nom du serveur d'abonnements local.", "name",
+                                           TelemetryIpcServer::DefaultName);
+    const QCommandLineOption verboseOption({"v", "verbose"}, "Affiche les messages de debug.");
+
+    parser.addOptions({ portOption, baudOption, pollOption, streamOption, heartbeatOption,
+                        captureOption, recordOption, rulesOption, exportOption, scriptOption,
+                        reportOption, reconnectOption,
+                        noShmOption, shmNameOption, noIpcOption, ipcNameOption, verboseOption });
+    parser.process(app);
+
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("*.debug=false");
+    }
+
+    HeadlessRunner::Options options;
+    options.portName = parser.value(portOption);
+    options.captureDirectory = parser.value(captureOption);
+    options.recordFile = parser.value(recordOption);
+    options.rulesFile = parser.value(rulesOption);
+    options.exportFile = parser.value(exportOption);
+    options.scriptFile = parser.value(scriptOption);
+    options.reportFile = parser.value(reportOption);
+    options.sharedMemory = !parser.isSet(noShmOption);
+    options.shmName = parser.value(shmNameOption);
+    if (!options.shmName.startsWith('/')) {
+        options.shmName.prepend(QLatin1Char('/'));
+    }
+    options.ipcServer = !parser.isSet(noIpcOption);
+    options.ipcName = parser.value(ipcNameOption);
+
+    bool ok = true;
+    options.baudRate = parser.value(baudOption).toInt(&ok);
+    if (ok) options.reconnectMs = parser.value(reconnectOption).toInt(&ok);
+    if (ok && parser.isSet(heartbeatOption)) options.heartbeatMs = parser.value(heartbeatOption).toUInt(&ok);
+    if (!ok) {
+        qCritical() << "Invalid numeric option";
+        return 2;
+    }
+
+    for (const QString &spec : parser.values(pollOption)) {
+        if (!parsePollSpec(spec, &options)) {
+            qCritical().noquote() << "Invalid --poll value:" << spec;
+            return 2;
+        }
+    }
+
+    if (parser.isSet(streamOption) && !parseStreamSpec(parser.value(streamOption), &options)) {
+        qCritical().noquote() << "Invalid --stream value:" << parser.value(streamOption);
+        return 2;
+    }
+
+    HeadlessRunner runner(options);
+    runner.installSignalHandlers();
+
+    QString error;
+    if (!runner.start(&error)) {
+        qCritical().noquote() << error;
+        return 1;
+    }
+
+    qInfo() << "Daemon started, Qt" << QT_VERSION_STR;
+    return app.exec();
+}
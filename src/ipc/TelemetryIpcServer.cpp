@@ -0,0 +1,490 @@
+#include "TelemetryIpcServer.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QTimer>
+#include <QDebug>
+
+TelemetryIpcServer::TelemetryIpcServer(DeviceState *state, DataModel *model, QObject *parent)
+    : QObject(parent)
+    , m_state(state)
+    , m_model(model)
+    , m_snapshotVersion(0)
+{
+    m_server = new QLocalServer(this);
+    connect(m_server, &QLocalServer::newConnection, this, &TelemetryIpcServer::handleNewConnection);
+
+    // Encodage dans le thread producteur, sans file d'attente Qt
+    connect(m_model, &DataModel::sampleAdded, this, &TelemetryIpcServer::publishSample,
+            Qt::DirectConnection);
+    connect(m_state, &DeviceState::stateChanged, this, &TelemetryIpcServer::publishState,
+            Qt::DirectConnection);
+}
+
+TelemetryIpcServer::~TelemetryIpcServer()
+{
+    close();
+}
+
+// ============================================================================
+// SERVEUR
+// ============================================================================
+
+bool TelemetryIpcServer::listen(const QString &name, QString *errorMessage)
+{
+    close();
+
+    bool listening = m_server->listen(name);
+    if (!listening && m_server->serverError() == QAbstractSocket::AddressInUseError) {
+        // Nom pris: retiré seulement si aucun serveur n'y répond (arrêt brutal)
+        QLocalSocket probe;
+        probe.connectToServer(name);
+        if (probe.waitForConnected(ProbeTimeoutMs)) {
+            probe.abort();
+            const QString error = QString("%1 déjà servi par une autre instance").arg(name);
+            if (errorMessage) *errorMessage = error;
+            qDebug() << "[TelemetryIpcServer]" << error;
+            return false;
+        }
+
+        qDebug() << "[TelemetryIpcServer] Removing stale socket" << name;
+        QLocalServer::removeServer(name);
+        listening = m_server->listen(name);
+    }
+
+    if (!listening) {
+        if (errorMessage) *errorMessage = m_server->errorString();
+        qDebug() << "[TelemetryIpcServer] Cannot listen on" << name << ":" << m_server->errorString();
+        return false;
+    }
+
+    qDebug() << "[TelemetryIpcServer] Listening on" << m_server->fullServerName();
+    return true;
+}
+
+void TelemetryIpcServer::close()
+{
+    for (Subscriber *subscriber : qAsConst(m_subscribers)) {
+        subscriber->socket->disconnect(this);
+        subscriber->socket->abort();
+        subscriber->socket->deleteLater();
+        delete subscriber;
+    }
+
+    const bool hadSubscribers = !m_subscribers.isEmpty();
+    m_subscribers.clear();
+    m_server->close();
+
+    if (hadSubscribers) {
+        emit subscriberCountChanged(0);
+    }
+}
+
+bool TelemetryIpcServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+void TelemetryIpcServer::handleNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        Subscriber *subscriber = new Subscriber;
+        subscriber->socket = socket;
+        subscriber->allChannels = false;
+        subscriber->states = false;
+        subscriber->alarms = false;
+        subscriber->policy = ConflateToLatest;
+        subscriber->maxQueue = DefaultQueueSize;
+        subscriber->dropped = 0;
+        subscriber->stateResync = false;
+        subscriber->closing = false;
+        m_subscribers.insert(socket, subscriber);
+
+        connect(socket, &QLocalSocket::readyRead, this, [this, subscriber]() {
+            handleReadyRead(subscriber);
+        });
+        connect(socket, &QLocalSocket::bytesWritten, this, [this, subscriber]() {
+            drain(subscriber);
+        });
+        connect(socket, &QLocalSocket::disconnected, this, [this, subscriber]() {
+            handleDisconnected(subscriber);
+        });
+
+        qDebug() << "[TelemetryIpcServer] Subscriber connected (" << m_subscribers.size() << "total)";
+        emit subscriberCountChanged(m_subscribers.size());
+    }
+}
+
+void TelemetryIpcServer::handleDisconnected(Subscriber *subscriber)
+{
+    if (!m_subscribers.remove(subscriber->socket)) {
+        return;
+    }
+
+    qDebug() << "[TelemetryIpcServer] Subscriber disconnected," << subscriber->dropped << "frame(s) dropped";
+    subscriber->socket->deleteLater();
+    delete subscriber;
+    emit subscriberCountChanged(m_subscribers.size());
+}
+
+// ============================================================================
+// COMMANDES CLIENT
+// ============================================================================
+
+void TelemetryIpcServer::handleReadyRead(Subscriber *subscriber)
+{
+    subscriber->readBuffer.append(subscriber->socket->readAll());
+
+    int newline;
+    while ((newline = subscriber->readBuffer.indexOf('\n')) >= 0) {
+        const QByteArray line = subscriber->readBuffer.left(newline).trimmed();
+        subscriber->readBuffer.remove(0, newline + 1);
+
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !document.isObject()) {
+            QJsonObject reply;
+            reply["type"] = "error";
+            reply["message"] = "Commande JSON invalide";
+            sendDirect(subscriber, reply);
+            continue;
+        }
+
+        handleCommand(subscriber, document.object());
+    }
+
+    // Ligne sans fin démesurée: client défaillant
+    if (subscriber->readBuffer.size() > MaxCommandLength) {
+        qDebug() << "[TelemetryIpcServer] Command too long, disconnecting subscriber";
+        subscriber->socket->abort();
+    }
+}
+
+void TelemetryIpcServer::handleCommand(Subscriber *subscriber, const QJsonObject &command)
+{
+    const QString cmd = command["cmd"].toString().toUpper();
+    QJsonObject reply;
+
+    if (cmd == "SUBSCRIBE") {
+        subscriber->allChannels = false;
+        subscriber->channels.clear();
+
+        QJsonArray accepted;
+        for (const QJsonValue &value : command["channels"].toArray()) {
+            const QString name = value.toString();
+            if (name == "*") {
+                subscriber->allChannels = true;
+                accepted.append(name);
+                continue;
+            }
+            const int id = m_model->channelIdForName(name);
+            if (id >= 0) {
+                subscriber->channels.insert(static_cast<quint16>(id));
+                accepted.append(name);
+            }
+        }
+
+        subscriber->states = false;
+        subscriber->alarms = false;
+        for (const QJsonValue &value : command["events"].toArray()) {
+            if (value.toString() == "state") subscriber->states = true;
+            if (value.toString() == "alarm") subscriber->alarms = true;
+        }
+
+        if (command.contains("policy")) {
+            bool ok;
+            const SlowConsumerPolicy policy = policyFromString(command["policy"].toString(), &ok);
+            if (ok) subscriber->policy = policy;
+        }
+        if (command.contains("queue")) {
+            subscriber->maxQueue = qBound(1, command["queue"].toInt(DefaultQueueSize), int(MaxQueueSize));
+        }
+
+        reply["type"] = "subscribed";
+        reply["channels"] = accepted;
+        reply["policy"] = policyToString(subscriber->policy);
+        reply["queue"] = subscriber->maxQueue;
+        sendDirect(subscriber, reply);
+
+        // État complet à l'abonnement: les trames suivantes sont des deltas.
+        // Passe par la file, derrière les échantillons déjà en attente; les
+        // deltas d'état plus anciens qu'elle contient sont périmés
+        subscriber->stateResync = false;
+        removePending(subscriber, StateKey);
+        if (subscriber->states) {
+            enqueue(subscriber, Frame{ StateKey, stateSnapshotFrame() });
+        }
+    } else if (cmd == "UNSUBSCRIBE") {
+        subscriber->allChannels = false;
+        subscriber->channels.clear();
+        subscriber->states = false;
+        subscriber->alarms = false;
+        subscriber->stateResync = false;
+        subscriber->queue.clear();
+        reply["type"] = "unsubscribed";
+        sendDirect(subscriber, reply);
+    } else if (cmd == "LIST") {
+        QJsonArray channels;
+        for (quint16 id : m_model->channelIds()) {
+            channels.append(m_model->channelInfo(id).toJson());
+        }
+        reply["type"] = "channels";
+        reply["channels"] = channels;
+        sendDirect(subscriber, reply);
+    } else {
+        reply["type"] = "error";
+        reply["message"] = QString("Commande inconnue: %1").arg(cmd);
+        sendDirect(subscriber, reply);
+    }
+}
+
+// ============================================================================
+// PUBLICATION
+// ============================================================================
+
+QByteArray TelemetryIpcServer::encode(const QJsonObject &message)
+{
+    QByteArray data = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    data.append('\n');
+    return data;
+}
+
+void TelemetryIpcServer::publishSample(quint16 channelId, const DataModel::DataPoint &point)
+{
+    if (m_subscribers.isEmpty()) {
+        return;
+    }
+
+    Frame frame;
+    frame.key = channelId;
+
+    for (Subscriber *subscriber : qAsConst(m_subscribers)) {
+        if (!subscriber->allChannels && !subscriber->channels.contains(channelId)) {
+            continue;
+        }
+
+        // Encodée au premier abonné intéressé, partagée ensuite
+        if (frame.data.isEmpty()) {
+            QJsonObject message;
+            message["type"] = "sample";
+            message["channel"] = m_model->channelInfo(channelId).name;
+            message["id"] = channelId;
+            message["t"] = point.timestampNs;
+            message["v"] = point.value;
+            frame.data = encode(message);
+        }
+        enqueue(subscriber, frame);
+    }
+}
+
+void TelemetryIpcServer::publishState(DeviceState::Fields fields)
+{
+    Q_UNUSED(fields)
+
+    if (m_subscribers.isEmpty()) {
+        return;
+    }
+
+    Frame frame;
+    frame.key = StateKey;
+
+    for (Subscriber *subscriber : qAsConst(m_subscribers)) {
+        if (!subscriber->states) {
+            continue;
+        }
+
+        if (frame.data.isEmpty()) {
+            const QList<DeviceState::Change> changes = m_state->changesSince(m_state->version() - 1);
+            if (changes.isEmpty()) {
+                return;
+            }
+            QJsonObject message;
+            message["type"] = "state";
+            message["version"] = static_cast<qint64>(changes.last().version);
+            message["values"] = changes.last().values;
+            frame.data = encode(message);
+        }
+        enqueue(subscriber, frame);
+    }
+}
+
+void TelemetryIpcServer::publishAlarm(const AlarmEvent &event)
+{
+    if (m_subscribers.isEmpty()) {
+        return;
+    }
+
+    Frame frame;
+    frame.key = NoKey;  // Jamais fusionnée: chaque levée/retombée compte
+
+    for (Subscriber *subscriber : qAsConst(m_subscribers)) {
+        if (!subscriber->alarms) {
+            continue;
+        }
+
+        if (frame.data.isEmpty()) {
+            QJsonObject message;
+            message["type"] = "alarm";
+            message["rule"] = event.ruleName;
+            message["kind"] = AlarmRule::kindToString(event.kind);
+            message["severity"] = event.severity == AlarmRule::Critical ? "critical" : "warning";
+            message["active"] = event.active;
+            message["channel"] = event.channelId;
+            message["value"] = event.value;
+            message["t"] = event.sampleTimestampNs;
+            frame.data = encode(message);
+        }
+        enqueue(subscriber, frame);
+    }
+}
+
+// ============================================================================
+// FILES PAR ABONNÉ
+// ============================================================================
+
+void TelemetryIpcServer::enqueue(Subscriber *subscriber, const Frame &frame)
+{
+    if (subscriber->closing) {
+        return;
+    }
+
+    if (subscriber->queue.size() >= subscriber->maxQueue) {
+        switch (subscriber->policy) {
+            case DropNewest:
+                loseFrame(subscriber, frame);
+                return;
+
+            case ConflateToLatest: {
+                // Les trames en attente de même clé sont retirées et la plus
+                // récente prend la queue: l'ordre d'émission est conservé
+                const int removed = frame.key != NoKey ? removePending(subscriber, frame.key) : 0;
+                if (removed > 0) {
+                    subscriber->dropped += removed;
+                    if (frame.key == StateKey) {
+                        // Deux deltas d'état ne se remplacent pas: état complet
+                        subscriber->queue.enqueue(Frame{ StateKey, stateSnapshotFrame() });
+                        drain(subscriber);
+                        return;
+                    }
+                } else {
+                    loseFrame(subscriber, subscriber->queue.dequeue());
+                }
+                break;
+            }
+
+            case Disconnect:
+                // Différé: la publication parcourt encore la liste des abonnés
+                if (!subscriber->closing) {
+                    qDebug() << "[TelemetryIpcServer] Slow subscriber disconnected (queue full)";
+                    subscriber->closing = true;
+                    subscriber->queue.clear();
+                    QLocalSocket *socket = subscriber->socket;
+                    QTimer::singleShot(0, socket, [socket]() { socket->abort(); });
+                }
+                return;
+        }
+    }
+
+    subscriber->queue.enqueue(frame);
+    drain(subscriber);
+}
+
+int TelemetryIpcServer::removePending(Subscriber *subscriber, quint32 key)
+{
+    int removed = 0;
+    for (auto it = subscriber->queue.begin(); it != subscriber->queue.end();) {
+        if (it->key == key) {
+            it = subscriber->queue.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+void TelemetryIpcServer::drain(Subscriber *subscriber)
+{
+    QLocalSocket *socket = subscriber->socket;
+    if (subscriber->closing || socket->state() != QLocalSocket::ConnectedState) {
+        return;
+    }
+
+    // Le tampon du socket reste borné: le surplus attend dans la file
+    while (!subscriber->queue.isEmpty() && socket->bytesToWrite() < SocketHighWaterMark) {
+        socket->write(subscriber->queue.dequeue().data);
+    }
+
+    // Delta d'état perdu: l'état complet prend la première place libre,
+    // après les deltas plus anciens encore en file
+    if (subscriber->stateResync && subscriber->queue.size() < subscriber->maxQueue) {
+        subscriber->stateResync = false;
+        subscriber->queue.enqueue(Frame{ StateKey, stateSnapshotFrame() });
+        while (!subscriber->queue.isEmpty() && socket->bytesToWrite() < SocketHighWaterMark) {
+            socket->write(subscriber->queue.dequeue().data);
+        }
+    }
+}
+
+void TelemetryIpcServer::loseFrame(Subscriber *subscriber, const Frame &frame)
+{
+    subscriber->dropped++;
+    if (frame.key == StateKey) {
+        subscriber->stateResync = true;
+    }
+}
+
+QByteArray TelemetryIpcServer::stateSnapshotFrame()
+{
+    // Encodé une fois par version, partagé entre abonnés
+    quint64 version;
+    const QJsonObject values = m_state->snapshot(&version);
+    if (m_snapshotFrame.isEmpty() || version != m_snapshotVersion) {
+        QJsonObject message;
+        message["type"] = "state";
+        message["version"] = static_cast<qint64>(version);
+        message["full"] = true;
+        message["values"] = values;
+        m_snapshotFrame = encode(message);
+        m_snapshotVersion = version;
+    }
+    return m_snapshotFrame;
+}
+
+void TelemetryIpcServer::sendDirect(Subscriber *subscriber, const QJsonObject &message)
+{
+    // Réponses de contrôle: hors file, jamais supprimées
+    subscriber->socket->write(encode(message));
+}
+
+// ============================================================================
+// UTILITAIRES
+// ============================================================================
+
+QString TelemetryIpcServer::policyToString(SlowConsumerPolicy policy)
+{
+    switch (policy) {
+        case DropNewest: return "drop";
+        case ConflateToLatest: return "conflate";
+        case Disconnect: return "disconnect";
+        default: return "conflate";
+    }
+}
+
+TelemetryIpcServer::SlowConsumerPolicy TelemetryIpcServer::policyFromString(const QString &policy, bool *ok)
+{
+    const QString value = policy.toLower();
+    if (ok) *ok = true;
+
+    if (value == "drop") return DropNewest;
+    if (value == "conflate") return ConflateToLatest;
+    if (value == "disconnect") return Disconnect;
+
+    if (ok) *ok = false;
+    return ConflateToLatest;
+}
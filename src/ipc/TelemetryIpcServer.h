@@ -0,0 +1,145 @@
+#ifndef TELEMETRYIPCSERVER_H
+#define TELEMETRYIPCSERVER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QQueue>
+#include <QJsonObject>
+#include "DeviceState.h"
+#include "DataModel.h"
+#include "AlarmEngine.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * @brief Serveur de diffusion locale de la télémétrie (QLocalServer)
+ *
+ * Protocole en lignes JSON, comme la liaison série. Le client s'abonne:
+ * @code
+ * {"cmd":"SUBSCRIBE","channels":["temp","voltage"],"events":["state","alarm"],
+ *  "policy":"conflate","queue":256}
+ * {"cmd":"LIST"}            → {"type":"channels","channels":[...]}
+ * {"cmd":"UNSUBSCRIBE"}
+ * @endcode
+ * puis reçoit:
+ * @code
+ * {"type":"sample","channel":"temp","id":0,"t":1700000000000000000,"v":23.5}
+ * {"type":"state","version":42,"values":{"temperature":23.5}}
+ * {"type":"state","version":57,"full":true,"values":{...}}
+ * {"type":"alarm","rule":"surchauffe","active":true,...}
+ * @endcode
+ * "channels":["*"] abonne à tous les canaux.
+ *
+ * Chaque trame est encodée une seule fois puis partagée (QByteArray à
+ * partage implicite) entre les files des abonnés concernés. Chaque abonné
+ * a sa file bornée; on n'écrit sur son socket que tant que moins de
+ * SocketHighWaterMark octets y sont en attente. Quand la file est pleine,
+ * la politique de l'abonné s'applique:
+ * - Drop: la nouvelle trame est ignorée (comptée);
+ * - Conflate: les trames en attente de même clé (canal, état) sont retirées
+ *   et la plus récente est ajoutée en queue, sinon la plus ancienne est
+ *   évincée;
+ * - Disconnect: le client est déconnecté.
+ *
+ * Les trames d'état sont des deltas (champs modifiés par le commit): elles
+ * ne sont jamais perdues silencieusement. L'état complet envoyé à
+ * l'abonnement passe par la file, qu'il purge des deltas plus anciens. Une trame d'état fusionnée est
+ * remplacée par l'état complet ("full":true); une trame d'état supprimée
+ * ou évincée déclenche l'envoi de l'état complet dès que la file de
+ * l'abonné a de la place.
+ *
+ * listen() ne retire un socket existant que si aucun serveur n'y répond
+ * (instance arrêtée brutalement): une autre instance vivante le garde.
+ * La publication ne bloque donc jamais le producteur: un encodage plus une
+ * insertion par abonné, quel que soit le débit des clients.
+ */
+class TelemetryIpcServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum SlowConsumerPolicy {
+        DropNewest,
+        ConflateToLatest,
+        Disconnect
+    };
+
+    static constexpr const char *DefaultName = "stm32_interface_telemetry";
+    static const int DefaultQueueSize = 256;
+    static const int MaxQueueSize = 65536;
+    static const qint64 SocketHighWaterMark = 64 * 1024;
+    static const int MaxCommandLength = 4096;
+    static const int ProbeTimeoutMs = 200;   // Test d'un serveur existant
+
+    TelemetryIpcServer(DeviceState *state, DataModel *model, QObject *parent = nullptr);
+    ~TelemetryIpcServer();
+
+    bool listen(const QString &name, QString *errorMessage = nullptr);
+    void close();
+    bool isListening() const;
+    int subscriberCount() const { return m_subscribers.size(); }
+
+    static QString policyToString(SlowConsumerPolicy policy);
+    static SlowConsumerPolicy policyFromString(const QString &policy, bool *ok = nullptr);
+
+public slots:
+    void publishAlarm(const AlarmEvent &event);
+
+signals:
+    void subscriberCountChanged(int count);
+
+private slots:
+    void handleNewConnection();
+    void publishSample(quint16 channelId, const DataModel::DataPoint &point);
+    void publishState(DeviceState::Fields fields);
+
+private:
+    // Clés de conflation (canal = son identifiant)
+    static const quint32 StateKey = 0x10000;
+    static const quint32 NoKey = 0xFFFFFFFF;
+
+    struct Frame {
+        quint32 key;
+        QByteArray data;   // Partagé entre abonnés
+    };
+
+    struct Subscriber {
+        QLocalSocket *socket;
+        QByteArray readBuffer;
+        bool allChannels;
+        QSet<quint16> channels;
+        bool states;
+        bool alarms;
+        SlowConsumerPolicy policy;
+        int maxQueue;
+        QQueue<Frame> queue;
+        quint64 dropped;
+        bool stateResync;  // Delta d'état perdu: état complet à renvoyer
+        bool closing;      // Déconnexion demandée (politique Disconnect)
+    };
+
+    void handleReadyRead(Subscriber *subscriber);
+    void handleCommand(Subscriber *subscriber, const QJsonObject &command);
+    void handleDisconnected(Subscriber *subscriber);
+    void enqueue(Subscriber *subscriber, const Frame &frame);
+    int removePending(Subscriber *subscriber, quint32 key);
+    void drain(Subscriber *subscriber);
+    void sendDirect(Subscriber *subscriber, const QJsonObject &message);
+    void loseFrame(Subscriber *subscriber, const Frame &frame);
+    QByteArray stateSnapshotFrame();
+    static QByteArray encode(const QJsonObject &message);
+
+    DeviceState *m_state;
+    DataModel *m_model;
+    QLocalServer *m_server;
+    QHash<QLocalSocket *, Subscriber *> m_subscribers;
+
+    QByteArray m_snapshotFrame;   // État complet encodé, à m_snapshotVersion
+    quint64 m_snapshotVersion;
+};
+
+#endif // TELEMETRYIPCSERVER_H
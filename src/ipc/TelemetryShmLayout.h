@@ -0,0 +1,105 @@
+#ifndef TELEMETRYSHMLAYOUT_H
+#define TELEMETRYSHMLAYOUT_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Format du segment de mémoire partagée de télémétrie
+ *
+ * Partagé par l'écrivain (TelemetryShmPublisher, dans l'application) et par
+ * la bibliothèque de lecture (TelemetryShmReader): C++ standard uniquement,
+ * sans Qt.
+ *
+ * Un seul écrivain. Les lecteurs mappent le segment en lecture seule et ne
+ * prennent aucun verrou:
+ * - l'état du dispositif et chaque descripteur de canal sont protégés par un
+ *   seqlock (compteur impair = écriture en cours, relecture si changé);
+ * - chaque canal possède un anneau de RingSize échantillons et un index
+ *   d'écriture croissant. L'écrivain annonce une case (claimIndex) avant de
+ *   l'écrire et la publie ensuite (writeIndex); le lecteur relit claimIndex
+ *   après copie pour écarter les échantillons recouverts entre-temps.
+ *
+ * Le champ magic est écrit en dernier à l'initialisation: un lecteur qui
+ * voit Magic voit un segment complet.
+ */
+namespace TelemetryShm {
+
+const char DefaultName[] = "/stm32_interface_telemetry";
+
+const uint32_t Magic = 0x544D5453;   // "STMT"
+const uint32_t LayoutVersion = 1;
+
+const int MaxChannels = 32;
+const int RingSize = 1024;           // Puissance de 2
+const int NameSize = 24;
+const int UnitSize = 8;
+const int FirmwareVersionSize = 32;
+
+// Essais de lecture d'un seqlock avant d'abandonner (lecteur sans attente)
+const int MaxReadAttempts = 64;
+
+struct StatePayload {
+    uint64_t version;            // DeviceState::version()
+    int64_t lastUpdateNs;        // MonotonicClock (ns depuis l'epoch)
+    float temperature;
+    float voltage;
+    uint32_t uptime;
+    uint32_t rxCharCount;
+    uint16_t adcRaw;
+    uint8_t pwmDutyCycle;
+    uint8_t ledState;
+    uint8_t connected;
+    uint8_t reserved[3];
+    char firmwareVersion[FirmwareVersionSize];
+};
+
+struct StateBlock {
+    std::atomic<uint32_t> sequence;
+    uint32_t reserved;
+    StatePayload payload;
+};
+
+struct ChannelDescriptor {
+    uint16_t id;
+    uint8_t active;
+    uint8_t reserved;
+    char name[NameSize];
+    char unit[UnitSize];
+};
+
+struct Sample {
+    int64_t timestampNs;
+    double value;                // Valeur physique
+};
+
+struct ChannelRing {
+    std::atomic<uint32_t> descriptorSequence;
+    uint32_t reserved;
+    ChannelDescriptor descriptor;
+    std::atomic<uint64_t> claimIndex;   // Échantillons écrits ou en cours d'écriture
+    std::atomic<uint64_t> writeIndex;   // Échantillons écrits (publiés)
+    Sample samples[RingSize];
+};
+
+struct Header {
+    std::atomic<uint32_t> magic;
+    uint32_t layoutVersion;
+    uint32_t maxChannels;
+    uint32_t ringSize;
+    int64_t writerPid;
+    std::atomic<int64_t> heartbeatNs;   // Rafraîchi périodiquement par l'écrivain
+    std::atomic<uint32_t> channelCount;
+    uint32_t reserved;
+    StateBlock state;
+    ChannelRing channels[MaxChannels];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "atomique 32 bits requis");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "atomique 64 bits requis");
+static_assert(std::atomic<int64_t>::is_always_lock_free, "atomique 64 bits requis");
+static_assert((RingSize & (RingSize - 1)) == 0, "RingSize doit être une puissance de 2");
+
+} // namespace TelemetryShm
+
+#endif // TELEMETRYSHMLAYOUT_H
@@ -0,0 +1,296 @@
+#include "TelemetryShmPublisher.h"
+#include "TelemetryShmLayout.h"
+#include "MonotonicClock.h"
+#include <QTimer>
+#include <QDebug>
+#include <cstring>
+#include <new>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace {
+
+void copyName(char *dst, int size, const QString &text)
+{
+    const QByteArray utf8 = text.toUtf8();
+    const int length = qMin(utf8.size(), size - 1);
+    std::memcpy(dst, utf8.constData(), length);
+    std::memset(dst + length, 0, size - length);
+}
+
+// Ouverture / fermeture d'un seqlock côté écrivain
+void beginWrite(std::atomic<uint32_t> &sequence)
+{
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void endWrite(std::atomic<uint32_t> &sequence)
+{
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+#ifdef Q_OS_UNIX
+// Segment existant encore tenu par son écrivain: processus présent et
+// heartbeat récent (ou initialisation en cours, magic pas encore publié)
+bool segmentOwnerAlive(const char *path, qint64 staleAfterNs, qint64 *ownerPid)
+{
+    const int fd = shm_open(path, O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool alive = false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size >= off_t(sizeof(TelemetryShm::Header))) {
+        void *memory = mmap(nullptr, sizeof(TelemetryShm::Header), PROT_READ, MAP_SHARED, fd, 0);
+        if (memory != MAP_FAILED) {
+            const TelemetryShm::Header *header = static_cast<const TelemetryShm::Header *>(memory);
+            const qint64 pid = header->writerPid;
+            const bool running = pid > 0 && (kill(pid_t(pid), 0) == 0 || errno == EPERM);
+            if (running) {
+                const qint64 heartbeat = header->heartbeatNs.load(std::memory_order_acquire);
+                alive = header->magic.load(std::memory_order_acquire) != TelemetryShm::Magic
+                        || (heartbeat != 0 && MonotonicClock::nowNs() - heartbeat < staleAfterNs);
+            }
+            *ownerPid = pid;
+            munmap(memory, sizeof(TelemetryShm::Header));
+        }
+    }
+    ::close(fd);
+    return alive;
+}
+#endif
+
+} // namespace
+
+TelemetryShmPublisher::TelemetryShmPublisher(DeviceState *state, DataModel *model, QObject *parent)
+    : QObject(parent)
+    , m_state(state)
+    , m_model(model)
+    , m_header(nullptr)
+    , m_fd(-1)
+{
+    m_heartbeatTimer = new QTimer(this);
+    m_heartbeatTimer->setInterval(HeartbeatIntervalMs);
+    connect(m_heartbeatTimer, &QTimer::timeout, this, &TelemetryShmPublisher::publishHeartbeat);
+
+    // Écriture synchrone, dans le thread qui met à jour le modèle
+    connect(m_state, &DeviceState::stateChanged, this, &TelemetryShmPublisher::publishState,
+            Qt::DirectConnection);
+    connect(m_model, &DataModel::channelRegistered, this, &TelemetryShmPublisher::publishChannel,
+            Qt::DirectConnection);
+    connect(m_model, &DataModel::sampleAdded, this, &TelemetryShmPublisher::publishSample,
+            Qt::DirectConnection);
+}
+
+TelemetryShmPublisher::~TelemetryShmPublisher()
+{
+    close();
+}
+
+// ============================================================================
+// SEGMENT
+// ============================================================================
+
+bool TelemetryShmPublisher::open(const QString &name, QString *errorMessage)
+{
+    close();
+
+#ifdef Q_OS_UNIX
+    const QByteArray path = name.toUtf8();
+    const size_t size = sizeof(TelemetryShm::Header);
+
+    int fd = shm_open(path.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        qint64 ownerPid = 0;
+        if (segmentOwnerAlive(path.constData(), qint64(StaleAfterMs) * MonotonicClock::NsPerMs, &ownerPid)) {
+            const QString error = QString("Segment %1 déjà publié par le processus %2").arg(name).arg(ownerPid);
+            if (errorMessage) *errorMessage = error;
+            qDebug() << "[TelemetryShmPublisher]" << error;
+            return false;
+        }
+
+        // Segment d'une instance arrêtée brutalement: recréé proprement
+        qDebug() << "[TelemetryShmPublisher] Removing stale segment" << name << "of pid" << ownerPid;
+        shm_unlink(path.constData());
+        fd = shm_open(path.constData(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) {
+        const QString error = QString("shm_open(%1): %2").arg(name, QString::fromLocal8Bit(strerror(errno)));
+        if (errorMessage) *errorMessage = error;
+        qDebug() << "[TelemetryShmPublisher]" << error;
+        return false;
+    }
+
+    void *memory = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    const int mapError = errno;
+
+    if (memory == MAP_FAILED) {
+        ::close(fd);
+        shm_unlink(path.constData());
+        const QString error = QString("mmap(%1): %2").arg(name, QString::fromLocal8Bit(strerror(mapError)));
+        if (errorMessage) *errorMessage = error;
+        qDebug() << "[TelemetryShmPublisher]" << error;
+        return false;
+    }
+
+    // Le segment neuf est à zéro; les atomiques sont construits en place
+    m_fd = fd;
+    m_header = new (memory) TelemetryShm::Header;
+    m_header->layoutVersion = TelemetryShm::LayoutVersion;
+    m_header->maxChannels = TelemetryShm::MaxChannels;
+    m_header->ringSize = TelemetryShm::RingSize;
+    m_header->writerPid = getpid();
+    m_header->heartbeatNs.store(MonotonicClock::nowNs(), std::memory_order_relaxed);
+    m_header->channelCount.store(0, std::memory_order_relaxed);
+    m_name = name;
+
+    for (quint16 id : m_model->channelIds()) {
+        publishChannel(m_model->channelInfo(id));
+    }
+    publishState();
+
+    // Publié en dernier: un lecteur qui voit Magic voit un segment complet
+    m_header->magic.store(TelemetryShm::Magic, std::memory_order_release);
+
+    m_heartbeatTimer->start();
+    qDebug() << "[TelemetryShmPublisher] Publishing to" << name << "(" << size << "bytes)";
+    return true;
+#else
+    const QString error = QString("Mémoire partagée POSIX indisponible sur cette plateforme");
+    if (errorMessage) *errorMessage = error;
+    qDebug() << "[TelemetryShmPublisher]" << error << name;
+    return false;
+#endif
+}
+
+void TelemetryShmPublisher::close()
+{
+    if (!m_header) {
+        return;
+    }
+
+    m_heartbeatTimer->stop();
+
+#ifdef Q_OS_UNIX
+    // Les lecteurs encore attachés gardent leur mapping jusqu'à leur propre fermeture
+    m_header->heartbeatNs.store(0, std::memory_order_release);
+    munmap(m_header, sizeof(TelemetryShm::Header));
+
+    // Le nom n'est retiré que s'il désigne encore ce segment
+    const QByteArray path = m_name.toUtf8();
+    const int current = shm_open(path.constData(), O_RDONLY, 0);
+    if (current >= 0) {
+        struct stat mine;
+        struct stat named;
+        if (fstat(m_fd, &mine) == 0 && fstat(current, &named) == 0
+                && mine.st_dev == named.st_dev && mine.st_ino == named.st_ino) {
+            shm_unlink(path.constData());
+        }
+        ::close(current);
+    }
+    ::close(m_fd);
+    m_fd = -1;
+#endif
+
+    m_header = nullptr;
+    m_slots.clear();
+    qDebug() << "[TelemetryShmPublisher] Closed" << m_name;
+}
+
+// ============================================================================
+// PUBLICATION
+// ============================================================================
+
+void TelemetryShmPublisher::publishState()
+{
+    if (!m_header) {
+        return;
+    }
+
+    TelemetryShm::StateBlock &block = m_header->state;
+    TelemetryShm::StatePayload &payload = block.payload;
+
+    beginWrite(block.sequence);
+    payload.version = m_state->version();
+    payload.lastUpdateNs = m_state->lastUpdateNs();
+    payload.temperature = m_state->temperature();
+    payload.voltage = m_state->voltage();
+    payload.uptime = m_state->uptime();
+    payload.rxCharCount = m_state->rxCharCount();
+    payload.adcRaw = m_state->adcRaw();
+    payload.pwmDutyCycle = m_state->pwmDutyCycle();
+    payload.ledState = m_state->ledState() ? 1 : 0;
+    payload.connected = m_state->isConnected() ? 1 : 0;
+    copyName(payload.firmwareVersion, TelemetryShm::FirmwareVersionSize, m_state->firmwareVersion());
+    endWrite(block.sequence);
+}
+
+void TelemetryShmPublisher::publishHeartbeat()
+{
+    if (m_header) {
+        m_header->heartbeatNs.store(MonotonicClock::nowNs(), std::memory_order_release);
+    }
+}
+
+void TelemetryShmPublisher::publishChannel(const ChannelInfo &info)
+{
+    if (!m_header) {
+        return;
+    }
+
+    int slot = m_slots.value(info.id, -1);
+    if (slot < 0) {
+        slot = m_slots.size();
+        if (slot >= TelemetryShm::MaxChannels) {
+            qDebug() << "[TelemetryShmPublisher] No ring left for channel" << info.name;
+            return;
+        }
+        m_slots.insert(info.id, slot);
+    }
+
+    TelemetryShm::ChannelRing &ring = m_header->channels[slot];
+    beginWrite(ring.descriptorSequence);
+    ring.descriptor.id = info.id;
+    ring.descriptor.active = 1;
+    copyName(ring.descriptor.name, TelemetryShm::NameSize, info.name);
+    copyName(ring.descriptor.unit, TelemetryShm::UnitSize, info.unit);
+    endWrite(ring.descriptorSequence);
+
+    m_header->channelCount.store(static_cast<uint32_t>(m_slots.size()), std::memory_order_release);
+}
+
+void TelemetryShmPublisher::publishSample(quint16 channelId, const DataModel::DataPoint &point)
+{
+    if (!m_header) {
+        return;
+    }
+
+    const int slot = m_slots.value(channelId, -1);
+    if (slot < 0) {
+        return;
+    }
+
+    // Annonce (la case recouvre l'échantillon index - RingSize), écriture,
+    // puis publication: un lecteur qui voit writeIndex voit l'échantillon
+    TelemetryShm::ChannelRing &ring = m_header->channels[slot];
+    const uint64_t index = ring.writeIndex.load(std::memory_order_relaxed);
+    ring.claimIndex.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    TelemetryShm::Sample &sample = ring.samples[index & (TelemetryShm::RingSize - 1)];
+    sample.timestampNs = point.timestampNs;
+    sample.value = point.value;
+    ring.writeIndex.store(index + 1, std::memory_order_release);
+}
@@ -0,0 +1,71 @@
+#ifndef TELEMETRYSHMPUBLISHER_H
+#define TELEMETRYSHMPUBLISHER_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include "DeviceState.h"
+#include "DataModel.h"
+
+class QTimer;
+
+namespace TelemetryShm {
+struct Header;
+}
+
+/**
+ * @brief Publie l'état et les derniers échantillons en mémoire partagée POSIX
+ *
+ * Écrivain unique du segment décrit par TelemetryShmLayout.h: l'état du
+ * DeviceState (seqlock) à chaque notification groupée, et chaque
+ * échantillon du DataModel dans l'anneau de son canal. Les connexions sont
+ * directes: la publication se fait dans le thread qui décode les trames,
+ * sans file d'attente.
+ *
+ * Les lecteurs (TelemetryShmReader, autres processus) ne prennent aucun
+ * verrou et ne peuvent pas ralentir l'écrivain: le segment leur est ouvert
+ * en lecture seule. Un heartbeat est rafraîchi toutes les HeartbeatIntervalMs
+ * pour qu'ils détectent l'arrêt de l'application.
+ *
+ * Un seul écrivain par nom: open() échoue si le segment existe et que son
+ * écrivain est vivant (processus présent, heartbeat de moins de
+ * StaleAfterMs). Seul un segment abandonné (arrêt brutal) est remplacé, et
+ * close() ne retire le nom que s'il désigne encore ce segment.
+ *
+ * Disponible sur les systèmes POSIX (shm_open/mmap); ailleurs open() échoue.
+ */
+class TelemetryShmPublisher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int HeartbeatIntervalMs = 500;
+    static const int StaleAfterMs = 10 * HeartbeatIntervalMs;
+
+    TelemetryShmPublisher(DeviceState *state, DataModel *model, QObject *parent = nullptr);
+    ~TelemetryShmPublisher();
+
+    bool open(const QString &name, QString *errorMessage = nullptr);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    QString name() const { return m_name; }
+
+private slots:
+    void publishState();
+    void publishHeartbeat();
+
+private:
+    void publishChannel(const ChannelInfo &info);
+    void publishSample(quint16 channelId, const DataModel::DataPoint &point);
+
+    DeviceState *m_state;
+    DataModel *m_model;
+
+    QString m_name;
+    TelemetryShm::Header *m_header;
+    int m_fd;                      // Gardé ouvert: identité du segment pour close()
+    QHash<quint16, int> m_slots;   // Canal → index d'anneau
+    QTimer *m_heartbeatTimer;
+};
+
+#endif // TELEMETRYSHMPUBLISHER_H
@@ -0,0 +1,226 @@
+#include "TelemetryShmReader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace TelemetryShm;
+
+TelemetryShmReader::TelemetryShmReader()
+    : m_header(nullptr)
+    , m_size(0)
+{
+}
+
+TelemetryShmReader::~TelemetryShmReader()
+{
+    close();
+}
+
+// ============================================================================
+// SEGMENT
+// ============================================================================
+
+bool TelemetryShmReader::open(const std::string &name)
+{
+    close();
+
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        m_lastError = "shm_open(" + name + "): " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        m_lastError = "Segment " + name + " incomplet";
+        return false;
+    }
+
+    void *memory = mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, fd, 0);
+    const int mapError = errno;
+    ::close(fd);
+
+    if (memory == MAP_FAILED) {
+        m_lastError = "mmap(" + name + "): " + std::strerror(mapError);
+        return false;
+    }
+
+    const Header *header = static_cast<const Header *>(memory);
+    if (header->magic.load(std::memory_order_acquire) != Magic
+            || header->layoutVersion != LayoutVersion
+            || header->maxChannels != static_cast<uint32_t>(MaxChannels)
+            || header->ringSize != static_cast<uint32_t>(RingSize)) {
+        munmap(memory, sizeof(Header));
+        m_lastError = "Segment " + name + " non initialisé ou de version incompatible";
+        return false;
+    }
+
+    m_header = header;
+    m_size = sizeof(Header);
+    m_lastError.clear();
+    return true;
+}
+
+void TelemetryShmReader::close()
+{
+    if (m_header) {
+        munmap(const_cast<Header *>(m_header), m_size);
+        m_header = nullptr;
+        m_size = 0;
+    }
+}
+
+int64_t TelemetryShmReader::writerHeartbeatNs() const
+{
+    return m_header ? m_header->heartbeatNs.load(std::memory_order_acquire) : 0;
+}
+
+bool TelemetryShmReader::isWriterAlive(int64_t nowNs, int64_t maxAgeNs) const
+{
+    const int64_t heartbeat = writerHeartbeatNs();
+    return heartbeat != 0 && nowNs - heartbeat <= maxAgeNs;
+}
+
+// ============================================================================
+// ÉTAT ET DESCRIPTEURS (seqlock)
+// ============================================================================
+
+bool TelemetryShmReader::readState(State *state) const
+{
+    if (!m_header || !state) {
+        return false;
+    }
+
+    const StateBlock &block = m_header->state;
+    for (int attempt = 0; attempt < MaxReadAttempts; ++attempt) {
+        const uint32_t before = block.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;  // Écriture en cours
+        }
+        std::memcpy(state, &block.payload, sizeof(State));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (block.sequence.load(std::memory_order_relaxed) == before) {
+            state->firmwareVersion[FirmwareVersionSize - 1] = '\0';
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TelemetryShmReader::readDescriptor(int slot, ChannelDescriptor *descriptor) const
+{
+    const ChannelRing &ring = m_header->channels[slot];
+    for (int attempt = 0; attempt < MaxReadAttempts; ++attempt) {
+        const uint32_t before = ring.descriptorSequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        std::memcpy(descriptor, &ring.descriptor, sizeof(ChannelDescriptor));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (ring.descriptorSequence.load(std::memory_order_relaxed) == before) {
+            descriptor->name[NameSize - 1] = '\0';
+            descriptor->unit[UnitSize - 1] = '\0';
+            return descriptor->active != 0;
+        }
+    }
+    return false;
+}
+
+std::vector<TelemetryShmReader::Channel> TelemetryShmReader::channels() const
+{
+    std::vector<Channel> result;
+    if (!m_header) {
+        return result;
+    }
+
+    const int count = std::min<int>(m_header->channelCount.load(std::memory_order_acquire), MaxChannels);
+    for (int slot = 0; slot < count; ++slot) {
+        ChannelDescriptor descriptor;
+        if (readDescriptor(slot, &descriptor)) {
+            result.push_back(Channel{slot, descriptor.id, descriptor.name, descriptor.unit});
+        }
+    }
+    return result;
+}
+
+int TelemetryShmReader::findChannel(const std::string &name) const
+{
+    for (const Channel &channel : channels()) {
+        if (channel.name == name) {
+            return channel.slot;
+        }
+    }
+    return -1;
+}
+
+// ============================================================================
+// ÉCHANTILLONS
+// ============================================================================
+
+uint64_t TelemetryShmReader::writeIndex(int slot) const
+{
+    if (!m_header || slot < 0 || slot >= MaxChannels) {
+        return 0;
+    }
+    return m_header->channels[slot].writeIndex.load(std::memory_order_acquire);
+}
+
+size_t TelemetryShmReader::readSamples(int slot, uint64_t *cursor, Sample *out, size_t maxCount,
+                                       uint64_t *dropped) const
+{
+    if (dropped) *dropped = 0;
+    if (!m_header || slot < 0 || slot >= MaxChannels || !cursor || !out) {
+        return 0;
+    }
+
+    const ChannelRing &ring = m_header->channels[slot];
+    const uint64_t published = ring.writeIndex.load(std::memory_order_acquire);
+
+    uint64_t start = std::min(*cursor, published);
+    uint64_t lost = 0;
+
+    // Plus d'un anneau de retard: reprise au plus ancien échantillon conservé
+    if (published - start > static_cast<uint64_t>(RingSize)) {
+        lost = published - RingSize - start;
+        start = published - RingSize;
+    }
+
+    size_t count = static_cast<size_t>(std::min<uint64_t>(published - start, maxCount));
+    for (size_t i = 0; i < count; ++i) {
+        std::memcpy(&out[i], &ring.samples[(start + i) & (RingSize - 1)], sizeof(Sample));
+    }
+
+    // Cases recouvertes pendant la copie (annoncées par l'écrivain)
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t claimed = ring.claimIndex.load(std::memory_order_relaxed);
+    const uint64_t firstValid = claimed > static_cast<uint64_t>(RingSize) ? claimed - RingSize : 0;
+
+    if (start < firstValid) {
+        const size_t skip = static_cast<size_t>(std::min<uint64_t>(firstValid - start, count));
+        std::memmove(out, out + skip, (count - skip) * sizeof(Sample));
+        count -= skip;
+        lost += skip;
+        start += skip;
+    }
+
+    *cursor = start + count;
+    if (dropped) *dropped = lost;
+    return count;
+}
+
+bool TelemetryShmReader::latestSample(int slot, Sample *sample) const
+{
+    const uint64_t published = writeIndex(slot);
+    if (published == 0 || !sample) {
+        return false;
+    }
+
+    uint64_t cursor = published - 1;
+    return readSamples(slot, &cursor, sample, 1) == 1;
+}
@@ -0,0 +1,90 @@
+#ifndef TELEMETRYSHMREADER_H
+#define TELEMETRYSHMREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TelemetryShmLayout.h"
+
+/**
+ * @brief Lecteur du segment de télémétrie publié par STM32_Interface
+ *
+ * Bibliothèque autonome (C++17 standard + POSIX, sans Qt) destinée aux
+ * autres processus de la machine: IHM, enregistreur, chien de garde.
+ *
+ * @code
+ * TelemetryShmReader reader;
+ * if (reader.open()) {
+ *     TelemetryShmReader::State state;
+ *     if (reader.readState(&state)) { ... state.temperature ... }
+ *
+ *     const int temp = reader.findChannel("temp");
+ *     uint64_t cursor = 0;
+ *     TelemetryShm::Sample samples[256];
+ *     const size_t n = reader.readSamples(temp, &cursor, samples, 256);
+ * }
+ * @endcode
+ *
+ * Aucune méthode ne bloque ni n'attend l'écrivain: une lecture d'état qui
+ * croise une écriture est retentée au plus MaxReadAttempts fois puis
+ * échoue (retourne false). Le segment est mappé en lecture seule.
+ */
+class TelemetryShmReader
+{
+public:
+    typedef TelemetryShm::StatePayload State;
+
+    struct Channel {
+        int slot;                  // Index d'anneau (paramètre de readSamples)
+        uint16_t id;
+        std::string name;
+        std::string unit;
+    };
+
+    TelemetryShmReader();
+    ~TelemetryShmReader();
+
+    TelemetryShmReader(const TelemetryShmReader &) = delete;
+    TelemetryShmReader &operator=(const TelemetryShmReader &) = delete;
+
+    bool open(const std::string &name = TelemetryShm::DefaultName);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    const std::string &lastError() const { return m_lastError; }
+
+    // Écrivain vivant: heartbeat plus récent que maxAgeNs (horloge murale, ns)
+    bool isWriterAlive(int64_t nowNs, int64_t maxAgeNs = 2000000000LL) const;
+    int64_t writerHeartbeatNs() const;
+
+    // Instantané cohérent de l'état du dispositif
+    bool readState(State *state) const;
+
+    // Canaux publiés
+    std::vector<Channel> channels() const;
+    int findChannel(const std::string &name) const;  // -1 si inconnu
+
+    /**
+     * Copie au plus maxCount échantillons d'indice >= *cursor et avance le
+     * curseur. Si le lecteur a pris plus d'un anneau de retard, les
+     * échantillons perdus sont comptés dans *dropped et la lecture reprend
+     * au plus ancien échantillon encore valide.
+     */
+    size_t readSamples(int slot, uint64_t *cursor, TelemetryShm::Sample *out, size_t maxCount,
+                       uint64_t *dropped = nullptr) const;
+
+    // Dernier échantillon publié du canal
+    bool latestSample(int slot, TelemetryShm::Sample *sample) const;
+
+    // Nombre d'échantillons publiés (curseur de départ pour ne lire que le neuf)
+    uint64_t writeIndex(int slot) const;
+
+private:
+    bool readDescriptor(int slot, TelemetryShm::ChannelDescriptor *descriptor) const;
+
+    const TelemetryShm::Header *m_header;
+    size_t m_size;
+    std::string m_lastError;
+};
+
+#endif // TELEMETRYSHMREADER_H
@@ -2,6 +2,7 @@
 #include <QDebug>
 #include "MainWindow.h"
 #include "DeviceController.h"
+#include "TelemetryShmLayout.h"
 
 /**
  * @brief Point d'entrée de l'application
@@ -35,6 +36,15 @@ int main(int argc, char *argv[])
     // Création du contrôleur principal (architecture MVC)
     DeviceController *controller = new DeviceController(&app);
 
+    // Publication locale: ignorée si une autre instance publie déjà
+    QString error;
+    if (!controller->shmPublisher()->open(TelemetryShm::DefaultName, &error)) {
+        qDebug() << "Shared memory telemetry disabled:" << error;
+    }
+    if (!controller->ipcServer()->listen(TelemetryIpcServer::DefaultName, &error)) {
+        qDebug() << "Local subscriptions disabled:" << error;
+    }
+
     // Création de la fenêtre principale (View)
     MainWindow window(controller);
     window.show();
@@ -0,0 +1,149 @@
+#include "ChannelInfo.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace {
+
+template <typename T>
+void storeAs(uchar *dst, double raw)
+{
+    T value;
+    if (std::is_floating_point<T>::value) {
+        value = static_cast<T>(raw);
+    } else if (std::isnan(raw)) {
+        value = T(0);
+    } else {
+        // Types entiers: arrondi et saturation
+        const double lo = static_cast<double>(std::numeric_limits<T>::lowest());
+        const double hi = static_cast<double>(std::numeric_limits<T>::max());
+        value = static_cast<T>(std::round(qBound(lo, raw, hi)));
+    }
+    std::memcpy(dst, &value, sizeof(T));
+}
+
+template <typename T>
+double loadAs(const uchar *src)
+{
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return static_cast<double>(value);
+}
+
+} // namespace
+
+ChannelInfo::ChannelInfo()
+    : id(0)
+    , scale(1.0)
+    , offset(0.0)
+    , storageType(Float64)
+{
+}
+
+ChannelInfo::ChannelInfo(quint16 channelId, const QString &channelName, const QString &channelUnit,
+                         StorageType type, double channelScale, double channelOffset)
+    : id(channelId)
+    , name(channelName)
+    , unit(channelUnit)
+    , scale(channelScale)
+    , offset(channelOffset)
+    , storageType(type)
+{
+}
+
+QJsonObject ChannelInfo::toJson() const
+{
+    QJsonObject json;
+    json["id"] = id;
+    json["name"] = name;
+    json["unit"] = unit;
+    json["type"] = storageTypeToString(storageType);
+    json["scale"] = scale;
+    json["offset"] = offset;
+
+    return json;
+}
+
+ChannelInfo ChannelInfo::fromJson(const QJsonObject &json, bool *ok)
+{
+    ChannelInfo info;
+
+    if (!json.contains("id") || !json.contains("name")) {
+        if (ok) *ok = false;
+        return info;
+    }
+
+    bool typeOk = true;
+    info.id = static_cast<quint16>(json["id"].toInt());
+    info.name = json["name"].toString();
+    info.unit = json["unit"].toString();
+    info.scale = json.contains("scale") ? json["scale"].toDouble() : 1.0;
+    info.offset = json["offset"].toDouble();
+    info.storageType = storageTypeFromString(json["type"].toString("f64"), &typeOk);
+
+    if (ok) *ok = typeOk && info.isValid();
+    return info;
+}
+
+int ChannelInfo::storageSize(StorageType type)
+{
+    switch (type) {
+        case Float64: return 8;
+        case Float32: return 4;
+        case Int32: return 4;
+        case UInt16: return 2;
+        case UInt8: return 1;
+        default: return 8;
+    }
+}
+
+QString ChannelInfo::storageTypeToString(StorageType type)
+{
+    switch (type) {
+        case Float64: return "f64";
+        case Float32: return "f32";
+        case Int32: return "i32";
+        case UInt16: return "u16";
+        case UInt8: return "u8";
+        default: return "f64";
+    }
+}
+
+ChannelInfo::StorageType ChannelInfo::storageTypeFromString(const QString &type, bool *ok)
+{
+    if (ok) *ok = true;
+
+    if (type == "f64") return Float64;
+    if (type == "f32") return Float32;
+    if (type == "i32") return Int32;
+    if (type == "u16") return UInt16;
+    if (type == "u8") return UInt8;
+
+    if (ok) *ok = false;
+    return Float64;
+}
+
+void ChannelInfo::encodeRaw(StorageType type, double raw, uchar *dst)
+{
+    switch (type) {
+        case Float32: storeAs<float>(dst, raw); break;
+        case Int32: storeAs<qint32>(dst, raw); break;
+        case UInt16: storeAs<quint16>(dst, raw); break;
+        case UInt8: storeAs<quint8>(dst, raw); break;
+        case Float64:
+        default: storeAs<double>(dst, raw); break;
+    }
+}
+
+double ChannelInfo::decodeRaw(StorageType type, const uchar *src)
+{
+    switch (type) {
+        case Float32: return loadAs<float>(src);
+        case Int32: return loadAs<qint32>(src);
+        case UInt16: return loadAs<quint16>(src);
+        case UInt8: return loadAs<quint8>(src);
+        case Float64:
+        default: return loadAs<double>(src);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef CHANNELINFO_H
+#define CHANNELINFO_H
+
+#include <QString>
+#include <QJsonObject>
+
+/**
+ * @brief Métadonnées d'un canal de télémétrie
+ *
+ * Décrit un canal annoncé par le firmware (commande CAPS) ou intégré à
+ * l'application: identifiant, nom (clé JSON), unité, échelle et type de
+ * stockage des échantillons bruts.
+ *
+ * Valeur physique = brut * scale + offset
+ */
+struct ChannelInfo
+{
+    // Type de stockage des valeurs brutes
+    enum StorageType {
+        Float64,
+        Float32,
+        Int32,
+        UInt16,
+        UInt8
+    };
+
+    // Canaux intégrés (toujours présents)
+    enum BuiltinChannel : quint16 {
+        TemperatureChannel = 0,
+        VoltageChannel = 1,
+        PwmChannel = 2,
+        AdcRawChannel = 3,
+        FirstDynamicChannel = 16
+    };
+
+    quint16 id;
+    QString name;
+    QString unit;
+    double scale;
+    double offset;
+    StorageType storageType;
+
+    ChannelInfo();
+    ChannelInfo(quint16 channelId, const QString &channelName, const QString &channelUnit,
+                StorageType type, double channelScale = 1.0, double channelOffset = 0.0);
+
+    bool isValid() const { return !name.isEmpty(); }
+    double toPhysical(double raw) const { return raw * scale + offset; }
+    int bytesPerValue() const { return storageSize(storageType); }
+
+    // Sérialisation (format du firmware: {"id":0,"name":"temp","unit":"°C","type":"f32","scale":1.0})
+    QJsonObject toJson() const;
+    static ChannelInfo fromJson(const QJsonObject &json, bool *ok = nullptr);
+
+    // Utilitaires
+    static int storageSize(StorageType type);
+    static QString storageTypeToString(StorageType type);
+    static StorageType storageTypeFromString(const QString &type, bool *ok = nullptr);
+
+    // Encodage binaire d'une valeur brute au type de stockage (storageSize octets)
+    static void encodeRaw(StorageType type, double raw, uchar *dst);
+    static double decodeRaw(StorageType type, const uchar *src);
+};
+
+#endif // CHANNELINFO_H
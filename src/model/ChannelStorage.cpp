@@ -0,0 +1,47 @@
+#include "ChannelStorage.h"
+#include "CompressedChannelStorage.h"
+
+ChannelStorage *ChannelStorage::create(ChannelInfo::StorageType type, int capacity, bool compressed)
+{
+    if (compressed) {
+        return new CompressedChannelStorage(type, capacity);
+    }
+
+    switch (type) {
+        case ChannelInfo::Float32:
+            return new TypedChannelStorage<float>(type, capacity);
+        case ChannelInfo::Int32:
+            return new TypedChannelStorage<qint32>(type, capacity);
+        case ChannelInfo::UInt16:
+            return new TypedChannelStorage<quint16>(type, capacity);
+        case ChannelInfo::UInt8:
+            return new TypedChannelStorage<quint8>(type, capacity);
+        case ChannelInfo::Float64:
+        default:
+            return new TypedChannelStorage<double>(ChannelInfo::Float64, capacity);
+    }
+}
+
+int ChannelStorage::lowerBound(qint64 timestamp) const
+{
+    int lo = 0;
+    int hi = size();
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (timestampAt(mid) < timestamp) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+int ChannelStorage::upperBound(qint64 timestamp) const
+{
+    int lo = 0;
+    int hi = size();
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (timestampAt(mid) <= timestamp) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
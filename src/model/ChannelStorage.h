@@ -0,0 +1,137 @@
+#ifndef CHANNELSTORAGE_H
+#define CHANNELSTORAGE_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include "ChannelInfo.h"
+
+/**
+ * @brief Stockage circulaire des échantillons bruts d'un canal
+ *
+ * Interface commune aux stockages typés. Les indices vont de 0 (échantillon
+ * le plus ancien) à size() - 1 (le plus récent). Lorsque la capacité est
+ * atteinte, l'échantillon le plus ancien est écrasé (O(1), sans décalage).
+ *
+ * Non thread-safe: la synchronisation est assurée par DataModel.
+ */
+class ChannelStorage
+{
+public:
+    virtual ~ChannelStorage() = default;
+
+    virtual void append(qint64 timestamp, double raw) = 0;
+    virtual void clear() = 0;
+    virtual void setCapacity(int capacity) = 0;
+
+    virtual int size() const = 0;
+    virtual int capacity() const = 0;
+    virtual qint64 timestampAt(int index) const = 0;
+    virtual double rawAt(int index) const = 0;
+    virtual ChannelInfo::StorageType storageType() const = 0;
+
+    virtual qint64 memoryUsage() const = 0;  // Octets occupés par les échantillons
+
+    bool isEmpty() const { return size() == 0; }
+
+    // Recherche dichotomique (horodatages croissants)
+    virtual int lowerBound(qint64 timestamp) const;  // Premier indice >= timestamp
+    virtual int upperBound(qint64 timestamp) const;  // Premier indice > timestamp
+
+    // Fabrique: instancie le stockage typé (ou compressé) correspondant à la métadonnée
+    static ChannelStorage *create(ChannelInfo::StorageType type, int capacity, bool compressed = false);
+};
+
+/**
+ * @brief Stockage circulaire typé (T = type de la valeur brute)
+ *
+ * Un canal ADC 16 bits occupe 2 octets par valeur au lieu d'un double.
+ */
+template <typename T>
+class TypedChannelStorage : public ChannelStorage
+{
+public:
+    explicit TypedChannelStorage(ChannelInfo::StorageType type, int capacity)
+        : m_type(type)
+        , m_head(0)
+        , m_count(0)
+    {
+        setCapacity(capacity);
+    }
+
+    void append(qint64 timestamp, double raw) override
+    {
+        const int cap = m_values.size();
+        const int slot = (m_head + m_count) % cap;
+
+        m_timestamps[slot] = timestamp;
+        m_values[slot] = fromDouble(raw);
+
+        if (m_count < cap) {
+            m_count++;
+        } else {
+            m_head = (m_head + 1) % cap;
+        }
+    }
+
+    void clear() override
+    {
+        m_head = 0;
+        m_count = 0;
+    }
+
+    void setCapacity(int capacity) override
+    {
+        if (capacity < 1) capacity = 1;
+        if (capacity == m_values.size()) return;
+
+        // Conserve les échantillons les plus récents
+        const int keep = qMin(m_count, capacity);
+        QVector<qint64> timestamps(capacity);
+        QVector<T> values(capacity);
+
+        for (int i = 0; i < keep; ++i) {
+            const int src = physicalIndex(m_count - keep + i);
+            timestamps[i] = m_timestamps[src];
+            values[i] = m_values[src];
+        }
+
+        m_timestamps.swap(timestamps);
+        m_values.swap(values);
+        m_head = 0;
+        m_count = keep;
+    }
+
+    int size() const override { return m_count; }
+    int capacity() const override { return m_values.size(); }
+    qint64 timestampAt(int index) const override { return m_timestamps[physicalIndex(index)]; }
+    double rawAt(int index) const override { return static_cast<double>(m_values[physicalIndex(index)]); }
+    ChannelInfo::StorageType storageType() const override { return m_type; }
+    qint64 memoryUsage() const override { return qint64(m_values.size()) * (sizeof(qint64) + sizeof(T)); }
+
+private:
+    int physicalIndex(int index) const { return (m_head + index) % m_values.size(); }
+
+    static T fromDouble(double raw)
+    {
+        if (std::is_floating_point<T>::value) {
+            return static_cast<T>(raw);
+        }
+
+        // Types entiers: arrondi et saturation
+        if (std::isnan(raw)) return T(0);
+        const double lo = static_cast<double>(std::numeric_limits<T>::lowest());
+        const double hi = static_cast<double>(std::numeric_limits<T>::max());
+        return static_cast<T>(std::round(qBound(lo, raw, hi)));
+    }
+
+    ChannelInfo::StorageType m_type;
+    QVector<qint64> m_timestamps;
+    QVector<T> m_values;
+    int m_head;
+    int m_count;
+};
+
+#endif // CHANNELSTORAGE_H
@@ -0,0 +1,231 @@
+#include "CompressedChannelStorage.h"
+#include "GorillaCodec.h"
+#include <algorithm>
+
+namespace {
+
+// Même arrondi que TypedChannelStorage::fromDouble
+template <typename T>
+double roundTo(double raw)
+{
+    if (std::is_floating_point<T>::value) {
+        return static_cast<double>(static_cast<T>(raw));
+    }
+    if (std::isnan(raw)) return 0.0;
+    const double lo = static_cast<double>(std::numeric_limits<T>::lowest());
+    const double hi = static_cast<double>(std::numeric_limits<T>::max());
+    return std::round(qBound(lo, raw, hi));
+}
+
+double quantize(ChannelInfo::StorageType type, double raw)
+{
+    switch (type) {
+        case ChannelInfo::Float32: return roundTo<float>(raw);
+        case ChannelInfo::Int32: return roundTo<qint32>(raw);
+        case ChannelInfo::UInt16: return roundTo<quint16>(raw);
+        case ChannelInfo::UInt8: return roundTo<quint8>(raw);
+        case ChannelInfo::Float64:
+        default: return raw;
+    }
+}
+
+} // namespace
+
+CompressedChannelStorage::CompressedChannelStorage(ChannelInfo::StorageType type, int capacity)
+    : m_type(type)
+    , m_capacity(qMax(1, capacity))
+    , m_sealedCount(0)
+    , m_cachedBlock(-1)
+{
+}
+
+int CompressedChannelStorage::blockSize() const
+{
+    return qBound(MinBlockSize, m_capacity / 16, MaxBlockSize);
+}
+
+// ============================================================================
+// ÉCRITURE
+// ============================================================================
+
+void CompressedChannelStorage::append(qint64 timestamp, double raw)
+{
+    if (m_headTimestamps.size() >= blockSize()) {
+        sealHead();
+    }
+
+    m_headTimestamps.append(timestamp);
+    m_headValues.append(quantize(m_type, raw));
+    enforceCapacity();
+}
+
+void CompressedChannelStorage::sealHead()
+{
+    if (m_headTimestamps.isEmpty()) {
+        return;
+    }
+
+    GorillaEncoder encoder;
+    for (int i = 0; i < m_headTimestamps.size(); ++i) {
+        encoder.append(m_headTimestamps[i], m_headValues[i]);
+    }
+
+    Block block;
+    block.first = m_sealedCount;
+    block.count = m_headTimestamps.size();
+    block.firstTimestamp = m_headTimestamps.first();
+    block.lastTimestamp = m_headTimestamps.last();
+    block.data = encoder.finish();
+    m_blocks.append(block);
+    m_sealedCount += block.count;
+
+    // Conserve l'allocation de la tête pour le bloc suivant
+    m_headTimestamps.resize(0);
+    m_headValues.resize(0);
+}
+
+void CompressedChannelStorage::enforceCapacity()
+{
+    while (size() > m_capacity) {
+        if (m_blocks.isEmpty()) {
+            const int excess = size() - m_capacity;
+            m_headTimestamps.remove(0, excess);
+            m_headValues.remove(0, excess);
+            break;
+        }
+
+        // Éviction du bloc scellé le plus ancien
+        const int removed = m_blocks.first().count;
+        m_blocks.removeFirst();
+        for (Block &block : m_blocks) {
+            block.first -= removed;
+        }
+        m_sealedCount -= removed;
+        m_cachedBlock--;
+    }
+}
+
+void CompressedChannelStorage::clear()
+{
+    m_blocks.clear();
+    m_sealedCount = 0;
+    m_headTimestamps.resize(0);
+    m_headValues.resize(0);
+    m_cachedBlock = -1;
+}
+
+void CompressedChannelStorage::setCapacity(int capacity)
+{
+    m_capacity = qMax(1, capacity);
+    enforceCapacity();
+}
+
+qint64 CompressedChannelStorage::memoryUsage() const
+{
+    qint64 bytes = 0;
+    for (const Block &block : m_blocks) {
+        bytes += sizeof(Block) + block.data.capacity();
+    }
+    bytes += qint64(m_headTimestamps.capacity()) * (sizeof(qint64) + sizeof(double));
+    bytes += qint64(m_cacheTimestamps.capacity()) * (sizeof(qint64) + sizeof(double));
+    return bytes;
+}
+
+// ============================================================================
+// LECTURE
+// ============================================================================
+
+int CompressedChannelStorage::findBlock(int index) const
+{
+    // Dernier bloc dont le premier indice est <= index
+    int lo = 0;
+    int hi = m_blocks.size();
+    while (hi - lo > 1) {
+        const int mid = (lo + hi) / 2;
+        if (m_blocks[mid].first <= index) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void CompressedChannelStorage::decode(int block) const
+{
+    if (block == m_cachedBlock) {
+        return;
+    }
+
+    const Block &source = m_blocks[block];
+    m_cacheTimestamps.resize(source.count);
+    m_cacheValues.resize(source.count);
+
+    GorillaDecoder decoder(source.data, source.count);
+    qint64 *timestamps = m_cacheTimestamps.data();
+    double *values = m_cacheValues.data();
+    for (int i = 0; i < source.count; ++i) {
+        decoder.next(&timestamps[i], &values[i]);
+    }
+
+    m_cachedBlock = block;
+}
+
+qint64 CompressedChannelStorage::timestampAt(int index) const
+{
+    if (index >= m_sealedCount) {
+        return m_headTimestamps[index - m_sealedCount];
+    }
+
+    const int block = findBlock(index);
+    decode(block);
+    return m_cacheTimestamps[index - m_blocks[block].first];
+}
+
+double CompressedChannelStorage::rawAt(int index) const
+{
+    if (index >= m_sealedCount) {
+        return m_headValues[index - m_sealedCount];
+    }
+
+    const int block = findBlock(index);
+    decode(block);
+    return m_cacheValues[index - m_blocks[block].first];
+}
+
+int CompressedChannelStorage::searchBlocks(qint64 timestamp, bool upper) const
+{
+    // Vrai si t se place avant la borne cherchée
+    auto before = [timestamp, upper](qint64 t) {
+        return upper ? t <= timestamp : t < timestamp;
+    };
+
+    // Premier bloc scellé dont la fin ne précède pas la borne
+    int lo = 0;
+    int hi = m_blocks.size();
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (before(m_blocks[mid].lastTimestamp)) lo = mid + 1;
+        else hi = mid;
+    }
+
+    if (lo < m_blocks.size()) {
+        const Block &block = m_blocks[lo];
+        if (!before(block.firstTimestamp)) {
+            return block.first;
+        }
+        decode(lo);
+        const qint64 *begin = m_cacheTimestamps.constData();
+        return block.first + int(std::partition_point(begin, begin + block.count, before) - begin);
+    }
+
+    const qint64 *begin = m_headTimestamps.constData();
+    return m_sealedCount + int(std::partition_point(begin, begin + m_headTimestamps.size(), before) - begin);
+}
+
+int CompressedChannelStorage::lowerBound(qint64 timestamp) const
+{
+    return searchBlocks(timestamp, false);
+}
+
+int CompressedChannelStorage::upperBound(qint64 timestamp) const
+{
+    return searchBlocks(timestamp, true);
+}
@@ -0,0 +1,85 @@
+#ifndef COMPRESSEDCHANNELSTORAGE_H
+#define COMPRESSEDCHANNELSTORAGE_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QByteArray>
+#include "ChannelStorage.h"
+
+/**
+ * @brief Stockage compressé des échantillons d'un canal (format Gorilla)
+ *
+ * Les échantillons récents vont dans un bloc de tête non compressé. Quand
+ * il est plein, il est encodé (GorillaEncoder) et scellé: horodatages en
+ * delta de delta, valeurs en XOR. Sur des signaux lents (température,
+ * tension), un échantillon scellé occupe quelques octets au lieu de 12 à 16.
+ *
+ * Lecture: les requêtes parcourent les indices dans l'ordre; le dernier bloc
+ * décodé est gardé en cache, chaque bloc n'est donc décodé qu'une fois par
+ * parcours. lowerBound/upperBound cherchent d'abord le bloc par ses bornes
+ * (sans décodage).
+ *
+ * La capacité est respectée à un bloc près: l'éviction retire le bloc scellé
+ * le plus ancien en entier. La taille des blocs suit la capacité
+ * (capacité / 16, entre MinBlockSize et MaxBlockSize).
+ *
+ * Les valeurs sont arrondies au type de stockage du canal avant encodage,
+ * comme dans TypedChannelStorage. Non thread-safe: synchronisé par DataModel.
+ */
+class CompressedChannelStorage : public ChannelStorage
+{
+public:
+    static const int MinBlockSize = 64;
+    static const int MaxBlockSize = 1024;
+
+    CompressedChannelStorage(ChannelInfo::StorageType type, int capacity);
+
+    void append(qint64 timestamp, double raw) override;
+    void clear() override;
+    void setCapacity(int capacity) override;
+
+    int size() const override { return m_sealedCount + m_headTimestamps.size(); }
+    int capacity() const override { return m_capacity; }
+    qint64 timestampAt(int index) const override;
+    double rawAt(int index) const override;
+    ChannelInfo::StorageType storageType() const override { return m_type; }
+    qint64 memoryUsage() const override;
+
+    int lowerBound(qint64 timestamp) const override;
+    int upperBound(qint64 timestamp) const override;
+
+    int sealedBlockCount() const { return m_blocks.size(); }
+
+private:
+    struct Block {
+        int first;              // Indice du premier échantillon
+        int count;
+        qint64 firstTimestamp;
+        qint64 lastTimestamp;
+        QByteArray data;        // Flux Gorilla
+    };
+
+    int blockSize() const;
+    void sealHead();
+    void enforceCapacity();
+    int findBlock(int index) const;
+    void decode(int block) const;
+    int searchBlocks(qint64 timestamp, bool upper) const;
+
+    ChannelInfo::StorageType m_type;
+    int m_capacity;
+
+    QVector<Block> m_blocks;
+    int m_sealedCount;
+
+    // Bloc de tête (non compressé)
+    QVector<qint64> m_headTimestamps;
+    QVector<double> m_headValues;
+
+    // Dernier bloc décodé
+    mutable int m_cachedBlock;
+    mutable QVector<qint64> m_cacheTimestamps;
+    mutable QVector<double> m_cacheValues;
+};
+
+#endif // COMPRESSEDCHANNELSTORAGE_H
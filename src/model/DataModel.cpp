@@ -1,167 +1,916 @@
 #include "DataModel.h"
+#include "ChannelStorage.h"
+#include "DownsamplePyramid.h"
+#include "ColumnStore.h"
 #include <QMutexLocker>
+#include <QReadLocker>
+#include <QScopedPointer>
+#include <QWriteLocker>
+#include <QThread>
+#include <QTimer>
+#include <QJsonObject>
 #include <QDebug>
 #include <algorithm>
+#include <climits>
 
 DataModel::DataModel(QObject *parent)
     : QObject(parent)
+    , m_store(nullptr)
+    , m_storeGeneration(0)
+    , m_commitThread(new QThread(this))
+    , m_commitTimer(new QTimer)
+    , m_commitQueued(false)
+    , m_storeRejected(0)
     , m_maxDataPoints(500)  // Par défaut: 500 points d'historique
+    , m_compressHistory(false)
 {
+    qRegisterMetaType<ChannelInfo>("ChannelInfo");
+    qRegisterMetaType<DataModel::DataPoint>("DataModel::DataPoint");
+
+    // Commits du fichier de capture: démarré au premier attachStore()
+    m_commitTimer->setInterval(ColumnStore::CommitIntervalMs);
+    m_commitTimer->moveToThread(m_commitThread);
+    connect(m_commitTimer, &QTimer::timeout, m_commitTimer, [this]() { commitStore(); });
+    connect(m_commitThread, &QThread::finished, m_commitTimer, &QTimer::deleteLater);
+
+    registerBuiltinChannels();
     qDebug() << "[DataModel] Initialized with max" << m_maxDataPoints << "data points";
 }
 
-void DataModel::addTemperaturePoint(float temperature)
+DataModel::~DataModel()
+{
+    detachStore();
+
+    if (m_commitThread->isRunning()) {
+        m_commitThread->quit();
+        m_commitThread->wait();
+    } else {
+        delete m_commitTimer;
+    }
+
+    for (Channel *channel : qAsConst(m_channels)) {
+        delete channel->storage;
+        delete channel->pyramid;
+        delete channel->rolling;
+        delete channel;
+    }
+}
+
+void DataModel::registerBuiltinChannels()
+{
+    registerChannel(ChannelInfo(ChannelInfo::TemperatureChannel, "temp", "°C", ChannelInfo::Float32));
+    registerChannel(ChannelInfo(ChannelInfo::VoltageChannel, "voltage", "V", ChannelInfo::Float32));
+    registerChannel(ChannelInfo(ChannelInfo::PwmChannel, "pwm", "%", ChannelInfo::UInt8));
+    registerChannel(ChannelInfo(ChannelInfo::AdcRawChannel, "adc_raw", "LSB", ChannelInfo::UInt16));
+}
+
+// ============================================================================
+// REGISTRE DE CANAUX
+// ============================================================================
+
+bool DataModel::registerChannel(const ChannelInfo &info)
+{
+    if (!info.isValid()) {
+        qDebug() << "[DataModel] Invalid channel description, ignored";
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        Channel *channel = m_channels.value(info.id, nullptr);
+
+        if (channel) {
+            // Canal déjà connu: recrée le stockage seulement si le type change
+            if (channel->info.storageType != info.storageType) {
+                delete channel->storage;
+                channel->storage = ChannelStorage::create(info.storageType, m_maxDataPoints, m_compressHistory);
+                channel->pyramid->clear();
+            }
+            // Valeurs physiques: une nouvelle échelle invalide les agrégats
+            if (channel->info.scale != info.scale || channel->info.offset != info.offset) {
+                channel->rolling->clear();
+            }
+            m_channelsByName.remove(channel->info.name);
+            channel->info = info;
+        } else {
+            channel = new Channel;
+            channel->info = info;
+            channel->storage = ChannelStorage::create(info.storageType, m_maxDataPoints, m_compressHistory);
+            channel->pyramid = new DownsamplePyramid;
+            channel->rolling = new RollingAggregator;
+            channel->storeBaseRow = 0;
+            m_channels.insert(info.id, channel);
+        }
+
+        m_channelsByName.insert(info.name, info.id);
+
+        if (m_store) {
+            QWriteLocker storeLocker(&m_storeLock);
+            m_store->addChannel(info);
+        }
+    }
+
+    emit channelRegistered(info);
+
+    qDebug() << "[DataModel] Channel" << info.id << info.name
+             << "(" << ChannelInfo::storageTypeToString(info.storageType) << info.unit << ") registered";
+    return true;
+}
+
+int DataModel::registerChannels(const QJsonArray &channels)
+{
+    int registered = 0;
+
+    for (const QJsonValue &value : channels) {
+        bool ok;
+        ChannelInfo info = ChannelInfo::fromJson(value.toObject(), &ok);
+        if (ok && registerChannel(info)) {
+            registered++;
+        }
+    }
+
+    return registered;
+}
+
+bool DataModel::hasChannel(quint16 channelId) const
 {
     QMutexLocker locker(&m_mutex);
-    
-    DataPoint point(QDateTime::currentDateTime(), temperature);
-    addDataPoint(m_temperatureHistory, point);
-    
-    emit temperatureDataAdded(point);
+    return m_channels.contains(channelId);
 }
 
-void DataModel::addVoltagePoint(float voltage)
+ChannelInfo DataModel::channelInfo(quint16 channelId) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Channel *channel = findChannel(channelId);
+    return channel ? channel->info : ChannelInfo();
+}
+
+int DataModel::channelIdForName(const QString &name) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_channelsByName.constFind(name);
+    return it != m_channelsByName.constEnd() ? it.value() : -1;
+}
+
+QList<quint16> DataModel::channelIds() const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<quint16> ids = m_channels.keys();
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+int DataModel::channelCount() const
 {
     QMutexLocker locker(&m_mutex);
-    
-    DataPoint point(QDateTime::currentDateTime(), voltage);
-    addDataPoint(m_voltageHistory, point);
-    
-    emit voltageDataAdded(point);
+    return m_channels.size();
+}
+
+const DataModel::Channel *DataModel::findChannel(quint16 channelId) const
+{
+    return m_channels.value(channelId, nullptr);
+}
+
+// ============================================================================
+// AJOUT DE DONNÉES
+// ============================================================================
+
+bool DataModel::addSample(quint16 channelId, double rawValue)
+{
+    return addSample(channelId, rawValue, MonotonicClock::nowNs());
+}
+
+bool DataModel::addSample(quint16 channelId, double rawValue, qint64 timestampNs)
+{
+    qint64 timestamp = timestampNs;
+    DataPoint point;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        Channel *channel = m_channels.value(channelId, nullptr);
+        if (!channel) {
+            return false;
+        }
+
+        if (!channel->storage->isEmpty()) {
+            timestamp = qMax(timestamp, channel->storage->timestampAt(channel->storage->size() - 1));
+        }
+
+        channel->storage->append(timestamp, rawValue);
+
+        // Relit la valeur stockée pour refléter la conversion de type
+        const int last = channel->storage->size() - 1;
+        const double stored = channel->storage->rawAt(last);
+        channel->pyramid->append(timestamp, stored);
+
+        if (m_store) {
+            // Capture rouverte: colonnes triées, rien avant la dernière ligne
+            if (timestamp < m_store->lastTimestamp(channelId)) {
+                if (m_storeRejected++ == 0) {
+                    qDebug() << "[DataModel] Sample older than the capture tail, not stored (channel"
+                             << channelId << ")";
+                }
+            } else {
+                // Remappage: aucune lecture concurrente du fichier
+                if (m_store->needsGrowth(channelId)) {
+                    QWriteLocker storeLocker(&m_storeLock);
+                    m_store->reserve(channelId, m_store->rowCount(channelId) + 1);
+                }
+                m_store->append(channelId, timestamp, stored);
+            }
+
+            if (m_store->isCommitDue() && !m_commitQueued) {
+                m_commitQueued = true;
+                QMetaObject::invokeMethod(m_commitTimer, [this]() { commitStore(); }, Qt::QueuedConnection);
+            }
+        }
+
+        point = DataPoint(timestamp, channel->info.toPhysical(stored));
+        channel->rolling->add(timestamp, point.value);
+    }
+
+    emit sampleAdded(channelId, point);
+
+    switch (channelId) {
+        case ChannelInfo::TemperatureChannel: emit temperatureDataAdded(point); break;
+        case ChannelInfo::VoltageChannel: emit voltageDataAdded(point); break;
+        case ChannelInfo::PwmChannel: emit pwmDataAdded(point); break;
+        default: break;
+    }
+
+    return true;
+}
+
+void DataModel::addTemperaturePoint(float temperature)
+{
+    addSample(ChannelInfo::TemperatureChannel, temperature);
+}
+
+void DataModel::addVoltagePoint(float voltage)
+{
+    addSample(ChannelInfo::VoltageChannel, voltage);
 }
 
 void DataModel::addPwmPoint(uint8_t pwmDuty)
+{
+    addSample(ChannelInfo::PwmChannel, pwmDuty);
+}
+
+// ============================================================================
+// LECTURE
+// ============================================================================
+
+QVector<DataModel::DataPoint> DataModel::channelHistory(quint16 channelId) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QVector<DataPoint> history;
+    const Channel *channel = findChannel(channelId);
+    if (!channel) {
+        return history;
+    }
+
+    const ChannelStorage *storage = channel->storage;
+    history.reserve(storage->size());
+
+    for (int i = 0; i < storage->size(); ++i) {
+        history.append(DataPoint(storage->timestampAt(i),
+                                 channel->info.toPhysical(storage->rawAt(i))));
+    }
+
+    return history;
+}
+
+QVector<DataModel::DataPoint> DataModel::channelHistory(quint16 channelId, qint64 fromNs, qint64 toNs) const
 {
     QMutexLocker locker(&m_mutex);
-    
-    DataPoint point(QDateTime::currentDateTime(), pwmDuty);
-    addDataPoint(m_pwmHistory, point);
-    
-    emit pwmDataAdded(point);
+
+    QVector<DataPoint> history;
+    const Channel *channel = findChannel(channelId);
+    if (!channel || fromNs > toNs) {
+        return history;
+    }
+
+    // Intervalle antérieur au buffer circulaire: lecture du fichier de capture
+    if (storeHolds(channel, fromNs)) {
+        const qint64 first = qMax(channel->storeBaseRow, m_store->lowerBound(channelId, fromNs));
+        const qint64 end = m_store->upperBound(channelId, toNs);
+
+        QVector<qint64> timestamps;
+        QVector<double> raw;
+        const int n = m_store->read(channelId, first, static_cast<int>(qMin<qint64>(end - first, INT_MAX)),
+                                    &timestamps, &raw);
+        history.reserve(n);
+        for (int i = 0; i < n; ++i) {
+            history.append(DataPoint(timestamps[i],
+                                     channel->info.toPhysical(raw[i])));
+        }
+        return history;
+    }
+
+    const ChannelStorage *storage = channel->storage;
+    const int first = storage->lowerBound(fromNs);
+    const int end = storage->upperBound(toNs);
+    history.reserve(qMax(0, end - first));
+
+    for (int i = first; i < end; ++i) {
+        history.append(DataPoint(storage->timestampAt(i),
+                                 channel->info.toPhysical(storage->rawAt(i))));
+    }
+
+    return history;
 }
 
-void DataModel::addDataPoint(QVector<DataPoint> &history, const DataPoint &point)
+DataModel::RollingStats DataModel::rollingStats(quint16 channelId, RollingWindow window) const
 {
-    history.append(point);
-    
-    // Limite la taille de l'historique
-    if (history.size() > m_maxDataPoints) {
-        history.removeFirst();
+    const qint64 now = MonotonicClock::nowNs();
+
+    QMutexLocker locker(&m_mutex);
+
+    const Channel *channel = findChannel(channelId);
+    if (!channel) {
+        return RollingStats();
     }
+
+    // Fenêtre terminée au dernier échantillon s'il est en avance (rejeu accéléré)
+    const ChannelStorage *storage = channel->storage;
+    const qint64 last = storage->isEmpty() ? now : storage->timestampAt(storage->size() - 1);
+    return channel->rolling->stats(window, qMax(now, last));
 }
 
 QVector<DataModel::DataPoint> DataModel::getTemperatureHistory() const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_temperatureHistory;
+    return channelHistory(ChannelInfo::TemperatureChannel);
 }
 
 QVector<DataModel::DataPoint> DataModel::getVoltageHistory() const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_voltageHistory;
+    return channelHistory(ChannelInfo::VoltageChannel);
 }
 
 QVector<DataModel::DataPoint> DataModel::getPwmHistory() const
 {
-    QMutexLocker locker(&m_mutex);
-    return m_pwmHistory;
+    return channelHistory(ChannelInfo::PwmChannel);
 }
 
 void DataModel::setMaxDataPoints(int maxPoints)
 {
     QMutexLocker locker(&m_mutex);
-    
+
     if (maxPoints < 10) maxPoints = 10;
-    if (maxPoints > 10000) maxPoints = 10000;
-    
+    maxPoints = qMin(maxPoints, m_compressHistory ? int(MaxCompressedDataPoints) : int(MaxDataPoints));
+
     m_maxDataPoints = maxPoints;
-    
+
     // Ajuste les historiques existants
-    while (m_temperatureHistory.size() > m_maxDataPoints)
-        m_temperatureHistory.removeFirst();
-    
-    while (m_voltageHistory.size() > m_maxDataPoints)
-        m_voltageHistory.removeFirst();
-    
-    while (m_pwmHistory.size() > m_maxDataPoints)
-        m_pwmHistory.removeFirst();
-    
+    for (Channel *channel : qAsConst(m_channels)) {
+        channel->storage->setCapacity(m_maxDataPoints);
+    }
+
     qDebug() << "[DataModel] Max data points set to" << m_maxDataPoints;
 }
 
-double DataModel::getTemperatureAverage() const
+void DataModel::setHistoryCompression(bool enabled)
 {
     QMutexLocker locker(&m_mutex);
-    return calculateAverage(m_temperatureHistory);
+
+    if (enabled == m_compressHistory) {
+        return;
+    }
+
+    m_compressHistory = enabled;
+    if (!enabled) {
+        m_maxDataPoints = qMin(m_maxDataPoints, int(MaxDataPoints));
+    }
+
+    // Recopie des échantillons dans le nouveau format
+    for (Channel *channel : qAsConst(m_channels)) {
+        ChannelStorage *storage = ChannelStorage::create(channel->info.storageType,
+                                                         m_maxDataPoints, enabled);
+        const ChannelStorage *previous = channel->storage;
+        for (int i = qMax(0, previous->size() - m_maxDataPoints); i < previous->size(); ++i) {
+            storage->append(previous->timestampAt(i), previous->rawAt(i));
+        }
+        delete channel->storage;
+        channel->storage = storage;
+    }
+
+    qDebug() << "[DataModel] History compression" << (enabled ? "enabled" : "disabled");
 }
 
-double DataModel::getVoltageAverage() const
+bool DataModel::historyCompression() const
 {
     QMutexLocker locker(&m_mutex);
-    return calculateAverage(m_voltageHistory);
+    return m_compressHistory;
 }
 
-double DataModel::getTemperatureMin() const
+qint64 DataModel::historyMemoryUsage() const
 {
     QMutexLocker locker(&m_mutex);
-    return findMin(m_temperatureHistory);
+
+    qint64 bytes = 0;
+    for (const Channel *channel : qAsConst(m_channels)) {
+        bytes += channel->storage->memoryUsage();
+    }
+    return bytes;
 }
 
-double DataModel::getTemperatureMax() const
+// ============================================================================
+// STATISTIQUES
+// ============================================================================
+
+double DataModel::channelAverage(quint16 channelId) const
 {
     QMutexLocker locker(&m_mutex);
-    return findMax(m_temperatureHistory);
-}
 
-double DataModel::calculateAverage(const QVector<DataPoint> &data) const
-{
-    if (data.isEmpty())
+    const Channel *channel = findChannel(channelId);
+    if (!channel || channel->storage->isEmpty())
         return 0.0;
-    
+
     double sum = 0.0;
-    for (const auto &point : data) {
-        sum += point.value;
+    for (int i = 0; i < channel->storage->size(); ++i) {
+        sum += channel->storage->rawAt(i);
     }
-    
-    return sum / data.size();
+
+    return channel->info.toPhysical(sum / channel->storage->size());
 }
 
-double DataModel::findMin(const QVector<DataPoint> &data) const
+double DataModel::channelMin(quint16 channelId) const
 {
-    if (data.isEmpty())
+    QMutexLocker locker(&m_mutex);
+
+    const Channel *channel = findChannel(channelId);
+    if (!channel || channel->storage->isEmpty())
         return 0.0;
-    
-    auto minIt = std::min_element(data.begin(), data.end(),
-        [](const DataPoint &a, const DataPoint &b) {
-            return a.value < b.value;
-        });
-    
-    return minIt->value;
+
+    double lo = channel->storage->rawAt(0);
+    double hi = lo;
+    for (int i = 1; i < channel->storage->size(); ++i) {
+        const double raw = channel->storage->rawAt(i);
+        lo = qMin(lo, raw);
+        hi = qMax(hi, raw);
+    }
+
+    // Une échelle négative inverse min et max
+    return qMin(channel->info.toPhysical(lo), channel->info.toPhysical(hi));
 }
 
-double DataModel::findMax(const QVector<DataPoint> &data) const
+double DataModel::channelMax(quint16 channelId) const
 {
-    if (data.isEmpty())
+    QMutexLocker locker(&m_mutex);
+
+    const Channel *channel = findChannel(channelId);
+    if (!channel || channel->storage->isEmpty())
         return 0.0;
-    
-    auto maxIt = std::max_element(data.begin(), data.end(),
-        [](const DataPoint &a, const DataPoint &b) {
-            return a.value < b.value;
-        });
-    
-    return maxIt->value;
+
+    double lo = channel->storage->rawAt(0);
+    double hi = lo;
+    for (int i = 1; i < channel->storage->size(); ++i) {
+        const double raw = channel->storage->rawAt(i);
+        lo = qMin(lo, raw);
+        hi = qMax(hi, raw);
+    }
+
+    return qMax(channel->info.toPhysical(lo), channel->info.toPhysical(hi));
+}
+
+// ============================================================================
+// SOUS-ÉCHANTILLONNAGE
+// ============================================================================
+
+QVector<DataModel::DecimatedColumn> DataModel::queryDecimated(quint16 channelId, qint64 fromNs,
+                                                              qint64 toNs, int maxColumns,
+                                                              DecimationMode mode) const
+{
+    QVector<DecimatedColumn> columns;
+    ChannelInfo info;
+    QVector<DownsamplePyramid::Point> points;
+    QVector<DownsamplePyramid::Bucket> buckets;
+    quint64 storeGeneration = 0;  // Non nul: lignes [first, end) à lire dans le fichier
+    qint64 first = 0;
+    qint64 end = 0;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        const Channel *channel = findChannel(channelId);
+        if (!channel || fromNs > toNs || maxColumns <= 0) {
+            return columns;
+        }
+        info = channel->info;
+
+        // Intervalle hors du buffer mais assez court: résolution complète
+        // depuis le fichier, lu après le mutex (seules les bornes sont relevées)
+        if (storeHolds(channel, fromNs)) {
+            first = qMax(channel->storeBaseRow, m_store->lowerBound(channelId, fromNs));
+            end = m_store->upperBound(channelId, toNs);
+            if (end - first <= qint64(maxColumns) * DownsamplePyramid::OversamplingFactor) {
+                storeGeneration = m_storeGeneration;
+            }
+        }
+
+        if (storeGeneration == 0) {
+            if (mode == LttbDecimation) {
+                points = channel->pyramid->lttb(*channel->storage, fromNs, toNs, maxColumns);
+            } else {
+                buckets = channel->pyramid->query(*channel->storage, fromNs, toNs, maxColumns);
+            }
+        }
+    }
+
+    if (storeGeneration != 0) {
+        QVector<qint64> timestamps;
+        QVector<double> raw;
+        const int n = readStoreRows(channelId, storeGeneration, first, static_cast<int>(end - first),
+                                    &timestamps, &raw);
+        if (n < 0) {
+            // Fichier détaché ou remplacé entre-temps: bornes à relever
+            return queryDecimated(channelId, fromNs, toNs, maxColumns, mode);
+        }
+
+        QVector<DownsamplePyramid::Bucket> sources(n);
+        for (int i = 0; i < n; ++i) {
+            sources[i].add(timestamps[i], raw[i]);
+        }
+        if (mode == LttbDecimation) {
+            points = DownsamplePyramid::lttbFromBuckets(sources, maxColumns);
+        } else {
+            buckets = DownsamplePyramid::binColumns(sources, fromNs, toNs, maxColumns);
+        }
+    }
+
+    if (mode == LttbDecimation) {
+        columns.reserve(points.size());
+
+        for (const DownsamplePyramid::Point &p : points) {
+            DecimatedColumn column;
+            column.startTime = column.endTime = p.first;
+            column.min = column.max = column.mean = info.toPhysical(p.second);
+            column.count = 1;
+            columns.append(column);
+        }
+        return columns;
+    }
+
+    columns.reserve(buckets.size());
+
+    for (const DownsamplePyramid::Bucket &bucket : buckets) {
+        const double lo = info.toPhysical(bucket.min);
+        const double hi = info.toPhysical(bucket.max);
+
+        DecimatedColumn column;
+        column.startTime = bucket.firstTimestamp;
+        column.endTime = bucket.lastTimestamp;
+        column.min = qMin(lo, hi);  // Une échelle négative inverse min et max
+        column.max = qMax(lo, hi);
+        column.mean = info.toPhysical(bucket.mean());
+        column.count = static_cast<int>(bucket.count);
+        columns.append(column);
+    }
+
+    return columns;
+}
+
+double DataModel::getTemperatureAverage() const
+{
+    return channelAverage(ChannelInfo::TemperatureChannel);
+}
+
+double DataModel::getVoltageAverage() const
+{
+    return channelAverage(ChannelInfo::VoltageChannel);
+}
+
+double DataModel::getTemperatureMin() const
+{
+    return channelMin(ChannelInfo::TemperatureChannel);
+}
+
+double DataModel::getTemperatureMax() const
+{
+    return channelMax(ChannelInfo::TemperatureChannel);
 }
 
 void DataModel::clearHistory()
 {
-    QMutexLocker locker(&m_mutex);
-    
-    m_temperatureHistory.clear();
-    m_voltageHistory.clear();
-    m_pwmHistory.clear();
-    
+    {
+        QMutexLocker locker(&m_mutex);
+
+        for (Channel *channel : qAsConst(m_channels)) {
+            channel->storage->clear();
+            channel->pyramid->clear();
+            channel->rolling->clear();
+
+            // La capture sur disque est conservée mais n'est plus visible
+            if (m_store) {
+                channel->storeBaseRow = m_store->rowCount(channel->info.id);
+            }
+        }
+    }
+
     emit historyCleared();
-    
+
     qDebug() << "[DataModel] History cleared";
 }
+
+// ============================================================================
+// LECTURE PAR BLOCS
+// ============================================================================
+
+qint64 DataModel::locateSamples(const Channel *channel, qint64 fromNs, qint64 toNs, qint64 *first) const
+{
+    if (fromNs > toNs) {
+        *first = 0;
+        return 0;
+    }
+
+    // Avec un fichier de capture, toutes les données depuis l'attachement y sont
+    if (m_store) {
+        const quint16 id = channel->info.id;
+        *first = qMax(channel->storeBaseRow, m_store->lowerBound(id, fromNs));
+        return qMax<qint64>(0, m_store->upperBound(id, toNs) - *first);
+    }
+
+    *first = channel->storage->lowerBound(fromNs);
+    return qMax<qint64>(0, channel->storage->upperBound(toNs) - *first);
+}
+
+qint64 DataModel::sampleCount(quint16 channelId, qint64 fromNs, qint64 toNs) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    const Channel *channel = findChannel(channelId);
+    if (!channel) {
+        return 0;
+    }
+
+    qint64 first;
+    return locateSamples(channel, fromNs, toNs, &first);
+}
+
+DataModel::SampleCursor DataModel::openSamples(quint16 channelId, qint64 fromNs, qint64 toNs) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    SampleCursor cursor;
+    cursor.channelId = channelId;
+
+    const Channel *channel = findChannel(channelId);
+    if (!channel) {
+        return cursor;
+    }
+
+    qint64 first;
+    const qint64 count = locateSamples(channel, fromNs, toNs, &first);
+
+    // Lignes du fichier de capture: stables, seul l'intervalle est retenu
+    if (m_store) {
+        cursor.begin = first;
+        cursor.next = first;
+        cursor.end = first + count;
+        cursor.storeGeneration = m_storeGeneration;
+        return cursor;
+    }
+
+    // Buffer circulaire: copie immédiate, les indices glissent à chaque éviction
+    const ChannelStorage *storage = channel->storage;
+    const int n = static_cast<int>(count);
+    cursor.timestamps.resize(n);
+    cursor.raw.resize(n);
+    for (int i = 0; i < n; ++i) {
+        cursor.timestamps[i] = storage->timestampAt(static_cast<int>(first) + i);
+        cursor.raw[i] = storage->rawAt(static_cast<int>(first) + i);
+    }
+    cursor.end = count;
+
+    return cursor;
+}
+
+int DataModel::readSamples(SampleCursor *cursor, int maxCount,
+                           QVector<qint64> *timestamps, QVector<double> *raw) const
+{
+    const int n = static_cast<int>(qMin<qint64>(maxCount, cursor->end - cursor->next));
+    if (n <= 0) {
+        return 0;
+    }
+
+    if (cursor->storeGeneration == 0) {
+        if (timestamps) *timestamps = cursor->timestamps.mid(static_cast<int>(cursor->next), n);
+        if (raw) *raw = cursor->raw.mid(static_cast<int>(cursor->next), n);
+        cursor->next += n;
+        return n;
+    }
+
+    // Lignes figées à l'ouverture: lues hors du mutex
+    const int read = readStoreRows(cursor->channelId, cursor->storeGeneration, cursor->next, n,
+                                   timestamps, raw);
+    if (read > 0) {
+        cursor->next += read;
+    }
+    return read;
+}
+
+int DataModel::readStoreRows(quint16 channelId, quint64 generation, qint64 firstRow, int count,
+                             QVector<qint64> *timestamps, QVector<double> *raw) const
+{
+    QReadLocker locker(&m_storeLock);
+
+    // Fichier détaché ou remplacé depuis le relevé des bornes
+    if (!m_store || m_storeGeneration != generation) {
+        return -1;
+    }
+    return m_store->readWritten(channelId, firstRow, count, timestamps, raw);
+}
+
+// ============================================================================
+// CAPTURE SUR DISQUE
+// ============================================================================
+
+bool DataModel::attachStore(const QString &directory, QString *errorMessage)
+{
+    ColumnStore *store = new ColumnStore(directory);
+    if (!store->open()) {
+        if (errorMessage) *errorMessage = store->lastError();
+        delete store;
+        return false;
+    }
+
+    ColumnStore *previous;
+    quint64 generation;
+    QList<quint16> reopened;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        for (Channel *channel : qAsConst(m_channels)) {
+            const quint16 id = channel->info.id;
+            store->addChannel(channel->info);
+            channel->storeBaseRow = 0;
+            if (store->rowCount(id) > 0) {
+                reopened.append(id);
+            }
+
+            // Échantillons déjà reçus versés au fichier: les exports et les
+            // requêtes sur le fichier couvrent aussi l'avant-attachement
+            const ChannelStorage *storage = channel->storage;
+            for (int i = storage->upperBound(store->lastTimestamp(id)); i < storage->size(); ++i) {
+                store->append(id, storage->timestampAt(i), storage->rawAt(i));
+            }
+        }
+
+        QWriteLocker storeLocker(&m_storeLock);
+        previous = m_store;
+        m_store = store;
+        generation = ++m_storeGeneration;
+        m_storeRejected = 0;
+    }
+
+    // Dernier commit de la capture précédente, hors verrou
+    delete previous;
+
+    if (!m_commitThread->isRunning()) {
+        m_commitThread->start(QThread::LowPriority);
+    }
+    QMetaObject::invokeMethod(m_commitTimer, "start", Qt::QueuedConnection);
+
+    // Capture existante: la pyramide couvrira aussi les données déjà sur
+    // disque, reconstruite par le thread de commit
+    for (quint16 id : qAsConst(reopened)) {
+        QMetaObject::invokeMethod(m_commitTimer, [this, id, generation]() {
+            rebuildPyramidFromStore(id, generation);
+        }, Qt::QueuedConnection);
+    }
+
+    qDebug() << "[DataModel] Capture store attached:" << directory;
+    return true;
+}
+
+void DataModel::detachStore()
+{
+    ColumnStore *store;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if (!m_store) {
+            return;
+        }
+
+        for (Channel *channel : qAsConst(m_channels)) {
+            channel->storeBaseRow = 0;
+        }
+
+        // Attend la fin des lectures en cours hors m_mutex
+        QWriteLocker storeLocker(&m_storeLock);
+        store = m_store;
+        m_store = nullptr;
+        m_storeGeneration++;
+    }
+
+    QMetaObject::invokeMethod(m_commitTimer, "stop", Qt::QueuedConnection);
+
+    // Dernier commit synchrone et fermeture des colonnes, hors verrou
+    const QString directory = store->directory();
+    delete store;
+
+    qDebug() << "[DataModel] Capture store detached:" << directory;
+}
+
+void DataModel::commitStore()
+{
+    QVector<ColumnStore::PendingCommit> commits;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        m_commitQueued = false;
+        if (!m_store) {
+            return;
+        }
+        commits = m_store->prepareCommit();
+    }
+
+    // fsync hors verrou: ingestion, tracé et export ne l'attendent pas
+    QString error;
+    if (!ColumnStore::syncCommit(commits, &error)) {
+        qDebug() << "[DataModel] Store commit failed:" << error;
+    }
+}
+
+bool DataModel::hasStore() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_store != nullptr;
+}
+
+QString DataModel::storeDirectory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_store ? m_store->directory() : QString();
+}
+
+bool DataModel::storeHolds(const Channel *channel, qint64 fromNs) const
+{
+    if (!m_store) {
+        return false;
+    }
+
+    // Le fichier contient des échantillons plus anciens que le buffer circulaire
+    const ChannelStorage *storage = channel->storage;
+    const qint64 storedRows = m_store->rowCount(channel->info.id) - channel->storeBaseRow;
+
+    return storedRows > storage->size()
+            && (storage->isEmpty() || storage->timestampAt(0) > fromNs);
+}
+
+void DataModel::rebuildPyramidFromStore(quint16 channelId, quint64 generation)
+{
+    static const int ChunkRows = 65536;
+
+    qint64 rows;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_store || m_storeGeneration != generation) {
+            return;
+        }
+        rows = m_store->rowCount(channelId);
+    }
+
+    // Lecture de toute la capture hors m_mutex, par blocs
+    QScopedPointer<DownsamplePyramid> pyramid(new DownsamplePyramid);
+    QVector<qint64> timestamps;
+    QVector<double> raw;
+    for (qint64 row = 0; row < rows; row += ChunkRows) {
+        const int n = readStoreRows(channelId, generation, row,
+                                    static_cast<int>(qMin<qint64>(ChunkRows, rows - row)), &timestamps, &raw);
+        if (n < 0) {
+            return;
+        }
+        for (int i = 0; i < n; ++i) {
+            pyramid->append(timestamps[i], raw[i]);
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    // Historique effacé ou capture changée pendant la lecture: abandon
+    Channel *channel = m_channels.value(channelId, nullptr);
+    if (!channel || !m_store || m_storeGeneration != generation || channel->storeBaseRow != 0) {
+        return;
+    }
+
+    // Lignes ajoutées depuis le relevé (le buffer y a été versé à l'attachement)
+    const qint64 total = m_store->rowCount(channelId);
+    for (qint64 row = rows; row < total; row += ChunkRows) {
+        const int n = m_store->read(channelId, row, ChunkRows, &timestamps, &raw);
+        for (int i = 0; i < n; ++i) {
+            pyramid->append(timestamps[i], raw[i]);
+        }
+    }
+
+    delete channel->pyramid;
+    channel->pyramid = pyramid.take();
+    qDebug() << "[DataModel] Pyramid rebuilt from capture for channel" << channelId << ":" << total << "rows";
+}
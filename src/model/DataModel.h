@@ -4,14 +4,59 @@
 #include <QObject>
 #include <QVector>
 #include <QPair>
+#include <QHash>
+#include <QList>
 #include <QDateTime>
+#include <QJsonArray>
 #include <QMutex>
+#include <QReadWriteLock>
+#include "ChannelInfo.h"
+#include "MonotonicClock.h"
+#include "RollingAggregator.h"
+
+class ChannelStorage;
+class DownsamplePyramid;
+class ColumnStore;
+class QThread;
+class QTimer;
 
 /**
  * @brief Modèle de données avec historique temporel
- * 
+ *
  * Gère l'historique des mesures pour l'affichage de graphiques temps réel.
  * Utilise un mutex pour la sécurité thread (accès depuis SerialWorker).
+ *
+ * Les séries sont organisées en registre de canaux indexé par identifiant.
+ * Chaque canal possède ses métadonnées (ChannelInfo) et un stockage
+ * circulaire typé. Les canaux sont créés à l'exécution à partir des
+ * capacités annoncées par le firmware; température, tension, PWM et ADC
+ * brut sont enregistrés par défaut.
+ *
+ * Chaque canal maintient aussi une pyramide min/max/moyenne (DownsamplePyramid)
+ * qui permet de tracer n'importe quel intervalle en un nombre borné de colonnes,
+ * et des agrégats glissants 1 s / 1 min / 1 h (RollingAggregator) lisibles
+ * en temps constant par les tableaux de bord.
+ *
+ * Le stockage peut être compressé (setHistoryCompression): blocs Gorilla
+ * scellés plus un bloc de tête non compressé pour les points récents.
+ *
+ * Un ColumnStore optionnel (attachStore) reçoit chaque échantillon en
+ * écriture directe: le buffer circulaire ne sert plus que de cache récent et
+ * les requêtes antérieures à son plus ancien échantillon lisent le fichier.
+ * À l'attachement, le contenu du buffer y est versé; un échantillon plus
+ * ancien que la dernière ligne du fichier (capture rouverte) reste hors du
+ * fichier. Ses commits (fsync) tournent dans un thread dédié, hors du mutex:
+ * toutes les ColumnStore::CommitIntervalMs, canaux inactifs compris, et dès
+ * qu'un canal accumule ColumnStore::CommitRows lignes non validées.
+ *
+ * Les lignes du fichier sont lues hors du mutex (bornes relevées sous le
+ * mutex, lecture sous m_storeLock partagé): un export, une trame de tracé
+ * sur l'historique ou la reconstruction de la pyramide d'une capture
+ * rouverte (thread de commit) ne bloquent pas l'ingestion.
+ *
+ * Les horodatages sont en nanosecondes MonotonicClock, fournis par
+ * l'appelant (instant de réception de la trame dans SerialWorker). Les
+ * intervalles [fromNs, toNs] des requêtes utilisent la même base.
  */
 class DataModel : public QObject
 {
@@ -19,56 +64,180 @@ class DataModel : public QObject
 
 public:
     struct DataPoint {
-        QDateTime timestamp;
+        qint64 timestampNs;  // MonotonicClock (ns depuis l'epoch)
         double value;
-        
-        DataPoint() : value(0.0) {}
-        DataPoint(const QDateTime &ts, double val) : timestamp(ts), value(val) {}
+
+        DataPoint() : timestampNs(0), value(0.0) {}
+        DataPoint(qint64 ts, double val) : timestampNs(ts), value(val) {}
+
+        // Heure murale, pour l'affichage uniquement
+        QDateTime timestamp() const { return MonotonicClock::toDateTime(timestampNs); }
+    };
+
+    // Colonne de tracé sous-échantillonnée (valeurs physiques)
+    struct DecimatedColumn {
+        qint64 startTime;   // Epoch ns du premier échantillon
+        qint64 endTime;     // Epoch ns du dernier échantillon
+        double min;
+        double max;
+        double mean;
+        int count;          // Nombre d'échantillons bruts agrégés
+
+        DecimatedColumn() : startTime(0), endTime(0), min(0.0), max(0.0), mean(0.0), count(0) {}
+    };
+
+    // Curseur de lecture par blocs sur un intervalle figé à l'ouverture
+    struct SampleCursor {
+        quint16 channelId;
+        qint64 begin;                  // Ligne absolue du fichier de capture
+        qint64 next;
+        qint64 end;
+        quint64 storeGeneration;       // 0: copie du buffer circulaire
+        QVector<qint64> timestamps;    // Copie figée (sans fichier de capture)
+        QVector<double> raw;
+
+        SampleCursor() : channelId(0), begin(0), next(0), end(0), storeGeneration(0) {}
+        qint64 count() const { return end - begin; }
+        void rewind() { next = begin; }
     };
-    
+
+    // Agrégats glissants (valeurs physiques): nombre, moyenne, min, max,
+    // écart-type et quantiles approchés p50/p95/p99
+    typedef RollingAggregator::Stats RollingStats;
+    typedef RollingAggregator::Window RollingWindow;
+
+    enum DecimationMode {
+        MinMaxDecimation,   // Enveloppe min/max par colonne
+        LttbDecimation      // Largest-Triangle-Three-Buckets (un point par colonne)
+    };
+
     explicit DataModel(QObject *parent = nullptr);
-    
+    ~DataModel();
+
+    // === REGISTRE DE CANAUX ===
+    bool registerChannel(const ChannelInfo &info);
+    int registerChannels(const QJsonArray &channels);  // Capacités du firmware
+    bool hasChannel(quint16 channelId) const;
+    ChannelInfo channelInfo(quint16 channelId) const;
+    int channelIdForName(const QString &name) const;  // -1 si inconnu
+    QList<quint16> channelIds() const;
+    int channelCount() const;
+
+    // Ajout d'un échantillon brut (converti selon le type de stockage du canal).
+    // Un horodatage antérieur au dernier échantillon du canal est ramené à
+    // celui-ci pour garder la série triée.
+    bool addSample(quint16 channelId, double rawValue, qint64 timestampNs);
+    bool addSample(quint16 channelId, double rawValue);  // Horodaté à l'appel
+
+    // Historique en valeurs physiques (thread-safe)
+    QVector<DataPoint> channelHistory(quint16 channelId) const;
+    QVector<DataPoint> channelHistory(quint16 channelId, qint64 fromNs, qint64 toNs) const;
+    double channelAverage(quint16 channelId) const;
+    double channelMin(quint16 channelId) const;
+    double channelMax(quint16 channelId) const;
+
+    // Au plus maxColumns colonnes sur [fromNs, toNs], coût indépendant de la longueur de l'historique
+    QVector<DecimatedColumn> queryDecimated(quint16 channelId, qint64 fromNs, qint64 toNs,
+                                            int maxColumns,
+                                            DecimationMode mode = MinMaxDecimation) const;
+
+    // Agrégats de la fenêtre glissante se terminant maintenant (coût constant)
+    RollingStats rollingStats(quint16 channelId, RollingWindow window) const;
+
     // Ajout de données
     void addTemperaturePoint(float temperature);
     void addVoltagePoint(float voltage);
     void addPwmPoint(uint8_t pwmDuty);
-    
+
     // Récupération des données (thread-safe)
     QVector<DataPoint> getTemperatureHistory() const;
     QVector<DataPoint> getVoltageHistory() const;
     QVector<DataPoint> getPwmHistory() const;
-    
+
+    // Lecture par blocs (export): valeurs brutes des échantillons de [fromNs, toNs].
+    // L'intervalle est figé à l'ouverture, sous un seul verrou: lignes absolues
+    // du fichier de capture, ou copie du buffer circulaire (bornée par sa
+    // capacité) dont les évictions décaleraient les indices entre deux blocs.
+    // readSamples() renvoie 0 en fin d'intervalle, -1 si le fichier de
+    // capture a été détaché ou remplacé depuis openSamples().
+    qint64 sampleCount(quint16 channelId, qint64 fromNs, qint64 toNs) const;
+    SampleCursor openSamples(quint16 channelId, qint64 fromNs, qint64 toNs) const;
+    int readSamples(SampleCursor *cursor, int maxCount,
+                    QVector<qint64> *timestamps, QVector<double> *raw) const;
+
+    // Capture longue durée sur disque
+    bool attachStore(const QString &directory, QString *errorMessage = nullptr);
+    void detachStore();
+    bool hasStore() const;
+    QString storeDirectory() const;
+    void commitStore();  // Commit différé; appelé par le thread de commit
+
     // Configuration
+    static const int MaxDataPoints = 10000;
+    static const int MaxCompressedDataPoints = 200000;
+
     void setMaxDataPoints(int maxPoints);
     int maxDataPoints() const { return m_maxDataPoints; }
-    
+
+    // Historique compressé (Gorilla): même mémoire pour 10 à 20 fois plus
+    // de points sur des signaux lents. Les échantillons présents sont conservés.
+    void setHistoryCompression(bool enabled);
+    bool historyCompression() const;
+    qint64 historyMemoryUsage() const;  // Octets, tous canaux
+
     // Statistiques
     double getTemperatureAverage() const;
     double getVoltageAverage() const;
     double getTemperatureMin() const;
     double getTemperatureMax() const;
-    
+
     // Gestion
     void clearHistory();
 
 signals:
+    void channelRegistered(const ChannelInfo &info);
+    void sampleAdded(quint16 channelId, const DataModel::DataPoint &point);
     void temperatureDataAdded(const DataPoint &point);
     void voltageDataAdded(const DataPoint &point);
     void pwmDataAdded(const DataPoint &point);
     void historyCleared();
 
 private:
-    void addDataPoint(QVector<DataPoint> &history, const DataPoint &point);
-    double calculateAverage(const QVector<DataPoint> &data) const;
-    double findMin(const QVector<DataPoint> &data) const;
-    double findMax(const QVector<DataPoint> &data) const;
-    
-    QVector<DataPoint> m_temperatureHistory;
-    QVector<DataPoint> m_voltageHistory;
-    QVector<DataPoint> m_pwmHistory;
-    
+    struct Channel {
+        ChannelInfo info;
+        ChannelStorage *storage;
+        DownsamplePyramid *pyramid;
+        RollingAggregator *rolling;
+        qint64 storeBaseRow;  // Lignes du store masquées par clearHistory()
+    };
+
+    void registerBuiltinChannels();
+    const Channel *findChannel(quint16 channelId) const;
+    bool storeHolds(const Channel *channel, qint64 fromNs) const;
+    qint64 locateSamples(const Channel *channel, qint64 fromNs, qint64 toNs, qint64 *first) const;
+    int readStoreRows(quint16 channelId, quint64 generation, qint64 firstRow, int count,
+                      QVector<qint64> *timestamps, QVector<double> *raw) const;  // -1: fichier changé
+    void rebuildPyramidFromStore(quint16 channelId, quint64 generation);
+
+    QHash<quint16, Channel *> m_channels;
+    QHash<QString, quint16> m_channelsByName;
+    ColumnStore *m_store;
+    quint64 m_storeGeneration;  // Incrémenté à chaque attachement/détachement
+    QThread *m_commitThread;
+    QTimer *m_commitTimer;      // Vit dans m_commitThread
+    bool m_commitQueued;        // Commit anticipé déjà demandé
+    qint64 m_storeRejected;     // Échantillons antérieurs à la fin du fichier
+
+    // Lecture partagée des lignes du fichier hors m_mutex; exclusif (pris
+    // après m_mutex) quand m_store ou ses mappages changent
+    mutable QReadWriteLock m_storeLock;
+
     int m_maxDataPoints;
+    bool m_compressHistory;
     mutable QMutex m_mutex;  // Protection pour accès multi-thread
 };
 
+Q_DECLARE_METATYPE(ChannelInfo)
+Q_DECLARE_METATYPE(DataModel::DataPoint)
+
 #endif // DATAMODEL_H
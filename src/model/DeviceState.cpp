@@ -12,17 +12,22 @@ DeviceState::DeviceState(QObject *parent)
     , m_uptime(0)
     , m_rxCharCount(0)
     , m_firmwareVersion("Unknown")
+    , m_lastUpdateNs(0)
+    , m_frameTimestampNs(0)
+    , m_updateDepth(0)
+    , m_version(0)
 {
+    qRegisterMetaType<DeviceState::Fields>("DeviceState::Fields");
+    m_snapshot = fieldsToJson(AllFields);
     qDebug() << "[DeviceState] Initialized";
 }
 
 void DeviceState::setConnected(bool connected)
 {
     if (m_connected != connected) {
+        UpdateBatch batch(this);
         m_connected = connected;
-        m_lastUpdate = QDateTime::currentDateTime();
-        emit connectedChanged(connected);
-        emit stateUpdated();
+        markChanged(ConnectedField);
         
         if (!connected) {
             // Reset state on disconnection
@@ -35,9 +40,7 @@ void DeviceState::setTemperature(float temp)
 {
     if (qAbs(m_temperature - temp) > 0.01f) {
         m_temperature = temp;
-        m_lastUpdate = QDateTime::currentDateTime();
-        emit temperatureChanged(temp);
-        emit stateUpdated();
+        markChanged(TemperatureField);
     }
 }
 
@@ -45,9 +48,7 @@ void DeviceState::setVoltage(float voltage)
 {
     if (qAbs(m_voltage - voltage) > 0.001f) {
         m_voltage = voltage;
-        m_lastUpdate = QDateTime::currentDateTime();
-        emit voltageChanged(voltage);
-        emit stateUpdated();
+        markChanged(VoltageField);
     }
 }
 
@@ -55,9 +56,7 @@ void DeviceState::setAdcRaw(uint16_t raw)
 {
     if (m_adcRaw != raw) {
         m_adcRaw = raw;
-        m_lastUpdate = QDateTime::currentDateTime();
-        emit adcRawChanged(raw);
-        emit stateUpdated();
+        markChanged(AdcRawField);
     }
 }
 
@@ -65,9 +64,7 @@ void DeviceState::setPwmDutyCycle(uint8_t duty)
 {
     if (m_pwmDutyCycle != duty) {
         m_pwmDutyCycle = duty;
-        m_lastUpdate = QDateTime::currentDateTime();
-        emit pwmDutyCycleChanged(duty);
-        emit stateUpdated();
+        markChanged(PwmDutyCycleField);
     }
 }
 
@@ -75,9 +72,7 @@ void DeviceState::setLedState(bool state)
 {
     if (m_ledState != state) {
         m_ledState = state;
-        m_lastUpdate = QDateTime::currentDateTime();
-        emit ledStateChanged(state);
-        emit stateUpdated();
+        markChanged(LedStateField);
     }
 }
 
@@ -85,9 +80,7 @@ void DeviceState::setUptime(quint32 uptime)
 {
     if (m_uptime != uptime) {
         m_uptime = uptime;
-        m_lastUpdate = QDateTime::currentDateTime();
-        emit uptimeChanged(uptime);
-        emit stateUpdated();
+        markChanged(UptimeField);
     }
 }
 
@@ -95,9 +88,7 @@ void DeviceState::setRxCharCount(quint32 count)
 {
     if (m_rxCharCount != count) {
         m_rxCharCount = count;
-        m_lastUpdate = QDateTime::currentDateTime();
-        emit rxCharCountChanged(count);
-        emit stateUpdated();
+        markChanged(RxCharCountField);
     }
 }
 
@@ -105,13 +96,120 @@ void DeviceState::setFirmwareVersion(const QString &version)
 {
     if (m_firmwareVersion != version) {
         m_firmwareVersion = version;
-        emit firmwareVersionChanged(version);
-        emit stateUpdated();
+        markChanged(FirmwareVersionField);
     }
 }
 
+// ============================================================================
+// MISES À JOUR GROUPÉES
+// ============================================================================
+
+void DeviceState::beginUpdate()
+{
+    m_updateDepth++;
+}
+
+void DeviceState::commitUpdate()
+{
+    if (m_updateDepth == 0) {
+        qDebug() << "[DeviceState] commitUpdate() without beginUpdate(), ignored";
+        return;
+    }
+
+    if (--m_updateDepth == 0 && m_pendingFields) {
+        const Fields fields = m_pendingFields;
+        m_pendingFields = NoField;
+        emitChanges(fields);
+    }
+}
+
+void DeviceState::markChanged(Field field)
+{
+    // La version du firmware ne date pas l'état
+    if (field != FirmwareVersionField) {
+        touch();
+    }
+
+    if (m_updateDepth > 0) {
+        m_pendingFields |= field;
+    } else {
+        emitChanges(field);
+    }
+}
+
+void DeviceState::emitChanges(Fields fields)
+{
+    record(fields);
+    emit stateChanged(fields);
+}
+
+// ============================================================================
+// VERSIONS ET JOURNAL
+// ============================================================================
+
+void DeviceState::record(Fields fields)
+{
+    Change change;
+    change.timestampNs = m_lastUpdateNs;
+    change.fields = fields;
+    change.values = fieldsToJson(fields);
+
+    QMutexLocker locker(&m_journalMutex);
+
+    change.version = ++m_version;
+    for (auto it = change.values.constBegin(); it != change.values.constEnd(); ++it) {
+        m_snapshot.insert(it.key(), it.value());
+    }
+
+    if (m_journal.size() >= JournalCapacity) {
+        m_journal.removeFirst();
+    }
+    m_journal.append(change);
+}
+
+quint64 DeviceState::version() const
+{
+    QMutexLocker locker(&m_journalMutex);
+    return m_version;
+}
+
+QList<DeviceState::Change> DeviceState::changesSince(quint64 version, bool *complete) const
+{
+    QMutexLocker locker(&m_journalMutex);
+
+    QList<Change> changes;
+    if (version >= m_version) {
+        if (complete) *complete = true;
+        return changes;
+    }
+
+    // Entrées évincées: le consommateur doit repartir d'un snapshot
+    const quint64 oldest = m_journal.isEmpty() ? m_version + 1 : m_journal.first().version;
+    if (complete) *complete = version + 1 >= oldest;
+
+    const int first = static_cast<int>(qMax<qint64>(0, qint64(version + 1) - qint64(oldest)));
+    changes.reserve(m_journal.size() - first);
+    for (int i = first; i < m_journal.size(); ++i) {
+        changes.append(m_journal.at(i));
+    }
+    return changes;
+}
+
+QJsonObject DeviceState::snapshot(quint64 *version) const
+{
+    QMutexLocker locker(&m_journalMutex);
+    if (version) *version = m_version;
+    return m_snapshot;
+}
+
+// ============================================================================
+// UTILITAIRES
+// ============================================================================
+
 void DeviceState::reset()
 {
+    UpdateBatch batch(this);
+    
     m_temperature = 0.0f;
     m_voltage = 0.0f;
     m_adcRaw = 0;
@@ -120,37 +218,40 @@ void DeviceState::reset()
     m_uptime = 0;
     m_rxCharCount = 0;
     
-    emit temperatureChanged(m_temperature);
-    emit voltageChanged(m_voltage);
-    emit adcRawChanged(m_adcRaw);
-    emit pwmDutyCycleChanged(m_pwmDutyCycle);
-    emit ledStateChanged(m_ledState);
-    emit uptimeChanged(m_uptime);
-    emit rxCharCountChanged(m_rxCharCount);
-    emit stateUpdated();
+    // Tous les champs remis à zéro sont notifiés, comme avant
+    m_pendingFields |= TemperatureField | VoltageField | AdcRawField | PwmDutyCycleField
+                     | LedStateField | UptimeField | RxCharCountField;
     
     qDebug() << "[DeviceState] Reset to default values";
 }
 
 QJsonObject DeviceState::toJson() const
 {
-    QJsonObject json;
-    json["connected"] = m_connected;
-    json["temperature"] = m_temperature;
-    json["voltage"] = m_voltage;
-    json["adc_raw"] = m_adcRaw;
-    json["pwm_duty"] = m_pwmDutyCycle;
-    json["led_state"] = m_ledState;
-    json["uptime"] = static_cast<qint64>(m_uptime);
-    json["rx_char_count"] = static_cast<qint64>(m_rxCharCount);
-    json["firmware_version"] = m_firmwareVersion;
-    json["last_update"] = m_lastUpdate.toString(Qt::ISODate);
+    QJsonObject json = fieldsToJson(AllFields);
+    json["last_update"] = lastUpdate().toString(Qt::ISODate);
     
     return json;
 }
 
+QJsonObject DeviceState::fieldsToJson(Fields fields) const
+{
+    QJsonObject json;
+    if (fields & ConnectedField) json["connected"] = m_connected;
+    if (fields & TemperatureField) json["temperature"] = m_temperature;
+    if (fields & VoltageField) json["voltage"] = m_voltage;
+    if (fields & AdcRawField) json["adc_raw"] = m_adcRaw;
+    if (fields & PwmDutyCycleField) json["pwm_duty"] = m_pwmDutyCycle;
+    if (fields & LedStateField) json["led_state"] = m_ledState;
+    if (fields & UptimeField) json["uptime"] = static_cast<qint64>(m_uptime);
+    if (fields & RxCharCountField) json["rx_char_count"] = static_cast<qint64>(m_rxCharCount);
+    if (fields & FirmwareVersionField) json["firmware_version"] = m_firmwareVersion;
+    return json;
+}
+
 void DeviceState::fromJson(const QJsonObject &json)
 {
+    UpdateBatch batch(this);
+    
     if (json.contains("temperature"))
         setTemperature(json["temperature"].toDouble());
     
@@ -5,29 +5,92 @@
 #include <QString>
 #include <QDateTime>
 #include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include "MonotonicClock.h"
 
 /**
  * @brief Classe représentant l'état complet du dispositif STM32
  * 
  * Cette classe fait partie du modèle (Model) dans l'architecture MVC.
  * Elle encapsule toutes les données d'état du microcontrôleur.
+ *
+ * Les setters appelés pendant le décodage d'une trame (beginFrame/endFrame)
+ * datent la mise à jour avec l'horodatage de réception de la trame; hors
+ * trame, ils lisent MonotonicClock.
+ *
+ * Mises à jour groupées: entre beginUpdate() et commitUpdate() (ou pendant
+ * la vie d'un UpdateBatch), les setters ne font qu'enregistrer les champs
+ * modifiés. Le commit émet un seul signal, stateChanged(champs): les
+ * valeurs finales se lisent par les getters. Les lots peuvent s'imbriquer:
+ * seul le commit le plus externe émet. Hors lot, chaque setter émet
+ * immédiatement stateChanged() pour son seul champ.
+ *
+ * Chaque notification incrémente version() et ajoute au journal (borné à
+ * JournalCapacity entrées) les valeurs des champs modifiés. Un consommateur
+ * lent demande changesSince(version vue): s'il a pris trop de retard
+ * (entrées évincées), il repart de snapshot(). Le journal est lisible depuis
+ * un autre thread.
  */
 class DeviceState : public QObject
 {
     Q_OBJECT
     
     // Propriétés Q_PROPERTY pour QML binding
-    Q_PROPERTY(bool connected READ isConnected WRITE setConnected NOTIFY connectedChanged)
-    Q_PROPERTY(float temperature READ temperature WRITE setTemperature NOTIFY temperatureChanged)
-    Q_PROPERTY(float voltage READ voltage WRITE setVoltage NOTIFY voltageChanged)
-    Q_PROPERTY(uint16_t adcRaw READ adcRaw WRITE setAdcRaw NOTIFY adcRawChanged)
-    Q_PROPERTY(uint8_t pwmDutyCycle READ pwmDutyCycle WRITE setPwmDutyCycle NOTIFY pwmDutyCycleChanged)
-    Q_PROPERTY(bool ledState READ ledState WRITE setLedState NOTIFY ledStateChanged)
-    Q_PROPERTY(quint32 uptime READ uptime WRITE setUptime NOTIFY uptimeChanged)
-    Q_PROPERTY(quint32 rxCharCount READ rxCharCount WRITE setRxCharCount NOTIFY rxCharCountChanged)
-    Q_PROPERTY(QString firmwareVersion READ firmwareVersion WRITE setFirmwareVersion NOTIFY firmwareVersionChanged)
+    Q_PROPERTY(bool connected READ isConnected WRITE setConnected NOTIFY stateChanged)
+    Q_PROPERTY(float temperature READ temperature WRITE setTemperature NOTIFY stateChanged)
+    Q_PROPERTY(float voltage READ voltage WRITE setVoltage NOTIFY stateChanged)
+    Q_PROPERTY(uint16_t adcRaw READ adcRaw WRITE setAdcRaw NOTIFY stateChanged)
+    Q_PROPERTY(uint8_t pwmDutyCycle READ pwmDutyCycle WRITE setPwmDutyCycle NOTIFY stateChanged)
+    Q_PROPERTY(bool ledState READ ledState WRITE setLedState NOTIFY stateChanged)
+    Q_PROPERTY(quint32 uptime READ uptime WRITE setUptime NOTIFY stateChanged)
+    Q_PROPERTY(quint32 rxCharCount READ rxCharCount WRITE setRxCharCount NOTIFY stateChanged)
+    Q_PROPERTY(QString firmwareVersion READ firmwareVersion WRITE setFirmwareVersion NOTIFY stateChanged)
 
 public:
+    // Champs d'état (masque transporté par stateChanged)
+    enum Field {
+        NoField              = 0x0000,
+        ConnectedField       = 0x0001,
+        TemperatureField     = 0x0002,
+        VoltageField         = 0x0004,
+        AdcRawField          = 0x0008,
+        PwmDutyCycleField    = 0x0010,
+        LedStateField        = 0x0020,
+        UptimeField          = 0x0040,
+        RxCharCountField     = 0x0080,
+        FirmwareVersionField = 0x0100,
+        AllFields            = 0x01FF
+    };
+    Q_DECLARE_FLAGS(Fields, Field)
+    Q_FLAG(Fields)
+
+    /**
+     * @brief Lot de mises à jour à portée de bloc (beginUpdate/commitUpdate)
+     */
+    class UpdateBatch
+    {
+    public:
+        explicit UpdateBatch(DeviceState *state) : m_state(state) { m_state->beginUpdate(); }
+        ~UpdateBatch() { m_state->commitUpdate(); }
+
+    private:
+        Q_DISABLE_COPY(UpdateBatch)
+        DeviceState *m_state;
+    };
+
+    // Entrée du journal: champs modifiés par une notification et leurs valeurs
+    struct Change {
+        quint64 version;
+        qint64 timestampNs;   // lastUpdateNs() au moment du commit
+        Fields fields;
+        QJsonObject values;   // Clés de toJson()
+
+        Change() : version(0), timestampNs(0) {}
+    };
+
+    static const int JournalCapacity = 1024;
+
     explicit DeviceState(QObject *parent = nullptr);
     
     // Getters
@@ -40,7 +103,17 @@ public:
     quint32 uptime() const { return m_uptime; }
     quint32 rxCharCount() const { return m_rxCharCount; }
     QString firmwareVersion() const { return m_firmwareVersion; }
-    QDateTime lastUpdate() const { return m_lastUpdate; }
+    qint64 lastUpdateNs() const { return m_lastUpdateNs; }
+    QDateTime lastUpdate() const { return MonotonicClock::toDateTime(m_lastUpdateNs); }
+    
+    // Horodatage (ns MonotonicClock) de la trame en cours de décodage
+    void beginFrame(qint64 timestampNs) { m_frameTimestampNs = timestampNs; }
+    void endFrame() { m_frameTimestampNs = 0; }
+    
+    // Mises à jour groupées (imbricables)
+    void beginUpdate();
+    void commitUpdate();
+    bool isUpdating() const { return m_updateDepth > 0; }
     
     // Setters
     void setConnected(bool connected);
@@ -57,21 +130,24 @@ public:
     void reset();
     QJsonObject toJson() const;
     void fromJson(const QJsonObject &json);
+    
+    // Versions et journal (thread-safe)
+    quint64 version() const;
+    QList<Change> changesSince(quint64 version, bool *complete = nullptr) const;
+    QJsonObject snapshot(quint64 *version) const;
     QString toString() const;
 
 signals:
-    void connectedChanged(bool connected);
-    void temperatureChanged(float temperature);
-    void voltageChanged(float voltage);
-    void adcRawChanged(uint16_t raw);
-    void pwmDutyCycleChanged(uint8_t duty);
-    void ledStateChanged(bool state);
-    void uptimeChanged(quint32 uptime);
-    void rxCharCountChanged(quint32 count);
-    void firmwareVersionChanged(const QString &version);
-    void stateUpdated();
+    // Une fois par lot (ou par setter hors lot); notifie aussi les Q_PROPERTY
+    void stateChanged(DeviceState::Fields fields);
 
 private:
+    void markChanged(Field field);
+    void emitChanges(Fields fields);
+    void record(Fields fields);
+    QJsonObject fieldsToJson(Fields fields) const;
+    void touch() { m_lastUpdateNs = m_frameTimestampNs != 0 ? m_frameTimestampNs : MonotonicClock::nowNs(); }
+    
     bool m_connected;
     float m_temperature;
     float m_voltage;
@@ -81,7 +157,18 @@ private:
     quint32 m_uptime;
     quint32 m_rxCharCount;
     QString m_firmwareVersion;
-    QDateTime m_lastUpdate;
+    qint64 m_lastUpdateNs;
+    qint64 m_frameTimestampNs;
+
+    int m_updateDepth;
+    Fields m_pendingFields;
+
+    mutable QMutex m_journalMutex;
+    quint64 m_version;
+    QList<Change> m_journal;
+    QJsonObject m_snapshot;    // État à m_version (lisible hors thread)
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(DeviceState::Fields)
+
 #endif // DEVICESTATE_H
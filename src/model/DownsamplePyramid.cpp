@@ -0,0 +1,352 @@
+#include "DownsamplePyramid.h"
+#include "ChannelStorage.h"
+#include <cmath>
+#include <limits>
+
+// ============================================================================
+// CASE
+// ============================================================================
+
+DownsamplePyramid::Bucket::Bucket()
+    : firstTimestamp(0)
+    , lastTimestamp(0)
+    , minTimestamp(0)
+    , maxTimestamp(0)
+    , min(std::numeric_limits<double>::max())
+    , max(std::numeric_limits<double>::lowest())
+    , sum(0.0)
+    , count(0)
+{
+}
+
+void DownsamplePyramid::Bucket::add(qint64 timestamp, double value)
+{
+    if (count == 0) {
+        firstTimestamp = timestamp;
+    }
+    lastTimestamp = timestamp;
+
+    if (value < min) {
+        min = value;
+        minTimestamp = timestamp;
+    }
+    if (value > max) {
+        max = value;
+        maxTimestamp = timestamp;
+    }
+
+    sum += value;
+    count++;
+}
+
+void DownsamplePyramid::Bucket::merge(const Bucket &other)
+{
+    if (other.count == 0) {
+        return;
+    }
+
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+
+    firstTimestamp = qMin(firstTimestamp, other.firstTimestamp);
+    lastTimestamp = qMax(lastTimestamp, other.lastTimestamp);
+
+    if (other.min < min) {
+        min = other.min;
+        minTimestamp = other.minTimestamp;
+    }
+    if (other.max > max) {
+        max = other.max;
+        maxTimestamp = other.maxTimestamp;
+    }
+
+    sum += other.sum;
+    count += other.count;
+}
+
+// ============================================================================
+// PYRAMIDE
+// ============================================================================
+
+DownsamplePyramid::DownsamplePyramid(int bucketsPerLevel, int maxLevels)
+    : m_bucketsPerLevel(qMax(2, bucketsPerLevel))
+    , m_maxLevels(qMax(1, maxLevels))
+    , m_sampleCount(0)
+{
+}
+
+void DownsamplePyramid::append(qint64 timestamp, double raw)
+{
+    Bucket carry;
+    carry.add(timestamp, raw);
+    m_sampleCount++;
+
+    // Propagation: une case scellée au niveau k alimente le niveau k + 1
+    for (int k = 0; k < m_maxLevels; ++k) {
+        if (k == m_levels.size()) {
+            m_levels.append(Level());
+        }
+
+        Level &level = m_levels[k];
+        level.open.merge(carry);
+        level.openChildren++;
+
+        if (level.openChildren < 2) {
+            return;
+        }
+
+        carry = level.open;
+        pushSealed(level, carry);
+        level.open = Bucket();
+        level.openChildren = 0;
+    }
+}
+
+void DownsamplePyramid::pushSealed(Level &level, const Bucket &bucket)
+{
+    // Allocation progressive jusqu'à la capacité, puis écrasement circulaire
+    if (level.ring.size() < m_bucketsPerLevel) {
+        level.ring.append(bucket);
+        level.count++;
+        return;
+    }
+
+    level.ring[level.head] = bucket;
+    level.head = (level.head + 1) % level.ring.size();
+    level.dropped = true;
+}
+
+void DownsamplePyramid::clear()
+{
+    m_levels.clear();
+    m_sampleCount = 0;
+}
+
+// ============================================================================
+// RECHERCHE
+// ============================================================================
+
+int DownsamplePyramid::lowerBound(const Level &level, qint64 from)
+{
+    // Première case dont la fin est >= from
+    int lo = 0;
+    int hi = level.count;
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (level.at(mid).lastTimestamp < from) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+int DownsamplePyramid::upperBound(const Level &level, qint64 to)
+{
+    // Première case qui commence après to
+    int lo = 0;
+    int hi = level.count;
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (level.at(mid).firstTimestamp <= to) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void DownsamplePyramid::collect(const ChannelStorage &raw, qint64 from, qint64 to, int budget,
+                                QVector<Bucket> *out) const
+{
+    out->clear();
+
+    // Niveau 0: échantillons bruts, si le buffer couvre le début de l'intervalle
+    const bool rawCovers = !raw.isEmpty()
+            && (raw.timestampAt(0) <= from || raw.size() >= m_sampleCount);
+    const int rawFirst = raw.lowerBound(from);
+    const int rawEnd = raw.upperBound(to);
+
+    if ((rawCovers && rawEnd - rawFirst <= budget) || m_levels.isEmpty()) {
+        out->reserve(qMax(0, rawEnd - rawFirst));
+        for (int i = rawFirst; i < rawEnd; ++i) {
+            Bucket sample;
+            sample.add(raw.timestampAt(i), raw.rawAt(i));
+            out->append(sample);
+        }
+        return;
+    }
+
+    // Niveau le plus fin couvrant l'intervalle avec au plus budget cases,
+    // à défaut le plus grossier (historique le plus long)
+    int chosen = m_levels.size() - 1;
+    for (int k = 0; k < m_levels.size(); ++k) {
+        const Level &level = m_levels[k];
+        const bool covers = !level.dropped || (level.count > 0 && level.at(0).firstTimestamp <= from);
+        if (covers && upperBound(level, to) - lowerBound(level, from) + 1 <= budget) {
+            chosen = k;
+            break;
+        }
+    }
+
+    const Level &level = m_levels[chosen];
+    const int first = lowerBound(level, from);
+    const int end = upperBound(level, to);
+
+    out->reserve(end - first + 1);
+    for (int i = first; i < end; ++i) {
+        out->append(level.at(i));
+    }
+
+    // Les cases ouvertes des niveaux <= chosen couvrent exactement les
+    // échantillons postérieurs à la dernière case scellée
+    Bucket tail;
+    for (int k = 0; k <= chosen; ++k) {
+        tail.merge(m_levels[k].open);
+    }
+    if (!tail.isEmpty() && tail.lastTimestamp >= from && tail.firstTimestamp <= to) {
+        out->append(tail);
+    }
+}
+
+// ============================================================================
+// REQUÊTES
+// ============================================================================
+
+QVector<DownsamplePyramid::Bucket> DownsamplePyramid::query(const ChannelStorage &raw, qint64 from,
+                                                            qint64 to, int maxColumns) const
+{
+    if (maxColumns < 1 || from > to) {
+        return QVector<Bucket>();
+    }
+
+    QVector<Bucket> sources;
+    collect(raw, from, to, maxColumns * OversamplingFactor, &sources);
+    return binColumns(sources, from, to, maxColumns);
+}
+
+QVector<DownsamplePyramid::Point> DownsamplePyramid::lttb(const ChannelStorage &raw, qint64 from,
+                                                          qint64 to, int maxPoints) const
+{
+    if (maxPoints < 1 || from > to) {
+        return QVector<Point>();
+    }
+
+    QVector<Bucket> sources;
+    collect(raw, from, to, maxPoints * OversamplingFactor, &sources);
+    return lttbFromBuckets(sources, maxPoints);
+}
+
+QVector<DownsamplePyramid::Bucket> DownsamplePyramid::binColumns(const QVector<Bucket> &sources,
+                                                                 qint64 from, qint64 to,
+                                                                 int maxColumns)
+{
+    QVector<Bucket> columns;
+    if (maxColumns < 1 || from > to) {
+        return columns;
+    }
+
+    // Regroupement par colonne de largeur constante (sources triées par temps)
+    const double width = (static_cast<double>(to) - from + 1.0) / maxColumns;
+    int currentColumn = -1;
+
+    for (const Bucket &bucket : sources) {
+        const qint64 position = qMax(bucket.firstTimestamp, from);
+        const int column = qMin(maxColumns - 1, static_cast<int>((position - from) / width));
+
+        if (column != currentColumn) {
+            columns.append(bucket);
+            currentColumn = column;
+        } else {
+            columns.last().merge(bucket);
+        }
+    }
+
+    return columns;
+}
+
+QVector<DownsamplePyramid::Point> DownsamplePyramid::lttbFromBuckets(const QVector<Bucket> &sources,
+                                                                     int maxPoints)
+{
+    // Chaque case fournit ses extrêmes dans l'ordre chronologique
+    QVector<Point> candidates;
+    candidates.reserve(sources.size() * 2);
+
+    for (const Bucket &bucket : sources) {
+        if (bucket.count == 1) {
+            candidates.append(Point(bucket.firstTimestamp, bucket.min));
+        } else if (bucket.minTimestamp <= bucket.maxTimestamp) {
+            candidates.append(Point(bucket.minTimestamp, bucket.min));
+            candidates.append(Point(bucket.maxTimestamp, bucket.max));
+        } else {
+            candidates.append(Point(bucket.maxTimestamp, bucket.max));
+            candidates.append(Point(bucket.minTimestamp, bucket.min));
+        }
+    }
+
+    return largestTriangles(candidates, maxPoints);
+}
+
+QVector<DownsamplePyramid::Point> DownsamplePyramid::largestTriangles(const QVector<Point> &points,
+                                                                      int threshold)
+{
+    const int n = points.size();
+    if (threshold >= n || n <= 2) {
+        return points;
+    }
+
+    QVector<Point> sampled;
+    sampled.reserve(threshold);
+    sampled.append(points.first());
+
+    if (threshold <= 2) {
+        if (threshold == 2) sampled.append(points.last());
+        return sampled;
+    }
+
+    // Abscisses relatives au premier point (précision du double)
+    const qint64 origin = points.first().first;
+    const double every = static_cast<double>(n - 2) / (threshold - 2);
+    int a = 0;
+
+    for (int i = 0; i < threshold - 2; ++i) {
+        // Moyenne de la case suivante (ou dernier point)
+        int avgStart = static_cast<int>(std::floor((i + 1) * every)) + 1;
+        int avgEnd = qMin(n, static_cast<int>(std::floor((i + 2) * every)) + 1);
+        if (avgStart >= avgEnd) {
+            avgStart = n - 1;
+            avgEnd = n;
+        }
+
+        double avgX = 0.0;
+        double avgY = 0.0;
+        for (int j = avgStart; j < avgEnd; ++j) {
+            avgX += points[j].first - origin;
+            avgY += points[j].second;
+        }
+        avgX /= (avgEnd - avgStart);
+        avgY /= (avgEnd - avgStart);
+
+        // Point de la case courante maximisant l'aire du triangle
+        const int rangeStart = static_cast<int>(std::floor(i * every)) + 1;
+        const int rangeEnd = qMin(n - 1, static_cast<int>(std::floor((i + 1) * every)) + 1);
+
+        const double ax = points[a].first - origin;
+        const double ay = points[a].second;
+        double maxArea = -1.0;
+        int next = rangeStart;
+
+        for (int j = rangeStart; j < rangeEnd; ++j) {
+            const double area = std::fabs((ax - avgX) * (points[j].second - ay)
+                                          - (ax - (points[j].first - origin)) * (avgY - ay));
+            if (area > maxArea) {
+                maxArea = area;
+                next = j;
+            }
+        }
+
+        sampled.append(points[next]);
+        a = next;
+    }
+
+    sampled.append(points.last());
+    return sampled;
+}
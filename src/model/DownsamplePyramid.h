@@ -0,0 +1,99 @@
+#ifndef DOWNSAMPLEPYRAMID_H
+#define DOWNSAMPLEPYRAMID_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QPair>
+
+class ChannelStorage;
+
+/**
+ * @brief Pyramide de sous-échantillonnage min/max/moyenne d'un canal
+ *
+ * Le niveau k agrège 2^k échantillons consécutifs par case. Les niveaux
+ * sont mis à jour incrémentalement à l'insertion (coût amorti O(1)):
+ * une case scellée au niveau k est fusionnée dans la case ouverte du
+ * niveau k + 1. Chaque niveau est un buffer circulaire de taille fixe,
+ * les niveaux grossiers conservent donc un historique bien plus long que
+ * le buffer brut. Les niveaux sont alloués à la demande.
+ *
+ * Une requête choisit le niveau le plus fin dont le nombre de cases dans
+ * l'intervalle reste proportionnel au nombre de colonnes demandées: le coût
+ * d'affichage ne dépend pas de la longueur de l'historique.
+ *
+ * Valeurs brutes (avant échelle). Non thread-safe: synchronisé par DataModel.
+ */
+class DownsamplePyramid
+{
+public:
+    struct Bucket {
+        qint64 firstTimestamp;
+        qint64 lastTimestamp;
+        qint64 minTimestamp;
+        qint64 maxTimestamp;
+        double min;
+        double max;
+        double sum;
+        quint32 count;
+
+        Bucket();
+        void add(qint64 timestamp, double value);
+        void merge(const Bucket &other);
+        bool isEmpty() const { return count == 0; }
+        double mean() const { return count ? sum / count : 0.0; }
+    };
+
+    typedef QPair<qint64, double> Point;
+
+    static const int DefaultBucketsPerLevel = 4096;
+    static const int DefaultMaxLevels = 24;
+    static const int OversamplingFactor = 4;  // Candidats lus par colonne demandée
+
+    explicit DownsamplePyramid(int bucketsPerLevel = DefaultBucketsPerLevel,
+                               int maxLevels = DefaultMaxLevels);
+
+    void append(qint64 timestamp, double raw);
+    void clear();
+
+    int levelCount() const { return m_levels.size(); }
+    qint64 sampleCount() const { return m_sampleCount; }
+
+    // Au plus maxColumns colonnes régulières sur [from, to] (colonnes vides omises)
+    QVector<Bucket> query(const ChannelStorage &raw, qint64 from, qint64 to, int maxColumns) const;
+
+    // Largest-Triangle-Three-Buckets sur les min/max du niveau choisi (MinMaxLTTB)
+    QVector<Point> lttb(const ChannelStorage &raw, qint64 from, qint64 to, int maxPoints) const;
+
+    // Étapes finales des requêtes, applicables à des cases d'une autre source
+    static QVector<Bucket> binColumns(const QVector<Bucket> &sources, qint64 from, qint64 to,
+                                      int maxColumns);
+    static QVector<Point> lttbFromBuckets(const QVector<Bucket> &sources, int maxPoints);
+
+private:
+    struct Level {
+        QVector<Bucket> ring;
+        int head;
+        int count;
+        bool dropped;       // Des cases anciennes ont été écrasées
+        Bucket open;        // Case en cours de remplissage
+        int openChildren;   // Nombre d'enfants fusionnés dans la case ouverte
+
+        Level() : head(0), count(0), dropped(false), openChildren(0) {}
+        const Bucket &at(int index) const { return ring[(head + index) % ring.size()]; }
+    };
+
+    void pushSealed(Level &level, const Bucket &bucket);
+    void collect(const ChannelStorage &raw, qint64 from, qint64 to, int budget,
+                 QVector<Bucket> *out) const;
+
+    static int lowerBound(const Level &level, qint64 from);
+    static int upperBound(const Level &level, qint64 to);
+    static QVector<Point> largestTriangles(const QVector<Point> &points, int threshold);
+
+    QVector<Level> m_levels;   // m_levels[i] = niveau i + 1 (2^(i+1) échantillons par case)
+    int m_bucketsPerLevel;
+    int m_maxLevels;
+    qint64 m_sampleCount;
+};
+
+#endif // DOWNSAMPLEPYRAMID_H
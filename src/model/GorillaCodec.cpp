@@ -0,0 +1,256 @@
+#include "GorillaCodec.h"
+#include <cstring>
+
+namespace {
+
+// Classes de delta de delta: largeur du champ signé
+const int DodBits[3] = { 14, 20, 32 };
+
+quint64 doubleBits(double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsDouble(quint64 bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool fitsSigned(qint64 value, int bits)
+{
+    const qint64 limit = qint64(1) << (bits - 1);
+    return value >= -limit && value < limit;
+}
+
+qint64 signExtend(quint64 bits, int n)
+{
+    const int shift = 64 - n;
+    return static_cast<qint64>(bits << shift) >> shift;
+}
+
+int leadingZeros(quint64 value)
+{
+    int n = 0;
+    for (quint64 mask = quint64(1) << 63; mask && !(value & mask); mask >>= 1) {
+        ++n;
+    }
+    return n;
+}
+
+int trailingZeros(quint64 value)
+{
+    int n = 0;
+    for (; n < 64 && !(value & 1); value >>= 1) {
+        ++n;
+    }
+    return n;
+}
+
+} // namespace
+
+// ============================================================================
+// ENCODEUR
+// ============================================================================
+
+GorillaEncoder::GorillaEncoder()
+    : m_pending(0)
+    , m_pendingBits(0)
+    , m_count(0)
+    , m_previousTimestamp(0)
+    , m_previousDelta(0)
+    , m_previousValue(0)
+    , m_leading(-1)
+    , m_trailing(0)
+{
+}
+
+void GorillaEncoder::writeBits(quint64 bits, int n)
+{
+    // Par tranches de 32 bits au plus pour ne pas déborder l'accumulateur
+    while (n > 32) {
+        n -= 32;
+        writeBits(bits >> n, 32);
+    }
+    if (n == 0) {
+        return;
+    }
+
+    m_pending = (m_pending << n) | (bits & ((quint64(1) << n) - 1));
+    m_pendingBits += n;
+
+    while (m_pendingBits >= 8) {
+        m_pendingBits -= 8;
+        m_data.append(static_cast<char>((m_pending >> m_pendingBits) & 0xFF));
+    }
+}
+
+void GorillaEncoder::append(qint64 timestamp, double value)
+{
+    const quint64 valueBits = doubleBits(value);
+
+    if (m_count == 0) {
+        writeBits(static_cast<quint64>(timestamp), 64);
+        writeBits(valueBits, 64);
+        m_previousTimestamp = timestamp;
+        m_previousValue = valueBits;
+        m_count = 1;
+        return;
+    }
+
+    // --- Horodatage ---
+    const qint64 delta = timestamp - m_previousTimestamp;
+    const qint64 dod = delta - m_previousDelta;
+
+    if (dod == 0) {
+        writeBits(0x0, 1);
+    } else if (fitsSigned(dod, DodBits[0])) {
+        writeBits(0x2, 2);
+        writeBits(static_cast<quint64>(dod), DodBits[0]);
+    } else if (fitsSigned(dod, DodBits[1])) {
+        writeBits(0x6, 3);
+        writeBits(static_cast<quint64>(dod), DodBits[1]);
+    } else if (fitsSigned(dod, DodBits[2])) {
+        writeBits(0xE, 4);
+        writeBits(static_cast<quint64>(dod), DodBits[2]);
+    } else {
+        writeBits(0xF, 4);
+        writeBits(static_cast<quint64>(dod), 64);
+    }
+
+    m_previousDelta = delta;
+    m_previousTimestamp = timestamp;
+
+    // --- Valeur ---
+    const quint64 xorBits = valueBits ^ m_previousValue;
+    m_previousValue = valueBits;
+
+    if (xorBits == 0) {
+        writeBits(0x0, 1);
+    } else {
+        const int leading = leadingZeros(xorBits);
+        const int trailing = trailingZeros(xorBits);
+
+        if (m_leading >= 0 && leading >= m_leading && trailing >= m_trailing) {
+            const int meaningful = 64 - m_leading - m_trailing;
+            writeBits(0x2, 2);
+            writeBits(xorBits >> m_trailing, meaningful);
+        } else {
+            const int meaningful = 64 - leading - trailing;
+            writeBits(0x3, 2);
+            writeBits(static_cast<quint64>(leading), 6);
+            writeBits(static_cast<quint64>(meaningful - 1), 6);
+            writeBits(xorBits >> trailing, meaningful);
+            m_leading = leading;
+            m_trailing = trailing;
+        }
+    }
+
+    m_count++;
+}
+
+QByteArray GorillaEncoder::finish()
+{
+    if (m_pendingBits > 0) {
+        writeBits(0, 8 - m_pendingBits);
+    }
+    m_data.squeeze();
+    return m_data;
+}
+
+// ============================================================================
+// DÉCODEUR
+// ============================================================================
+
+GorillaDecoder::GorillaDecoder(const QByteArray &data, int count)
+    : m_data(reinterpret_cast<const uchar *>(data.constData()))
+    , m_size(data.size())
+    , m_position(0)
+    , m_buffer(0)
+    , m_bufferBits(0)
+    , m_remaining(count)
+    , m_first(true)
+    , m_previousTimestamp(0)
+    , m_previousDelta(0)
+    , m_previousValue(0)
+    , m_leading(0)
+    , m_trailing(0)
+{
+}
+
+quint64 GorillaDecoder::readBits(int n)
+{
+    if (n > 32) {
+        const quint64 high = readBits(n - 32);
+        return (high << 32) | readBits(32);
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    // Recharge par octets (au-delà de la fin: zéros)
+    while (m_bufferBits <= 56) {
+        const quint64 byte = m_position < m_size ? m_data[m_position] : 0;
+        m_buffer |= byte << (56 - m_bufferBits);
+        m_bufferBits += 8;
+        m_position++;
+    }
+
+    const quint64 bits = m_buffer >> (64 - n);
+    m_buffer <<= n;
+    m_bufferBits -= n;
+    return bits;
+}
+
+bool GorillaDecoder::readBit()
+{
+    return readBits(1) != 0;
+}
+
+bool GorillaDecoder::next(qint64 *timestamp, double *value)
+{
+    if (m_remaining <= 0) {
+        return false;
+    }
+    m_remaining--;
+
+    if (m_first) {
+        m_first = false;
+        m_previousTimestamp = static_cast<qint64>(readBits(64));
+        m_previousValue = readBits(64);
+    } else {
+        // --- Horodatage ---
+        qint64 dod = 0;
+        if (readBit()) {
+            if (!readBit()) {
+                dod = signExtend(readBits(DodBits[0]), DodBits[0]);
+            } else if (!readBit()) {
+                dod = signExtend(readBits(DodBits[1]), DodBits[1]);
+            } else if (!readBit()) {
+                dod = signExtend(readBits(DodBits[2]), DodBits[2]);
+            } else {
+                dod = static_cast<qint64>(readBits(64));
+            }
+        }
+        m_previousDelta += dod;
+        m_previousTimestamp += m_previousDelta;
+
+        // --- Valeur ---
+        if (readBit()) {
+            if (readBit()) {
+                m_leading = static_cast<int>(readBits(6));
+                const int meaningful = static_cast<int>(readBits(6)) + 1;
+                m_trailing = 64 - m_leading - meaningful;
+            }
+            const int meaningful = 64 - m_leading - m_trailing;
+            m_previousValue ^= readBits(meaningful) << m_trailing;
+        }
+    }
+
+    if (timestamp) *timestamp = m_previousTimestamp;
+    if (value) *value = bitsDouble(m_previousValue);
+    return true;
+}
@@ -0,0 +1,85 @@
+#ifndef GORILLACODEC_H
+#define GORILLACODEC_H
+
+#include <QtGlobal>
+#include <QByteArray>
+
+/**
+ * @brief Encodeur de séries (horodatage, valeur) au format Gorilla
+ *
+ * Horodatages: delta de delta codé sur un préfixe de longueur variable.
+ * Les classes sont dimensionnées pour des nanosecondes (gigue de réception
+ * de l'ordre de la microseconde):
+ *   0                  delta identique
+ *   10   + 14 bits     |dod| < 8 µs
+ *   110  + 20 bits     |dod| < 0,5 ms
+ *   1110 + 32 bits     |dod| < 2,1 s
+ *   1111 + 64 bits     sinon
+ *
+ * Valeurs: XOR avec la valeur précédente (représentation IEEE 754 double).
+ *   0                                  valeur identique
+ *   10 + bits significatifs            dans la fenêtre précédente
+ *   11 + 6 bits zéros de tête + 6 bits (longueur - 1) + bits significatifs
+ *
+ * Le premier échantillon est écrit en clair (2 x 64 bits).
+ */
+class GorillaEncoder
+{
+public:
+    GorillaEncoder();
+
+    void append(qint64 timestamp, double value);
+    int count() const { return m_count; }
+
+    // Termine le flux (complète le dernier octet) et le retourne
+    QByteArray finish();
+
+private:
+    void writeBits(quint64 bits, int n);
+
+    QByteArray m_data;
+    quint64 m_pending;      // Bits en attente, alignés à droite
+    int m_pendingBits;
+
+    int m_count;
+    qint64 m_previousTimestamp;
+    qint64 m_previousDelta;
+    quint64 m_previousValue;
+    int m_leading;          // Fenêtre XOR courante (-1 = aucune)
+    int m_trailing;
+};
+
+/**
+ * @brief Décodeur en flux d'un bloc GorillaEncoder
+ *
+ * Lit les échantillons un à un, sans allocation. Le nombre d'échantillons
+ * n'est pas contenu dans le flux: il est fourni par le conteneur.
+ */
+class GorillaDecoder
+{
+public:
+    GorillaDecoder(const QByteArray &data, int count);
+
+    bool next(qint64 *timestamp, double *value);
+    int remaining() const { return m_remaining; }
+
+private:
+    quint64 readBits(int n);
+    bool readBit();
+
+    const uchar *m_data;
+    int m_size;
+    int m_position;         // Octet suivant à charger
+    quint64 m_buffer;       // Bits chargés, alignés à gauche
+    int m_bufferBits;
+
+    int m_remaining;
+    bool m_first;
+    qint64 m_previousTimestamp;
+    qint64 m_previousDelta;
+    quint64 m_previousValue;
+    int m_leading;
+    int m_trailing;
+};
+
+#endif // GORILLACODEC_H
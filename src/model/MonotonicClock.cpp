@@ -0,0 +1,25 @@
+#include "MonotonicClock.h"
+#include <QElapsedTimer>
+
+namespace {
+
+struct ClockAnchor
+{
+    QElapsedTimer timer;
+    qint64 epochNs;
+
+    ClockAnchor()
+    {
+        timer.start();
+        epochNs = QDateTime::currentMSecsSinceEpoch() * MonotonicClock::NsPerMs;
+    }
+};
+
+} // namespace
+
+qint64 MonotonicClock::nowNs()
+{
+    // Initialisation thread-safe (C++11), une seule lecture de l'heure murale
+    static const ClockAnchor anchor;
+    return anchor.epochNs + anchor.timer.nsecsElapsed();
+}
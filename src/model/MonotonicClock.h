@@ -0,0 +1,35 @@
+#ifndef MONOTONICCLOCK_H
+#define MONOTONICCLOCK_H
+
+#include <QtGlobal>
+#include <QDateTime>
+
+/**
+ * @brief Horloge monotone de l'application (nanosecondes)
+ *
+ * Les horodatages sont des nanosecondes depuis l'epoch Unix: l'heure murale
+ * est lue une seule fois au premier appel, puis l'horloge avance avec
+ * l'horloge stable du système (QElapsedTimer). Le coût d'un appel est celui
+ * d'une lecture de CLOCK_MONOTONIC, sans conversion de fuseau horaire, et
+ * deux appels successifs ne reculent jamais, même si l'heure système change.
+ *
+ * La conversion en heure murale (QDateTime) n'est faite que pour
+ * l'affichage et l'export.
+ */
+class MonotonicClock
+{
+public:
+    static const qint64 NsPerMs = 1000000;
+
+    // Instant courant en ns depuis l'epoch (thread-safe)
+    static qint64 nowNs();
+
+    static qint64 toEpochMs(qint64 ns) { return ns / NsPerMs; }
+    static qint64 fromEpochMs(qint64 ms) { return ms * NsPerMs; }
+    static QDateTime toDateTime(qint64 ns) { return QDateTime::fromMSecsSinceEpoch(toEpochMs(ns)); }
+
+private:
+    MonotonicClock() = delete;
+};
+
+#endif // MONOTONICCLOCK_H
@@ -0,0 +1,191 @@
+#include "QuantileSketch.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double Gamma = (1.0 + QuantileSketch::RelativeAccuracy) / (1.0 - QuantileSketch::RelativeAccuracy);
+const double LogGamma = std::log(Gamma);
+
+// Index de case d'une magnitude: ceil(log_gamma(v)), décalé pour être >= 0
+const int MinIndex = static_cast<int>(std::ceil(std::log(QuantileSketch::MinMagnitude) / LogGamma));
+const int MaxIndex = static_cast<int>(std::ceil(std::log(QuantileSketch::MaxMagnitude) / LogGamma));
+
+} // namespace
+
+QuantileSketch::QuantileSketch()
+    : m_zeroCount(0)
+{
+}
+
+// ============================================================================
+// STOCKAGE DENSE
+// ============================================================================
+
+void QuantileSketch::Store::add(int index, quint32 count)
+{
+    if (bins.isEmpty()) {
+        offset = index;
+        bins.resize(1);
+    } else if (index < offset) {
+        bins.insert(0, offset - index, 0);
+        offset = index;
+    } else if (index >= offset + bins.size()) {
+        bins.resize(index - offset + 1);
+    }
+
+    bins[index - offset] += count;
+    total += count;
+}
+
+void QuantileSketch::Store::subtract(int index, quint32 count)
+{
+    const int i = index - offset;
+    if (i < 0 || i >= bins.size()) {
+        return;
+    }
+
+    const quint32 removed = qMin(bins[i], count);
+    bins[i] -= removed;
+    total -= removed;
+}
+
+void QuantileSketch::Store::clear()
+{
+    bins.clear();
+    offset = 0;
+    total = 0;
+}
+
+// ============================================================================
+// AJOUT / FUSION
+// ============================================================================
+
+int QuantileSketch::keyOf(double value)
+{
+    const double magnitude = std::fabs(value);
+    if (!(magnitude >= MinMagnitude)) {  // Inclut NaN
+        return 0;
+    }
+
+    const int index = qBound(MinIndex,
+                             static_cast<int>(std::ceil(std::log(magnitude) / LogGamma)),
+                             MaxIndex);
+    const int key = index - MinIndex + 1;
+    return value > 0 ? key : -key;
+}
+
+double QuantileSketch::valueOf(int index)
+{
+    // Milieu (en erreur relative) de la case ]gamma^(i-1), gamma^i]
+    return 2.0 * std::pow(Gamma, index + MinIndex) / (Gamma + 1.0);
+}
+
+void QuantileSketch::addKey(int key, quint32 count)
+{
+    if (key > 0) {
+        m_positive.add(key - 1, count);
+    } else if (key < 0) {
+        m_negative.add(-key - 1, count);
+    } else {
+        m_zeroCount += count;
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch &other)
+{
+    for (int i = 0; i < other.m_positive.bins.size(); ++i) {
+        if (other.m_positive.bins[i] != 0) {
+            m_positive.add(other.m_positive.offset + i, other.m_positive.bins[i]);
+        }
+    }
+    for (int i = 0; i < other.m_negative.bins.size(); ++i) {
+        if (other.m_negative.bins[i] != 0) {
+            m_negative.add(other.m_negative.offset + i, other.m_negative.bins[i]);
+        }
+    }
+    m_zeroCount += other.m_zeroCount;
+}
+
+void QuantileSketch::subtract(const QuantileSketch &other)
+{
+    for (int i = 0; i < other.m_positive.bins.size(); ++i) {
+        if (other.m_positive.bins[i] != 0) {
+            m_positive.subtract(other.m_positive.offset + i, other.m_positive.bins[i]);
+        }
+    }
+    for (int i = 0; i < other.m_negative.bins.size(); ++i) {
+        if (other.m_negative.bins[i] != 0) {
+            m_negative.subtract(other.m_negative.offset + i, other.m_negative.bins[i]);
+        }
+    }
+    m_zeroCount -= qMin(m_zeroCount, other.m_zeroCount);
+
+    // Libère le stockage d'une esquisse redevenue vide
+    if (m_positive.total == 0) {
+        m_positive.clear();
+    }
+    if (m_negative.total == 0) {
+        m_negative.clear();
+    }
+}
+
+void QuantileSketch::clear()
+{
+    m_positive.clear();
+    m_negative.clear();
+    m_zeroCount = 0;
+}
+
+// ============================================================================
+// QUANTILES
+// ============================================================================
+
+double QuantileSketch::quantile(double q) const
+{
+    double value;
+    quantiles(&q, 1, &value);
+    return value;
+}
+
+void QuantileSketch::quantiles(const double *qs, int n, double *values) const
+{
+    const quint64 total = count();
+    if (total == 0) {
+        for (int k = 0; k < n; ++k) {
+            values[k] = std::numeric_limits<double>::quiet_NaN();
+        }
+        return;
+    }
+
+    // Parcours par valeurs croissantes: négatifs (clé décroissante), zéro, positifs
+    int k = 0;
+    quint64 cumulative = 0;
+    auto rankOf = [&](int i) {
+        return static_cast<quint64>(qBound(0.0, qs[i], 1.0) * static_cast<double>(total - 1));
+    };
+
+    for (int i = m_negative.bins.size() - 1; i >= 0 && k < n; --i) {
+        cumulative += m_negative.bins[i];
+        while (k < n && rankOf(k) < cumulative) {
+            values[k++] = -valueOf(m_negative.offset + i);
+        }
+    }
+
+    cumulative += m_zeroCount;
+    while (k < n && rankOf(k) < cumulative) {
+        values[k++] = 0.0;
+    }
+
+    for (int i = 0; i < m_positive.bins.size() && k < n; ++i) {
+        cumulative += m_positive.bins[i];
+        while (k < n && rankOf(k) < cumulative) {
+            values[k++] = valueOf(m_positive.offset + i);
+        }
+    }
+
+    // Garde-fou (arrondis): rang au-delà du total
+    while (k < n) {
+        values[k++] = m_positive.total > 0 ? valueOf(m_positive.offset + m_positive.bins.size() - 1) : 0.0;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+#include <QtGlobal>
+#include <QVector>
+
+/**
+ * @brief Esquisse de quantiles à erreur relative bornée (type DDSketch)
+ *
+ * Chaque valeur est comptée dans une case logarithmique de rapport
+ * gamma = (1 + a) / (1 - a): tout quantile est restitué à une erreur
+ * relative a (RelativeAccuracy) près, quel que soit le nombre de valeurs.
+ * Les valeurs positives et négatives ont chacune leur stockage dense,
+ * alloué entre la plus petite et la plus grande case utilisées; les
+ * magnitudes hors [MinMagnitude, MaxMagnitude] sont ramenées aux bornes,
+ * ce qui borne la mémoire.
+ *
+ * Les esquisses sont fusionnables (merge) et, les cases étant fixes, une
+ * esquisse incluse dans une autre peut en être retirée (subtract): c'est
+ * ce qui permet les fenêtres glissantes de RollingAggregator.
+ *
+ * La clé d'une valeur (keyOf) peut être calculée une fois et ajoutée à
+ * plusieurs esquisses (addKey) pour éviter des logarithmes redondants.
+ */
+class QuantileSketch
+{
+public:
+    static constexpr double RelativeAccuracy = 0.01;
+    static constexpr double MinMagnitude = 1e-9;   // En dessous: compté comme zéro
+    static constexpr double MaxMagnitude = 1e12;
+
+    QuantileSketch();
+
+    // Clé signée: 0 = zéro, > 0 valeurs positives, < 0 valeurs négatives
+    static int keyOf(double value);
+
+    void add(double value) { addKey(keyOf(value)); }
+    void addKey(int key, quint32 count = 1);
+    void merge(const QuantileSketch &other);
+    void subtract(const QuantileSketch &other);  // other doit être inclus dans *this
+    void clear();
+
+    quint64 count() const { return m_positive.total + m_negative.total + m_zeroCount; }
+    bool isEmpty() const { return count() == 0; }
+
+    // Quantile q dans [0, 1] (NaN si vide)
+    double quantile(double q) const;
+    // Plusieurs quantiles croissants en un seul parcours
+    void quantiles(const double *qs, int n, double *values) const;
+
+private:
+    struct Store {
+        int offset;
+        QVector<quint32> bins;
+        quint64 total;
+
+        Store() : offset(0), total(0) {}
+        void add(int index, quint32 count);
+        void subtract(int index, quint32 count);
+        void clear();
+    };
+
+    static double valueOf(int index);
+
+    Store m_positive;
+    Store m_negative;
+    quint64 m_zeroCount;
+};
+
+#endif // QUANTILESKETCH_H
@@ -0,0 +1,221 @@
+#include "RollingAggregator.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const qint64 NsPerSecond = 1000000000LL;
+const qint64 NoSlot = std::numeric_limits<qint64>::min();
+
+// Division entière arrondie vers -infini
+qint64 slotOf(qint64 timestampNs, qint64 bucketNs)
+{
+    qint64 slot = timestampNs / bucketNs;
+    if (timestampNs % bucketNs < 0) {
+        --slot;
+    }
+    return slot;
+}
+
+int bucketIndex(qint64 slot)
+{
+    const qint64 index = slot % RollingAggregator::BucketsPerWindow;
+    return static_cast<int>(index < 0 ? index + RollingAggregator::BucketsPerWindow : index);
+}
+
+} // namespace
+
+RollingAggregator::Stats::Stats()
+    : spanNs(0)
+    , count(0)
+    , mean(0.0)
+    , min(0.0)
+    , max(0.0)
+    , stddev(0.0)
+    , p50(0.0)
+    , p95(0.0)
+    , p99(0.0)
+{
+}
+
+RollingAggregator::Bucket::Bucket()
+{
+    reset(NoSlot);
+}
+
+void RollingAggregator::Bucket::reset(qint64 bucketSlot)
+{
+    slot = bucketSlot;
+    count = 0;
+    sum = 0.0;
+    sumSq = 0.0;
+    min = std::numeric_limits<double>::max();
+    max = std::numeric_limits<double>::lowest();
+    sketch.clear();
+}
+
+RollingAggregator::RollingAggregator()
+    : m_reference(0.0)
+    , m_hasReference(false)
+{
+    for (int w = 0; w < WindowCount; ++w) {
+        Ring &ring = m_rings[w];
+        ring.bucketNs = windowSpanNs(static_cast<Window>(w)) / BucketsPerWindow;
+        ring.headSlot = NoSlot;
+        ring.buckets.resize(BucketsPerWindow);
+        ring.cacheValid = false;
+    }
+}
+
+qint64 RollingAggregator::windowSpanNs(Window window)
+{
+    switch (window) {
+        case Window1s: return NsPerSecond;
+        case Window1min: return 60 * NsPerSecond;
+        case Window1h: return 3600 * NsPerSecond;
+        default: return NsPerSecond;
+    }
+}
+
+void RollingAggregator::clear()
+{
+    for (Ring &ring : m_rings) {
+        for (Bucket &bucket : ring.buckets) {
+            bucket.reset(NoSlot);
+        }
+        ring.sketch.clear();
+        ring.headSlot = NoSlot;
+        ring.cacheValid = false;
+    }
+    m_hasReference = false;
+}
+
+// ============================================================================
+// MISE À JOUR
+// ============================================================================
+
+void RollingAggregator::advance(Ring &ring, qint64 slot)
+{
+    if (ring.headSlot != NoSlot && slot <= ring.headSlot) {
+        return;
+    }
+
+    // Saut plus long que la fenêtre: tout expire
+    if (ring.headSlot == NoSlot || slot - ring.headSlot >= BucketsPerWindow) {
+        for (int i = 0; i < BucketsPerWindow; ++i) {
+            ring.buckets[bucketIndex(slot - i)].reset(slot - i);
+        }
+        ring.sketch.clear();
+    } else {
+        for (qint64 s = ring.headSlot + 1; s <= slot; ++s) {
+            Bucket &bucket = ring.buckets[bucketIndex(s)];
+            if (bucket.count > 0) {
+                ring.sketch.subtract(bucket.sketch);
+            }
+            bucket.reset(s);
+        }
+    }
+
+    ring.headSlot = slot;
+    ring.cacheValid = false;
+}
+
+void RollingAggregator::add(qint64 timestampNs, double value)
+{
+    if (std::isnan(value)) {
+        return;
+    }
+
+    if (!m_hasReference) {
+        m_reference = value;
+        m_hasReference = true;
+    }
+
+    const int key = QuantileSketch::keyOf(value);
+    const double centered = value - m_reference;
+
+    for (Ring &ring : m_rings) {
+        const qint64 slot = slotOf(timestampNs, ring.bucketNs);
+        advance(ring, slot);
+
+        // Échantillon plus ancien que la fenêtre
+        if (slot <= ring.headSlot - BucketsPerWindow) {
+            continue;
+        }
+
+        Bucket &bucket = ring.buckets[bucketIndex(slot)];
+        if (bucket.slot != slot) {
+            continue;
+        }
+
+        bucket.count++;
+        bucket.sum += centered;
+        bucket.sumSq += centered * centered;
+        bucket.min = qMin(bucket.min, value);
+        bucket.max = qMax(bucket.max, value);
+        bucket.sketch.addKey(key);
+        ring.sketch.addKey(key);
+        ring.cacheValid = false;
+    }
+}
+
+// ============================================================================
+// LECTURE
+// ============================================================================
+
+RollingAggregator::Stats RollingAggregator::stats(Window window, qint64 nowNs)
+{
+    if (window < 0 || window >= WindowCount) {
+        return Stats();
+    }
+
+    Ring &ring = m_rings[window];
+    advance(ring, slotOf(nowNs, ring.bucketNs));
+
+    if (ring.cacheValid) {
+        return ring.cache;
+    }
+
+    Stats result;
+    result.spanNs = windowSpanNs(window);
+
+    double sum = 0.0;
+    double sumSq = 0.0;
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+
+    for (const Bucket &bucket : qAsConst(ring.buckets)) {
+        if (bucket.count == 0) {
+            continue;
+        }
+        result.count += bucket.count;
+        sum += bucket.sum;
+        sumSq += bucket.sumSq;
+        min = qMin(min, bucket.min);
+        max = qMax(max, bucket.max);
+    }
+
+    if (result.count > 0) {
+        const double n = static_cast<double>(result.count);
+        result.mean = m_reference + sum / n;
+        result.min = min;
+        result.max = max;
+
+        if (result.count > 1) {
+            const double variance = (sumSq - sum * sum / n) / (n - 1.0);
+            result.stddev = std::sqrt(qMax(0.0, variance));
+        }
+
+        // Quantiles approchés, bornés par les extrêmes exacts
+        static const double Quantiles[3] = { 0.50, 0.95, 0.99 };
+        double values[3];
+        ring.sketch.quantiles(Quantiles, 3, values);
+        result.p50 = qBound(min, values[0], max);
+        result.p95 = qBound(min, values[1], max);
+        result.p99 = qBound(min, values[2], max);
+    }
+
+    ring.cache = result;
+    ring.cacheValid = true;
+    return result;
+}
@@ -0,0 +1,88 @@
+#ifndef ROLLINGAGGREGATOR_H
+#define ROLLINGAGGREGATOR_H
+
+#include <QtGlobal>
+#include <QVector>
+#include "QuantileSketch.h"
+
+/**
+ * @brief Agrégats glissants d'un canal sur 1 s, 1 min et 1 h
+ *
+ * Chaque fenêtre est un anneau de BucketsPerWindow cases de durée fixe
+ * (1 s / 60, 1 s, 1 min). Une case accumule nombre, somme, somme des carrés
+ * (autour d'une valeur de référence, pour limiter les annulations), min, max
+ * et une QuantileSketch. La fenêtre entretient en plus l'esquisse cumulée de
+ * ses cases vivantes: la case qui sort de la fenêtre est soustraite.
+ *
+ * stats() ne lit que les cases (coût constant, indépendant du nombre
+ * d'échantillons) et met son résultat en cache jusqu'à la prochaine
+ * modification. La fenêtre couvre les cases (tête - 60, tête]: sa durée
+ * effective varie d'une case au plus.
+ *
+ * Valeurs physiques. Non thread-safe: synchronisé par DataModel.
+ */
+class RollingAggregator
+{
+public:
+    enum Window {
+        Window1s,
+        Window1min,
+        Window1h,
+        WindowCount
+    };
+
+    static const int BucketsPerWindow = 60;
+
+    struct Stats {
+        qint64 spanNs;
+        quint64 count;
+        double mean;
+        double min;
+        double max;
+        double stddev;
+        double p50;
+        double p95;
+        double p99;
+
+        Stats();
+    };
+
+    RollingAggregator();
+
+    void add(qint64 timestampNs, double value);
+    Stats stats(Window window, qint64 nowNs);
+    void clear();
+
+    static qint64 windowSpanNs(Window window);
+
+private:
+    struct Bucket {
+        qint64 slot;
+        quint64 count;
+        double sum;     // Somme de (valeur - m_reference)
+        double sumSq;
+        double min;
+        double max;
+        QuantileSketch sketch;
+
+        Bucket();
+        void reset(qint64 bucketSlot);
+    };
+
+    struct Ring {
+        qint64 bucketNs;
+        qint64 headSlot;
+        QVector<Bucket> buckets;
+        QuantileSketch sketch;   // Somme des esquisses des cases vivantes
+        bool cacheValid;
+        Stats cache;
+    };
+
+    void advance(Ring &ring, qint64 slot);
+
+    Ring m_rings[WindowCount];
+    double m_reference;
+    bool m_hasReference;
+};
+
+#endif // ROLLINGAGGREGATOR_H
@@ -0,0 +1,774 @@
+#include "ColumnStore.h"
+#include <QFile>
+#include <QDir>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDebug>
+#include <cerrno>
+#include <cstring>
+#include <cstddef>
+#include <limits>
+
+#if defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#include <io.h>
+#include <stdio.h>
+#endif
+
+// ============================================================================
+// FORMAT SUR DISQUE
+// ============================================================================
+
+namespace {
+
+const quint32 HeaderMagic = 0x53544353;  // "STCS"
+const quint16 HeaderVersion = 2;  // v2: horodatages en ns
+const int HeaderSlotCount = 2;
+
+// En-tête d'un canal (little-endian, 64 octets par emplacement)
+struct SlotHeader {
+    quint32 magic;
+    quint16 version;
+    quint16 channelId;
+    quint64 sequence;
+    qint64 rowCount;
+    qint64 indexCount;
+    qint64 firstTimestamp;
+    qint64 lastTimestamp;
+    quint32 storageType;
+    quint32 valueSize;
+    quint32 reserved;
+    quint32 crc;         // CRC32 des 60 octets précédents
+};
+static_assert(sizeof(SlotHeader) == 64, "SlotHeader doit faire 64 octets");
+
+struct IndexEntry {
+    qint64 timestamp;
+    qint64 row;
+};
+static_assert(sizeof(IndexEntry) == 16, "IndexEntry doit faire 16 octets");
+
+quint32 crc32(const void *data, size_t length)
+{
+    static quint32 table[256];
+    static bool tableReady = false;
+
+    if (!tableReady) {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        tableReady = true;
+    }
+
+    const uchar *bytes = static_cast<const uchar *>(data);
+    quint32 crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+quint32 headerCrc(const SlotHeader &header)
+{
+    return crc32(&header, offsetof(SlotHeader, crc));
+}
+
+// Synchronisation disque d'une plage mappée (asynchrone: écriture lancée
+// seulement, la durabilité vient du fsync du fichier)
+void syncMappedRange(uchar *map, qint64 from, qint64 to, bool async = false)
+{
+    if (!map || to <= from) {
+        return;
+    }
+
+#if defined(Q_OS_UNIX)
+    const qint64 page = ::sysconf(_SC_PAGESIZE);
+    const qint64 start = from - from % page;
+    ::msync(map + start, static_cast<size_t>(to - start), async ? MS_ASYNC : MS_SYNC);
+#elif defined(Q_OS_WIN)
+    Q_UNUSED(async)
+    ::FlushViewOfFile(map + from, static_cast<SIZE_T>(to - from));
+#endif
+}
+
+bool syncDescriptor(int fd)
+{
+#if defined(Q_OS_UNIX)
+    return ::fsync(fd) == 0;
+#elif defined(Q_OS_WIN)
+    return ::FlushFileBuffers(reinterpret_cast<HANDLE>(::_get_osfhandle(fd))) != 0;
+#else
+    Q_UNUSED(fd)
+    return true;
+#endif
+}
+
+void syncFile(QFile &file)
+{
+    file.flush();
+    syncDescriptor(file.handle());
+}
+
+// Descripteurs propres au commit différé
+int duplicateDescriptor(const QFile &file)
+{
+#if defined(Q_OS_UNIX)
+    return ::dup(file.handle());
+#elif defined(Q_OS_WIN)
+    return ::_dup(file.handle());
+#else
+    Q_UNUSED(file)
+    return -1;
+#endif
+}
+
+void closeDescriptor(int fd)
+{
+    if (fd < 0) {
+        return;
+    }
+
+#if defined(Q_OS_UNIX)
+    ::close(fd);
+#elif defined(Q_OS_WIN)
+    ::_close(fd);
+#endif
+}
+
+bool writeDescriptor(int fd, qint64 offset, const QByteArray &data)
+{
+#if defined(Q_OS_UNIX)
+    return ::pwrite(fd, data.constData(), static_cast<size_t>(data.size()), static_cast<off_t>(offset)) == data.size();
+#elif defined(Q_OS_WIN)
+    return ::_lseeki64(fd, offset, SEEK_SET) == offset
+            && ::_write(fd, data.constData(), static_cast<unsigned int>(data.size())) == data.size();
+#else
+    Q_UNUSED(fd) Q_UNUSED(offset) Q_UNUSED(data)
+    return false;
+#endif
+}
+
+} // namespace
+
+// ============================================================================
+// COLONNES D'UN CANAL
+// ============================================================================
+
+struct ColumnStore::Column {
+    ChannelInfo info;
+    int valueSize;
+
+    QFile tsFile;
+    QFile valFile;
+    QFile idxFile;
+    QFile hdrFile;
+
+    uchar *tsMap;
+    uchar *valMap;
+    qint64 capacityRows;
+
+    qint64 rows;
+    qint64 committedRows;
+    qint64 firstTimestamp;
+    qint64 lastTimestamp;
+    quint64 sequence;
+
+    QVector<IndexEntry> index;  // Index creux gardé en mémoire (rows / IndexStride entrées)
+
+    Column()
+        : valueSize(8)
+        , tsMap(nullptr)
+        , valMap(nullptr)
+        , capacityRows(0)
+        , rows(0)
+        , committedRows(0)
+        , firstTimestamp(0)
+        , lastTimestamp(0)
+        , sequence(0)
+    {
+    }
+
+    // En-tête du prochain commit (séquence suivante, lignes actuelles)
+    SlotHeader nextHeader() const
+    {
+        SlotHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic = HeaderMagic;
+        header.version = HeaderVersion;
+        header.channelId = info.id;
+        header.sequence = sequence + 1;
+        header.rowCount = rows;
+        header.indexCount = index.size();
+        header.firstTimestamp = firstTimestamp;
+        header.lastTimestamp = lastTimestamp;
+        header.storageType = static_cast<quint32>(info.storageType);
+        header.valueSize = static_cast<quint32>(valueSize);
+        header.crc = headerCrc(header);
+        return header;
+    }
+};
+
+ColumnStore::ColumnStore(const QString &directory)
+    : m_directory(directory)
+    , m_open(false)
+    , m_commitDue(false)
+{
+}
+
+ColumnStore::~ColumnStore()
+{
+    close();
+}
+
+QString ColumnStore::columnPath(quint16 channelId, const char *suffix) const
+{
+    return QDir(m_directory).filePath(QString("ch%1.%2").arg(channelId).arg(QLatin1String(suffix)));
+}
+
+ColumnStore::Column *ColumnStore::findColumn(quint16 channelId) const
+{
+    return m_columns.value(channelId, nullptr);
+}
+
+// ============================================================================
+// OUVERTURE / FERMETURE
+// ============================================================================
+
+bool ColumnStore::open()
+{
+    if (m_open) {
+        return true;
+    }
+
+    if (!QDir().mkpath(m_directory)) {
+        m_lastError = QString("Impossible de créer le répertoire %1").arg(m_directory);
+        qDebug() << "[ColumnStore]" << m_lastError;
+        return false;
+    }
+
+    m_open = true;
+
+    if (!loadCatalog()) {
+        close();
+        return false;
+    }
+
+    qDebug() << "[ColumnStore] Opened" << m_directory << "with" << m_columns.size() << "channels";
+    return true;
+}
+
+void ColumnStore::close()
+{
+    for (Column *column : qAsConst(m_columns)) {
+        closeColumn(column);
+        delete column;
+    }
+    m_columns.clear();
+
+    if (m_open) {
+        qDebug() << "[ColumnStore] Closed" << m_directory;
+    }
+    m_open = false;
+}
+
+bool ColumnStore::loadCatalog()
+{
+    QFile file(QDir(m_directory).filePath("channels.json"));
+    if (!file.exists()) {
+        return true;  // Nouvelle capture
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_lastError = QString("Catalogue illisible: %1").arg(file.errorString());
+        qDebug() << "[ColumnStore]" << m_lastError;
+        return false;
+    }
+
+    const QJsonArray channels = QJsonDocument::fromJson(file.readAll()).object()["channels"].toArray();
+
+    for (const QJsonValue &value : channels) {
+        bool ok;
+        const ChannelInfo info = ChannelInfo::fromJson(value.toObject(), &ok);
+        if (!ok || m_columns.contains(info.id)) {
+            continue;
+        }
+
+        Column *column = new Column;
+        column->info = info;
+        column->valueSize = ChannelInfo::storageSize(info.storageType);
+
+        if (!openColumn(column)) {
+            delete column;
+            return false;
+        }
+        m_columns.insert(info.id, column);
+    }
+
+    return true;
+}
+
+bool ColumnStore::saveCatalog()
+{
+    QJsonArray channels;
+    for (const Column *column : qAsConst(m_columns)) {
+        channels.append(column->info.toJson());
+    }
+
+    QJsonObject catalog;
+    catalog["version"] = HeaderVersion;
+    catalog["channels"] = channels;
+
+    // Écriture atomique (fichier temporaire + renommage)
+    QSaveFile file(QDir(m_directory).filePath("channels.json"));
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_lastError = QString("Catalogue non enregistré: %1").arg(file.errorString());
+        qDebug() << "[ColumnStore]" << m_lastError;
+        return false;
+    }
+
+    file.write(QJsonDocument(catalog).toJson());
+    return file.commit();
+}
+
+bool ColumnStore::openColumn(Column *column)
+{
+    const quint16 id = column->info.id;
+    column->tsFile.setFileName(columnPath(id, "ts"));
+    column->valFile.setFileName(columnPath(id, "val"));
+    column->idxFile.setFileName(columnPath(id, "idx"));
+    column->hdrFile.setFileName(columnPath(id, "hdr"));
+
+    QFile *files[] = { &column->tsFile, &column->valFile, &column->idxFile, &column->hdrFile };
+    for (QFile *file : files) {
+        if (!file->open(QIODevice::ReadWrite)) {
+            m_lastError = QString("%1: %2").arg(file->fileName(), file->errorString());
+            qDebug() << "[ColumnStore]" << m_lastError;
+            return false;
+        }
+    }
+
+    // En-tête valide de plus haute séquence
+    SlotHeader best;
+    bool found = false;
+
+    for (int slot = 0; slot < HeaderSlotCount; ++slot) {
+        SlotHeader header;
+        column->hdrFile.seek(slot * sizeof(SlotHeader));
+        if (column->hdrFile.read(reinterpret_cast<char *>(&header), sizeof(header)) != sizeof(header)) {
+            continue;
+        }
+        if (header.magic != HeaderMagic || header.version != HeaderVersion
+                || header.channelId != id || header.crc != headerCrc(header)) {
+            continue;
+        }
+        if (!found || header.sequence > best.sequence) {
+            best = header;
+            found = true;
+        }
+    }
+
+    if (found) {
+        // Le type du fichier prime: les nouvelles valeurs sont converties
+        column->info.storageType = static_cast<ChannelInfo::StorageType>(best.storageType);
+        column->valueSize = static_cast<int>(best.valueSize);
+        column->sequence = best.sequence;
+        column->firstTimestamp = best.firstTimestamp;
+        column->lastTimestamp = best.lastTimestamp;
+
+        // Borne par la taille réelle des colonnes (protection contre un en-tête incohérent)
+        column->rows = qMin(best.rowCount,
+                            qMin(column->tsFile.size() / qint64(sizeof(qint64)),
+                                 column->valFile.size() / column->valueSize));
+    }
+
+    column->committedRows = column->rows;
+
+    // Index: entrées validées uniquement, la fin non validée est tronquée
+    const qint64 indexCount = found ? qMin(best.indexCount, column->idxFile.size() / qint64(sizeof(IndexEntry))) : 0;
+    column->index.resize(static_cast<int>(indexCount));
+    column->idxFile.seek(0);
+    column->idxFile.read(reinterpret_cast<char *>(column->index.data()), indexCount * sizeof(IndexEntry));
+    while (!column->index.isEmpty() && column->index.last().row >= column->rows) {
+        column->index.removeLast();
+    }
+    column->idxFile.resize(column->index.size() * qint64(sizeof(IndexEntry)));
+    column->idxFile.seek(column->idxFile.size());
+
+    if (!growColumn(column, column->rows + 1)) {
+        return false;
+    }
+
+    if (column->rows > 0) {
+        qDebug() << "[ColumnStore] Channel" << id << "reopened with" << column->rows << "rows";
+    }
+    return true;
+}
+
+bool ColumnStore::growColumn(Column *column, qint64 minRows)
+{
+    const qint64 capacity = ((minRows + GrowRows - 1) / GrowRows) * GrowRows;
+    if (capacity <= column->capacityRows && column->tsMap && column->valMap) {
+        return true;
+    }
+
+    if (column->tsMap) column->tsFile.unmap(column->tsMap);
+    if (column->valMap) column->valFile.unmap(column->valMap);
+    column->tsMap = nullptr;
+    column->valMap = nullptr;
+
+    const qint64 tsBytes = capacity * qint64(sizeof(qint64));
+    const qint64 valBytes = capacity * column->valueSize;
+
+    if ((column->tsFile.size() < tsBytes && !column->tsFile.resize(tsBytes))
+            || (column->valFile.size() < valBytes && !column->valFile.resize(valBytes))) {
+        m_lastError = QString("Préallocation impossible: %1").arg(column->tsFile.errorString());
+        qDebug() << "[ColumnStore]" << m_lastError;
+        return false;
+    }
+
+    column->tsMap = column->tsFile.map(0, tsBytes);
+    column->valMap = column->valFile.map(0, valBytes);
+
+    if (!column->tsMap || !column->valMap) {
+        m_lastError = QString("Mapping mémoire impossible: %1").arg(column->tsFile.errorString());
+        qDebug() << "[ColumnStore]" << m_lastError;
+        return false;
+    }
+
+    column->capacityRows = capacity;
+    return true;
+}
+
+void ColumnStore::closeColumn(Column *column)
+{
+    if (column->tsMap && column->valMap) {
+        commitColumn(column);
+    }
+
+    if (column->tsMap) column->tsFile.unmap(column->tsMap);
+    if (column->valMap) column->valFile.unmap(column->valMap);
+    column->tsMap = nullptr;
+    column->valMap = nullptr;
+
+    // Supprime la préallocation inutilisée
+    if (column->tsFile.isOpen()) column->tsFile.resize(column->committedRows * qint64(sizeof(qint64)));
+    if (column->valFile.isOpen()) column->valFile.resize(column->committedRows * column->valueSize);
+
+    column->tsFile.close();
+    column->valFile.close();
+    column->idxFile.close();
+    column->hdrFile.close();
+}
+
+// ============================================================================
+// CANAUX
+// ============================================================================
+
+bool ColumnStore::addChannel(const ChannelInfo &info)
+{
+    if (!m_open) {
+        return false;
+    }
+
+    Column *column = findColumn(info.id);
+
+    if (column) {
+        // Métadonnées mises à jour, le type des colonnes existantes est conservé
+        const ChannelInfo::StorageType type = column->info.storageType;
+        column->info = info;
+        column->info.storageType = type;
+        return saveCatalog();
+    }
+
+    column = new Column;
+    column->info = info;
+    column->valueSize = ChannelInfo::storageSize(info.storageType);
+
+    if (!openColumn(column)) {
+        delete column;
+        return false;
+    }
+
+    m_columns.insert(info.id, column);
+    return saveCatalog();
+}
+
+bool ColumnStore::hasChannel(quint16 channelId) const
+{
+    return m_columns.contains(channelId);
+}
+
+QList<ChannelInfo> ColumnStore::channels() const
+{
+    QList<ChannelInfo> result;
+    for (const Column *column : qAsConst(m_columns)) {
+        result.append(column->info);
+    }
+    return result;
+}
+
+// ============================================================================
+// ÉCRITURE
+// ============================================================================
+
+bool ColumnStore::append(quint16 channelId, qint64 timestamp, double raw)
+{
+    Column *column = findColumn(channelId);
+    if (!column) {
+        return false;
+    }
+
+    if (column->rows >= column->capacityRows && !growColumn(column, column->rows + 1)) {
+        return false;
+    }
+
+    const qint64 row = column->rows;
+    std::memcpy(column->tsMap + row * sizeof(qint64), &timestamp, sizeof(qint64));
+    ChannelInfo::encodeRaw(column->info.storageType, raw, column->valMap + row * column->valueSize);
+
+    if (row % IndexStride == 0) {
+        const IndexEntry entry = { timestamp, row };
+        column->index.append(entry);
+        column->idxFile.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    }
+
+    if (row == 0) {
+        column->firstTimestamp = timestamp;
+    }
+    column->lastTimestamp = timestamp;
+    column->rows++;
+
+    // Le commit lui-même est laissé au thread de commit de DataModel
+    if (column->rows - column->committedRows >= CommitRows) {
+        m_commitDue = true;
+    }
+
+    return true;
+}
+
+bool ColumnStore::needsGrowth(quint16 channelId) const
+{
+    const Column *column = findColumn(channelId);
+    return column && column->rows >= column->capacityRows;
+}
+
+bool ColumnStore::reserve(quint16 channelId, qint64 minRows)
+{
+    Column *column = findColumn(channelId);
+    return column && growColumn(column, minRows);
+}
+
+bool ColumnStore::commit()
+{
+    bool ok = true;
+    for (Column *column : qAsConst(m_columns)) {
+        ok = commitColumn(column) && ok;
+    }
+    return ok;
+}
+
+bool ColumnStore::commitColumn(Column *column)
+{
+    if (column->rows == column->committedRows) {
+        return true;
+    }
+
+    // 1. Données et index sur disque avant l'en-tête qui les référence
+    syncMappedRange(column->tsMap, column->committedRows * qint64(sizeof(qint64)),
+                    column->rows * qint64(sizeof(qint64)));
+    syncMappedRange(column->valMap, column->committedRows * column->valueSize,
+                    column->rows * column->valueSize);
+    syncFile(column->idxFile);
+
+    // 2. En-tête dans l'emplacement le plus ancien
+    const SlotHeader header = column->nextHeader();
+    const qint64 slot = header.sequence % HeaderSlotCount;
+    column->hdrFile.seek(slot * sizeof(SlotHeader));
+    if (column->hdrFile.write(reinterpret_cast<const char *>(&header), sizeof(header)) != sizeof(header)) {
+        m_lastError = QString("En-tête non écrit: %1").arg(column->hdrFile.errorString());
+        qDebug() << "[ColumnStore]" << m_lastError;
+        return false;
+    }
+    syncFile(column->hdrFile);
+
+    column->sequence = header.sequence;
+    column->committedRows = column->rows;
+    return true;
+}
+
+QVector<ColumnStore::PendingCommit> ColumnStore::prepareCommit()
+{
+    m_commitDue = false;
+
+    QVector<PendingCommit> commits;
+    for (Column *column : qAsConst(m_columns)) {
+        if (column->rows == column->committedRows || !column->tsMap || !column->valMap) {
+            continue;
+        }
+
+        // Écriture des pages lancée sans attendre, index remis au noyau
+        syncMappedRange(column->tsMap, column->committedRows * qint64(sizeof(qint64)),
+                        column->rows * qint64(sizeof(qint64)), true);
+        syncMappedRange(column->valMap, column->committedRows * column->valueSize,
+                        column->rows * column->valueSize, true);
+        column->idxFile.flush();
+
+        const SlotHeader header = column->nextHeader();
+
+        PendingCommit commit;
+        commit.tsFd = duplicateDescriptor(column->tsFile);
+        commit.valFd = duplicateDescriptor(column->valFile);
+        commit.idxFd = duplicateDescriptor(column->idxFile);
+        commit.hdrFd = duplicateDescriptor(column->hdrFile);
+        commit.headerOffset = (header.sequence % HeaderSlotCount) * qint64(sizeof(SlotHeader));
+        commit.header = QByteArray(reinterpret_cast<const char *>(&header), sizeof(header));
+        commits.append(commit);
+
+        // Séquence réservée: le commit suivant vise l'autre emplacement
+        column->sequence = header.sequence;
+        column->committedRows = column->rows;
+    }
+
+    return commits;
+}
+
+bool ColumnStore::syncCommit(const QVector<PendingCommit> &commits, QString *errorMessage)
+{
+    bool ok = true;
+
+    for (const PendingCommit &commit : commits) {
+        // 1. Données et index sur disque avant l'en-tête qui les référence
+        bool synced = commit.tsFd >= 0 && commit.valFd >= 0 && commit.idxFd >= 0 && commit.hdrFd >= 0
+                && syncDescriptor(commit.tsFd)
+                && syncDescriptor(commit.valFd)
+                && syncDescriptor(commit.idxFd);
+
+        // 2. En-tête: sans lui, l'en-tête précédent reste la référence
+        synced = synced
+                && writeDescriptor(commit.hdrFd, commit.headerOffset, commit.header)
+                && syncDescriptor(commit.hdrFd);
+
+        if (!synced && ok && errorMessage) {
+            *errorMessage = QString("Commit différé incomplet (errno %1)").arg(errno);
+        }
+        ok = ok && synced;
+
+        closeDescriptor(commit.tsFd);
+        closeDescriptor(commit.valFd);
+        closeDescriptor(commit.idxFd);
+        closeDescriptor(commit.hdrFd);
+    }
+
+    return ok;
+}
+
+// ============================================================================
+// LECTURE
+// ============================================================================
+
+qint64 ColumnStore::rowCount(quint16 channelId) const
+{
+    const Column *column = findColumn(channelId);
+    return column ? column->rows : 0;
+}
+
+qint64 ColumnStore::lastTimestamp(quint16 channelId) const
+{
+    const Column *column = findColumn(channelId);
+    return column && column->rows > 0 ? column->lastTimestamp : std::numeric_limits<qint64>::min();
+}
+
+qint64 ColumnStore::searchRows(const Column *column, qint64 timestamp, bool upper) const
+{
+    // Index creux: encadre la recherche entre deux entrées consécutives
+    int lo = 0;
+    int hi = column->index.size();
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        const qint64 ts = column->index[mid].timestamp;
+        if (upper ? ts <= timestamp : ts < timestamp) lo = mid + 1;
+        else hi = mid;
+    }
+
+    qint64 first = lo > 0 ? column->index[lo - 1].row : 0;
+    qint64 last = lo < column->index.size() ? column->index[lo].row : column->rows;
+
+    // Recherche dichotomique dans la colonne mappée (un seul bloc touché)
+    const qint64 *timestamps = reinterpret_cast<const qint64 *>(column->tsMap);
+    while (first < last) {
+        const qint64 mid = first + (last - first) / 2;
+        if (upper ? timestamps[mid] <= timestamp : timestamps[mid] < timestamp) first = mid + 1;
+        else last = mid;
+    }
+
+    return first;
+}
+
+qint64 ColumnStore::lowerBound(quint16 channelId, qint64 timestamp) const
+{
+    const Column *column = findColumn(channelId);
+    return column ? searchRows(column, timestamp, false) : 0;
+}
+
+qint64 ColumnStore::upperBound(quint16 channelId, qint64 timestamp) const
+{
+    const Column *column = findColumn(channelId);
+    return column ? searchRows(column, timestamp, true) : 0;
+}
+
+int ColumnStore::read(quint16 channelId, qint64 firstRow, int count,
+                      QVector<qint64> *timestamps, QVector<double> *raw) const
+{
+    const Column *column = findColumn(channelId);
+    if (!column || firstRow < 0 || count <= 0) {
+        return 0;
+    }
+
+    return readRows(column, firstRow, static_cast<int>(qMin<qint64>(count, column->rows - firstRow)),
+                    timestamps, raw);
+}
+
+int ColumnStore::readWritten(quint16 channelId, qint64 firstRow, int count,
+                             QVector<qint64> *timestamps, QVector<double> *raw) const
+{
+    const Column *column = findColumn(channelId);
+    if (!column || firstRow < 0 || count <= 0) {
+        return 0;
+    }
+
+    // capacityRows ne change que sous verrou exclusif (voir la classe)
+    return readRows(column, firstRow, static_cast<int>(qMin<qint64>(count, column->capacityRows - firstRow)),
+                    timestamps, raw);
+}
+
+int ColumnStore::readRows(const Column *column, qint64 firstRow, int n,
+                          QVector<qint64> *timestamps, QVector<double> *raw) const
+{
+    if (n <= 0) {
+        return 0;
+    }
+
+    if (timestamps) {
+        timestamps->resize(n);
+        std::memcpy(timestamps->data(), column->tsMap + firstRow * sizeof(qint64), n * sizeof(qint64));
+    }
+
+    if (raw) {
+        raw->resize(n);
+        const uchar *src = column->valMap + firstRow * column->valueSize;
+        for (int i = 0; i < n; ++i) {
+            (*raw)[i] = ChannelInfo::decodeRaw(column->info.storageType, src + i * column->valueSize);
+        }
+    }
+
+    return n;
+}
@@ -0,0 +1,122 @@
+#ifndef COLUMNSTORE_H
+#define COLUMNSTORE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QVector>
+#include "ChannelInfo.h"
+
+/**
+ * @brief Stockage colonne mappé en mémoire pour les captures longue durée
+ *
+ * Une capture est un répertoire contenant, pour chaque canal:
+ * - ch<id>.ts  : colonne des horodatages (qint64, ns MonotonicClock)
+ * - ch<id>.val : colonne des valeurs brutes (type de stockage du canal)
+ * - ch<id>.idx : index temporel creux (un couple horodatage/ligne toutes
+ *                les IndexStride lignes)
+ * - ch<id>.hdr : en-tête double emplacement (A/B) avec numéro de séquence
+ *                et CRC32
+ * ainsi qu'un catalogue channels.json (métadonnées ChannelInfo).
+ *
+ * Les colonnes sont en ajout seul, préallouées par blocs et mappées
+ * (QFile::map): la mémoire résidente reste constante quelle que soit la
+ * durée de la capture. Un commit synchronise les données puis écrit l'en-tête
+ * dans l'emplacement le plus ancien; après un crash, l'en-tête valide de plus
+ * haute séquence donne le nombre de lignes cohérentes, la fin des colonnes
+ * au-delà est ignorée.
+ *
+ * append() ne touche jamais le disque de façon bloquante. Le commit se fait
+ * en deux temps: prepareCommit(), sous le verrou de DataModel, lance
+ * l'écriture des pages (MS_ASYNC) et fige l'en-tête de chaque colonne
+ * modifiée avec des descripteurs dupliqués; syncCommit() fait ensuite les
+ * fsync et écrit les en-têtes hors verrou, depuis le thread de commit de
+ * DataModel. Seuls close() et le destructeur committent de façon synchrone.
+ *
+ * Non thread-safe: la synchronisation est assurée par DataModel
+ * (syncCommit() excepté, qui n'accède plus au ColumnStore). Seule exception,
+ * readWritten() peut lire des lignes déjà écrites pendant un append()
+ * concurrent, tant que les mappages ne changent pas: DataModel réserve la
+ * place (needsGrowth()/reserve()) et déclare les canaux sous verrou
+ * exclusif.
+ */
+class ColumnStore
+{
+public:
+    static const int IndexStride = 1024;      // Lignes entre deux entrées d'index
+    static const int GrowRows = 65536;        // Granularité de préallocation
+    static const int CommitRows = 4096;       // Commit anticipé (lignes non validées)
+    static const int CommitIntervalMs = 1000; // Commit périodique, canaux inactifs compris
+
+    // En-tête figé par prepareCommit(), à synchroniser par syncCommit()
+    struct PendingCommit {
+        int tsFd;             // Descripteurs dupliqués: valides après close()
+        int valFd;
+        int idxFd;
+        int hdrFd;
+        qint64 headerOffset;
+        QByteArray header;
+    };
+
+    explicit ColumnStore(const QString &directory);
+    ~ColumnStore();
+
+    bool open();
+    void close();
+    bool isOpen() const { return m_open; }
+    QString directory() const { return m_directory; }
+    QString lastError() const { return m_lastError; }
+
+    // Déclare un canal (colonnes créées ou rouvertes)
+    bool addChannel(const ChannelInfo &info);
+    bool hasChannel(quint16 channelId) const;
+    QList<ChannelInfo> channels() const;
+
+    // Ajout en fin de colonne (horodatages croissants)
+    bool append(quint16 channelId, qint64 timestamp, double raw);
+    bool needsGrowth(quint16 channelId) const;           // Le prochain append() remappe
+    bool reserve(quint16 channelId, qint64 minRows);     // Remappe si nécessaire
+    bool commit();  // Synchrone
+
+    // Commit différé (voir description de la classe)
+    bool isCommitDue() const { return m_commitDue; }  // CommitRows atteint sur un canal
+    QVector<PendingCommit> prepareCommit();
+    static bool syncCommit(const QVector<PendingCommit> &commits, QString *errorMessage = nullptr);
+
+    // Lecture
+    qint64 rowCount(quint16 channelId) const;
+    qint64 lastTimestamp(quint16 channelId) const;  // Minimum de qint64 si vide
+    qint64 lowerBound(quint16 channelId, qint64 timestamp) const;  // Première ligne >= timestamp
+    qint64 upperBound(quint16 channelId, qint64 timestamp) const;  // Première ligne > timestamp
+    int read(quint16 channelId, qint64 firstRow, int count,
+             QVector<qint64> *timestamps, QVector<double> *raw) const;
+
+    // Comme read(), pour des lignes déjà écrites (bornes relevées par
+    // l'appelant): ne lit pas l'état modifié par append()
+    int readWritten(quint16 channelId, qint64 firstRow, int count,
+                    QVector<qint64> *timestamps, QVector<double> *raw) const;
+
+private:
+    struct Column;
+
+    Column *findColumn(quint16 channelId) const;
+    bool openColumn(Column *column);
+    bool growColumn(Column *column, qint64 minRows);
+    bool commitColumn(Column *column);
+    void closeColumn(Column *column);
+    bool loadCatalog();
+    bool saveCatalog();
+    QString columnPath(quint16 channelId, const char *suffix) const;
+    qint64 searchRows(const Column *column, qint64 timestamp, bool upper) const;
+    int readRows(const Column *column, qint64 firstRow, int n,
+                 QVector<qint64> *timestamps, QVector<double> *raw) const;
+
+    QString m_directory;
+    QHash<quint16, Column *> m_columns;
+    bool m_open;
+    bool m_commitDue;
+    QString m_lastError;
+};
+
+#endif // COLUMNSTORE_H
@@ -0,0 +1,289 @@
+#include "ExportWorker.h"
+#include "DataModel.h"
+#include "MonotonicClock.h"
+#include <QSaveFile>
+#include <QThread>
+#include <QtEndian>
+#include <QDebug>
+
+namespace {
+
+const char BinaryMagic[4] = { 'S', 'T', 'L', 'B' };
+const quint16 BinaryVersion = 2;  // v2: horodatages en ns
+
+template <typename T>
+void appendLittleEndian(QByteArray &buffer, T value)
+{
+    uchar bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    buffer.append(reinterpret_cast<const char *>(bytes), sizeof(T));
+}
+
+void appendString(QByteArray &buffer, const QString &text)
+{
+    const QByteArray utf8 = text.toUtf8().left(0xFFFF);
+    appendLittleEndian<quint16>(buffer, static_cast<quint16>(utf8.size()));
+    buffer.append(utf8);
+}
+
+// Heure murale en ms avec six décimales (résolution de l'horodatage ns)
+void appendTimestampMs(QByteArray &buffer, qint64 ns)
+{
+    qint64 ms = ns / MonotonicClock::NsPerMs;
+    qint64 fraction = ns % MonotonicClock::NsPerMs;
+    if (fraction < 0) {
+        fraction += MonotonicClock::NsPerMs;
+        --ms;
+    }
+
+    char digits[6];
+    for (int i = 5; i >= 0; --i) {
+        digits[i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+
+    buffer.append(QByteArray::number(ms));
+    buffer.append('.');
+    buffer.append(digits, sizeof(digits));
+}
+
+} // namespace
+
+ExportWorker::ExportWorker(DataModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_lastPermille(-1)
+    , m_written(0)
+    , m_storeLost(false)
+{
+}
+
+void ExportWorker::reportProgress(qint64 done, qint64 total)
+{
+    // Limite le débit de signaux: au plus un par millième
+    const int permille = total > 0 ? static_cast<int>(done * 1000 / total) : 1000;
+    if (permille != m_lastPermille) {
+        m_lastPermille = permille;
+        emit progress(done, total);
+    }
+}
+
+// ============================================================================
+// EXPORT
+// ============================================================================
+
+void ExportWorker::runExport(const ExportRequest &request)
+{
+    // Drapeau d'annulation remis à zéro par l'appelant (resetCancel())
+    m_lastPermille = -1;
+    m_written = 0;
+    m_storeLost = false;
+
+    qDebug() << "[ExportWorker] Export to" << request.fileName << "in thread" << QThread::currentThreadId();
+
+    // Canaux à exporter
+    QList<ChannelInfo> channels;
+    const QList<quint16> ids = request.channels.isEmpty() ? m_model->channelIds() : request.channels;
+    for (quint16 id : ids) {
+        if (m_model->hasChannel(id)) {
+            channels.append(m_model->channelInfo(id));
+        }
+    }
+
+    qint64 total = 0;
+    for (const ChannelInfo &info : qAsConst(channels)) {
+        total += m_model->sampleCount(info.id, request.fromNs, request.toNs);
+    }
+
+    QSaveFile file(request.fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        emit failed(QString("Impossible d'ouvrir %1: %2").arg(request.fileName, file.errorString()));
+        return;
+    }
+
+    const bool ok = request.format == ExportRequest::BinaryColumnar
+            ? writeBinary(&file, request, channels, total)
+            : writeCsv(&file, request, channels, total);
+
+    if (isCanceled()) {
+        file.cancelWriting();
+        qDebug() << "[ExportWorker] Export canceled after" << m_written << "samples";
+        emit canceled();
+        return;
+    }
+
+    if (m_storeLost) {
+        file.cancelWriting();
+        emit failed(QString("Capture détachée pendant l'export (%1 échantillons écrits)").arg(m_written));
+        return;
+    }
+
+    if (!ok || !file.commit()) {
+        emit failed(QString("Erreur d'écriture: %1").arg(file.errorString()));
+        return;
+    }
+
+    qDebug() << "[ExportWorker] Exported" << m_written << "samples to" << request.fileName;
+    emit finished(request.fileName, m_written);
+}
+
+bool ExportWorker::writeCsv(QIODevice *device, const ExportRequest &request,
+                            const QList<ChannelInfo> &channels, qint64 total)
+{
+    if (device->write("timestamp_ms,channel,unit,value\n") < 0) {
+        return false;
+    }
+
+    QVector<qint64> timestamps;
+    QVector<double> raw;
+    QByteArray buffer;
+
+    for (const ChannelInfo &info : channels) {
+        QByteArray prefix(",");
+        prefix.append(info.name.toUtf8()).append(',').append(info.unit.toUtf8()).append(',');
+
+        DataModel::SampleCursor cursor = m_model->openSamples(info.id, request.fromNs, request.toNs);
+        for (;;) {
+            if (isCanceled()) {
+                return false;
+            }
+
+            const int n = m_model->readSamples(&cursor, ChunkSamples, &timestamps, &raw);
+            if (n < 0) {
+                m_storeLost = true;
+                return false;
+            }
+            if (n == 0) {
+                break;
+            }
+
+            buffer.clear();
+            buffer.reserve(n * (prefix.size() + 40));
+            for (int i = 0; i < n; ++i) {
+                appendTimestampMs(buffer, timestamps[i]);
+                buffer.append(prefix);
+                buffer.append(QByteArray::number(info.toPhysical(raw[i]), 'g', 10));
+                buffer.append('\n');
+            }
+
+            if (device->write(buffer) != buffer.size()) {
+                return false;
+            }
+
+            m_written += n;
+            reportProgress(m_written, total);
+        }
+    }
+
+    return true;
+}
+
+bool ExportWorker::writeBinary(QIODevice *device, const ExportRequest &request,
+                               const QList<ChannelInfo> &channels, qint64 total)
+{
+    QByteArray buffer;
+    buffer.append(BinaryMagic, sizeof(BinaryMagic));
+    appendLittleEndian<quint16>(buffer, BinaryVersion);
+    appendLittleEndian<quint16>(buffer, static_cast<quint16>(channels.size()));
+    if (device->write(buffer) != buffer.size()) {
+        return false;
+    }
+
+    QVector<qint64> timestamps;
+    QVector<double> raw;
+
+    for (const ChannelInfo &info : channels) {
+        // Les deux passes relisent le même intervalle figé
+        DataModel::SampleCursor cursor = m_model->openSamples(info.id, request.fromNs, request.toNs);
+        const qint64 expected = cursor.count();
+
+        buffer.clear();
+        appendLittleEndian<quint16>(buffer, info.id);
+        buffer.append(static_cast<char>(info.storageType));
+        buffer.append('\0');
+        appendLittleEndian<double>(buffer, info.scale);
+        appendLittleEndian<double>(buffer, info.offset);
+        appendString(buffer, info.name);
+        appendString(buffer, info.unit);
+        if (device->write(buffer) != buffer.size()) {
+            return false;
+        }
+
+        // Nombre d'échantillons, corrigé après la colonne des horodatages si besoin
+        const qint64 countPos = device->pos();
+        buffer.clear();
+        appendLittleEndian<quint64>(buffer, static_cast<quint64>(expected));
+        if (device->write(buffer) != buffer.size()) {
+            return false;
+        }
+
+        // Passe 1: colonne des horodatages
+        qint64 count = 0;
+        for (;;) {
+            if (isCanceled()) {
+                return false;
+            }
+
+            const int n = m_model->readSamples(&cursor, ChunkSamples, &timestamps, nullptr);
+            if (n < 0) {
+                m_storeLost = true;
+                return false;
+            }
+            if (n == 0) {
+                break;
+            }
+
+            buffer.resize(n * static_cast<int>(sizeof(qint64)));
+            for (int i = 0; i < n; ++i) {
+                qToLittleEndian(timestamps[i], buffer.data() + i * sizeof(qint64));
+            }
+            if (device->write(buffer) != buffer.size()) {
+                return false;
+            }
+
+            count += n;
+            m_written += n / 2;
+            reportProgress(m_written, total);
+        }
+
+        if (count != expected) {
+            const qint64 end = device->pos();
+            buffer.clear();
+            appendLittleEndian<quint64>(buffer, static_cast<quint64>(count));
+            if (!device->seek(countPos) || device->write(buffer) != buffer.size() || !device->seek(end)) {
+                return false;
+            }
+        }
+
+        // Passe 2: colonne des valeurs brutes au type du canal
+        const int valueSize = info.bytesPerValue();
+        cursor.rewind();
+        for (qint64 index = 0; index < count; ) {
+            if (isCanceled()) {
+                return false;
+            }
+
+            const int n = m_model->readSamples(&cursor, static_cast<int>(qMin<qint64>(ChunkSamples, count - index)),
+                                               nullptr, &raw);
+            if (n <= 0) {
+                m_storeLost = n < 0;
+                return false;
+            }
+
+            buffer.resize(n * valueSize);
+            uchar *dst = reinterpret_cast<uchar *>(buffer.data());
+            for (int i = 0; i < n; ++i) {
+                ChannelInfo::encodeRaw(info.storageType, raw[i], dst + i * valueSize);
+            }
+            if (device->write(buffer) != buffer.size()) {
+                return false;
+            }
+
+            index += n;
+            m_written += n - n / 2;
+            reportProgress(m_written, total);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,98 @@
+#ifndef EXPORTWORKER_H
+#define EXPORTWORKER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QMetaType>
+#include <QAtomicInt>
+#include <limits>
+
+class DataModel;
+class QIODevice;
+struct ChannelInfo;
+
+/**
+ * @brief Paramètres d'un export de télémétrie
+ */
+struct ExportRequest
+{
+    enum Format {
+        Csv,             // timestamp_ms,channel,unit,value (heure murale, valeurs physiques)
+        BinaryColumnar   // Colonnes brutes par canal (voir ExportWorker)
+    };
+
+    QString fileName;
+    Format format;
+    QList<quint16> channels;  // Vide = tous les canaux
+    qint64 fromNs;  // Base MonotonicClock (ns depuis l'epoch)
+    qint64 toNs;
+
+    ExportRequest()
+        : format(Csv)
+        , fromNs(std::numeric_limits<qint64>::min())
+        , toNs(std::numeric_limits<qint64>::max())
+    {
+    }
+};
+
+Q_DECLARE_METATYPE(ExportRequest)
+
+/**
+ * @brief Worker d'export exécuté dans un thread dédié
+ *
+ * Lit les canaux par blocs via DataModel::readSamples() et écrit le fichier
+ * au fil de l'eau. L'intervalle est figé par DataModel::openSamples(): lignes
+ * stables du fichier de capture (mémoire indépendante du nombre
+ * d'échantillons) ou copie du buffer circulaire, bornée par sa capacité.
+ * Les blocs du CSV et les deux colonnes binaires portent donc sur les mêmes
+ * échantillons, même si l'acquisition continue. L'écriture passe par un
+ * QSaveFile: un export annulé ou en erreur ne laisse aucun fichier partiel.
+ *
+ * Format binaire colonne (little-endian):
+ * @code
+ * "STLB" | u16 version | u16 nbCanaux
+ * par canal: u16 id | u8 type | u8 réservé | f64 scale | f64 offset
+ *            | u16 len + nom UTF-8 | u16 len + unité UTF-8 | u64 n
+ *            | n x i64 horodatages (ns) | n x valeurs brutes (type du canal)
+ * @endcode
+ */
+class ExportWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int ChunkSamples = 65536;
+
+    explicit ExportWorker(DataModel *model, QObject *parent = nullptr);
+
+    // Appelables depuis n'importe quel thread. resetCancel() précède la mise
+    // en file de runExport(): une annulation qui la suit n'est pas perdue
+    void cancel() { m_cancelRequested.storeRelease(1); }
+    void resetCancel() { m_cancelRequested.storeRelease(0); }
+
+public slots:
+    void runExport(const ExportRequest &request);
+
+signals:
+    void progress(qint64 done, qint64 total);
+    void finished(const QString &fileName, qint64 samples);
+    void failed(const QString &error);
+    void canceled();
+
+private:
+    bool writeCsv(QIODevice *device, const ExportRequest &request,
+                  const QList<ChannelInfo> &channels, qint64 total);
+    bool writeBinary(QIODevice *device, const ExportRequest &request,
+                     const QList<ChannelInfo> &channels, qint64 total);
+    bool isCanceled() const { return m_cancelRequested.loadAcquire() != 0; }
+    void reportProgress(qint64 done, qint64 total);
+
+    DataModel *m_model;
+    QAtomicInt m_cancelRequested;
+    int m_lastPermille;
+    qint64 m_written;
+    bool m_storeLost;   // Fichier de capture détaché pendant l'export
+};
+
+#endif // EXPORTWORKER_H
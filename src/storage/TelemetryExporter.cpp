@@ -0,0 +1,86 @@
+#include "TelemetryExporter.h"
+#include <QDebug>
+
+TelemetryExporter::TelemetryExporter(DataModel *model, QObject *parent)
+    : QObject(parent)
+    , m_busy(false)
+{
+    qRegisterMetaType<ExportRequest>("ExportRequest");
+
+    m_workerThread = new QThread(this);
+    m_worker = new ExportWorker(model);
+    m_worker->moveToThread(m_workerThread);
+
+    connect(m_workerThread, &QThread::finished,
+            m_worker, &ExportWorker::deleteLater);
+
+    connect(this, &TelemetryExporter::requestExport,
+            m_worker, &ExportWorker::runExport, Qt::QueuedConnection);
+
+    connect(m_worker, &ExportWorker::progress,
+            this, &TelemetryExporter::exportProgress);
+
+    connect(m_worker, &ExportWorker::finished,
+            this, &TelemetryExporter::handleFinished);
+
+    connect(m_worker, &ExportWorker::failed,
+            this, &TelemetryExporter::handleFailed);
+
+    connect(m_worker, &ExportWorker::canceled,
+            this, &TelemetryExporter::handleCanceled);
+
+    m_workerThread->start(QThread::LowPriority);
+    qDebug() << "[TelemetryExporter] Worker thread started";
+}
+
+TelemetryExporter::~TelemetryExporter()
+{
+    // Interrompt un export en cours avant d'arrêter le thread
+    m_worker->cancel();
+    m_workerThread->quit();
+    m_workerThread->wait();
+    qDebug() << "[TelemetryExporter] Destroyed";
+}
+
+bool TelemetryExporter::startExport(const ExportRequest &request)
+{
+    if (m_busy) {
+        qDebug() << "[TelemetryExporter] Export already running, request ignored";
+        return false;
+    }
+
+    // Avant la mise en file: un cancel() émis avant le démarrage du worker
+    // reste visible pour cet export
+    m_worker->resetCancel();
+    m_busy = true;
+    emit exportStarted(request.fileName);
+    emit requestExport(request);
+    return true;
+}
+
+void TelemetryExporter::cancel()
+{
+    if (m_busy) {
+        qDebug() << "[TelemetryExporter] Cancel requested";
+        m_worker->cancel();
+    }
+}
+
+void TelemetryExporter::handleFinished(const QString &fileName, qint64 samples)
+{
+    m_busy = false;
+    emit exportFinished(fileName, samples);
+}
+
+void TelemetryExporter::handleFailed(const QString &error)
+{
+    m_busy = false;
+    qDebug() << "[TelemetryExporter] Export failed:" << error;
+    emit exportFailed(error);
+}
+
+void TelemetryExporter::handleCanceled()
+{
+    m_busy = false;
+    emit exportCanceled();
+}
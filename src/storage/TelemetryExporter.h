@@ -0,0 +1,55 @@
+#ifndef TELEMETRYEXPORTER_H
+#define TELEMETRYEXPORTER_H
+
+#include <QObject>
+#include <QThread>
+#include "ExportWorker.h"
+
+class DataModel;
+
+/**
+ * @brief Gestionnaire d'export de télémétrie en arrière-plan
+ *
+ * Même architecture que SerialManager:
+ * - TelemetryExporter (thread principal) : interface de haut niveau
+ * - ExportWorker (thread dédié) : lecture du modèle et écriture du fichier
+ *
+ * L'interface reste fluide pendant l'export de millions d'échantillons;
+ * la progression et la fin sont notifiées par signaux.
+ */
+class TelemetryExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TelemetryExporter(DataModel *model, QObject *parent = nullptr);
+    ~TelemetryExporter();
+
+    bool isBusy() const { return m_busy; }
+
+public slots:
+    bool startExport(const ExportRequest &request);
+    void cancel();
+
+signals:
+    void exportStarted(const QString &fileName);
+    void exportProgress(qint64 done, qint64 total);
+    void exportFinished(const QString &fileName, qint64 samples);
+    void exportFailed(const QString &error);
+    void exportCanceled();
+
+    // Signal interne pour le worker (queued connection)
+    void requestExport(const ExportRequest &request);
+
+private slots:
+    void handleFinished(const QString &fileName, qint64 samples);
+    void handleFailed(const QString &error);
+    void handleCanceled();
+
+private:
+    ExportWorker *m_worker;
+    QThread *m_workerThread;
+    bool m_busy;
+};
+
+#endif // TELEMETRYEXPORTER_H
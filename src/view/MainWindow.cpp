@@ -1,9 +1,13 @@
 #include "MainWindow.h"
 #include "ui_MainWindow.h"
+#include "MonitorLogModel.h"
+#include "MonitorLogDelegate.h"
+#include "PlotWidget.h"
 #include <QSerialPortInfo>
 #include <QMessageBox>
 #include <QDateTime>
 #include <QScrollBar>
+#include <QListView>
 #include <QFileDialog>
 #include <QFile>
 #include <QTextStream>
@@ -12,6 +16,12 @@
 #include <QTimer>
 #include <QTableWidgetItem>
 #include <QPushButton>
+#include <QSignalBlocker>
+#include <QStyle>
+#include <QTextCursor>
+#include <QTextDocument>
+#include <QProgressDialog>
+#include <QInputDialog>
 #include <functional>
 
 MainWindow::MainWindow(DeviceController *controller, QWidget *parent)
@@ -19,8 +29,23 @@ MainWindow::MainWindow(DeviceController *controller, QWidget *parent)
     , ui(new Ui::MainWindow)
     , m_controller(controller)
     , m_isAuthenticated(false)
+    , m_exportProgress(nullptr)
+    , m_monitorModel(nullptr)
+    , m_monitorFollow(true)
+    , m_plotWidget(nullptr)
     , m_sessionStartTime(QDateTime::currentDateTime())
+    , m_securityStats()
+    , m_renderTimer(new QTimer(this))
+    , m_dirty(NothingDirty)
+    , m_latestTemperature(0.0f)
+    , m_latestVoltage(0.0f)
+    , m_shownSecurityLevel(-1)
 {
+    m_renderTimer->setSingleShot(true);
+    m_renderTimer->setTimerType(Qt::PreciseTimer);
+    m_renderTimer->setInterval(RenderIntervalMs);
+    connect(m_renderTimer, &QTimer::timeout, this, &MainWindow::renderFrame);
+
     ui->setupUi(this);
     setupUI();
     setupConnections();
@@ -123,34 +148,81 @@ void MainWindow::initializeSecurityCards()
     }
 }
 
+void MainWindow::setupMonitor()
+{
+    // Moniteur série: journal borné, seules les lignes visibles sont
+    // formatées et dessinées, ajouts insérés au tick de rendu
+    m_monitorModel = new MonitorLogModel(this);
+    m_monitorModel->setFrameDriven(true);
+    connect(m_monitorModel, &MonitorLogModel::frameRequested, this, [this]() {
+        scheduleRender(MonitorLogDirty);
+    });
+    QListView *view = ui->monitorListView;
+    view->setModel(m_monitorModel);
+    view->setItemDelegate(new MonitorLogDelegate(view));
+    view->setUniformItemSizes(true);
+    view->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    view->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    
+    // Défilement automatique tant que la vue est en bas de la liste
+    QScrollBar *scrollBar = view->verticalScrollBar();
+    connect(scrollBar, &QScrollBar::valueChanged, this, [this, scrollBar](int value) {
+        m_monitorFollow = (value == scrollBar->maximum());
+    });
+    connect(m_monitorModel, &MonitorLogModel::batchAppended, this, [this]() {
+        if (m_monitorFollow) {
+            ui->monitorListView->scrollToBottom();
+        }
+    });
+}
+
+void MainWindow::setupPlot()
+{
+    // Tracé temps réel: rastérisé hors du thread graphique, onglet ajouté
+    // après ceux du .ui pour ne pas décaler leurs index; trames envoyées
+    // au tick de rendu
+    m_plotWidget = new PlotWidget(m_controller->dataModel(), this);
+    m_plotWidget->setFrameDriven(true);
+    connect(m_plotWidget, &PlotWidget::frameRequested, this, [this]() {
+        scheduleRender(PlotDirty);
+    });
+    m_plotWidget->addChannel(ChannelInfo::TemperatureChannel, QColor("#f59e0b"));
+    m_plotWidget->addChannel(ChannelInfo::VoltageChannel, QColor("#00d9ff"));
+    m_plotWidget->setToolTip("Molette: zoom temporel · Ctrl + molette: zoom vertical\n"
+                             "Glisser: déplacer · Double-clic: retour au temps réel");
+    ui->mainTabWidget->addTab(m_plotWidget, "Graphiques");
+}
+
 void MainWindow::setupUI()
 {
     setWindowTitle("STM32 SecureLink - Interface de Pilotage Sécurisé");
+    setupMonitor();
+    setupPlot();
     ui->baudRateComboBox->setCurrentText("115200");
     loadSerialPorts();
     updateConnectionState(false);
     updateAuthenticationState(false);
     ui->statusbar->showMessage("⚫ Déconnecté - En attente de connexion", 0);
-    ui->receiveTextEdit->setHtml(
-        "<div style='color: #00d9ff; font-weight: bold;'>"
-        "<pre>"
-        "╔═══════════════════════════════════════════════════════════════╗\n"
-        "║     🔐 STM32 SecureLink - Communication Sécurisée            ║\n"
-        "╠═══════════════════════════════════════════════════════════════╣\n"
-        "║  ✅ Chiffrement AES-128-CBC                                   ║\n"
-        "║  ✅ Authentification HMAC-SHA256                              ║\n"
-        "║  ✅ Protection Anti-Replay                                    ║\n"
-        "║  ✅ Architecture MVC Moderne                                  ║\n"
-        "╠═══════════════════════════════════════════════════════════════╣\n"
-        "║  📌 Étapes:                                                   ║\n"
-        "║     1. Connectez-vous au port série                          ║\n"
-        "║     2. Authentifiez-vous (onglet Sécurité)                   ║\n"
-        "║     3. Commencez à piloter le STM32                          ║\n"
+    static const char *const banner[] = {
+        "╔═══════════════════════════════════════════════════════════════╗",
+        "║     🔐 STM32 SecureLink - Communication Sécurisée            ║",
+        "╠═══════════════════════════════════════════════════════════════╣",
+        "║  ✅ Chiffrement AES-128-CBC                                   ║",
+        "║  ✅ Authentification HMAC-SHA256                              ║",
+        "║  ✅ Protection Anti-Replay                                    ║",
+        "║  ✅ Architecture MVC Moderne                                  ║",
+        "╠═══════════════════════════════════════════════════════════════╣",
+        "║  📌 Étapes:                                                   ║",
+        "║     1. Connectez-vous au port série                          ║",
+        "║     2. Authentifiez-vous (onglet Sécurité)                   ║",
+        "║     3. Commencez à piloter le STM32                          ║",
         "╚═══════════════════════════════════════════════════════════════╝"
-        "</pre>"
-        "</div><br>"
-    );
+    };
+    for (const char *line : banner) {
+        m_monitorModel->append(MonitorLogModel::Banner, QString::fromUtf8(line));
+    }
     setupSecurityStatsTable();
+    ui->securityLogsTextEdit->document()->setMaximumBlockCount(SecurityLogMaxLines);
     ui->pwmValueLCD->display(50);
     initializeSecurityCards();
     ui->mainTabWidget->setCurrentIndex(0);
@@ -165,6 +237,10 @@ void MainWindow::setupConnections()
     connect(m_controller, &DeviceController::voltageUpdated, this, &MainWindow::onVoltageUpdated);
     connect(m_controller, &DeviceController::statusUpdated, this, &MainWindow::onStatusUpdated);
     connect(m_controller, &DeviceController::deviceError, this, &MainWindow::onDeviceError);
+    connect(m_controller, &DeviceController::alarmRaised, this, &MainWindow::onAlarmRaised);
+    connect(m_controller, &DeviceController::alarmCleared, this, &MainWindow::onAlarmCleared);
+    connect(m_controller, &DeviceController::actuationConfirmed, this, &MainWindow::onActuationConfirmed);
+    connect(m_controller, &DeviceController::actuationRolledBack, this, &MainWindow::onActuationRolledBack);
     connect(ui->connectButton, &QPushButton::clicked, this, &MainWindow::onConnectClicked);
     connect(ui->refreshPortsButton, &QPushButton::clicked, this, &MainWindow::onRefreshPorts);
     connect(ui->authenticateButton, &QPushButton::clicked, this, &MainWindow::onAuthenticateClicked);
@@ -183,6 +259,20 @@ void MainWindow::setupConnections()
     connect(ui->clearSecLogsButton, &QPushButton::clicked, this, &MainWindow::onClearSecurityLogs);
     connect(ui->exportSecLogsButton, &QPushButton::clicked, this, &MainWindow::onExportSecurityLogs);
     connect(ui->actionExportLogs, &QAction::triggered, this, &MainWindow::onExportLogs);
+    connect(ui->actionExportTelemetry, &QAction::triggered, this, &MainWindow::onExportTelemetry);
+    connect(m_controller->exporter(), &TelemetryExporter::exportProgress, this, &MainWindow::onExportProgress);
+    connect(m_controller->exporter(), &TelemetryExporter::exportFinished, this, &MainWindow::onExportFinished);
+    connect(m_controller->exporter(), &TelemetryExporter::exportFailed, this, &MainWindow::onExportFailed);
+    connect(m_controller->exporter(), &TelemetryExporter::exportCanceled, this, &MainWindow::onExportCanceled);
+    connect(ui->actionCapture, &QAction::toggled, this, &MainWindow::onCaptureToggled);
+    connect(ui->actionRawRecording, &QAction::toggled, this, &MainWindow::onRawRecordingToggled);
+    connect(ui->actionReplay, &QAction::triggered, this, &MainWindow::onReplayCapture);
+    connect(m_controller, &DeviceController::rawRecordingChanged, this, &MainWindow::onRawRecordingChanged);
+    connect(m_controller, &DeviceController::replayFinished, this, &MainWindow::onReplayFinished);
+    connect(ui->actionRunScript, &QAction::triggered, this, &MainWindow::onRunScript);
+    connect(m_controller->scriptRunner(), &ScriptRunner::stepFinished, this, &MainWindow::onScriptStepFinished);
+    connect(m_controller->scriptRunner(), &ScriptRunner::finished, this, &MainWindow::onScriptFinished);
+    connect(m_controller, &DeviceController::captureStateChanged, this, &MainWindow::onCaptureStateChanged);
     connect(ui->actionQuitter, &QAction::triggered, this, &QMainWindow::close);
     connect(ui->actionAuthentifier, &QAction::triggered, this, &MainWindow::onAuthenticateClicked);
     connect(ui->actionRapportSecurite, &QAction::triggered, this, &MainWindow::onSecurityReport);
@@ -269,10 +359,7 @@ void MainWindow::loadSerialPorts()
 void MainWindow::onRefreshPorts()
 {
     loadSerialPorts();
-    ui->receiveTextEdit->append(
-        QString("<span style='color: #00d9ff;'>[%1] 🔄 Liste des ports mise à jour</span>")
-        .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-    );
+    m_monitorModel->append(MonitorLogModel::Info, "🔄 Liste des ports mise à jour");
     logSecurityEvent("🔄 Rafraîchissement de la liste des ports");
 }
 
@@ -294,13 +381,8 @@ void MainWindow::onConnectClicked()
         }
         int baudRate = ui->baudRateComboBox->currentText().toInt();
         m_controller->connectToDevice(portName, baudRate);
-        ui->receiveTextEdit->append(
-            QString("<span style='color: #10b981; font-weight: bold;'>"
-                    "[%1] 🔌 Connexion à %2 @ %3 bauds...</span>")
-            .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-            .arg(portName)
-            .arg(baudRate)
-        );
+        m_monitorModel->append(MonitorLogModel::Success,
+                               QString("🔌 Connexion à %1 @ %2 bauds...").arg(portName).arg(baudRate), true);
         logSecurityEvent(QString("🔌 Tentative de connexion à %1 @ %2 bauds").arg(portName).arg(baudRate));
     }
 }
@@ -341,11 +423,7 @@ void MainWindow::onAuthenticateClicked()
         m_isAuthenticated = true;
         m_sessionStartTime = QDateTime::currentDateTime();
         updateAuthenticationState(true);
-        ui->receiveTextEdit->append(
-            QString("<span style='color: #10b981; font-weight: bold;'>"
-                    "[%1] ✅ Authentification réussie - Session ouverte</span>")
-            .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-        );
+        m_monitorModel->append(MonitorLogModel::Success, "✅ Authentification réussie - Session ouverte", true);
         logSecurityEvent(QString("✅ Authentification réussie pour l'utilisateur: %1").arg(username));
         m_controller->sendCustomCommand(QString("AUTH:%1:%2").arg(username).arg(password));
         ui->mainTabWidget->setCurrentIndex(0);
@@ -357,7 +435,7 @@ void MainWindow::onAuthenticateClicked()
         );
     } else {
         m_securityStats.failedAuthAttempts++;
-        updateSecurityStats();
+        scheduleRender(SecurityStatsDirty);
         showStyledMessageBox(
             "Authentification échouée",
             "❌ Nom d'utilisateur ou mot de passe incorrect.\n\n"
@@ -380,14 +458,9 @@ void MainWindow::onSendClicked()
         return;
     }
     m_controller->sendCustomCommand(text);
-    ui->receiveTextEdit->append(
-        QString("<span style='color: #00d9ff; font-weight: bold;'>"
-                "[%1] 📤 TX: %2</span>")
-        .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-        .arg(text)
-    );
+    m_monitorModel->append(MonitorLogModel::Sent, QString("TX: %1").arg(text), true);
     m_securityStats.successfulCommands++;
-    updateSecurityStats();
+    scheduleRender(SecurityStatsDirty);
     logSecurityEvent(QString("📤 Commande envoyée: %1").arg(text));
     ui->commandLineEdit->clear();
     ui->commandLineEdit->setFocus();
@@ -465,58 +538,20 @@ void MainWindow::onResetClicked()
 
 void MainWindow::onDataReceived(const QString &data)
 {
+    // Icône et couleur déduites à l'affichage, pour les seules lignes visibles
     QString text = data.trimmed();
     if (text.isEmpty()) return;
-    QString color = "#10b981";
-    QString icon = "📥";
-    if (text.contains("ERROR") || text.contains("error")) {
-        color = "#ef4444";
-        icon = "❌";
-        m_securityStats.malformedPackets++;
-        updateSecurityStats();
-    } else if (text.contains("OK") || text.contains("ok")) {
-        color = "#00d9ff";
-        icon = "✅";
-    } else if (text.contains("TEMP") || text.contains("temp")) {
-        color = "#f59e0b";
-        icon = "🌡️";
-    } else if (text.contains("VOLTAGE") || text.contains("voltage")) {
-        color = "#f59e0b";
-        icon = "⚡";
-    } else if (text.contains("STATUS") || text.contains("status")) {
-        color = "#8b5cf6";
-        icon = "📊";
-    } else if (text.contains("READY")) {
-        color = "#10b981";
-        icon = "🚀";
-    }
-    ui->receiveTextEdit->append(
-        QString("<span style='color: %1;'>[%2] %3 <b>%4</b></span>")
-        .arg(color)
-        .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-        .arg(icon)
-        .arg(text.toHtmlEscaped())
-    );
-    QScrollBar *scrollBar = ui->receiveTextEdit->verticalScrollBar();
-    scrollBar->setValue(scrollBar->maximum());
+    m_monitorModel->append(MonitorLogModel::Received, text, true);
 }
 
 void MainWindow::onConnectionChanged(bool connected)
 {
     updateConnectionState(connected);
     if (connected) {
-        ui->receiveTextEdit->append(
-            QString("<span style='color: #10b981; font-weight: bold;'>"
-                    "[%1] ✅ Connexion établie avec succès</span>")
-            .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-        );
+        m_monitorModel->append(MonitorLogModel::Success, "✅ Connexion établie avec succès", true);
         logSecurityEvent("✅ Connexion établie avec le STM32");
     } else {
-        ui->receiveTextEdit->append(
-            QString("<span style='color: #f59e0b; font-weight: bold;'>"
-                    "[%1] ⚠️ Déconnexion du port série</span><br>")
-            .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-        );
+        m_monitorModel->append(MonitorLogModel::Warning, "⚠️ Déconnexion du port série", true);
         logSecurityEvent("⚠️ Déconnexion du STM32");
         if (m_isAuthenticated) {
             m_isAuthenticated = false;
@@ -527,62 +562,86 @@ void MainWindow::onConnectionChanged(bool connected)
 
 void MainWindow::onTemperatureUpdated(float temperature)
 {
-    ui->receiveTextEdit->append(
-        QString("<span style='color: #f59e0b;'>"
-                "[%1] 🌡️ Température: <b>%.1f°C</b></span>")
-        .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-        .arg(temperature)
-    );
+    m_latestTemperature = temperature;
+    scheduleRender(TemperatureDirty);
 }
 
 void MainWindow::onVoltageUpdated(float voltage)
 {
-    ui->receiveTextEdit->append(
-        QString("<span style='color: #f59e0b;'>"
-                "[%1] ⚡ Tension: <b>%.2fV</b></span>")
-        .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-        .arg(voltage)
-    );
+    m_latestVoltage = voltage;
+    scheduleRender(VoltageDirty);
 }
 
 void MainWindow::onStatusUpdated(const QJsonObject &status)
 {
-    QString statusText = QJsonDocument(status).toJson(QJsonDocument::Compact);
-    ui->receiveTextEdit->append(
-        QString("<span style='color: #8b5cf6;'>"
-                "[%1] 📊 STATUS: <b>%2</b></span>")
-        .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-        .arg(statusText)
-    );
+    m_latestStatus = status;
+    scheduleRender(StatusDirty);
 }
 
 void MainWindow::onDeviceError(const QString &error)
 {
     ui->statusbar->showMessage("⚠️ Erreur: " + error, 5000);
-    ui->receiveTextEdit->append(
-        QString("<span style='color: #ef4444; font-weight: bold;'>"
-                "[%1] ❌ ERREUR: %2</span>")
-        .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-        .arg(error.toHtmlEscaped())
-    );
+    m_monitorModel->append(MonitorLogModel::Error, QString("❌ ERREUR: %1").arg(error), true);
     logSecurityEvent(QString("❌ ERREUR: %1").arg(error));
     m_securityStats.malformedPackets++;
-    updateSecurityStats();
+    scheduleRender(SecurityStatsDirty);
     qDebug() << "[MainWindow] Erreur:" << error;
 }
 
+void MainWindow::onAlarmRaised(const AlarmEvent &event)
+{
+    const bool critical = event.severity == AlarmRule::Critical;
+    QString message = QString("%1 ALARME: %2").arg(critical ? "🚨" : "⚠️").arg(event.ruleName);
+    if (event.channelId >= 0 && event.kind != AlarmRule::StaleChannel) {
+        message += QString(" (valeur %1)").arg(event.value, 0, 'g', 6);
+    }
+    ui->statusbar->showMessage(message, 10000);
+    m_monitorModel->append(critical ? MonitorLogModel::Error : MonitorLogModel::Warning,
+                           QString("%1 (détection %2 µs)").arg(message).arg(event.latencyNs() / 1000),
+                           true, event.sampleTimestampNs);
+    logSecurityEvent(message);
+}
+
+void MainWindow::onAlarmCleared(const AlarmEvent &event)
+{
+    const QString message = QString("✅ Fin d'alarme: %1").arg(event.ruleName);
+    m_monitorModel->append(MonitorLogModel::Success, message);
+    logSecurityEvent(message);
+}
+
+void MainWindow::onActuationConfirmed(const QString &actuator, int value, qint64 latencyNs)
+{
+    ui->statusbar->showMessage(QString("✔ %1 = %2 confirmé en %3 ms")
+                               .arg(actuator.toUpper()).arg(value)
+                               .arg(latencyNs / 1e6, 0, 'f', 1), 3000);
+}
+
+void MainWindow::onActuationRolledBack(const QString &actuator, int requested, int actual, const QString &reason)
+{
+    // La commande n'a pas été appliquée: le curseur reprend la valeur réelle
+    if (actuator == "pwm") {
+        const QSignalBlocker blocker(ui->pwmSlider);
+        ui->pwmSlider->setValue(actual);
+        onPwmSliderChanged(actual);
+    }
+    
+    const QString message = QString("↩️ %1: %2 demandé, %3 appliqué (%4)")
+        .arg(actuator.toUpper()).arg(requested).arg(actual)
+        .arg(reason == "timeout" ? "sans confirmation" : "valeur différente");
+    ui->statusbar->showMessage(message, 10000);
+    m_monitorModel->append(MonitorLogModel::Warning, message, true);
+    logSecurityEvent(message);
+}
+
 void MainWindow::onClearMonitor()
 {
-    ui->receiveTextEdit->clear();
-    ui->receiveTextEdit->append(
-        QString("<span style='color: #6b7280; font-style: italic;'>"
-                "[%1] 🗑️ Moniteur effacé</span><br>")
-        .arg(QDateTime::currentDateTime().toString("HH:mm:ss"))
-    );
+    m_monitorModel->clear();
+    m_monitorModel->append(MonitorLogModel::Muted, "🗑️ Moniteur effacé");
 }
 
 void MainWindow::onClearSecurityLogs()
 {
+    m_pendingSecurityLog.clear();
     ui->securityLogsTextEdit->clear();
     ui->securityLogsTextEdit->append(
         QString("<span style='color: #6b7280; font-style: italic;'>"
@@ -606,6 +665,7 @@ void MainWindow::onExportSecurityLogs()
         out << "================================================================\n";
         out << "Date: " << QDateTime::currentDateTime().toString("dd/MM/yyyy HH:mm:ss") << "\n";
         out << "================================================================\n\n";
+        renderFrame();
         out << ui->securityLogsTextEdit->toPlainText();
         file.close();
         ui->statusbar->showMessage("💾 Logs de sécurité exportés: " + fileName, 5000);
@@ -642,7 +702,8 @@ void MainWindow::onExportLogs()
         out << "================================================================\n";
         out << "Date: " << QDateTime::currentDateTime().toString("dd/MM/yyyy HH:mm:ss") << "\n";
         out << "================================================================\n\n";
-        out << ui->receiveTextEdit->toPlainText();
+        m_monitorModel->flush();
+        out << m_monitorModel->toPlainText();
         file.close();
         ui->statusbar->showMessage("💾 Logs sauvegardés: " + fileName, 5000);
         logSecurityEvent(QString("💾 Export des logs: %1").arg(fileName));
@@ -662,6 +723,222 @@ void MainWindow::onExportLogs()
     }
 }
 
+void MainWindow::onExportTelemetry()
+{
+    if (m_controller->exporter()->isBusy()) {
+        return;
+    }
+    QString selectedFilter;
+    QString defaultFileName = QDateTime::currentDateTime().toString("'mesures_'yyyyMMdd'_'HHmmss'.csv'");
+    QString fileName = QFileDialog::getSaveFileName(this, "Exporter les mesures", defaultFileName,
+                                                    "CSV (*.csv);;Binaire colonnes (*.stlb)", &selectedFilter);
+    if (fileName.isEmpty()) {
+        return;
+    }
+    ExportRequest request;
+    request.fileName = fileName;
+    request.format = (selectedFilter.contains("stlb") || fileName.endsWith(".stlb"))
+                     ? ExportRequest::BinaryColumnar : ExportRequest::Csv;
+    if (!m_exportProgress) {
+        m_exportProgress = new QProgressDialog("Export des mesures en cours...", "Annuler", 0, 1000, this);
+        m_exportProgress->setWindowTitle("Export");
+        m_exportProgress->setMinimumDuration(300);
+        m_exportProgress->setAutoClose(false);
+        m_exportProgress->setAutoReset(false);
+        connect(m_exportProgress, &QProgressDialog::canceled, m_controller->exporter(), &TelemetryExporter::cancel);
+    }
+    m_exportProgress->reset();
+    m_exportProgress->setValue(0);
+    ui->actionExportTelemetry->setEnabled(false);
+    m_controller->exporter()->startExport(request);
+}
+
+void MainWindow::onExportProgress(qint64 done, qint64 total)
+{
+    if (m_exportProgress && total > 0) {
+        m_exportProgress->setValue(static_cast<int>(done * 1000 / total));
+    }
+}
+
+void MainWindow::onExportFinished(const QString &fileName, qint64 samples)
+{
+    if (m_exportProgress) {
+        m_exportProgress->reset();
+    }
+    ui->actionExportTelemetry->setEnabled(true);
+    ui->statusbar->showMessage(QString("💾 %1 mesures exportées: %2").arg(samples).arg(fileName), 5000);
+    logSecurityEvent(QString("💾 Export des mesures: %1").arg(fileName));
+    qDebug() << "[MainWindow] Mesures exportées:" << fileName << samples;
+}
+
+void MainWindow::onExportFailed(const QString &error)
+{
+    if (m_exportProgress) {
+        m_exportProgress->reset();
+    }
+    ui->actionExportTelemetry->setEnabled(true);
+    showStyledMessageBox("Erreur d'export", "❌ L'export des mesures a échoué:\n\n" + error, QMessageBox::Critical);
+}
+
+void MainWindow::onExportCanceled()
+{
+    if (m_exportProgress) {
+        m_exportProgress->reset();
+    }
+    ui->actionExportTelemetry->setEnabled(true);
+    ui->statusbar->showMessage("Export des mesures annulé", 3000);
+}
+
+void MainWindow::onCaptureToggled(bool enabled)
+{
+    if (enabled == m_controller->isCapturing()) {
+        return;
+    }
+    if (!enabled) {
+        m_controller->stopCapture();
+        return;
+    }
+    QString directory = QFileDialog::getExistingDirectory(this, "Répertoire de capture");
+    if (directory.isEmpty() || !m_controller->startCapture(directory)) {
+        QSignalBlocker blocker(ui->actionCapture);
+        ui->actionCapture->setChecked(false);
+    }
+}
+
+void MainWindow::onCaptureStateChanged(bool active, const QString &directory)
+{
+    QSignalBlocker blocker(ui->actionCapture);
+    ui->actionCapture->setChecked(active);
+    if (active) {
+        ui->statusbar->showMessage("⏺ Capture longue durée: " + directory, 5000);
+        logSecurityEvent(QString("⏺ Capture démarrée: %1").arg(directory));
+    } else {
+        ui->statusbar->showMessage("⏹ Capture terminée: " + directory, 5000);
+        logSecurityEvent(QString("⏹ Capture terminée: %1").arg(directory));
+    }
+}
+
+void MainWindow::onRawRecordingToggled(bool enabled)
+{
+    if (!enabled) {
+        m_controller->stopRawRecording();
+        return;
+    }
+    QString defaultFileName = QDateTime::currentDateTime().toString("'flux_'yyyyMMdd'_'HHmmss'.strc'");
+    QString fileName = QFileDialog::getSaveFileName(this, "Enregistrer le flux brut", defaultFileName,
+                                                    "Captures brutes (*.strc);;Tous les fichiers (*)");
+    if (fileName.isEmpty()) {
+        QSignalBlocker blocker(ui->actionRawRecording);
+        ui->actionRawRecording->setChecked(false);
+        return;
+    }
+    m_controller->startRawRecording(fileName);
+}
+
+void MainWindow::onRawRecordingChanged(bool active, const QString &fileName)
+{
+    QSignalBlocker blocker(ui->actionRawRecording);
+    ui->actionRawRecording->setChecked(active);
+    ui->statusbar->showMessage(QString(active ? "⏺ Enregistrement du flux brut: %1" : "⏹ Flux brut enregistré: %1")
+                               .arg(fileName), 5000);
+    logSecurityEvent(QString(active ? "⏺ Enregistrement du flux brut: %1" : "⏹ Fin d'enregistrement: %1").arg(fileName));
+}
+
+void MainWindow::onReplayCapture()
+{
+    if (m_controller->isConnected()) {
+        showStyledMessageBox("Rejeu", "⚠️ Déconnectez le port série avant de rejouer une capture.", QMessageBox::Warning);
+        return;
+    }
+    QString fileName = QFileDialog::getOpenFileName(this, "Rejouer une capture", QString(),
+                                                    "Captures brutes (*.strc);;Tous les fichiers (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    bool ok = false;
+    double speed = QInputDialog::getDouble(this, "Vitesse de rejeu",
+                                           "Facteur de vitesse (1 = temps réel, 0 = au plus vite):",
+                                           1.0, 0.0, 1000.0, 2, &ok);
+    if (!ok) {
+        return;
+    }
+    logSecurityEvent(QString("▶ Rejeu de la capture %1 (x%2)").arg(fileName).arg(speed));
+    m_controller->startReplay(fileName, speed);
+}
+
+void MainWindow::onReplayFinished(qint64 records, qint64 bytes, qint64 elapsedNs)
+{
+    const double seconds = elapsedNs / 1e9;
+    QString summary = QString("⏹ Rejeu terminé: %1 blocs, %2 octets en %3 s")
+                      .arg(records).arg(bytes).arg(seconds, 0, 'f', 3);
+    if (seconds > 0) {
+        summary += QString(" (%1 Mo/s)").arg(bytes / seconds / 1e6, 0, 'f', 2);
+    }
+    ui->statusbar->showMessage(summary, 10000);
+    logSecurityEvent(summary);
+    qDebug() << "[MainWindow]" << summary;
+}
+
+void MainWindow::onRunScript()
+{
+    ScriptRunner *runner = m_controller->scriptRunner();
+    if (runner->isRunning()) {
+        logSecurityEvent("⏹ Script interrompu par l'utilisateur");
+        runner->abort();
+        return;
+    }
+    if (!m_controller->isConnected()) {
+        showStyledMessageBox("Script de test", "⚠️ Connectez le dispositif avant d'exécuter un script.", QMessageBox::Warning);
+        return;
+    }
+    QString fileName = QFileDialog::getOpenFileName(this, "Exécuter un script de test", QString(),
+                                                    "Scripts JSON (*.json);;Tous les fichiers (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    QString error;
+    if (!runner->loadFile(fileName, &error)) {
+        showStyledMessageBox("Script de test", QString("❌ %1").arg(error), QMessageBox::Critical);
+        return;
+    }
+    logSecurityEvent(QString("▶ Script %1 (%2 étapes)").arg(runner->script().name).arg(runner->script().steps.size()));
+    runner->start();
+}
+
+void MainWindow::onScriptStepFinished(const ScriptStepResult &result)
+{
+    const QString summary = QString("Étape %1 [%2] %3 ms")
+                            .arg(result.step).arg(result.label).arg(result.latencyNs / 1e6, 0, 'f', 3);
+    ui->statusbar->showMessage(summary, 2000);
+    if (!result.passed) {
+        logSecurityEvent(QString("❌ %1: %2").arg(summary, result.message));
+    }
+}
+
+void MainWindow::onScriptFinished(bool passed, int failures)
+{
+    const QJsonObject report = m_controller->scriptRunner()->report();
+    const QJsonObject latency = report["latency"].toObject();
+    const QString summary = QString("%1 Script %2: %3 échec(s), latence moy. %4 ms, max %5 ms")
+                            .arg(passed ? "✅" : "❌").arg(report["name"].toString()).arg(failures)
+                            .arg(latency["mean_ms"].toDouble(), 0, 'f', 3)
+                            .arg(latency["max_ms"].toDouble(), 0, 'f', 3);
+    ui->statusbar->showMessage(summary, 10000);
+    logSecurityEvent(summary);
+
+    QString fileName = QFileDialog::getSaveFileName(this, "Enregistrer le rapport", "rapport_script.json",
+                                                    "Rapports JSON (*.json)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        showStyledMessageBox("Rapport", QString("❌ %1").arg(file.errorString()), QMessageBox::Critical);
+        return;
+    }
+    file.write(QJsonDocument(report).toJson());
+}
+
 void MainWindow::onSecurityReport()
 {
     QString report = QString(
@@ -694,7 +971,7 @@ void MainWindow::updateConnectionState(bool connected)
     if (connected) {
         ui->statusbar->showMessage("🟢 Connecté - Communication active", 0);
         ui->connectButton->setText("Déconnecter");
-        ui->connIndicator->setStyleSheet("background-color: #10b981; border-radius: 10px; border: 2px solid #059669;");
+        setStyleState(ui->connIndicator, "indicator", "ok");
         ui->sendButton->setEnabled(m_isAuthenticated);
         ui->getTempButton->setEnabled(m_isAuthenticated);
         ui->getVoltageButton->setEnabled(m_isAuthenticated);
@@ -711,7 +988,7 @@ void MainWindow::updateConnectionState(bool connected)
     } else {
         ui->statusbar->showMessage("⚫ Déconnecté", 0);
         ui->connectButton->setText("Connecter");
-        ui->connIndicator->setStyleSheet("background-color: #ef4444; border-radius: 10px; border: 2px solid #dc2626;");
+        setStyleState(ui->connIndicator, "indicator", "error");
         ui->sendButton->setEnabled(false);
         ui->getTempButton->setEnabled(false);
         ui->getVoltageButton->setEnabled(false);
@@ -734,21 +1011,14 @@ void MainWindow::updateAuthenticationState(bool authenticated)
     if (authenticated) {
         ui->authStatusLabel->setText("AUTHENTIFIE");
         if (ui->authStatusFrame) {
-            ui->authStatusFrame->setStyleSheet(
-                "QFrame {"
-                "    background-color: #0a0e27;"
-                "    border: 2px solid #10b981;"
-                "    border-radius: 8px;"
-                "    padding: 15px;"
-                "}"
-            );
+            setStyleState(ui->authStatusFrame, "state", "ok");
         }
-        ui->authStatusLabel->setStyleSheet("font-size: 14pt; font-weight: bold; color: #10b981; border: none; background: transparent;");
+        setStyleState(ui->authStatusLabel, "state", "ok");
         if (ui->authSubtitleLabel) {
             ui->authSubtitleLabel->setText("Session active - Tous les controles disponibles");
         }
-        ui->authIndicator->setStyleSheet("background-color: #10b981; border-radius: 10px; border: 2px solid #059669;");
-        ui->encryptIndicator->setStyleSheet("background-color: #10b981; border-radius: 10px; border: 2px solid #059669;");
+        setStyleState(ui->authIndicator, "indicator", "ok");
+        setStyleState(ui->encryptIndicator, "indicator", "ok");
         if (m_controller->isConnected()) {
             ui->sendButton->setEnabled(true);
             ui->getTempButton->setEnabled(true);
@@ -766,21 +1036,14 @@ void MainWindow::updateAuthenticationState(bool authenticated)
     } else {
         ui->authStatusLabel->setText("NON AUTHENTIFIE");
         if (ui->authStatusFrame) {
-            ui->authStatusFrame->setStyleSheet(
-                "QFrame {"
-                "    background-color: #0a0e27;"
-                "    border: 2px solid #ef4444;"
-                "    border-radius: 8px;"
-                "    padding: 15px;"
-                "}"
-            );
+            setStyleState(ui->authStatusFrame, "state", "error");
         }
-        ui->authStatusLabel->setStyleSheet("font-size: 14pt; font-weight: bold; color: #ef4444; border: none; background: transparent;");
+        setStyleState(ui->authStatusLabel, "state", "error");
         if (ui->authSubtitleLabel) {
             ui->authSubtitleLabel->setText("Connectez-vous pour acceder aux controles");
         }
-        ui->authIndicator->setStyleSheet("background-color: #6b7280; border-radius: 10px; border: 2px solid #4b5563;");
-        ui->encryptIndicator->setStyleSheet("background-color: #6b7280; border-radius: 10px; border: 2px solid #4b5563;");
+        setStyleState(ui->authIndicator, "indicator", "idle");
+        setStyleState(ui->encryptIndicator, "indicator", "idle");
         ui->sendButton->setEnabled(false);
         ui->getTempButton->setEnabled(false);
         ui->getVoltageButton->setEnabled(false);
@@ -797,6 +1060,86 @@ void MainWindow::updateAuthenticationState(bool authenticated)
     updateSecurityLevel();
 }
 
+void MainWindow::scheduleRender(DirtyFlags flags)
+{
+    m_dirty |= flags;
+    if (!m_renderTimer->isActive()) {
+        m_renderTimer->start();
+    }
+}
+
+void MainWindow::renderFrame()
+{
+    m_renderTimer->stop();
+    const DirtyFlags dirty = m_dirty;
+    m_dirty = NothingDirty;
+    
+    // Une ligne par trame et par grandeur: seule la dernière valeur compte
+    if (dirty & TemperatureDirty) {
+        m_monitorModel->append(MonitorLogModel::Warning,
+                               QString("🌡️ Température: %1°C").arg(m_latestTemperature, 0, 'f', 1));
+    }
+    if (dirty & VoltageDirty) {
+        m_monitorModel->append(MonitorLogModel::Warning,
+                               QString("⚡ Tension: %1V").arg(m_latestVoltage, 0, 'f', 2));
+    }
+    if (dirty & StatusDirty) {
+        const QString statusText = QJsonDocument(m_latestStatus).toJson(QJsonDocument::Compact);
+        m_monitorModel->append(MonitorLogModel::Status, QString("📊 STATUS: %1").arg(statusText));
+    }
+    
+    // Moniteur (lignes ci-dessus comprises) et tracé suivent ce même tick
+    m_monitorModel->flush();
+    m_dirty &= ~DirtyFlags(MonitorLogDirty);
+    if (!m_dirty) {
+        m_renderTimer->stop();
+    }
+    if (dirty & PlotDirty) {
+        m_plotWidget->advanceFrame();
+    }
+    
+    if (dirty & SecurityStatsDirty) {
+        updateSecurityStats();
+    }
+    // Un bloc par entrée: setMaximumBlockCount borne bien le nombre de lignes.
+    // Au plus SecurityLogLinesPerFrame insertions par tick: une rafale est
+    // étalée sur plusieurs trames au lieu d'en bloquer une
+    if ((dirty & SecurityLogDirty) && !m_pendingSecurityLog.isEmpty()) {
+        const int count = qMin(m_pendingSecurityLog.size(), int(SecurityLogLinesPerFrame));
+        QTextDocument *document = ui->securityLogsTextEdit->document();
+        QTextCursor cursor(document);
+        cursor.movePosition(QTextCursor::End);
+        cursor.beginEditBlock();
+        for (int i = 0; i < count; ++i) {
+            if (!document->isEmpty()) {
+                cursor.insertBlock();
+            }
+            cursor.insertHtml(m_pendingSecurityLog.at(i));
+        }
+        cursor.endEditBlock();
+        m_pendingSecurityLog.erase(m_pendingSecurityLog.begin(), m_pendingSecurityLog.begin() + count);
+        if (!m_pendingSecurityLog.isEmpty()) {
+            scheduleRender(SecurityLogDirty);
+        }
+        if (ui->autoScrollLogsCheckBox && ui->autoScrollLogsCheckBox->isChecked()) {
+            QScrollBar *scrollBar = ui->securityLogsTextEdit->verticalScrollBar();
+            scrollBar->setValue(scrollBar->maximum());
+        }
+    }
+}
+
+void MainWindow::setStyleState(QWidget *widget, const char *property, const char *state)
+{
+    // Règles de la feuille de style réévaluées pour ce seul widget
+    const QString value = QString::fromLatin1(state);
+    if (widget->property(property).toString() == value) {
+        return;
+    }
+    widget->setProperty(property, value);
+    widget->style()->unpolish(widget);
+    widget->style()->polish(widget);
+}
+
 void MainWindow::updateSecurityStats()
 {
     if (ui->securityStatsTable && ui->securityStatsTable->rowCount() >= 5) {
@@ -824,38 +1167,27 @@ void MainWindow::updateSecurityStats()
 void MainWindow::updateSecurityLevel()
 {
     int level = getSecurityLevel();
+    if (level == m_shownSecurityLevel) {
+        return;
+    }
+    m_shownSecurityLevel = level;
     ui->securityLevelBar->setValue(level);
-    QString status;
-    QString chunkStyle;
+    
+    // Couleurs portées par la feuille de style (propriété "level"): aucun
+    // re-parse de feuille de style, restyle seulement au changement de palier
     if (level >= 80) {
-        status = "SECURISE";
-        chunkStyle = "background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #10b981, stop:1 #059669);";
-        ui->threatIndicator->setStyleSheet("background-color: #10b981; border-radius: 10px; border: 2px solid #059669;");
+        ui->securityLevelBar->setFormat("%p% - SECURISE");
+        setStyleState(ui->securityLevelBar, "level", "ok");
+        setStyleState(ui->threatIndicator, "indicator", "ok");
     } else if (level >= 50) {
-        status = "ATTENTION";
-        chunkStyle = "background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #f59e0b, stop:1 #d97706);";
-        ui->threatIndicator->setStyleSheet("background-color: #f59e0b; border-radius: 10px; border: 2px solid #d97706;");
+        ui->securityLevelBar->setFormat("%p% - ATTENTION");
+        setStyleState(ui->securityLevelBar, "level", "warning");
+        setStyleState(ui->threatIndicator, "indicator", "warning");
     } else {
-        status = "CRITIQUE";
-        chunkStyle = "background: qlineargradient(x1:0, y1:0, x2:1, y2:0, stop:0 #ef4444, stop:1 #dc2626);";
-        ui->threatIndicator->setStyleSheet("background-color: #ef4444; border-radius: 10px; border: 2px solid #dc2626;");
-    }
-    ui->securityLevelBar->setFormat("%p% - " + status);
-    ui->securityLevelBar->setStyleSheet(
-        "QProgressBar {"
-        "    border: none;"
-        "    border-radius: 8px;"
-        "    text-align: center;"
-        "    background-color: #16213e;"
-        "    color: #ffffff;"
-        "    font-weight: bold;"
-        "    font-size: 11pt;"
-        "}"
-        "QProgressBar::chunk {"
-        "    " + chunkStyle +
-        "    border-radius: 8px;"
-        "}"
-    );
+        ui->securityLevelBar->setFormat("%p% - CRITIQUE");
+        setStyleState(ui->securityLevelBar, "level", "critical");
+        setStyleState(ui->threatIndicator, "indicator", "error");
+    }
 }
 
 int MainWindow::getSecurityLevel()
@@ -899,13 +1231,14 @@ QString MainWindow::getUptime()
 
 void MainWindow::logSecurityEvent(const QString &event)
 {
+    // Ajouté au journal au prochain tick de rendu (un bloc par entrée)
     QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss");
     QString logEntry = QString("[%1] %2").arg(timestamp).arg(event);
-    ui->securityLogsTextEdit->append(QString("<span style='color: #00d9ff;'>%1</span>").arg(logEntry.toHtmlEscaped()));
-    if (ui->autoScrollLogsCheckBox && ui->autoScrollLogsCheckBox->isChecked()) {
-        QScrollBar *scrollBar = ui->securityLogsTextEdit->verticalScrollBar();
-        scrollBar->setValue(scrollBar->maximum());
+    m_pendingSecurityLog.append(QString("<span style='color: #00d9ff;'>%1</span>").arg(logEntry.toHtmlEscaped()));
+    if (m_pendingSecurityLog.size() > SecurityLogMaxLines) {
+        m_pendingSecurityLog.removeFirst();
     }
+    scheduleRender(SecurityLogDirty);
 }
 
 bool MainWindow::checkAuthentication()
@@ -4,13 +4,33 @@
 #include <QMainWindow>
 #include <QDateTime>
 #include <QMessageBox>
+#include <QJsonObject>
+#include <QStringList>
 #include <functional>
 #include "DeviceController.h"
 
+class QProgressDialog;
+class QTimer;
+class MonitorLogModel;
+class PlotWidget;
+
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
+/**
+ * @brief Fenêtre principale (View dans MVC)
+ *
+ * Les notifications du contrôleur ne touchent pas directement les widgets:
+ * elles enregistrent la dernière valeur et un drapeau "à redessiner". Un
+ * tick de rendu (RenderIntervalMs, ~60 Hz, armé seulement s'il y a quelque
+ * chose à afficher) applique une fois par trame les seules valeurs les plus
+ * récentes. Le coût de la vue est ainsi borné quel que soit le débit.
+ *
+ * Les voyants (connexion, authentification, niveau de sécurité) changent
+ * d'apparence par propriété dynamique ("indicator", "state", "level") dont
+ * les règles sont dans la feuille de style chargée une seule fois.
+ */
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -36,6 +56,20 @@ private slots:
     void onClearSecurityLogs();
     void onExportSecurityLogs();
     void onExportLogs();
+    void onExportTelemetry();
+    void onExportProgress(qint64 done, qint64 total);
+    void onExportFinished(const QString &fileName, qint64 samples);
+    void onExportFailed(const QString &error);
+    void onExportCanceled();
+    void onCaptureToggled(bool enabled);
+    void onRawRecordingToggled(bool enabled);
+    void onRawRecordingChanged(bool active, const QString &fileName);
+    void onReplayCapture();
+    void onReplayFinished(qint64 records, qint64 bytes, qint64 elapsedNs);
+    void onRunScript();
+    void onScriptStepFinished(const ScriptStepResult &result);
+    void onScriptFinished(bool passed, int failures);
+    void onCaptureStateChanged(bool active, const QString &directory);
     void onSecurityReport();
     void onConnectionChanged(bool connected);
     void onDataReceived(const QString &data);
@@ -43,13 +77,39 @@ private slots:
     void onVoltageUpdated(float voltage);
     void onStatusUpdated(const QJsonObject &status);
     void onDeviceError(const QString &error);
+    void onAlarmRaised(const AlarmEvent &event);
+    void onAlarmCleared(const AlarmEvent &event);
+    void onActuationConfirmed(const QString &actuator, int value, qint64 latencyNs);
+    void onActuationRolledBack(const QString &actuator, int requested, int actual, const QString &reason);
     void updateSessionInfo();
+    void renderFrame();
 
 private:
+    // Éléments de vue à mettre à jour au prochain tick de rendu
+    enum DirtyFlag {
+        NothingDirty       = 0x00,
+        TemperatureDirty   = 0x01,
+        VoltageDirty       = 0x02,
+        StatusDirty        = 0x04,
+        SecurityStatsDirty = 0x08,
+        SecurityLogDirty   = 0x10,
+        MonitorLogDirty    = 0x20,   // Lignes du moniteur en attente
+        PlotDirty          = 0x40    // Trame du tracé demandée
+    };
+    Q_DECLARE_FLAGS(DirtyFlags, DirtyFlag)
+
+    static const int RenderIntervalMs = 16;
+    static const int SecurityLogMaxLines = 5000;
+    static const int SecurityLogLinesPerFrame = 200;   // Le reste attend le tick suivant
+
     Ui::MainWindow *ui;
     DeviceController *m_controller;
 
     bool m_isAuthenticated;
+    QProgressDialog *m_exportProgress;
+    MonitorLogModel *m_monitorModel;
+    bool m_monitorFollow;          // Vue du moniteur en bas: suit les ajouts
+    PlotWidget *m_plotWidget;
     QDateTime m_sessionStartTime;
 
     struct SecurityStats {
@@ -60,7 +120,18 @@ private:
     };
     SecurityStats m_securityStats;
 
+    // Tick de rendu et dernières valeurs reçues depuis la trame précédente
+    QTimer *m_renderTimer;
+    DirtyFlags m_dirty;
+    float m_latestTemperature;
+    float m_latestVoltage;
+    QJsonObject m_latestStatus;
+    QStringList m_pendingSecurityLog;
+    int m_shownSecurityLevel;      // -1 tant que rien n'est affiché
+
     void setupUI();
+    void setupMonitor();
+    void setupPlot();
     void setupConnections();
     void setupSecurityMonitoring();
     void setupSecurityStatsTable();
@@ -69,6 +140,8 @@ private:
     void updateAuthenticationState(bool authenticated);
     void updateSecurityStats();
     void updateSecurityLevel();
+    void scheduleRender(DirtyFlags flags);
+    void setStyleState(QWidget *widget, const char *property, const char *state);
     int getSecurityLevel();
     QString getSessionDuration();
     QString getUptime();
@@ -0,0 +1,60 @@
+#include "MonitorLogDelegate.h"
+#include "MonitorLogModel.h"
+#include <QPainter>
+#include <QApplication>
+
+MonitorLogDelegate::MonitorLogDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void MonitorLogDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                               const QModelIndex &index) const
+{
+    // Fond et sélection selon le style, sans le texte
+    QStyleOptionViewItem background = option;
+    initStyleOption(&background, index);
+    background.text.clear();
+    const QWidget *widget = option.widget;
+    QStyle *style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &background, painter, widget);
+
+    const int kind = index.data(MonitorLogModel::KindRole).toInt();
+    const QString timestamp = index.data(MonitorLogModel::TimestampRole).toString();
+    const QString icon = index.data(MonitorLogModel::IconRole).toString();
+    const QString text = index.data(MonitorLogModel::TextRole).toString();
+
+    QFont font = option.font;
+    font.setBold(index.data(MonitorLogModel::BoldRole).toBool() || kind == MonitorLogModel::Banner);
+    font.setItalic(kind == MonitorLogModel::Muted);
+
+    QString line;
+    if (!timestamp.isEmpty()) {
+        line = QLatin1Char('[') + timestamp + QLatin1String("] ");
+    }
+    if (!icon.isEmpty()) {
+        line += icon + QLatin1Char(' ');
+    }
+    line += text;
+
+    const QRect rect = option.rect.adjusted(RowPadding * 2, 0, -RowPadding * 2, 0);
+    const QFontMetrics metrics(font);
+
+    painter->save();
+    painter->setFont(font);
+    painter->setPen(option.state & QStyle::State_Selected
+                    ? option.palette.color(QPalette::HighlightedText)
+                    : index.data(Qt::ForegroundRole).value<QColor>());
+    painter->drawText(rect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine,
+                      metrics.elidedText(line, Qt::ElideRight, rect.width()));
+    painter->restore();
+}
+
+QSize MonitorLogDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(index)
+    // Hauteur fixe: la vue n'interroge qu'une ligne (uniformItemSizes)
+    QFont font = option.font;
+    font.setBold(true);
+    return QSize(option.rect.width(), QFontMetrics(font).height() + 2 * RowPadding);
+}
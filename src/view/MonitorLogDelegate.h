@@ -0,0 +1,30 @@
+#ifndef MONITORLOGDELEGATE_H
+#define MONITORLOGDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+/**
+ * @brief Rendu d'une ligne du moniteur série (MonitorLogModel)
+ *
+ * Une ligne = horodatage, icône et texte sur une seule ligne de hauteur
+ * fixe (texte élidé), dessinés directement au QPainter: pas de document
+ * HTML ni de mise en page de texte riche. Combiné à
+ * QListView::setUniformItemSizes(true), seules les lignes visibles sont
+ * formatées et dessinées.
+ */
+class MonitorLogDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit MonitorLogDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    static const int RowPadding = 2;
+};
+
+#endif // MONITORLOGDELEGATE_H
@@ -0,0 +1,245 @@
+#include "MonitorLogModel.h"
+#include "MonotonicClock.h"
+#include <QColor>
+#include <QTimer>
+
+namespace {
+
+struct Style {
+    const char *color;
+    const char *icon;
+};
+
+Style kindStyle(MonitorLogModel::Kind kind)
+{
+    switch (kind) {
+        case MonitorLogModel::Sent:    return { "#00d9ff", "📤" };
+        case MonitorLogModel::Info:    return { "#00d9ff", "" };
+        case MonitorLogModel::Success: return { "#10b981", "" };
+        case MonitorLogModel::Warning: return { "#f59e0b", "" };
+        case MonitorLogModel::Error:   return { "#ef4444", "" };
+        case MonitorLogModel::Status:  return { "#8b5cf6", "" };
+        case MonitorLogModel::Muted:   return { "#6b7280", "" };
+        case MonitorLogModel::Banner:  return { "#00d9ff", "" };
+        default:                       return { "#10b981", "📥" };
+    }
+}
+
+// Coloration d'une ligne reçue d'après son contenu (les erreurs sont
+// comptées via deviceError, ceci n'est que de l'affichage)
+Style receivedStyle(const QString &text)
+{
+    if (text.contains("ERROR") || text.contains("error")) {
+        return { "#ef4444", "❌" };
+    }
+    if (text.contains("OK") || text.contains("ok")) {
+        return { "#00d9ff", "✅" };
+    }
+    if (text.contains("TEMP") || text.contains("temp")) {
+        return { "#f59e0b", "🌡️" };
+    }
+    if (text.contains("VOLTAGE") || text.contains("voltage")) {
+        return { "#f59e0b", "⚡" };
+    }
+    if (text.contains("STATUS") || text.contains("status")) {
+        return { "#8b5cf6", "📊" };
+    }
+    if (text.contains("READY")) {
+        return { "#10b981", "🚀" };
+    }
+    return kindStyle(MonitorLogModel::Received);
+}
+
+} // namespace
+
+MonitorLogModel::MonitorLogModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_head(0)
+    , m_count(0)
+    , m_capacity(DefaultCapacity)
+    , m_flushTimer(new QTimer(this))
+    , m_frameDriven(false)
+{
+    m_entries.resize(m_capacity);
+
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FrameIntervalMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &MonitorLogModel::flush);
+}
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+void MonitorLogModel::setCapacity(int capacity)
+{
+    capacity = qMax(1, capacity);
+    if (capacity == m_capacity) {
+        return;
+    }
+
+    // Les lignes les plus récentes sont conservées, remises à plat
+    beginResetModel();
+    const int kept = qMin(m_count, capacity);
+    QVector<Entry> entries(capacity);
+    for (int i = 0; i < kept; ++i) {
+        entries[i] = entryAt(m_count - kept + i);
+    }
+    m_entries.swap(entries);
+    m_capacity = capacity;
+    m_head = 0;
+    m_count = kept;
+    endResetModel();
+}
+
+void MonitorLogModel::setFrameDriven(bool driven)
+{
+    m_frameDriven = driven;
+    if (driven) {
+        m_flushTimer->stop();
+        if (!m_pending.isEmpty()) {
+            emit frameRequested();
+        }
+    } else if (!m_pending.isEmpty()) {
+        m_flushTimer->start();
+    }
+}
+
+// ============================================================================
+// AJOUT PAR LOTS
+// ============================================================================
+
+void MonitorLogModel::append(Kind kind, const QString &text, bool bold, qint64 timestampNs)
+{
+    const bool firstPending = m_pending.isEmpty();
+    m_pending.append(Entry{ timestampNs > 0 ? timestampNs : MonotonicClock::nowNs(), text, quint8(kind), bold });
+
+    // Rafale plus longue que le tampon: seules les capacity() dernières
+    // lignes survivront au lot (éviction amortie)
+    if (m_pending.size() >= 2 * m_capacity) {
+        m_pending.remove(0, m_pending.size() - m_capacity);
+    }
+
+    if (m_frameDriven) {
+        if (firstPending) {
+            emit frameRequested();
+        }
+    } else if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void MonitorLogModel::flush()
+{
+    m_flushTimer->stop();
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    QVector<Entry> batch;
+    batch.swap(m_pending);
+    const int skipped = qMax(0, batch.size() - m_capacity);
+    const int count = batch.size() - skipped;
+
+    // Place libérée en tête en une seule suppression
+    const int overflow = qMax(0, m_count + count - m_capacity);
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_head = (m_head + overflow) % m_capacity;
+        m_count -= overflow;
+        endRemoveRows();
+    }
+
+    beginInsertRows(QModelIndex(), m_count, m_count + count - 1);
+    for (int i = skipped; i < batch.size(); ++i) {
+        m_entries[(m_head + m_count) % m_capacity] = std::move(batch[i]);
+        ++m_count;
+    }
+    endInsertRows();
+
+    emit batchAppended(count);
+}
+
+void MonitorLogModel::clear()
+{
+    m_flushTimer->stop();
+    m_pending.clear();
+
+    beginResetModel();
+    m_entries = QVector<Entry>(m_capacity);
+    m_head = 0;
+    m_count = 0;
+    endResetModel();
+}
+
+QString MonitorLogModel::toPlainText() const
+{
+    QString text;
+    for (int row = 0; row < m_count; ++row) {
+        text += lineText(entryAt(row));
+        text += '\n';
+    }
+    return text;
+}
+
+// ============================================================================
+// MODÈLE
+// ============================================================================
+
+int MonitorLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant MonitorLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_count) {
+        return QVariant();
+    }
+
+    const Entry &entry = entryAt(index.row());
+    const Kind kind = Kind(entry.kind);
+
+    switch (role) {
+        case Qt::DisplayRole:
+            return lineText(entry);
+
+        case TimestampRole:
+            return kind == Banner ? QString()
+                                  : MonotonicClock::toDateTime(entry.timestampNs).toString("HH:mm:ss");
+
+        case TextRole:
+            return entry.text;
+
+        case IconRole:
+            return QString::fromUtf8(kind == Received ? receivedStyle(entry.text).icon : kindStyle(kind).icon);
+
+        case Qt::ForegroundRole:
+            return QColor(kind == Received ? receivedStyle(entry.text).color : kindStyle(kind).color);
+
+        case KindRole:
+            return int(kind);
+
+        case BoldRole:
+            return entry.bold;
+
+        default:
+            return QVariant();
+    }
+}
+
+QString MonitorLogModel::lineText(const Entry &entry) const
+{
+    const Kind kind = Kind(entry.kind);
+    if (kind == Banner) {
+        return entry.text;
+    }
+
+    const char *icon = kind == Received ? receivedStyle(entry.text).icon : kindStyle(kind).icon;
+    QString line = QString("[%1] ").arg(MonotonicClock::toDateTime(entry.timestampNs).toString("HH:mm:ss"));
+    if (*icon) {
+        line += QString::fromUtf8(icon);
+        line += ' ';
+    }
+    return line + entry.text;
+}
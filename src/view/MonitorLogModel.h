@@ -0,0 +1,104 @@
+#ifndef MONITORLOGMODEL_H
+#define MONITORLOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+class QTimer;
+
+/**
+ * @brief Journal du moniteur série, borné et virtualisé (vue QListView)
+ *
+ * Les lignes sont conservées dans un tampon circulaire de capacity()
+ * entrées: au-delà, les plus anciennes sont retirées. Une entrée ne stocke
+ * que son horodatage (MonotonicClock), sa catégorie et son texte brut;
+ * horodatage formaté, icône et couleur sont calculés dans data(), donc
+ * uniquement pour les lignes visibles.
+ *
+ * append() ne touche pas la vue: les lignes sont accumulées puis insérées
+ * en un seul lot par trame (FrameIntervalMs), avec au plus un
+ * rowsRemoved/rowsInserted par trame quel que soit le débit. En mode
+ * cadencé (setFrameDriven), le timer interne n'est pas utilisé: le modèle
+ * émet frameRequested() et la vue hôte appelle flush() à son propre tick.
+ */
+class MonitorLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Kind {
+        Received,   // Ligne du dispositif, couleur déduite du contenu
+        Sent,       // Commande envoyée
+        Info,
+        Success,
+        Warning,
+        Error,
+        Status,
+        Muted,      // Messages de service (moniteur effacé...)
+        Banner      // Bannière d'accueil, sans horodatage
+    };
+
+    enum Roles {
+        TimestampRole = Qt::UserRole + 1,   // "HH:mm:ss"
+        TextRole,                           // Texte brut de la ligne
+        IconRole,                           // Emoji de la catégorie
+        KindRole,
+        BoldRole
+    };
+
+    static const int DefaultCapacity = 10000;
+    static const int FrameIntervalMs = 16;
+
+    explicit MonitorLogModel(QObject *parent = nullptr);
+
+    void setCapacity(int capacity);
+    int capacity() const { return m_capacity; }
+
+    // Ajout différé à la prochaine trame (timestampNs = 0: maintenant)
+    void append(Kind kind, const QString &text, bool bold = false, qint64 timestampNs = 0);
+    void clear();
+
+    // Insère immédiatement les lignes en attente
+    void flush();
+
+    // true: trames fournies par l'appelant (frameRequested → flush())
+    void setFrameDriven(bool driven);
+    bool isFrameDriven() const { return m_frameDriven; }
+
+    // Contenu complet en texte brut ("[HH:mm:ss] texte"), pour l'export
+    QString toPlainText() const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+signals:
+    // Lot inséré (après rowsInserted), pour le défilement automatique
+    void batchAppended(int count);
+
+    // Mode cadencé: premières lignes en attente depuis le dernier flush()
+    void frameRequested();
+
+private:
+    struct Entry {
+        qint64 timestampNs;
+        QString text;
+        quint8 kind;
+        bool bold;
+    };
+
+    const Entry &entryAt(int row) const { return m_entries[(m_head + row) % m_entries.size()]; }
+    QString lineText(const Entry &entry) const;
+
+    QVector<Entry> m_entries;    // Tampon circulaire (m_count valides à partir de m_head)
+    int m_head;
+    int m_count;
+    int m_capacity;
+
+    QVector<Entry> m_pending;    // Lignes de la trame en cours
+    QTimer *m_flushTimer;
+    bool m_frameDriven;
+};
+
+#endif // MONITORLOGMODEL_H
@@ -0,0 +1,143 @@
+#include "PlotRenderer.h"
+#include "DataModel.h"
+#include "MonotonicClock.h"
+#include <QLineF>
+#include <QPainter>
+#include <QPen>
+#include <QPolygonF>
+#include <limits>
+
+namespace {
+
+const QRgb BackgroundColor = 0xff0a0e27;
+const QRgb PlotBackgroundColor = 0xff0f1535;
+const QRgb GridColor = 0xff1e293b;
+
+// Marge relative ajoutée autour de l'échelle automatique
+const double AutoScaleMargin = 0.05;
+
+} // namespace
+
+PlotRenderer::PlotRenderer(DataModel *model, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_nextBuffer(0)
+{
+}
+
+// ============================================================================
+// RENDU
+// ============================================================================
+
+void PlotRenderer::render(const PlotFrameRequest &request)
+{
+    const qint64 startNs = MonotonicClock::nowNs();
+
+    PlotFrame frame;
+    frame.serial = request.serial;
+    frame.fromNs = request.fromNs;
+    frame.toNs = request.toNs;
+
+    // Trame vide renvoyée quand même: la vue attend une réponse par requête
+    const QRect plot = request.plotRect;
+    if (request.size.isEmpty() || plot.isEmpty() || request.toNs <= request.fromNs) {
+        emit frameReady(frame);
+        return;
+    }
+
+    // Une colonne par pixel physique, lue sous le mutex du modèle
+    QVector<QVector<DataModel::DecimatedColumn>> columns(request.traces.size());
+    double low = std::numeric_limits<double>::max();
+    double high = std::numeric_limits<double>::lowest();
+
+    for (int i = 0; i < request.traces.size(); ++i) {
+        columns[i] = m_model->queryDecimated(request.traces[i].channelId,
+                                             request.fromNs, request.toNs, plot.width());
+        for (const DataModel::DecimatedColumn &column : columns[i]) {
+            low = qMin(low, column.min);
+            high = qMax(high, column.max);
+        }
+    }
+
+    double yMin = request.yMin;
+    double yMax = request.yMax;
+    if (request.autoScale && low <= high) {
+        double margin = (high - low) * AutoScaleMargin;
+        if (margin <= 0.0) {
+            margin = qMax(qAbs(high) * AutoScaleMargin, 0.5);
+        }
+        yMin = low - margin;
+        yMax = high + margin;
+    } else if (request.autoScale) {
+        yMin = 0.0;
+        yMax = 1.0;
+    }
+    if (yMax <= yMin) {
+        yMax = yMin + 1.0;
+    }
+    frame.yMin = yMin;
+    frame.yMax = yMax;
+
+    // Tampon réutilisé: la trame précédente est encore affichée par la vue
+    QImage &image = m_buffers[m_nextBuffer];
+    m_nextBuffer ^= 1;
+    if (image.size() != request.size) {
+        image = QImage(request.size, QImage::Format_ARGB32_Premultiplied);
+    }
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.fillRect(image.rect(), QColor(BackgroundColor));
+    painter.fillRect(plot, QColor(PlotBackgroundColor));
+
+    // Grille
+    QVector<QLineF> lines;
+    lines.reserve(qMax(plot.width() + 1, GridColumns + GridRows + 2));
+    for (int c = 0; c <= GridColumns; ++c) {
+        const double x = plot.left() + double(plot.width() - 1) * c / GridColumns;
+        lines.append(QLineF(x, plot.top(), x, plot.bottom()));
+    }
+    for (int r = 0; r <= GridRows; ++r) {
+        const double y = plot.top() + double(plot.height() - 1) * r / GridRows;
+        lines.append(QLineF(plot.left(), y, plot.right(), y));
+    }
+    painter.setPen(QPen(QColor(GridColor), 0));
+    painter.drawLines(lines);
+
+    // Courbes: enveloppe min/max verticale + moyenne reliée
+    const double xScale = double(plot.width() - 1) / double(request.toNs - request.fromNs);
+    const double yScale = double(plot.height() - 1) / (yMax - yMin);
+    const double bottom = plot.top() + plot.height() - 1;
+
+    QPolygonF path;
+    path.reserve(plot.width());
+    painter.setClipRect(plot);
+
+    for (int i = 0; i < request.traces.size(); ++i) {
+        lines.resize(0);
+        path.resize(0);
+
+        for (const DataModel::DecimatedColumn &column : columns[i]) {
+            const qint64 midNs = column.startTime + (column.endTime - column.startTime) / 2;
+            const double x = plot.left() + (midNs - request.fromNs) * xScale;
+            if (column.count > 1 && column.max > column.min) {
+                lines.append(QLineF(x, bottom - (column.min - yMin) * yScale,
+                                    x, bottom - (column.max - yMin) * yScale));
+            }
+            path.append(QPointF(x, bottom - (column.mean - yMin) * yScale));
+        }
+
+        painter.setPen(QPen(request.traces[i].color, qMax(1.0, request.devicePixelRatio)));
+        painter.drawLines(lines);
+        if (path.size() == 1) {
+            painter.drawPoint(path.first());
+        } else {
+            painter.drawPolyline(path);
+        }
+    }
+    painter.end();
+
+    frame.image = image;
+    frame.renderNs = MonotonicClock::nowNs() - startNs;
+    emit frameReady(frame);
+}
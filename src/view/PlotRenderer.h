@@ -0,0 +1,104 @@
+#ifndef PLOTRENDERER_H
+#define PLOTRENDERER_H
+
+#include <QObject>
+#include <QColor>
+#include <QImage>
+#include <QMetaType>
+#include <QRect>
+#include <QSize>
+#include <QVector>
+#include <QtGlobal>
+
+class DataModel;
+
+/**
+ * @brief Paramètres d'une trame de tracé (copiés vers le thread de rendu)
+ */
+struct PlotFrameRequest
+{
+    struct Trace {
+        quint16 channelId;
+        QColor color;
+    };
+
+    QVector<Trace> traces;
+    QSize size;             // Pixels physiques
+    QRect plotRect;         // Zone des courbes dans l'image (pixels physiques)
+    qreal devicePixelRatio;
+    qint64 fromNs;          // Base MonotonicClock
+    qint64 toNs;
+    bool autoScale;         // false: yMin/yMax imposés
+    double yMin;
+    double yMax;
+    quint64 serial;
+
+    PlotFrameRequest()
+        : devicePixelRatio(1.0)
+        , fromNs(0)
+        , toNs(0)
+        , autoScale(true)
+        , yMin(0.0)
+        , yMax(1.0)
+        , serial(0)
+    {
+    }
+};
+
+/**
+ * @brief Trame rastérisée, prête à être copiée à l'écran
+ */
+struct PlotFrame
+{
+    QImage image;
+    quint64 serial;
+    qint64 fromNs;          // Intervalle et échelle réellement tracés
+    qint64 toNs;
+    double yMin;
+    double yMax;
+    qint64 renderNs;        // Durée de rendu (requêtes + rastérisation)
+
+    PlotFrame() : serial(0), fromNs(0), toNs(0), yMin(0.0), yMax(1.0), renderNs(0) {}
+};
+
+Q_DECLARE_METATYPE(PlotFrameRequest)
+Q_DECLARE_METATYPE(PlotFrame)
+
+/**
+ * @brief Rastérisation des courbes dans un thread dédié
+ *
+ * Même architecture que ExportWorker: l'objet est déplacé dans un QThread
+ * et reçoit ses requêtes par connexion en file. Chaque canal est lu via
+ * DataModel::queryDecimated() (pyramide min/max, une colonne par pixel
+ * physique): le coût d'une trame dépend de la largeur du tracé, pas de la
+ * longueur de l'historique.
+ *
+ * Chaque colonne est dessinée comme un segment vertical min → max relié à
+ * la suivante par sa moyenne, sans anticrénelage. Le fond, la grille et
+ * les courbes sont peints dans une QImage; le texte (axes, légende) reste
+ * au thread graphique. Deux images sont réutilisées en alternance: tant
+ * que la vue ne garde que la trame affichée, aucune allocation par trame.
+ */
+class PlotRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int GridColumns = 6;
+    static const int GridRows = 5;
+
+    explicit PlotRenderer(DataModel *model, QObject *parent = nullptr);
+
+public slots:
+    void render(const PlotFrameRequest &request);
+
+signals:
+    void frameReady(const PlotFrame &frame);
+
+private:
+    DataModel *m_model;
+    QImage m_buffers[2];
+    int m_nextBuffer;
+};
+
+#endif // PLOTRENDERER_H
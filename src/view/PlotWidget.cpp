@@ -0,0 +1,540 @@
+#include "PlotWidget.h"
+#include <QFontMetrics>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QThread>
+#include <QTimer>
+#include <QWheelEvent>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+
+// Marges autour de la zone des courbes (pixels logiques): valeurs à
+// gauche, légende en haut, temps en bas
+const int LeftMargin = 56;
+const int TopMargin = 24;
+const int RightMargin = 12;
+const int BottomMargin = 22;
+
+const QRgb BackgroundColor = 0xff0a0e27;
+const QRgb TextColor = 0xff6b7280;
+
+// Facteur de zoom par cran de molette (120 unités)
+const double WheelZoomStep = 0.85;
+
+const qint64 NsPerSec = 1000 * MonotonicClock::NsPerMs;
+
+int valueDecimals(double range)
+{
+    if (range < 1.0) {
+        return 3;
+    }
+    if (range < 10.0) {
+        return 2;
+    }
+    return range < 100.0 ? 1 : 0;
+}
+
+} // namespace
+
+PlotWidget::PlotWidget(DataModel *model, QWidget *parent)
+    : QWidget(parent)
+    , m_model(model)
+    , m_renderer(nullptr)
+    , m_renderThread(nullptr)
+    , m_frameTimer(new QTimer(this))
+    , m_followTimer(new QTimer(this))
+    , m_serial(0)
+    , m_inFlight(false)
+    , m_dirty(false)
+    , m_lastRequestNs(0)
+    , m_frameDriven(false)
+    , m_frameRequested(false)
+    , m_spanNs(DefaultSpanMs * MonotonicClock::NsPerMs)
+    , m_endNs(0)
+    , m_follow(true)
+    , m_autoScale(true)
+    , m_yMin(0.0)
+    , m_yMax(1.0)
+    , m_dragging(false)
+    , m_dragEndNs(0)
+    , m_dragYMin(0.0)
+    , m_dragYMax(1.0)
+    , m_framesInWindow(0)
+    , m_fpsWindowNs(0)
+    , m_fps(0.0)
+{
+    qRegisterMetaType<PlotFrameRequest>("PlotFrameRequest");
+    qRegisterMetaType<PlotFrame>("PlotFrame");
+
+    // Toute la surface est peinte à chaque trame
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumSize(320, 200);
+
+    m_renderThread = new QThread(this);
+    m_renderer = new PlotRenderer(model);
+    m_renderer->moveToThread(m_renderThread);
+
+    connect(m_renderThread, &QThread::finished,
+            m_renderer, &PlotRenderer::deleteLater);
+
+    connect(this, &PlotWidget::requestFrame,
+            m_renderer, &PlotRenderer::render, Qt::QueuedConnection);
+
+    connect(m_renderer, &PlotRenderer::frameReady,
+            this, &PlotWidget::onFrameReady);
+
+    connect(m_model, &DataModel::sampleAdded, this, &PlotWidget::onSampleAdded);
+    connect(m_model, &DataModel::historyCleared, this, &PlotWidget::onHistoryCleared);
+
+    m_frameTimer->setSingleShot(true);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_frameTimer, &QTimer::timeout, this, &PlotWidget::onTick);
+
+    m_followTimer->setSingleShot(true);
+    connect(m_followTimer, &QTimer::timeout, this, &PlotWidget::scheduleFrame);
+
+    m_renderThread->start();
+    qDebug() << "[PlotWidget] Render thread started";
+}
+
+PlotWidget::~PlotWidget()
+{
+    // Une trame en cours est terminée avant l'arrêt du thread
+    m_frameTimer->stop();
+    m_followTimer->stop();
+    m_renderThread->quit();
+    m_renderThread->wait();
+}
+
+// ============================================================================
+// CANAUX
+// ============================================================================
+
+void PlotWidget::addChannel(quint16 channelId, const QColor &color)
+{
+    for (Channel &channel : m_channels) {
+        if (channel.id == channelId) {
+            channel.color = color;
+            scheduleFrame();
+            return;
+        }
+    }
+
+    const ChannelInfo info = m_model->channelInfo(channelId);
+    QString label = info.isValid() ? info.name : QString("canal %1").arg(channelId);
+    if (info.isValid() && !info.unit.isEmpty()) {
+        label += QString(" (%1)").arg(info.unit);
+    }
+
+    m_channels.append(Channel{ channelId, color, label });
+    scheduleFrame();
+}
+
+void PlotWidget::removeChannel(quint16 channelId)
+{
+    for (int i = 0; i < m_channels.size(); ++i) {
+        if (m_channels[i].id == channelId) {
+            m_channels.remove(i);
+            scheduleFrame();
+            return;
+        }
+    }
+}
+
+void PlotWidget::clearChannels()
+{
+    m_channels.clear();
+    scheduleFrame();
+}
+
+QList<quint16> PlotWidget::channels() const
+{
+    QList<quint16> ids;
+    for (const Channel &channel : m_channels) {
+        ids.append(channel.id);
+    }
+    return ids;
+}
+
+// ============================================================================
+// VUE
+// ============================================================================
+
+void PlotWidget::setTimeSpanMs(qint64 spanMs)
+{
+    m_spanNs = qBound(qint64(MinSpanMs), spanMs, qint64(MaxSpanMs)) * MonotonicClock::NsPerMs;
+    applyView();
+}
+
+void PlotWidget::setFollowLatest(bool follow)
+{
+    if (!follow && m_follow) {
+        m_endNs = MonotonicClock::nowNs();
+    }
+    m_follow = follow;
+    applyView();
+}
+
+void PlotWidget::setAutoScale(bool enabled)
+{
+    if (!enabled && m_autoScale) {
+        m_yMin = m_frame.yMin;
+        m_yMax = m_frame.yMax;
+    }
+    m_autoScale = enabled;
+    applyView();
+}
+
+void PlotWidget::setValueRange(double min, double max)
+{
+    m_yMin = qMin(min, max);
+    m_yMax = qMax(min, max);
+    m_autoScale = false;
+    applyView();
+}
+
+void PlotWidget::resetView()
+{
+    m_spanNs = DefaultSpanMs * MonotonicClock::NsPerMs;
+    m_follow = true;
+    m_autoScale = true;
+    applyView();
+}
+
+void PlotWidget::applyView()
+{
+    const qint64 endNs = viewEndNs();
+    emit viewChanged(endNs - m_spanNs, endNs);
+    scheduleFrame();
+}
+
+qint64 PlotWidget::viewEndNs() const
+{
+    return m_follow ? MonotonicClock::nowNs() : m_endNs;
+}
+
+QRect PlotWidget::plotRect() const
+{
+    return rect().adjusted(LeftMargin, TopMargin, -RightMargin, -BottomMargin);
+}
+
+// ============================================================================
+// CADENCE DES TRAMES
+// ============================================================================
+
+void PlotWidget::setFrameDriven(bool driven)
+{
+    if (driven == m_frameDriven) {
+        return;
+    }
+
+    // Une trame déjà due passe dans l'autre mode
+    const bool pending = m_frameTimer->isActive() || m_frameRequested;
+    m_frameTimer->stop();
+    m_frameRequested = false;
+    m_frameDriven = driven;
+    if (pending) {
+        scheduleFrame();
+    }
+}
+
+void PlotWidget::scheduleFrame()
+{
+    if (m_frameDriven) {
+        if (!m_frameRequested) {
+            m_frameRequested = true;
+            emit frameRequested();
+        }
+        return;
+    }
+
+    if (m_frameTimer->isActive()) {
+        return;
+    }
+
+    // Échéance calée sur la requête précédente: FrameIntervalMs entre deux
+    // trames, rendu compris
+    const qint64 elapsedMs = (MonotonicClock::nowNs() - m_lastRequestNs) / MonotonicClock::NsPerMs;
+    m_frameTimer->start(int(qBound<qint64>(0, FrameIntervalMs - elapsedMs, FrameIntervalMs)));
+}
+
+void PlotWidget::advanceFrame()
+{
+    if (!m_frameRequested) {
+        return;
+    }
+    m_frameRequested = false;
+    onTick();
+}
+
+void PlotWidget::onTick()
+{
+    // Onglet masqué ou trame en cours: rendu reporté (showEvent / onFrameReady)
+    if (m_inFlight || !isVisible()) {
+        m_dirty = true;
+        return;
+    }
+
+    const qreal dpr = devicePixelRatioF();
+    const QRect plot = plotRect();
+
+    PlotFrameRequest request;
+    request.size = QSize(qRound(width() * dpr), qRound(height() * dpr));
+    request.plotRect = QRect(qRound(plot.left() * dpr), qRound(plot.top() * dpr),
+                             qRound(plot.width() * dpr), qRound(plot.height() * dpr));
+    request.devicePixelRatio = dpr;
+    request.toNs = viewEndNs();
+    request.fromNs = request.toNs - m_spanNs;
+    request.autoScale = m_autoScale;
+    request.yMin = m_yMin;
+    request.yMax = m_yMax;
+    request.serial = ++m_serial;
+
+    request.traces.reserve(m_channels.size());
+    for (const Channel &channel : m_channels) {
+        request.traces.append(PlotFrameRequest::Trace{ channel.id, channel.color });
+    }
+
+    m_inFlight = true;
+    m_dirty = false;
+    m_lastRequestNs = MonotonicClock::nowNs();
+    emit requestFrame(request);
+}
+
+void PlotWidget::onFrameReady(const PlotFrame &frame)
+{
+    m_inFlight = false;
+    m_frame = frame;
+    update();
+
+    const qint64 now = MonotonicClock::nowNs();
+    if (m_framesInWindow == 0) {
+        m_fpsWindowNs = now;
+    }
+    ++m_framesInWindow;
+    if (now - m_fpsWindowNs >= NsPerSec) {
+        m_fps = (m_framesInWindow - 1) * double(NsPerSec) / double(now - m_fpsWindowNs);
+        m_framesInWindow = 0;
+    }
+
+    if (m_dirty) {
+        scheduleFrame();
+    } else if (m_follow && isVisible()) {
+        // Le bord droit avance avec l'horloge: trame suivante quand il a
+        // parcouru un pixel, même si aucun échantillon n'arrive
+        const qint64 pixelMs = m_spanNs / qMax(1, plotRect().width()) / MonotonicClock::NsPerMs;
+        m_followTimer->start(int(qBound<qint64>(FrameIntervalMs, pixelMs, FollowMaxIntervalMs)));
+    }
+}
+
+void PlotWidget::onSampleAdded(quint16 channelId, const DataModel::DataPoint &point)
+{
+    // Hors suivi, seuls les échantillons tombant dans la fenêtre comptent
+    if (!m_follow && (point.timestampNs > m_endNs || point.timestampNs < m_endNs - m_spanNs)) {
+        return;
+    }
+
+    for (const Channel &channel : m_channels) {
+        if (channel.id == channelId) {
+            scheduleFrame();
+            return;
+        }
+    }
+}
+
+void PlotWidget::onHistoryCleared()
+{
+    scheduleFrame();
+}
+
+// ============================================================================
+// AFFICHAGE
+// ============================================================================
+
+void PlotWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+
+    QPainter painter(this);
+    if (m_frame.image.isNull()) {
+        painter.fillRect(rect(), QColor(BackgroundColor));
+    } else {
+        // Image aux dimensions physiques: copie 1:1 sauf pendant un redimensionnement
+        painter.drawImage(QRectF(rect()), m_frame.image);
+    }
+
+    const QRect plot = plotRect();
+    const QFontMetrics metrics(font());
+    const int textHeight = metrics.height();
+    painter.setPen(QColor(TextColor));
+
+    // Axe des valeurs
+    const double range = m_frame.yMax - m_frame.yMin;
+    const int decimals = valueDecimals(range);
+    for (int r = 0; r <= PlotRenderer::GridRows; ++r) {
+        const double value = m_frame.yMax - range * r / PlotRenderer::GridRows;
+        const int y = plot.top() + (plot.height() - 1) * r / PlotRenderer::GridRows;
+        painter.drawText(QRect(0, y - textHeight / 2, LeftMargin - 6, textHeight),
+                         Qt::AlignRight | Qt::AlignVCenter, QString::number(value, 'f', decimals));
+    }
+
+    // Axe du temps, relatif au bord droit
+    const double spanSec = double(m_frame.toNs - m_frame.fromNs) / NsPerSec;
+    const int timeDecimals = spanSec < 6.0 ? 2 : (spanSec < 60.0 ? 1 : 0);
+    for (int c = 0; c <= PlotRenderer::GridColumns; ++c) {
+        const int x = plot.left() + (plot.width() - 1) * c / PlotRenderer::GridColumns;
+        QString label;
+        if (c == PlotRenderer::GridColumns) {
+            label = m_follow ? QString("maintenant")
+                             : MonotonicClock::toDateTime(m_frame.toNs).toString("HH:mm:ss");
+        } else {
+            const double seconds = -spanSec * (PlotRenderer::GridColumns - c) / PlotRenderer::GridColumns;
+            label = QString("%1 s").arg(seconds, 0, 'f', timeDecimals);
+        }
+        const Qt::Alignment align = c == 0 ? Qt::AlignLeft
+                                  : (c == PlotRenderer::GridColumns ? Qt::AlignRight : Qt::AlignHCenter);
+        const int labelWidth = 2 * LeftMargin;
+        const int left = c == 0 ? x : (c == PlotRenderer::GridColumns ? x - labelWidth : x - labelWidth / 2);
+        painter.drawText(QRect(left, plot.bottom() + 4, labelWidth, BottomMargin - 4), align | Qt::AlignTop, label);
+    }
+
+    // Légende et état de la vue
+    int x = plot.left();
+    const int baseline = (TopMargin + metrics.ascent()) / 2;
+    for (const Channel &channel : m_channels) {
+        painter.setPen(channel.color);
+        painter.drawText(x, baseline, channel.label);
+        x += metrics.horizontalAdvance(channel.label) + 16;
+    }
+
+    QStringList state;
+    if (!m_follow) {
+        state << "pause";
+    }
+    if (!m_autoScale) {
+        state << "échelle manuelle";
+    }
+    if (!state.isEmpty()) {
+        painter.setPen(QColor(TextColor));
+        painter.drawText(QRect(plot.left(), 0, plot.width(), TopMargin),
+                         Qt::AlignRight | Qt::AlignVCenter, state.join(" · "));
+    }
+}
+
+void PlotWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    scheduleFrame();
+}
+
+void PlotWidget::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    scheduleFrame();
+}
+
+// ============================================================================
+// INTERACTIONS
+// ============================================================================
+
+void PlotWidget::wheelEvent(QWheelEvent *event)
+{
+    const int delta = event->angleDelta().y();
+    if (delta == 0) {
+        event->ignore();
+        return;
+    }
+
+    const double factor = std::pow(WheelZoomStep, delta / 120.0);
+    const QRect plot = plotRect();
+    const QPointF pos = event->position();
+
+    if (event->modifiers() & Qt::ControlModifier) {
+        // Zoom vertical autour de la valeur sous le curseur
+        const double yMin = m_autoScale ? m_frame.yMin : m_yMin;
+        const double yMax = m_autoScale ? m_frame.yMax : m_yMax;
+        const double ratio = qBound(0.0, (plot.bottom() - pos.y()) / qMax(1, plot.height()), 1.0);
+        const double anchor = yMin + (yMax - yMin) * ratio;
+        m_yMin = anchor - (anchor - yMin) * factor;
+        m_yMax = anchor + (yMax - anchor) * factor;
+        m_autoScale = false;
+    } else {
+        // Zoom temporel: autour du curseur, ou du présent en suivi
+        const qint64 spanNs = qBound(MinSpanMs * MonotonicClock::NsPerMs,
+                                     qint64(m_spanNs * factor),
+                                     MaxSpanMs * MonotonicClock::NsPerMs);
+        if (!m_follow) {
+            const double ratio = qBound(0.0, (pos.x() - plot.left()) / qMax(1, plot.width()), 1.0);
+            const qint64 anchorNs = m_endNs - qint64(m_spanNs * (1.0 - ratio));
+            m_endNs = anchorNs + qint64(spanNs * (1.0 - ratio));
+        }
+        m_spanNs = spanNs;
+    }
+
+    event->accept();
+    applyView();
+}
+
+void PlotWidget::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+
+    m_dragging = true;
+    m_dragOrigin = event->pos();
+    m_dragEndNs = viewEndNs();
+    m_dragYMin = m_autoScale ? m_frame.yMin : m_yMin;
+    m_dragYMax = m_autoScale ? m_frame.yMax : m_yMax;
+    setCursor(Qt::ClosedHandCursor);
+}
+
+void PlotWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_dragging) {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+
+    const QRect plot = plotRect();
+    const QPoint delta = event->pos() - m_dragOrigin;
+
+    // Glisser vers la droite remonte dans le temps; le suivi reprend au présent
+    const qint64 endNs = m_dragEndNs - qint64(double(delta.x()) * m_spanNs / qMax(1, plot.width()));
+    if (endNs >= MonotonicClock::nowNs()) {
+        m_follow = true;
+    } else {
+        m_follow = false;
+        m_endNs = endNs;
+    }
+
+    if (!m_autoScale) {
+        const double shift = double(delta.y()) * (m_dragYMax - m_dragYMin) / qMax(1, plot.height());
+        m_yMin = m_dragYMin + shift;
+        m_yMax = m_dragYMax + shift;
+    }
+
+    applyView();
+}
+
+void PlotWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && m_dragging) {
+        m_dragging = false;
+        unsetCursor();
+        return;
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void PlotWidget::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton) {
+        resetView();
+        return;
+    }
+    QWidget::mouseDoubleClickEvent(event);
+}
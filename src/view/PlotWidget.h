@@ -0,0 +1,153 @@
+#ifndef PLOTWIDGET_H
+#define PLOTWIDGET_H
+
+#include <QWidget>
+#include <QColor>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "DataModel.h"
+#include "PlotRenderer.h"
+
+class QThread;
+class QTimer;
+
+/**
+ * @brief Tracé temps réel des canaux du DataModel
+ *
+ * Le thread graphique ne fait que copier la dernière trame rastérisée par
+ * PlotRenderer (thread dédié) et y ajouter le texte des axes et la
+ * légende. Une seule trame est en cours de rendu à la fois: les
+ * échantillons et les interactions arrivés entre-temps sont regroupés
+ * dans la trame suivante, cadencée à FrameIntervalMs (60 images/s au
+ * plus, moins si le rendu est plus lent, sans file d'attente). En mode
+ * cadencé (setFrameDriven), la trame part au tick de la vue hôte:
+ * frameRequested() signale une trame nécessaire, advanceFrame() l'envoie.
+ * En suivi, une trame reste armée tant que le tracé est visible (une par
+ * pixel de temps, FollowMaxIntervalMs au plus): l'axe défile même entre
+ * deux échantillons d'un canal lent.
+ *
+ * Interactions:
+ * - molette: zoom temporel (autour du curseur, ou du bord droit en suivi)
+ * - Ctrl + molette: zoom vertical (passe en échelle manuelle)
+ * - glisser: déplacement dans le temps et, en échelle manuelle, en valeur;
+ *   le suivi du temps réel reprend si la fenêtre rejoint le présent
+ * - double-clic: retour au suivi, à la durée par défaut et à l'échelle
+ *   automatique
+ */
+class PlotWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static const int FrameIntervalMs = 16;
+    static const int FollowMaxIntervalMs = 1000;
+    static const qint64 DefaultSpanMs = 30000;
+    static const qint64 MinSpanMs = 100;
+    static const qint64 MaxSpanMs = 24LL * 3600 * 1000;
+
+    explicit PlotWidget(DataModel *model, QWidget *parent = nullptr);
+    ~PlotWidget();
+
+    // === CANAUX ===
+    void addChannel(quint16 channelId, const QColor &color);
+    void removeChannel(quint16 channelId);
+    void clearChannels();
+    QList<quint16> channels() const;
+
+    // === VUE ===
+    void setTimeSpanMs(qint64 spanMs);
+    qint64 timeSpanMs() const { return m_spanNs / MonotonicClock::NsPerMs; }
+
+    void setFollowLatest(bool follow);
+    bool followLatest() const { return m_follow; }
+
+    void setAutoScale(bool enabled);
+    bool autoScale() const { return m_autoScale; }
+    void setValueRange(double min, double max);  // Désactive l'échelle automatique
+
+    // === MESURES ===
+    double framesPerSecond() const { return m_fps; }
+    double lastRenderMs() const { return m_frame.renderNs / double(MonotonicClock::NsPerMs); }
+
+    // === CADENCE ===
+    // true: trames fournies par l'appelant (frameRequested → advanceFrame())
+    void setFrameDriven(bool driven);
+    bool isFrameDriven() const { return m_frameDriven; }
+
+public slots:
+    void resetView();
+    void scheduleFrame();
+    void advanceFrame();  // Tick de la vue hôte (mode cadencé)
+
+signals:
+    void viewChanged(qint64 fromNs, qint64 toNs);
+
+    // Mode cadencé: une trame est nécessaire au prochain advanceFrame()
+    void frameRequested();
+
+    // Signal interne pour le renderer (queued connection)
+    void requestFrame(const PlotFrameRequest &request);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private slots:
+    void onTick();
+    void onFrameReady(const PlotFrame &frame);
+    void onSampleAdded(quint16 channelId, const DataModel::DataPoint &point);
+    void onHistoryCleared();
+
+private:
+    struct Channel {
+        quint16 id;
+        QColor color;
+        QString label;  // "nom (unité)"
+    };
+
+    QRect plotRect() const;   // Pixels logiques
+    qint64 viewEndNs() const;
+    void applyView();
+
+    DataModel *m_model;
+    PlotRenderer *m_renderer;
+    QThread *m_renderThread;
+    QTimer *m_frameTimer;
+    QTimer *m_followTimer;    // Suivi: prochaine trame sans nouvel échantillon
+
+    QVector<Channel> m_channels;
+    PlotFrame m_frame;        // Dernière trame reçue
+    quint64 m_serial;
+    bool m_inFlight;          // Une trame en cours de rendu
+    bool m_dirty;             // Nouvelle trame nécessaire à la réception
+    qint64 m_lastRequestNs;
+    bool m_frameDriven;
+    bool m_frameRequested;    // Mode cadencé: frameRequested() émis, trame due
+
+    qint64 m_spanNs;
+    qint64 m_endNs;           // Bord droit hors suivi
+    bool m_follow;
+    bool m_autoScale;
+    double m_yMin;            // Échelle manuelle
+    double m_yMax;
+
+    bool m_dragging;
+    QPoint m_dragOrigin;
+    qint64 m_dragEndNs;
+    double m_dragYMin;
+    double m_dragYMax;
+
+    int m_framesInWindow;     // Cadence mesurée sur une seconde
+    qint64 m_fpsWindowNs;
+    double m_fps;
+};
+
+#endif // PLOTWIDGET_H
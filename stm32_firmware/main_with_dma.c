@@ -30,6 +30,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include "protocol_commands.h"
 
 // ============================================================================
 // CONFIGURATION GLOBALE
@@ -45,17 +46,27 @@ DMA_HandleTypeDef hdma_adc1;
 
 // Buffers UART avec DMA
 #define UART_RX_BUFFER_SIZE 512
-#define UART_TX_BUFFER_SIZE 512
 uint8_t uart_rx_buffer[UART_RX_BUFFER_SIZE];
-uint8_t uart_tx_buffer[UART_TX_BUFFER_SIZE];
 volatile uint16_t rx_write_pos = 0;
 volatile uint16_t rx_read_pos = 0;
 
+// File circulaire TX: sendResponse() ajoute en tx_head, le DMA envoie le
+// segment contigu à partir de tx_tail, HAL_UART_TxCpltCallback l'avance et
+// relance le suivant. Un message n'est jamais écrit sur un envoi en cours.
+#define UART_TX_BUFFER_SIZE 1024
+#define UART_TX_WAIT_MS 100          // Attente max d'une place (réponses)
+uint8_t uart_tx_buffer[UART_TX_BUFFER_SIZE];
+static volatile uint16_t tx_head = 0;
+static volatile uint16_t tx_tail = 0;
+static volatile uint16_t tx_dma_len = 0;   // 0 = aucun transfert en cours
+static volatile uint32_t tx_dropped = 0;   // Messages perdus (file pleine)
+
 // Buffer circulaire pour commandes
-#define CMD_BUFFER_SIZE 256
+#define CMD_BUFFER_SIZE 512
 char cmd_buffer[CMD_BUFFER_SIZE];
 volatile uint16_t cmd_index = 0;
 volatile uint8_t cmd_ready = 0;
+volatile uint64_t cmd_rx_us = 0;  // Instant de réception de la commande (SYNC)
 
 // Buffer ADC avec DMA
 #define ADC_BUFFER_SIZE 16
@@ -85,6 +96,42 @@ volatile DeviceState_t device_state = {
     .error_code = 0
 };
 
+// Canaux de télémétrie annoncés à l'hôte (commande CAPS)
+// type: f64, f32, i32, u16, u8 - valeur physique = brut * scale
+typedef struct {
+    uint16_t id;
+    const char *name;
+    const char *unit;
+    const char *type;
+    float scale;
+} ChannelDesc_t;
+
+static const ChannelDesc_t channel_table[] = {
+    {0, "temp",    "°C",  "f32", 1.0f},
+    {1, "voltage", "V",   "f32", 1.0f},
+    {2, "pwm",     "%",   "u8",  1.0f},
+    {3, "adc_raw", "LSB", "u16", 1.0f},
+};
+#define CHANNEL_COUNT (sizeof(channel_table) / sizeof(channel_table[0]))
+
+// Lots de commandes (BATCH): les réponses sont accumulées dans batch_buffer
+// puis envoyées en une seule trame {"batch":[r0,r1,...]}
+#define BATCH_MAX_COMMANDS 8
+#define BATCH_BUFFER_SIZE 440
+static char batch_buffer[BATCH_BUFFER_SIZE];
+static uint16_t batch_len = 0;
+static uint8_t batch_active = 0;
+static uint8_t batch_results = 0;
+static uint8_t batch_executed = 0;
+static uint8_t batch_truncated = 0;
+
+// Flux de télémétrie (STREAM): canaux poussés à période fixe, numérotés
+#define STREAM_MIN_PERIOD_MS 10
+#define STREAM_FRAME_MAX 300         // Trame stream complète, enveloppe comprise
+static uint32_t stream_mask = 0;     // Bit i = channel_table[i]
+static uint32_t stream_period = 0;   // ms, 0 = flux arrêté
+static uint32_t stream_seq = 0;
+
 // Configuration
 volatile uint32_t heartbeat_interval = 5000;  // ms
 volatile uint8_t json_mode = 1;  // 1=JSON, 0=text
@@ -101,6 +148,10 @@ void DMA_Init(void);
 
 void processCommand(char *cmd);
 void sendResponse(const char *msg);
+static uint8_t uartTxEnqueue(const char *msg, uint16_t len);
+static uint16_t uartTxFree(void);
+static void uartTxKick(void);
+static void uartTxResume(void);
 void sendJsonResponse(const char *type, const char *data);
 void sendJsonError(const char *message);
 void setPWM(uint8_t duty_cycle);
@@ -111,6 +162,11 @@ void sendJsonTemperature(float temp);
 void sendJsonVoltage(float volt, uint16_t adc);
 void sendJsonStatus(void);
 void sendJsonHeartbeat(void);
+void sendJsonCapabilities(void);
+void sendJsonSync(uint32_t seq, uint64_t rx_us);
+void processBatch(const char *json);
+void configureStream(const char *params);
+void sendJsonStream(void);
 
 // DMA callbacks
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
@@ -119,7 +175,11 @@ void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc);
 
 // Utilitaires
 static void trim(char *s);
+static uint64_t micros(void);
+static char *formatU64(uint64_t value, char *buf);
 static uint8_t parseJson(const char *json, char *cmd, char *params);
+static void batchAppend(const char *result);
+static void batchFinish(void);
 
 // ============================================================================
 // MAIN
@@ -142,8 +202,7 @@ int main(void) {
     }
     
     // Message de démarrage (JSON)
-    sendResponse("{\\"type\\":\\"startup\\",\\"version\\":\\"1.0.0\\",\\"features\\":[\\"DMA\\",\\"JSON\\",\\"ADC\\",\\"PWM\\"]}\
-");
+    sendResponse("{\"type\":\"startup\",\"version\":\"1.0.0\",\"features\":[\"DMA\",\"JSON\",\"ADC\",\"PWM\"]}\n");
     
     // Démarre la réception UART en DMA mode
     HAL_UART_Receive_DMA(&huart2, uart_rx_buffer, UART_RX_BUFFER_SIZE);
@@ -154,6 +213,7 @@ int main(void) {
     uint32_t last_heartbeat = HAL_GetTick();
     uint32_t last_temp_update = HAL_GetTick();
     uint32_t last_adc_update = HAL_GetTick();
+    uint32_t last_stream = HAL_GetTick();
     
     while (1) {
         // Traitement des commandes reçues
@@ -180,6 +240,22 @@ int main(void) {
             last_heartbeat = HAL_GetTick();
         }
         
+        // Flux de télémétrie: échéances sur une grille fixe, recalée après
+        // un retard d'une période entière (commande longue, RESET...).
+        // File TX sans place pour une trame: la période est sautée (trou de
+        // seq côté hôte) plutôt que d'attendre ou d'écraser un envoi
+        if (stream_period > 0 && HAL_GetTick() - last_stream >= stream_period) {
+            last_stream += stream_period;
+            if (HAL_GetTick() - last_stream >= stream_period) {
+                last_stream = HAL_GetTick();
+            }
+            if (uartTxFree() >= STREAM_FRAME_MAX) {
+                sendJsonStream();
+            } else {
+                stream_seq++;
+            }
+        }
+        
         // Mise à jour ADC
         if (HAL_GetTick() - last_adc_update > 100) {
             updateADCAverage();
@@ -198,6 +274,9 @@ int main(void) {
         // Mise à jour uptime
         device_state.uptime = HAL_GetTick() / 1000;
         
+        // Envoi refusé par un UART occupé: reprise
+        uartTxResume();
+        
         HAL_Delay(10);
     }
 }
@@ -213,100 +292,142 @@ void processCommand(char *cmd) {
     char json_params[128] = {0};
     
     if (cmd[0] == '{' && parseJson(cmd, json_cmd, json_params)) {
-        // Mode JSON
-        if (strcmp(json_cmd, "GET_TEMP") == 0) {
-            sendJsonTemperature(device_state.temperature);
-        }
-        else if (strcmp(json_cmd, "GET_VOLTAGE") == 0) {
-            sendJsonVoltage(device_state.voltage, device_state.adc_raw);
-        }
-        else if (strcmp(json_cmd, "STATUS") == 0) {
-            sendJsonStatus();
-        }
-        else if (strcmp(json_cmd, "SET_LED") == 0) {
-            // Parse {"state":1}
-            if (strstr(json_params, "\\"state\\":1") != NULL) {
-                HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_RESET);
-                device_state.led_state = 1;
-                sendJsonResponse("response", "{\\"led\\":1}");
-            } else {
-                HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_SET);
-                device_state.led_state = 0;
-                sendJsonResponse("response", "{\\"led\\":0}");
+        // Mode JSON: une recherche dans la table générée (protocol_commands.h)
+        switch (lookupCommand(json_cmd, strlen(json_cmd), CMD_MODE_JSON)) {
+            case CMD_GET_TEMP:
+                sendJsonTemperature(device_state.temperature);
+                break;
+            
+            case CMD_GET_VOLTAGE:
+                sendJsonVoltage(device_state.voltage, device_state.adc_raw);
+                break;
+            
+            case CMD_STATUS:
+                sendJsonStatus();
+                break;
+            
+            case CMD_CAPS:
+                sendJsonCapabilities();
+                break;
+            
+            case CMD_SYNC: {
+                // Parse {"seq":42} - renvoyé tel quel avec t1/t2
+                char *seq_ptr = strstr(json_params, "\"seq\":");
+                uint32_t seq = seq_ptr ? (uint32_t)strtoul(seq_ptr + 6, NULL, 10) : 0;
+                sendJsonSync(seq, cmd_rx_us);
+                break;
             }
-        }
-        else if (strcmp(json_cmd, "SET_PWM") == 0) {
-            // Parse {"duty":50}
-            char *duty_ptr = strstr(json_params, "\\"duty\\":");
-            if (duty_ptr) {
-                int duty = atoi(duty_ptr + 7);
-                if (duty >= 0 && duty <= 100) {
-                    setPWM((uint8_t)duty);
-                    device_state.pwm_duty = duty;
-                    snprintf(response, sizeof(response), "{\\"pwm\\":%d}", duty);
-                    sendJsonResponse("response", response);
+            
+            case CMD_SET_LED:
+                // Parse {"state":1}
+                if (strstr(json_params, "\"state\":1") != NULL) {
+                    HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_RESET);
+                    device_state.led_state = 1;
+                    sendJsonResponse("response", "{\"led\":1}");
+                } else {
+                    HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_SET);
+                    device_state.led_state = 0;
+                    sendJsonResponse("response", "{\"led\":0}");
+                }
+                break;
+            
+            case CMD_SET_PWM: {
+                // Parse {"duty":50}
+                char *duty_ptr = strstr(json_params, "\"duty\":");
+                if (duty_ptr) {
+                    int duty = atoi(duty_ptr + 7);
+                    if (duty >= 0 && duty <= 100) {
+                        setPWM((uint8_t)duty);
+                        device_state.pwm_duty = duty;
+                        snprintf(response, sizeof(response), "{\"pwm\":%d}", duty);
+                        sendJsonResponse("response", response);
+                    }
                 }
+                break;
             }
-        }
-        else if (strcmp(json_cmd, "RESET") == 0) {
-            sendJsonResponse("response", "{\\"status\\":\\"resetting\\"}");
-            HAL_Delay(100);
-            NVIC_SystemReset();
-        }
-        else {
-            sendJsonError("Unknown command");
+            
+            case CMD_STREAM:
+                configureStream(json_params);
+                break;
+            
+            case CMD_BATCH:
+                processBatch(cmd);
+                break;
+            
+            case CMD_RESET:
+                sendJsonResponse("response", "{\"status\":\"resetting\"}");
+                batchFinish();  // Réponse du lot émise avant le redémarrage
+                HAL_Delay(100);
+                NVIC_SystemReset();
+                break;
+            
+            default:
+                sendJsonError("Unknown command");
+                break;
         }
     }
     else {
-        // Mode texte (compatibilité)
-        if (strcmp(cmd, "GET_TEMP") == 0) {
-            snprintf(response, sizeof(response), "TEMP: %.1f°C\
-", device_state.temperature);
-            sendResponse(response);
-        }
-        else if (strcmp(cmd, "GET_VOLTAGE") == 0) {
-            snprintf(response, sizeof(response), 
-                    "VOLTAGE: %.2fV (ADC: %u)\
-", 
-                    device_state.voltage, device_state.adc_raw);
-            sendResponse(response);
-        }
-        else if (strcmp(cmd, "STATUS") == 0) {
-            sendJsonStatus();
-        }
-        else if (strncmp(cmd, "SET_LED=", 8) == 0) {
-            int val = atoi(cmd + 8);
-            if (val == 1) {
-                HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_RESET);
-                device_state.led_state = 1;
-                sendResponse("OK: LED ON\
-");
-            } else {
-                HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_SET);
-                device_state.led_state = 0;
-                sendResponse("OK: LED OFF\
-");
-            }
+        // Mode texte (compatibilité): "NOM" ou "NOM=valeur"
+        const size_t name_length = strcspn(cmd, "=");
+        const uint8_t has_value = (cmd[name_length] == '=');
+        CommandId id = lookupCommand(cmd, name_length, CMD_MODE_TEXT);
+        
+        // SET_LED et SET_PWM exigent une valeur, les autres n'en ont pas
+        if ((id == CMD_SET_LED || id == CMD_SET_PWM) != has_value) {
+            id = CMD_UNKNOWN;
         }
-        else if (strncmp(cmd, "SET_PWM=", 8) == 0) {
-            int val = atoi(cmd + 8);
-            if (val >= 0 && val <= 100) {
-                setPWM((uint8_t)val);
-                device_state.pwm_duty = val;
-                snprintf(response, sizeof(response), "OK: PWM=%d%%\
-", val);
+        
+        switch (id) {
+            case CMD_GET_TEMP:
+                snprintf(response, sizeof(response), "TEMP: %.1f°C\n", device_state.temperature);
                 sendResponse(response);
+                break;
+            
+            case CMD_GET_VOLTAGE:
+                snprintf(response, sizeof(response), 
+                        "VOLTAGE: %.2fV (ADC: %u)\n", 
+                        device_state.voltage, device_state.adc_raw);
+                sendResponse(response);
+                break;
+            
+            case CMD_STATUS:
+                sendJsonStatus();
+                break;
+            
+            case CMD_SET_LED: {
+                int val = atoi(cmd + 8);
+                if (val == 1) {
+                    HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_RESET);
+                    device_state.led_state = 1;
+                    sendResponse("OK: LED ON\n");
+                } else {
+                    HAL_GPIO_WritePin(GPIOC, GPIO_PIN_13, GPIO_PIN_SET);
+                    device_state.led_state = 0;
+                    sendResponse("OK: LED OFF\n");
+                }
+                break;
             }
-        }
-        else if (strcmp(cmd, "RESET") == 0) {
-            sendResponse("OK: Resetting...\
-");
-            HAL_Delay(100);
-            NVIC_SystemReset();
-        }
-        else {
-            sendResponse("ERROR: Unknown command\
-");
+            
+            case CMD_SET_PWM: {
+                int val = atoi(cmd + 8);
+                if (val >= 0 && val <= 100) {
+                    setPWM((uint8_t)val);
+                    device_state.pwm_duty = val;
+                    snprintf(response, sizeof(response), "OK: PWM=%d%%\n", val);
+                    sendResponse(response);
+                }
+                break;
+            }
+            
+            case CMD_RESET:
+                sendResponse("OK: Resetting...\n");
+                HAL_Delay(100);
+                NVIC_SystemReset();
+                break;
+            
+            default:
+                sendResponse("ERROR: Unknown command\n");
+                break;
         }
     }
 }
@@ -315,73 +436,409 @@ void processCommand(char *cmd) {
 // FONCTIONS JSON
 // ============================================================================
 void sendJsonResponse(const char *type, const char *data) {
+    if (batch_active) {
+        batchAppend(data);
+        return;
+    }
+    
     char buffer[512];
     snprintf(buffer, sizeof(buffer), 
-            "{\\"type\\":\\"%s\\",\\"data\\":%s}\
-", 
+            "{\"type\":\"%s\",\"data\":%s}\n", 
             type, data);
     sendResponse(buffer);
 }
 
 void sendJsonError(const char *message) {
     char buffer[256];
+    if (batch_active) {
+        snprintf(buffer, sizeof(buffer), "{\"error\":\"%s\"}", message);
+        batchAppend(buffer);
+        return;
+    }
+    
     snprintf(buffer, sizeof(buffer), 
-            "{\\"type\\":\\"error\\",\\"message\\":\\"%s\\"}\
-", 
+            "{\"type\":\"error\",\"message\":\"%s\"}\n", 
             message);
     sendResponse(buffer);
 }
 
 void sendJsonTemperature(float temp) {
     char buffer[128];
-    snprintf(buffer, sizeof(buffer), "{\\"temp\\":%.1f}", temp);
+    snprintf(buffer, sizeof(buffer), "{\"temp\":%.1f}", temp);
     sendJsonResponse("response", buffer);
 }
 
 void sendJsonVoltage(float volt, uint16_t adc) {
     char buffer[128];
     snprintf(buffer, sizeof(buffer), 
-            "{\\"voltage\\":%.2f,\\"adc_raw\\":%u}", 
+            "{\"voltage\":%.2f,\"adc_raw\":%u}", 
             volt, adc);
     sendJsonResponse("response", buffer);
 }
 
 void sendJsonStatus(void) {
     char buffer[512];
+    char t_us[21];
     snprintf(buffer, sizeof(buffer),
-            "{\\"temp\\":%.1f,\\"voltage\\":%.2f,\\"adc\\":%u,"
-            "\\"pwm\\":%u,\\"led\\":%u,\\"uptime\\":%lu,\\"rx_chars\\":%lu}",
+            "{\"temp\":%.1f,\"voltage\":%.2f,\"adc\":%u,"
+            "\"pwm\":%u,\"led\":%u,\"uptime\":%lu,\"rx_chars\":%lu,\"tx_dropped\":%lu,\"t_us\":%s}",
             device_state.temperature,
             device_state.voltage,
             device_state.adc_raw,
             device_state.pwm_duty,
             device_state.led_state,
             device_state.uptime,
-            device_state.rx_char_count);
+            device_state.rx_char_count,
+            (unsigned long)tx_dropped,
+            formatU64(micros(), t_us));
     sendJsonResponse("response", buffer);
 }
 
 void sendJsonHeartbeat(void) {
     char buffer[256];
+    char t_us[21];
     snprintf(buffer, sizeof(buffer),
-            "{\\"rx_chars\\":%lu,\\"temp\\":%.1f,\\"pwm\\":%u}",
+            "{\"rx_chars\":%lu,\"temp\":%.1f,\"pwm\":%u,\"t_us\":%s}",
             device_state.rx_char_count,
             device_state.temperature,
-            device_state.pwm_duty);
+            device_state.pwm_duty,
+            formatU64(micros(), t_us));
     sendJsonResponse("heartbeat", buffer);
 }
 
+void sendJsonCapabilities(void) {
+    char buffer[400];
+    int pos = snprintf(buffer, sizeof(buffer), "{\"channels\":[");
+    
+    for (uint16_t i = 0; i < CHANNEL_COUNT && pos < (int)sizeof(buffer); i++) {
+        pos += snprintf(buffer + pos, sizeof(buffer) - pos,
+                "%s{\"id\":%u,\"name\":\"%s\",\"unit\":\"%s\",\"type\":\"%s\",\"scale\":%g}",
+                (i > 0) ? "," : "",
+                channel_table[i].id,
+                channel_table[i].name,
+                channel_table[i].unit,
+                channel_table[i].type,
+                channel_table[i].scale);
+    }
+    
+    if (pos < (int)sizeof(buffer) - 64) {
+        snprintf(buffer + pos, sizeof(buffer) - pos, "],\"batch\":{\"max\":%u,\"bytes\":%u,\"results\":%u}}",
+                BATCH_MAX_COMMANDS, CMD_BUFFER_SIZE - 1, BATCH_BUFFER_SIZE - 2);
+        sendJsonResponse("response", buffer);
+    } else {
+        sendJsonError("Capabilities overflow");
+    }
+}
+
+void sendJsonSync(uint32_t seq, uint64_t rx_us) {
+    // Réponse d'un échange de synchronisation (type NTP): t1 = réception de
+    // la commande, t2 = émission de la réponse, en µs depuis le démarrage
+    char buffer[128];
+    char t1[21];
+    char t2[21];
+    formatU64(rx_us, t1);
+    formatU64(micros(), t2);
+    snprintf(buffer, sizeof(buffer),
+            "{\"sync\":{\"seq\":%lu,\"t1\":%s,\"t2\":%s}}",
+            (unsigned long)seq, t1, t2);
+    sendJsonResponse("response", buffer);
+}
+
+// ============================================================================
+// FLUX DE TÉLÉMÉTRIE
+// ============================================================================
+void configureStream(const char *params) {
+    // {"channels":[0,1,3],"rate":50}: identifiants de canaux (CAPS) et
+    // fréquence en Hz; "rate":0 ou aucun canal arrête le flux
+    uint32_t mask = 0;
+    uint32_t rate = 0;
+    
+    const char *channels_ptr = strstr(params, "\"channels\":[");
+    if (channels_ptr) {
+        const char *p = channels_ptr + 12;
+        while (*p != '\0' && *p != ']') {
+            if (*p >= '0' && *p <= '9') {
+                char *next;
+                unsigned long id = strtoul(p, &next, 10);
+                for (uint16_t i = 0; i < CHANNEL_COUNT; i++) {
+                    if (channel_table[i].id == id) {
+                        mask |= 1u << i;
+                    }
+                }
+                p = next;
+            } else {
+                p++;
+            }
+        }
+    }
+    
+    const char *rate_ptr = strstr(params, "\"rate\":");
+    if (rate_ptr) {
+        rate = (uint32_t)strtoul(rate_ptr + 7, NULL, 10);
+    }
+    
+    if (mask == 0 || rate == 0) {
+        stream_mask = 0;
+        stream_period = 0;
+    } else {
+        uint32_t period = 1000u / rate;
+        if (period < STREAM_MIN_PERIOD_MS) period = STREAM_MIN_PERIOD_MS;
+        stream_mask = mask;
+        stream_period = period;
+    }
+    stream_seq = 0;
+    
+    char buffer[96];
+    snprintf(buffer, sizeof(buffer), "{\"stream\":{\"period\":%lu,\"mask\":%lu}}",
+            (unsigned long)stream_period, (unsigned long)stream_mask);
+    sendJsonResponse("response", buffer);
+}
+
+void sendJsonStream(void) {
+    // {"type":"stream","data":{"seq":N,"t_us":...,"temp":25.1,"voltage":1.65}}
+    // Les clés sont les noms de canaux annoncés par CAPS
+    char buffer[256];
+    char t_us[21];
+    int pos = snprintf(buffer, sizeof(buffer), "{\"seq\":%lu,\"t_us\":%s",
+            (unsigned long)stream_seq++, formatU64(micros(), t_us));
+    
+    for (uint16_t i = 0; i < CHANNEL_COUNT && pos < (int)sizeof(buffer) - 32; i++) {
+        if (!(stream_mask & (1u << i))) {
+            continue;
+        }
+        switch (channel_table[i].id) {
+            case 0:
+                pos += snprintf(buffer + pos, sizeof(buffer) - pos, ",\"%s\":%.1f",
+                        channel_table[i].name, device_state.temperature);
+                break;
+            case 1:
+                pos += snprintf(buffer + pos, sizeof(buffer) - pos, ",\"%s\":%.3f",
+                        channel_table[i].name, device_state.voltage);
+                break;
+            case 2:
+                pos += snprintf(buffer + pos, sizeof(buffer) - pos, ",\"%s\":%u",
+                        channel_table[i].name, device_state.pwm_duty);
+                break;
+            case 3:
+                pos += snprintf(buffer + pos, sizeof(buffer) - pos, ",\"%s\":%u",
+                        channel_table[i].name, device_state.adc_raw);
+                break;
+            default:
+                break;
+        }
+    }
+    
+    snprintf(buffer + pos, sizeof(buffer) - pos, "}");
+    sendJsonResponse("stream", buffer);
+}
+
+// ============================================================================
+// LOTS DE COMMANDES
+// ============================================================================
+void processBatch(const char *json) {
+    // {"type":"cmd","command":"BATCH","params":{"cmds":[{"command":"SET_LED",
+    //  "params":{"state":1}},{"command":"GET_TEMP"}]}}
+    // Exécution dans l'ordre, sans HAL_Delay entre les commandes, puis une
+    // seule réponse {"batch":[...]}: un résultat par commande, null si la
+    // commande ne répond pas, {"error":"..."} si elle échoue.
+    // Lot tronqué (BATCH_MAX_COMMANDS ou batch_buffer plein): l'exécution
+    // s'arrête et la réponse porte "truncated":1 et "executed":N. Les N
+    // premières commandes ont été exécutées (la dernière peut avoir perdu
+    // son résultat), les suivantes sont à renvoyer.
+    const char *p = strstr(json, "\"cmds\":[");
+    if (batch_active || p == NULL) {
+        sendJsonError("Invalid batch");
+        return;
+    }
+    p += 8;
+    
+    batch_active = 1;
+    batch_len = 0;
+    batch_results = 0;
+    batch_executed = 0;
+    batch_truncated = 0;
+    
+    char entry[CMD_BUFFER_SIZE];
+    while (*p != '\0' && *p != ']') {
+        if (*p != '{') {
+            p++;
+            continue;
+        }
+        
+        // Fin de l'objet par comptage des accolades (aucune chaîne du
+        // protocole n'en contient)
+        const char *end = p;
+        int depth = 0;
+        do {
+            if (*end == '{') depth++;
+            else if (*end == '}') depth--;
+            end++;
+        } while (*end != '\0' && depth > 0);
+        
+        if (depth != 0) {
+            sendJsonError("Invalid batch");
+            break;
+        }
+        if (batch_results >= BATCH_MAX_COMMANDS) {
+            batch_truncated = 1;
+            break;
+        }
+        
+        size_t len = (size_t)(end - p);
+        memcpy(entry, p, len);
+        entry[len] = '\0';
+        
+        const uint8_t before = batch_results;
+        if (strstr(entry, "\"command\":\"") != NULL) {
+            processCommand(entry);
+        } else {
+            sendJsonError("Invalid command");
+        }
+        if (batch_results == before) {
+            batchAppend("null");
+        }
+        batch_executed++;
+        
+        if (batch_truncated) {
+            break;
+        }
+        p = end;
+    }
+    
+    batchFinish();
+}
+
+static void batchAppend(const char *result) {
+    size_t len = strlen(result);
+    if (batch_truncated || batch_len + len + 2 >= BATCH_BUFFER_SIZE) {
+        batch_truncated = 1;
+        return;
+    }
+    
+    if (batch_results > 0) {
+        batch_buffer[batch_len++] = ',';
+    }
+    memcpy(batch_buffer + batch_len, result, len);
+    batch_len += len;
+    batch_buffer[batch_len] = '\0';
+    batch_results++;
+}
+
+static void batchFinish(void) {
+    if (!batch_active) {
+        return;
+    }
+    batch_active = 0;
+    batch_buffer[batch_len] = '\0';
+    
+    char buffer[BATCH_BUFFER_SIZE + 48];
+    char tail[40] = "";
+    if (batch_truncated) {
+        snprintf(tail, sizeof(tail), ",\"truncated\":1,\"executed\":%u", batch_executed);
+    }
+    snprintf(buffer, sizeof(buffer), "{\"batch\":[%s]%s}", batch_buffer, tail);
+    sendJsonResponse("response", buffer);
+}
+
+// ============================================================================
+// HORLOGE MICROSECONDE
+// ============================================================================
+static uint64_t micros(void) {
+    // Tick HAL (ms) + position du décompteur SysTick dans la milliseconde
+    uint32_t ms;
+    uint32_t val;
+    do {
+        ms = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (ms != HAL_GetTick());
+    
+    const uint32_t load = SysTick->LOAD + 1;
+    
+    // Débordement SysTick pas encore traité (appel depuis une interruption)
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && val > load / 2) {
+        ms++;
+    }
+    
+    return (uint64_t)ms * 1000u + ((uint64_t)(load - val) * 1000u) / load;
+}
+
+static char *formatU64(uint64_t value, char *buf) {
+    // printf de newlib-nano ne gère pas %llu (buf >= 21 octets)
+    char tmp[21];
+    int len = 0;
+    do {
+        tmp[len++] = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value > 0);
+    
+    for (int i = 0; i < len; i++) {
+        buf[i] = tmp[len - 1 - i];
+    }
+    buf[len] = '\0';
+    return buf;
+}
+
 // ============================================================================
 // ENVOI UART (avec DMA)
 // ============================================================================
 void sendResponse(const char *msg) {
     uint16_t len = strlen(msg);
-    if (len > UART_TX_BUFFER_SIZE) {
-        len = UART_TX_BUFFER_SIZE;
+    if (len >= UART_TX_BUFFER_SIZE) {
+        len = UART_TX_BUFFER_SIZE - 1;
     }
     
-    memcpy((void*)uart_tx_buffer, msg, len);
-    HAL_UART_Transmit_DMA(&huart2, uart_tx_buffer, len);
+    // File pleine: on attend que le DMA la vide, puis le message est perdu
+    // (compté dans tx_dropped) plutôt que d'écraser un envoi en cours
+    const uint32_t start = HAL_GetTick();
+    while (!uartTxEnqueue(msg, len)) {
+        uartTxResume();
+        if (HAL_GetTick() - start >= UART_TX_WAIT_MS) {
+            tx_dropped++;
+            return;
+        }
+    }
+    uartTxResume();
+}
+
+static uint16_t uartTxFree(void) {
+    // Une case reste vide pour distinguer file pleine et file vide
+    return (uint16_t)((tx_tail + UART_TX_BUFFER_SIZE - tx_head - 1) % UART_TX_BUFFER_SIZE);
+}
+
+static uint8_t uartTxEnqueue(const char *msg, uint16_t len) {
+    if (uartTxFree() < len) {
+        return 0;
+    }
+    
+    // Seul le contexte principal écrit: tx_head n'est publié qu'après la copie
+    uint16_t head = tx_head;
+    const uint16_t first = (len < UART_TX_BUFFER_SIZE - head) ? len : (uint16_t)(UART_TX_BUFFER_SIZE - head);
+    memcpy(uart_tx_buffer + head, msg, first);
+    memcpy(uart_tx_buffer, msg + first, len - first);
+    tx_head = (uint16_t)((head + len) % UART_TX_BUFFER_SIZE);
+    return 1;
+}
+
+static void uartTxResume(void) {
+    // Depuis le contexte principal: masqué contre HAL_UART_TxCpltCallback
+    __disable_irq();
+    uartTxKick();
+    __enable_irq();
+}
+
+static void uartTxKick(void) {
+    // Appelé interruptions masquées ou depuis HAL_UART_TxCpltCallback
+    if (tx_dma_len != 0 || tx_head == tx_tail) {
+        return;
+    }
+    
+    // Segment contigu: le reste après le repli part au transfert suivant
+    const uint16_t tail = tx_tail;
+    const uint16_t len = (tx_head > tail) ? (uint16_t)(tx_head - tail) : (uint16_t)(UART_TX_BUFFER_SIZE - tail);
+    tx_dma_len = len;
+    if (HAL_UART_Transmit_DMA(&huart2, uart_tx_buffer + tail, len) != HAL_OK) {
+        tx_dma_len = 0;  // UART occupé: relancé par uartTxResume()
+    }
 }
 
 // ============================================================================
@@ -400,10 +857,10 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
             device_state.rx_char_count++;
             HAL_GPIO_TogglePin(GPIOC, GPIO_PIN_13);  // Feedback visuel
             
-            if (c == '\
-' || c == '\r') {
+            if (c == '\n' || c == '\r') {
                 if (cmd_index > 0) {
                     cmd_buffer[cmd_index] = '\0';
+                    cmd_rx_us = micros();
                     cmd_ready = 1;
                 }
             }
@@ -418,6 +875,15 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
     }
 }
 
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+    if (huart->Instance == USART2) {
+        // Segment envoyé: place libérée, segment suivant
+        tx_tail = (uint16_t)((tx_tail + tx_dma_len) % UART_TX_BUFFER_SIZE);
+        tx_dma_len = 0;
+        uartTxKick();
+    }
+}
+
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
     // Le DMA a rempli le buffer ADC (mode circulaire)
     updateADCAverage();
@@ -667,8 +1133,7 @@ static void trim(char *s) {
     
     size_t len = strlen(s);
     while (len > 0 && (s[len-1] == ' ' || s[len-1] == '\t' || 
-                       s[len-1] == '\r' || s[len-1] == '\
-')) {
+                       s[len-1] == '\r' || s[len-1] == '\n')) {
         s[len-1] = '\0';
         len--;
     }
@@ -676,7 +1141,7 @@ static void trim(char *s) {
 
 static uint8_t parseJson(const char *json, char *cmd, char *params) {
     // Parse simple: {"type":"cmd","command":"XXX","params":{...}}
-    const char *cmd_ptr = strstr(json, "\\"command\\":\\"");
+    const char *cmd_ptr = strstr(json, "\"command\":\"");
     if (!cmd_ptr) return 0;
     
     cmd_ptr += 11;  // Saute le préfixe
@@ -689,7 +1154,7 @@ static uint8_t parseJson(const char *json, char *cmd, char *params) {
     cmd[len] = '\0';
     
     // Parse params
-    const char *params_ptr = strstr(json, "\\"params\\":");
+    const char *params_ptr = strstr(json, "\"params\":");
     if (params_ptr) {
         params_ptr += 9;
         const char *params_end = strchr(params_ptr, '}');
@@ -0,0 +1,72 @@
+/**
+ * Table des commandes du protocole - FICHIER GÉNÉRÉ, NE PAS MODIFIER
+ *
+ * Source: src/communication/ProtocolCommands.def
+ * Générateur: tools/gen_protocol_tables.py
+ */
+
+#ifndef PROTOCOL_COMMANDS_H
+#define PROTOCOL_COMMANDS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define CMD_MODE_JSON 0x01u
+#define CMD_MODE_TEXT 0x02u
+
+typedef enum {
+    CMD_GET_TEMP,
+    CMD_GET_VOLTAGE,
+    CMD_STATUS,
+    CMD_CAPS,
+    CMD_SYNC,
+    CMD_SET_LED,
+    CMD_SET_PWM,
+    CMD_STREAM,
+    CMD_BATCH,
+    CMD_RESET,
+    CMD_UNKNOWN
+} CommandId;
+
+#define COMMAND_HASH_SEED  0x00000001u
+#define COMMAND_TABLE_MASK 31u
+
+typedef struct {
+    const char *name;
+    uint8_t length;
+    uint8_t modes;
+    uint8_t id;
+} CommandEntry;
+
+static const CommandEntry command_table[COMMAND_TABLE_MASK + 1] = {
+    [3] = { "RESET", 5, CMD_MODE_JSON | CMD_MODE_TEXT, CMD_RESET },
+    [5] = { "CAPS", 4, CMD_MODE_JSON, CMD_CAPS },
+    [7] = { "SYNC", 4, CMD_MODE_JSON, CMD_SYNC },
+    [11] = { "SET_PWM", 7, CMD_MODE_JSON | CMD_MODE_TEXT, CMD_SET_PWM },
+    [12] = { "BATCH", 5, CMD_MODE_JSON, CMD_BATCH },
+    [14] = { "STATUS", 6, CMD_MODE_JSON | CMD_MODE_TEXT, CMD_STATUS },
+    [28] = { "STREAM", 6, CMD_MODE_JSON, CMD_STREAM },
+    [29] = { "GET_VOLTAGE", 11, CMD_MODE_JSON | CMD_MODE_TEXT, CMD_GET_VOLTAGE },
+    [30] = { "SET_LED", 7, CMD_MODE_JSON | CMD_MODE_TEXT, CMD_SET_LED },
+    [31] = { "GET_TEMP", 8, CMD_MODE_JSON | CMD_MODE_TEXT, CMD_GET_TEMP },
+};
+
+// Un hachage FNV-1a et une comparaison; CMD_UNKNOWN si absente ou
+// non disponible dans ce mode
+static inline CommandId lookupCommand(const char *name, size_t length, uint8_t mode) {
+    uint32_t hash = 2166136261u ^ COMMAND_HASH_SEED;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)name[i];
+        hash *= 16777619u;
+    }
+
+    const CommandEntry *entry = &command_table[hash & COMMAND_TABLE_MASK];
+    if (entry->name == NULL || entry->length != length || (entry->modes & mode) == 0
+        || memcmp(entry->name, name, length) != 0) {
+        return CMD_UNKNOWN;
+    }
+    return (CommandId)entry->id;
+}
+
+#endif // PROTOCOL_COMMANDS_H
@@ -0,0 +1,247 @@
+#include <QtTest>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include "TextProtocol.h"
+
+namespace {
+
+// Lignes valides servant de base au fuzz (mode texte du firmware)
+const char *const SeedLines[] = {
+    "TEMP: 25.3\xC2\xB0" "C",
+    "TEMP: -4.5\xB0" "C\r",
+    "VOLTAGE: 1.65V (ADC: 2048)",
+    "VOLTAGE: 3.30V",
+    "OK: LED ON",
+    "OK: LED OFF",
+    "OK: PWM=50%",
+    "OK: RESET",
+    "ERROR: Unknown command",
+    "LED: ON",
+    "PWM: 100%",
+    "UPTIME: 4294967295s",
+    "=== STATUS ===",
+};
+
+// Octets ajoutés par les mutations: séparateurs et débuts de nombres
+const char MutationBytes[] = " \t\r:%=()-.0123456789VCONFLEDPWM\xC2\xB0\xFF";
+
+const quint32 FuzzSeed = 0x5354334Du;
+const int FuzzIterations = 200000;
+const int MaxLineSize = 96;
+
+// Copie exacte dans un tas de la taille de la ligne: sans octet nul ni
+// capacité en réserve (contrairement à QByteArray), AddressSanitizer signale
+// toute lecture au-delà de la fin. text reçoit une copie du texte OK/ERROR.
+TextProtocol::Message parseExact(const std::string &line, QByteArray *text = nullptr)
+{
+    std::unique_ptr<char[]> buffer(new char[line.empty() ? 1 : line.size()]);
+    std::memcpy(buffer.get(), line.data(), line.size());
+    const TextProtocol::Message message = TextProtocol::parse(buffer.get(), int(line.size()));
+
+    // Invariants vérifiés pendant que le tampon est encore valide
+    if (message.kind == TextProtocol::Message::Ok || message.kind == TextProtocol::Message::Error) {
+        if (message.text < buffer.get() || message.textSize < 0
+                || message.text + message.textSize > buffer.get() + line.size()) {
+            qFatal("text view outside the line: \"%s\"", line.c_str());
+        }
+    } else if (message.text || message.textSize != 0) {
+        qFatal("unexpected text view: \"%s\"", line.c_str());
+    }
+    if (message.kind == TextProtocol::Message::Pwm && message.pwmDuty > 100) {
+        qFatal("PWM out of range: \"%s\"", line.c_str());
+    }
+    if (text) {
+        *text = QByteArray(message.text, message.textSize);
+    }
+    return message;
+}
+
+std::string mutate(std::string line, std::mt19937 &random)
+{
+    const int mutations = 1 + int(random() % 4);
+    for (int i = 0; i < mutations; ++i) {
+        const std::size_t at = line.empty() ? 0 : random() % (line.size() + 1);
+        switch (random() % 5) {
+            case 0:  // Troncature
+                line.resize(at);
+                break;
+            case 1:  // Octet remplacé
+                if (at < line.size()) {
+                    line[at] = char(random());
+                }
+                break;
+            case 2:  // Octet inséré
+                line.insert(at, 1, MutationBytes[random() % (sizeof(MutationBytes) - 1)]);
+                break;
+            case 3:  // Octet supprimé
+                if (at < line.size()) {
+                    line.erase(at, 1);
+                }
+                break;
+            default:  // Fragment répété
+                line.insert(at, line.substr(at, random() % 8));
+                break;
+        }
+    }
+    if (line.size() > std::size_t(MaxLineSize)) {
+        line.resize(MaxLineSize);
+    }
+    return line;
+}
+
+} // namespace
+
+/**
+ * @brief Décodage des réponses texte: cas nominaux, régressions et fuzz
+ *
+ * Compilé avec AddressSanitizer et UBSan (TESTS_WITH_SANITIZERS): le fuzz
+ * vérifie qu'aucune entrée ne lit hors de la ligne reçue.
+ */
+class TestTextProtocol : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void temperature();
+    void voltage();
+    void voltageWithoutValue();
+    void pwmAcknowledgement();
+    void truncatedPwmAcknowledgement();
+    void statusBlock();
+    void errorText();
+    void truncatedSeeds();
+    void fuzz();
+};
+
+void TestTextProtocol::temperature()
+{
+    TextProtocol::Message message = parseExact("TEMP: 25.3\xC2\xB0" "C");
+    QCOMPARE(message.kind, TextProtocol::Message::Temperature);
+    QCOMPARE(message.value, 25.3f);
+
+    message = parseExact("TEMP: 25.3\xB0" "C\r");
+    QCOMPARE(message.kind, TextProtocol::Message::Temperature);
+
+    QCOMPARE(parseExact("TEMP: 25.3 degrees").kind, TextProtocol::Message::Unknown);
+}
+
+void TestTextProtocol::voltage()
+{
+    TextProtocol::Message message = parseExact("VOLTAGE: 1.65V (ADC: 2048)");
+    QCOMPARE(message.kind, TextProtocol::Message::Voltage);
+    QCOMPARE(message.value, 1.65f);
+    QVERIFY(message.hasAdcRaw);
+    QCOMPARE(message.adcRaw, quint16(2048));
+
+    message = parseExact("VOLTAGE: 1.65V");
+    QCOMPARE(message.kind, TextProtocol::Message::Voltage);
+    QVERIFY(!message.hasAdcRaw);
+
+    QCOMPARE(parseExact("VOLTAGE: 1.65V (ADC: 70000)").kind, TextProtocol::Message::Unknown);
+    QCOMPARE(parseExact("VOLTAGE: 1.65V (ADC: 2048").kind, TextProtocol::Message::Unknown);
+}
+
+void TestTextProtocol::voltageWithoutValue()
+{
+    QCOMPARE(parseExact("VOLTAGE:").kind, TextProtocol::Message::Unknown);
+    QCOMPARE(parseExact("VOLTAGE: ").kind, TextProtocol::Message::Unknown);
+    QCOMPARE(parseExact("VOLTAGE: V").kind, TextProtocol::Message::Unknown);
+    QCOMPARE(parseExact("VOLTAGE: -").kind, TextProtocol::Message::Unknown);
+}
+
+void TestTextProtocol::pwmAcknowledgement()
+{
+    TextProtocol::Message message = parseExact("OK: PWM=50%");
+    QCOMPARE(message.kind, TextProtocol::Message::Pwm);
+    QCOMPARE(message.pwmDuty, quint8(50));
+    QVERIFY(message.acknowledgement);
+
+    message = parseExact("OK: LED OFF");
+    QCOMPARE(message.kind, TextProtocol::Message::Led);
+    QVERIFY(!message.ledState);
+    QVERIFY(message.acknowledgement);
+}
+
+void TestTextProtocol::truncatedPwmAcknowledgement()
+{
+    // Valeur absente ou hors plage: acquittement générique, pas de PWM
+    QByteArray text;
+    QCOMPARE(parseExact("OK: PWM=", &text).kind, TextProtocol::Message::Ok);
+    QCOMPARE(text, QByteArray("PWM="));
+    QCOMPARE(parseExact("OK: PWM=%", &text).kind, TextProtocol::Message::Ok);
+    QCOMPARE(parseExact("OK: PWM=101%", &text).kind, TextProtocol::Message::Ok);
+    QCOMPARE(text, QByteArray("PWM=101%"));
+    QCOMPARE(parseExact("OK: PWM=5x", &text).kind, TextProtocol::Message::Ok);
+}
+
+void TestTextProtocol::statusBlock()
+{
+    // Bloc renvoyé par STATUS en mode texte, une ligne par champ
+    TextProtocol::Message message = parseExact("LED: ON");
+    QCOMPARE(message.kind, TextProtocol::Message::Led);
+    QVERIFY(message.ledState);
+    QVERIFY(!message.acknowledgement);
+
+    message = parseExact("PWM: 75%");
+    QCOMPARE(message.kind, TextProtocol::Message::Pwm);
+    QCOMPARE(message.pwmDuty, quint8(75));
+    QVERIFY(!message.acknowledgement);
+
+    message = parseExact("UPTIME: 1234s");
+    QCOMPARE(message.kind, TextProtocol::Message::Uptime);
+    QCOMPARE(message.uptime, quint32(1234));
+
+    QCOMPARE(parseExact("=== STATUS ===").kind, TextProtocol::Message::Unknown);
+    QCOMPARE(parseExact("LED: MAYBE").kind, TextProtocol::Message::Unknown);
+    QCOMPARE(parseExact("PWM: 150%").kind, TextProtocol::Message::Unknown);
+    QCOMPARE(parseExact("UPTIME: 4294967296").kind, TextProtocol::Message::Unknown);
+    QCOMPARE(parseExact("UPTIME:").kind, TextProtocol::Message::Unknown);
+}
+
+void TestTextProtocol::errorText()
+{
+    QByteArray text;
+    QCOMPARE(parseExact("ERROR: Unknown command  \r", &text).kind, TextProtocol::Message::Error);
+    QCOMPARE(text, QByteArray("Unknown command"));
+
+    QCOMPARE(parseExact("ERROR").kind, TextProtocol::Message::Error);
+    QCOMPARE(TextProtocol::parse(nullptr, 0).kind, TextProtocol::Message::Unknown);
+}
+
+void TestTextProtocol::truncatedSeeds()
+{
+    // Chaque préfixe de chaque ligne valide (réception coupée en cours)
+    for (const char *seed : SeedLines) {
+        const std::string line(seed);
+        for (std::size_t size = 0; size <= line.size(); ++size) {
+            parseExact(line.substr(0, size));
+        }
+    }
+}
+
+void TestTextProtocol::fuzz()
+{
+    // Graine fixe: un échec se reproduit à l'identique
+    std::mt19937 random(FuzzSeed);
+    const int seedCount = int(sizeof(SeedLines) / sizeof(SeedLines[0]));
+
+    for (int i = 0; i < FuzzIterations; ++i) {
+        std::string line;
+        if (i % 16 == 0) {
+            // Octets quelconques
+            line.resize(random() % MaxLineSize);
+            for (char &c : line) {
+                c = char(random());
+            }
+        } else {
+            line = mutate(SeedLines[random() % seedCount], random);
+        }
+        parseExact(line);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestTextProtocol)
+
+#include "test_textprotocol.moc"
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""
+Génère la table de commandes du firmware à partir de ProtocolCommands.def.
+
+Usage (depuis la racine du projet):
+    python3 tools/gen_protocol_tables.py
+
+Écrit stm32_firmware/protocol_commands.h: énumération CommandId et table à
+hachage parfait (FNV-1a 32 bits avec graine, taille puissance de 2). La
+graine est la plus petite valeur sans collision; une recherche de commande
+coûte un hachage et une comparaison. La fonction de hachage est la même
+que Protocol::hashName() côté application.
+"""
+
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEF_FILE = os.path.join(ROOT, "src", "communication", "ProtocolCommands.def")
+OUT_FILE = os.path.join(ROOT, "stm32_firmware", "protocol_commands.h")
+
+COMMAND_RE = re.compile(r'^PROTOCOL_COMMAND\(\s*(\w+)\s*,\s*"([^"]+)"\s*,\s*([\w\s|]+)\)', re.M)
+MODES = {"ModeJson": "CMD_MODE_JSON", "ModeText": "CMD_MODE_TEXT"}
+MAX_SEED = 1 << 20
+
+
+def fnv1a(name, seed):
+    value = (2166136261 ^ seed) & 0xFFFFFFFF
+    for byte in name.encode("ascii"):
+        value ^= byte
+        value = (value * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def table_size(count):
+    size = 8
+    while size < 2 * count:
+        size *= 2
+    return size
+
+
+def find_seed(names, size):
+    for seed in range(MAX_SEED):
+        slots = {fnv1a(name, seed) & (size - 1) for name in names}
+        if len(slots) == len(names):
+            return seed
+    raise SystemExit("Aucune graine sans collision, agrandir la table")
+
+
+def constant_name(name):
+    return "CMD_" + name.upper()
+
+
+def main():
+    with open(DEF_FILE, encoding="utf-8") as f:
+        commands = COMMAND_RE.findall(f.read())
+    if not commands:
+        raise SystemExit("Aucune commande dans " + DEF_FILE)
+
+    names = [name for _, name, _ in commands]
+    if len(set(names)) != len(names):
+        raise SystemExit("Commande dupliquée dans " + DEF_FILE)
+
+    size = table_size(len(commands))
+    seed = find_seed(names, size)
+
+    slots = {}
+    for _, name, modes in commands:
+        flags = " | ".join(MODES[m.strip()] for m in modes.split("|"))
+        slots[fnv1a(name, seed) & (size - 1)] = (name, flags)
+
+    lines = [
+        "/**",
+        " * Table des commandes du protocole - FICHIER GÉNÉRÉ, NE PAS MODIFIER",
+        " *",
+        " * Source: src/communication/ProtocolCommands.def",
+        " * Générateur: tools/gen_protocol_tables.py",
+        " */",
+        "",
+        "#ifndef PROTOCOL_COMMANDS_H",
+        "#define PROTOCOL_COMMANDS_H",
+        "",
+        "#include <stdint.h>",
+        "#include <stddef.h>",
+        "#include <string.h>",
+        "",
+        "#define CMD_MODE_JSON 0x01u",
+        "#define CMD_MODE_TEXT 0x02u",
+        "",
+        "typedef enum {",
+    ]
+    lines += ["    %s," % constant_name(name) for name in names]
+    lines += [
+        "    CMD_UNKNOWN",
+        "} CommandId;",
+        "",
+        "#define COMMAND_HASH_SEED  0x%08Xu" % seed,
+        "#define COMMAND_TABLE_MASK %uu" % (size - 1),
+        "",
+        "typedef struct {",
+        "    const char *name;",
+        "    uint8_t length;",
+        "    uint8_t modes;",
+        "    uint8_t id;",
+        "} CommandEntry;",
+        "",
+        "static const CommandEntry command_table[COMMAND_TABLE_MASK + 1] = {",
+    ]
+    for index in sorted(slots):
+        name, flags = slots[index]
+        lines.append('    [%u] = { "%s", %u, %s, %s },' % (index, name, len(name), flags, constant_name(name)))
+    lines += [
+        "};",
+        "",
+        "// Un hachage FNV-1a et une comparaison; CMD_UNKNOWN si absente ou",
+        "// non disponible dans ce mode",
+        "static inline CommandId lookupCommand(const char *name, size_t length, uint8_t mode) {",
+        "    uint32_t hash = 2166136261u ^ COMMAND_HASH_SEED;",
+        "    for (size_t i = 0; i < length; i++) {",
+        "        hash ^= (uint8_t)name[i];",
+        "        hash *= 16777619u;",
+        "    }",
+        "",
+        "    const CommandEntry *entry = &command_table[hash & COMMAND_TABLE_MASK];",
+        "    if (entry->name == NULL || entry->length != length || (entry->modes & mode) == 0",
+        "        || memcmp(entry->name, name, length) != 0) {",
+        "        return CMD_UNKNOWN;",
+        "    }",
+        "    return (CommandId)entry->id;",
+        "}",
+        "",
+        "#endif // PROTOCOL_COMMANDS_H",
+        "",
+    ]
+
+    with open(OUT_FILE, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(lines))
+    print("%s: %d commandes, table %d, graine 0x%08X"
+          % (os.path.relpath(OUT_FILE, ROOT), len(names), size, seed))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())